@@ -1,10 +1,125 @@
 #ifndef ALPHA101_H
 #define ALPHA101_H
 
+#include "Alpha101Panel.h"
+#include "Alpha101ThreadPool.h"
 #include "Alpha101Utils.h"
 
 // ====== Alpha-Faktor-Implementierungen ======
 
+/**
+ * @brief Alpha#1 Step 1 的单只股票内核：ts_argmax(SignedPower(returns < 0 ? stddev(returns, 20) : close, 2), 5)
+ *
+ * 各版本 alpha001 共用。std_ret/inner_sq 为调用方提供的临时缓冲区，与 close 等长；
+ * 与 ops（ts_argmax 的单调队列存储）一起跨股票复用时不再分配。
+ *
+ * @param close    单只股票的收盘价序列
+ * @param returns  单只股票的收益率序列，与 close 等长
+ * @param argmax_s 输出：ts_argmax 结果（1..5，热身期为 NaN）
+ */
+inline void alpha001_argmax_series(span<const float> close, span<const float> returns, span<float> std_ret,
+                                   span<float> inner_sq, span<float> argmax_s, Workspace& ops) {
+    size_t T = close.size();
+    rolling_stddev(returns, 20, std_ret);
+    for (size_t t = 0; t < T; ++t) {
+        if (isnan(std_ret[t])) {
+            inner_sq[t] = NAN;
+            continue;
+        }
+        float val = (returns[t] < 0.0f) ? std_ret[t] : close[t];
+        inner_sq[t] = val * val;
+    }
+    ts_argmax(span<const float>(inner_sq), 5, argmax_s, ops);
+}
+
+/**
+ * @brief alpha 求值的可复用工作区：持有全部中间结果与输出缓冲区
+ *
+ * 各缓冲区在第一次调用时按 (S, T) 分配，之后同形状的调用直接复用：不再触碰分配器，缓冲区也留在缓存中。
+ * 形状变化时按新形状重新分配。非线程安全：每个线程使用自己的工作区。
+ */
+struct AlphaWorkspace {
+    // 时序阶段与截面阶段之间按 kBlock 只股票 / kBlock 个日期成组搬运（一组 float 恰为一条缓存行）
+    static constexpr size_t kBlock = 16;
+
+    // Step 1：ts_argmax 结果，TimeMajor [S × T]，即 argmax_flat[t*S + s]，Step 2 逐行读取
+    Panel<float> argmax_tm;
+    // Step 1 的 TimeMajor SIMD 路径：stddev / inner_sq 面板与 tm_rolling_stddev 的运行状态
+    Panel<float> work;
+    vector<double> simd_state;
+    // Step 1 的逐股票路径：单只股票的序列缓冲区（长度 T），以及一组股票的 argmax 序列 [kBlock × T]
+    vector<float> close_buf, returns_buf, std_ret, inner_sq;
+    vector<float> series_block;
+    // Step 2：一组日期的截面排名 [kBlock × S] 及其转置 [S × kBlock]
+    vector<float> rank_block, rank_tile;
+    // 分片求值的 Step 2：从各分片汇集的一组日期的 argmax 截面 [kBlock × S]
+    vector<float> gathered;
+    // 两步共用的算子临时存储（ts_argmax 单调队列、alpha_rank 下标）
+    Workspace ops;
+    // 嵌套 vector 接口的输出 result[s][t]
+    vector<vector<float>> result;
+
+    // 把两个 [S × T] 中间面板预先放进 arena（大页），供完整求值 alpha001(close, returns, out, ws) 复用。
+    // arena 面板的元素个数固定：之后以其他形状调用（alpha001_tail / alpha001_recompute）时改用堆面板，见 reset_scratch
+    void reserve(PanelArena& arena, size_t S, size_t T) {
+        argmax_tm = Panel<float>::in_arena(arena, S, T, PanelLayout::TimeMajor);
+        work = Panel<float>::in_arena(arena, S, T, PanelLayout::TimeMajor);
+    }
+
+    // 把中间面板重置为 TimeMajor [S × T]；reserve 放入 arena 的面板元素个数不符时换成堆面板（释放其 arena 租约）
+    static void reset_scratch(Panel<float>& p, size_t S, size_t T) {
+        if (!p.owns_memory() && p.size() != S * T) p = Panel<float>(S, T, PanelLayout::TimeMajor);
+        else p.reset(S, T, PanelLayout::TimeMajor);
+    }
+};
+
+/**
+ * @brief Alpha#1 Step 1：股票 [s_begin, s_end) 的 ts_argmax 写入 TimeMajor 的 argmax_flat
+ *
+ * 每 kBlock 只股票先逐只写入 series_block 的连续行，再分块转置进 argmax_flat 的 [s0, s0 + kBlock) 列，
+ * 避免逐元素以步长 S 写入。series(s) 返回股票 s 的 {close, returns} 连续序列。
+ */
+template <typename SeriesFn>
+inline void alpha001_argmax_stocks(size_t s_begin, size_t s_end, size_t S, size_t T, SeriesFn&& series,
+                                   float* argmax_flat, AlphaWorkspace& ws) {
+    constexpr size_t B = AlphaWorkspace::kBlock;
+    ws.std_ret.resize(T);
+    ws.inner_sq.resize(T);
+    ws.series_block.resize(B * T);
+    for (size_t s0 = s_begin; s0 < s_end; s0 += B) {
+        size_t nb = min(B, s_end - s0);
+        for (size_t j = 0; j < nb; ++j) {
+            auto [c, r] = series(s0 + j);
+            alpha001_argmax_series(c, r, ws.std_ret, ws.inner_sq, span<float>(ws.series_block.data() + j * T, T), ws.ops);
+        }
+        transpose(ws.series_block.data(), nb, T, T, argmax_flat + s0, S);
+    }
+}
+
+/**
+ * @brief Alpha#1 Step 2：日期 [t_begin, t_end) 的截面排名 - 0.5，按股票写回
+ *
+ * 每 kBlock 个日期先排名进 rank_block，转置为 [S × kBlock] 后，每只股票一次写入 kBlock 个连续日期，
+ * 避免逐元素以步长 T（或跨 S 个独立的行）分散写入。row(s) 返回股票 s 的输出序列首地址（按 t 连续）。
+ */
+template <typename RowFn>
+inline void alpha001_rank_dates(const float* argmax_flat, size_t S, size_t t_begin, size_t t_end, RowFn&& row,
+                                AlphaWorkspace& ws) {
+    constexpr size_t B = AlphaWorkspace::kBlock;
+    ws.rank_block.resize(B * S);
+    ws.rank_tile.resize(S * B);
+    for (size_t t0 = t_begin; t0 < t_end; t0 += B) {
+        size_t nb = min(B, t_end - t0);
+        for (size_t j = 0; j < nb; ++j) {
+            span<float> ranked(ws.rank_block.data() + j * S, S);
+            alpha_rank(span<const float>(argmax_flat + (t0 + j) * S, S), ranked, ws.ops);
+            for (float& v : ranked) v -= 0.5f;  // NaN - 0.5 仍为 NaN
+        }
+        transpose(ws.rank_block.data(), nb, S, S, ws.rank_tile.data(), B);
+        for (size_t s = 0; s < S; ++s) copy_n(ws.rank_tile.data() + s * B, nb, row(s) + t0);
+    }
+}
+
 /**
  * @brief Alpha#1，截面rank版（符合论文原意）
  *
@@ -13,48 +128,353 @@
  *
  * @param close_mat   收盘价矩阵，close_mat[s][t]，s = 股票索引，t = 时间索引
  * @param returns_mat 收益率矩阵，returns_mat[s][t]，维度与 close_mat 相同
- * @return            因子矩阵 result[s][t]，值域 (-0.5, 0.5]；
- *                    前23个时间点（热身期）输出 NaN
+ * @param ws          工作区；同形状的重复调用零堆分配
+ * @return            ws.result：因子矩阵 result[s][t]，值域 (-0.5, 0.5]；
+ *                    前 kAlpha001Lookback - 1 = 23 个时间点（热身期）输出 NaN。下一次使用 ws 的调用会覆盖它
  */
+inline const vector<vector<float>>& alpha001(const vector<vector<float>>& close_mat,
+                                             const vector<vector<float>>& returns_mat, AlphaWorkspace& ws) {
+    size_t S = close_mat.size();
+    ws.result.resize(S);
+    if (S == 0) return ws.result;
+    size_t T = close_mat[0].size();
+
+    // Step 1: 每只股票独立计算 ts_argmax(inner_sq, 5)
+    // 结果写入列主序平坦缓冲区 argmax_flat[t*S + s]，使 Step 2 的截面读取成为连续内存访问
+    AlphaWorkspace::reset_scratch(ws.argmax_tm, S, T);
+    float* argmax_flat = ws.argmax_tm.data();
+    auto series = [&](size_t s) { return pair{span<const float>(close_mat[s]), span<const float>(returns_mat[s])}; };
+    alpha001_argmax_stocks(0, S, S, T, series, argmax_flat, ws);
+
+    // Step 2: 对每个时间截面，跨股票做截面排名
+    for (auto& row : ws.result) row.resize(T);
+    alpha001_rank_dates(argmax_flat, S, 0, T, [&](size_t s) { return ws.result[s].data(); }, ws);
+
+    return ws.result;
+}
+
+// 一次性调用：使用临时工作区，结果移出返回
 inline vector<vector<float>> alpha001(const vector<vector<float>>& close_mat,
                                       const vector<vector<float>>& returns_mat) {
+    AlphaWorkspace ws;
+    alpha001(close_mat, returns_mat, ws);
+    return std::move(ws.result);
+}
+
+/**
+ * @brief Alpha#1 的多线程版本，结果与单线程版逐位相同
+ *
+ * Step 1 按股票分块、Step 2 按日期分块交给 pool，每个块内的计算顺序与单线程版一致；
+ * 每个工作线程持有自己的 AlphaWorkspace 临时存储。
+ *
+ * @param pool 复用的线程池；pool.size() == 1 时退化为在调用线程上串行执行
+ */
+inline vector<vector<float>> alpha001(const vector<vector<float>>& close_mat,
+                                      const vector<vector<float>>& returns_mat, ThreadPool& pool) {
     size_t S = close_mat.size();
     if (S == 0) return {};
     size_t T = close_mat[0].size();
+    vector<AlphaWorkspace> wss(pool.size());
 
-    // Step 1: 每只股票独立计算 ts_argmax(inner_sq, 5)
-    // 结果直接写入列主序平坦缓冲区 argmax_flat[t*S + s]，
-    // 使 Step 2 的截面读取成为连续内存访问
-    // std_ret/inner_sq/argmax_s 在循环外预分配，S 次迭代全程复用，零内部堆分配
-    vector<float> argmax_flat(T * S, NAN);
-    vector<float> std_ret(T), inner_sq(T), argmax_s(T);
-    for (size_t s = 0; s < S; ++s) {
-        rolling_stddev(returns_mat[s], 20, std_ret);
+    // Step 1: 各块写入 argmax_flat 中互不重叠的列 [s_begin, s_end)
+    vector<float> argmax_flat(T * S);
+    auto series = [&](size_t s) { return pair{span<const float>(close_mat[s]), span<const float>(returns_mat[s])}; };
+    pool.parallel_for(S, [&](size_t s_begin, size_t s_end, size_t w) {
+        alpha001_argmax_stocks(s_begin, s_end, S, T, series, argmax_flat.data(), wss[w]);
+    });
+
+    // Step 2: 各块只写 result[s][t_begin, t_end)
+    vector<vector<float>> result(S, vector<float>(T));
+    pool.parallel_for(T, [&](size_t t_begin, size_t t_end, size_t w) {
+        alpha001_rank_dates(argmax_flat.data(), S, t_begin, t_end, [&](size_t s) { return result[s].data(); }, wss[w]);
+    });
+
+    return result;
+}
+
+// Alpha#1 的最小回看：stddev(returns, 20) 的结果再经 ts_argmax(·, 5)，窗口串联需要 20 + 5 - 1 个观测；
+// 第 t 个日期的输出只取决于 [t - kAlpha001Lookback + 1, t]，前 kAlpha001Lookback - 1 个日期为热身期
+constexpr size_t kAlpha001StddevWindow = 20;
+constexpr size_t kAlpha001ArgmaxWindow = 5;
+constexpr size_t kAlpha001Lookback = kAlpha001StddevWindow + kAlpha001ArgmaxWindow - 1;
 
-        fill(inner_sq.begin(), inner_sq.end(), NAN);
-        for (size_t t = 0; t < T; ++t) {
-            if (isnan(std_ret[t])) continue;
-            float val = (returns_mat[s][t] < 0.0f) ? std_ret[t] : close_mat[s][t];
-            inner_sq[t] = val * val;
+/**
+ * @brief Alpha#1 Step 1 的 Panel 版本：日期 [d_begin, d_end) 的 ts_argmax 写入 TimeMajor 的 ws.argmax_tm
+ *
+ * ws.argmax_tm 的形状为 [S × (d_end - d_begin)]，第 0 行对应日期 d_begin；窗口只在该区间内展开，
+ * 区间之前的历史不参与计算。TimeMajor 输入跨股票 SIMD 扫描，StockMajor 输入直接读取连续子序列（零拷贝），
+ * 其余布局先聚合到序列缓冲区。
+ */
+inline void alpha001_argmax_panel(const Panel<float>& close, const Panel<float>& returns, size_t d_begin,
+                                  size_t d_end, AlphaWorkspace& ws) {
+    size_t S = close.stocks(), n = d_end - d_begin;
+    Panel<float>& argmax_tm = ws.argmax_tm;
+    AlphaWorkspace::reset_scratch(argmax_tm, S, n);
+    if (close.layout() == PanelLayout::TimeMajor && returns.layout() == PanelLayout::TimeMajor) {
+        // TimeMajor 输入：跨股票 SIMD 扫描，stddev → inner_sq（原地）→ ts_argmax，全程无转置
+        Panel<float>& work = ws.work;
+        AlphaWorkspace::reset_scratch(work, S, n);
+        tm_rolling_stddev(returns.row(d_begin).data(), S, n, (int)kAlpha001StddevWindow, work.data(), ws.simd_state);
+        for (size_t t = 0; t < n; ++t) {
+            const float* c = close.row(d_begin + t).data();
+            const float* r = returns.row(d_begin + t).data();
+            float* w = work.row(t).data();
+            simd_sweep(S, [&]<typename L>(size_t s) {
+                auto sd = L::load(w + s);
+                auto val = L::select(L::lt(L::load(r + s), L::set1(0.0f)), sd, L::load(c + s));
+                L::store(w + s, L::select(L::is_nan(sd), L::set1(NAN), L::mul(val, val)));
+            });
         }
-        ts_argmax(inner_sq, 5, argmax_s);
-        for (size_t t = 0; t < T; ++t) argmax_flat[t * S + s] = argmax_s[t];
+        tm_ts_argmax(work.data(), S, n, (int)kAlpha001ArgmaxWindow, argmax_tm.data());
+        return;
     }
 
-    // Step 2: 对每个时间截面，跨股票做截面排名
-    // argmax_flat[t*S .. t*S+S) 为连续内存，直接以 span 传入，无需额外拷贝
-    // ranked/idx_buf 在循环外预分配，T 次迭代全程复用，零内部堆分配
-    vector<vector<float>> result(S, vector<float>(T, NAN));
-    vector<float> ranked(S);
-    vector<size_t> idx_buf;
-    idx_buf.reserve(S);
-    for (size_t t = 0; t < T; ++t) {
-        alpha_rank(span<const float>(&argmax_flat[t * S], S), span<float>(ranked), idx_buf);
-        for (size_t s = 0; s < S; ++s)
-            if (!isnan(ranked[s])) result[s][t] = ranked[s] - 0.5f;
+    // 其他布局：每只股票独立计算；StockMajor 下直接读取连续子序列，否则先聚合到序列缓冲区
+    bool contiguous = close.layout() == PanelLayout::StockMajor && returns.layout() == PanelLayout::StockMajor;
+    if (!contiguous) {
+        ws.close_buf.resize(n);
+        ws.returns_buf.resize(n);
     }
+    auto series = [&](size_t s) {
+        if (contiguous) return pair{close.row(s).subspan(d_begin, n), returns.row(s).subspan(d_begin, n)};
+        auto cs = close.series(s), rs = returns.series(s);
+        for (size_t t = 0; t < n; ++t) {
+            ws.close_buf[t] = cs[d_begin + t];
+            ws.returns_buf[t] = rs[d_begin + t];
+        }
+        return pair{span<const float>(ws.close_buf), span<const float>(ws.returns_buf)};
+    };
+    alpha001_argmax_stocks(0, S, S, n, series, argmax_tm.data(), ws);
+}
 
-    return result;
+/**
+ * @brief Alpha#1 Step 2 的 Panel 版本：从 argmax_flat 起的 n 行 TimeMajor 截面逐行排名 - 0.5，写入 out 的 n 个日期
+ *
+ * TimeMajor 输出直接写入连续行，StockMajor 输出经分块转置写回。
+ */
+inline void alpha001_rank_panel(const float* argmax_flat, size_t S, size_t n, Panel<float>& out, AlphaWorkspace& ws) {
+    if (out.layout() == PanelLayout::TimeMajor) {
+        for (size_t t = 0; t < n; ++t) {
+            alpha_rank(span<const float>(argmax_flat + t * S, S), out.row(t), ws.ops);
+            for (float& v : out.row(t)) v -= 0.5f;  // NaN - 0.5 仍为 NaN
+        }
+    } else {
+        alpha001_rank_dates(argmax_flat, S, 0, n, [&](size_t s) { return out.row(s).data(); }, ws);
+    }
+}
+
+/**
+ * @brief Alpha#1 的 Panel 重载：单块连续内存输入/输出，语义与嵌套 vector 版完全相同
+ *
+ * Step 1 在 StockMajor 输入上直接以 span 读取每只股票的序列（零拷贝）；
+ * 在 TimeMajor 输入上改为跨股票 SIMD 扫描（Alpha101Simd.h），一次推进全部股票的一个时间步。
+ * Step 2 的截面排名在 TimeMajor 输出上直接写入 out.row(t)；其余情况下两阶段之间的布局切换经分块转置完成。
+ *
+ * @param close   收盘价面板 [S × T]，任意布局
+ * @param returns 收益率面板，形状与 close 相同
+ * @param out     输出面板；按 close 的形状 reset，布局由调用方预先设定（默认构造为 StockMajor）
+ * @param ws      工作区；与同形状、同布局的 out 一起复用时，重复调用零堆分配
+ */
+inline void alpha001(const Panel<float>& close, const Panel<float>& returns, Panel<float>& out, AlphaWorkspace& ws) {
+    size_t S = close.stocks(), T = close.dates();
+    out.reset(S, T, out.layout());
+    if (S == 0 || T == 0) return;
+    alpha001_argmax_panel(close, returns, 0, T, ws);
+    alpha001_rank_panel(ws.argmax_tm.data(), S, T, out, ws);
+}
+
+/**
+ * @brief Alpha#1 的尾部求值：只计算日期 [t_begin, t_end)，结果与完整求值的对应日期逐位一致
+ *
+ * 只展开 t_begin 之前 kAlpha001Lookback - 1 个日期的回看，截面排名只对目标日期进行；
+ * 实盘每天只取最新一行时（t_begin = T - 1），每日工作量与 T 无关。回看起点向下对齐到
+ * stddev 窗口的整数倍，使滑动方差的重新锚定位置与完整求值相同（至多多读 19 个日期）。
+ *
+ * @param out 输出面板 [S × (t_end - t_begin)]，第 0 个日期对应 t_begin；布局由调用方预先设定
+ */
+inline void alpha001_tail(const Panel<float>& close, const Panel<float>& returns, size_t t_begin, size_t t_end,
+                          Panel<float>& out, AlphaWorkspace& ws) {
+    size_t S = close.stocks(), T = close.dates();
+    if (t_begin > t_end || t_end > T) throw std::invalid_argument("alpha001_tail: date range out of bounds");
+    out.reset(S, t_end - t_begin, out.layout());
+    if (S == 0 || t_begin == t_end) return;
+    size_t d_begin = t_begin < kAlpha001Lookback ? 0 : t_begin - (kAlpha001Lookback - 1);
+    d_begin -= d_begin % kAlpha001StddevWindow;
+    alpha001_argmax_panel(close, returns, d_begin, t_end, ws);
+    alpha001_rank_panel(ws.argmax_tm.row(t_begin - d_begin).data(), S, t_end - t_begin, out, ws);
+}
+
+inline Panel<float> alpha001_tail(const Panel<float>& close, const Panel<float>& returns, size_t t_begin,
+                                  size_t t_end, PanelLayout out_layout = PanelLayout::TimeMajor) {
+    AlphaWorkspace ws;
+    Panel<float> out(0, 0, out_layout);
+    alpha001_tail(close, returns, t_begin, t_end, out, ws);
+    return out;
+}
+
+/**
+ * @brief 修订输入日期 [d_begin, d_end) 后，Alpha#1 输出中需要重算的日期区间终点（不含）
+ *
+ * 结构上，输入 x 只进入 [x, x + kAlpha001Lookback - 1] 的窗口；但 stddev 的滑动和式在窗口起点为 20 的
+ * 整数倍时才重新锚定，x 移出窗口后其舍入仍留在和式中，直到下一次锚定。为与完整求值逐位一致，
+ * stddev 的脏区延伸到 x 之后第二个锚点窗口的末尾，再加上 ts_argmax 的 4 个日期。截面排名污染整个截面。
+ */
+inline size_t alpha001_dirty_end(size_t d_begin, size_t d_end, size_t T) {
+    if (d_begin >= d_end) return d_begin;
+    constexpr size_t w = kAlpha001StddevWindow;
+    size_t stddev_end = ((d_end - 1) / w + 2) * w - 1;
+    return std::min(T, stddev_end + kAlpha001ArgmaxWindow - 1);
+}
+
+/**
+ * @brief 输入修订后的局部重算：close / returns 在日期 [d_begin, d_end) 上被修订，只重写 out 中受影响的日期
+ *
+ * out 为此前在修订前输入上完整求值的结果（任意布局），重写日期 [d_begin, alpha001_dirty_end(...)) 的全部股票，
+ * 其余日期不变；结果与在修订后输入上完整求值逐位一致。代价只与修订区间的长度有关，与 T 无关。
+ *
+ * @return 重写的日期区间终点（不含）
+ */
+inline size_t alpha001_recompute(const Panel<float>& close, const Panel<float>& returns, size_t d_begin,
+                                 size_t d_end, Panel<float>& out, AlphaWorkspace& ws) {
+    size_t S = close.stocks(), T = close.dates();
+    if (d_begin > d_end || d_end > T) throw std::invalid_argument("alpha001_recompute: date range out of bounds");
+    if (out.stocks() != S || out.dates() != T)
+        throw std::invalid_argument("alpha001_recompute: out must hold the previous full evaluation");
+    size_t t_end = alpha001_dirty_end(d_begin, d_end, T);
+    if (S == 0 || d_begin == t_end) return t_end;
+
+    size_t first = d_begin < kAlpha001Lookback ? 0 : d_begin - (kAlpha001Lookback - 1);
+    first -= first % kAlpha001StddevWindow;
+    alpha001_argmax_panel(close, returns, first, t_end, ws);
+    const float* argmax_flat = ws.argmax_tm.row(d_begin - first).data();
+    if (out.layout() == PanelLayout::TimeMajor) {
+        Panel<float> rows = Panel<float>::view(out.row(d_begin).data(), S, t_end - d_begin, PanelLayout::TimeMajor);
+        alpha001_rank_panel(argmax_flat, S, t_end - d_begin, rows, ws);
+    } else {
+        alpha001_rank_dates(argmax_flat, S, 0, t_end - d_begin, [&](size_t s) { return out.row(s).data() + d_begin; }, ws);
+    }
+    return t_end;
+}
+
+inline void alpha001(const Panel<float>& close, const Panel<float>& returns, Panel<float>& out) {
+    AlphaWorkspace ws;
+    alpha001(close, returns, out, ws);
+}
+
+inline Panel<float> alpha001(const Panel<float>& close, const Panel<float>& returns, PanelLayout out_layout) {
+    Panel<float> out(0, 0, out_layout);
+    alpha001(close, returns, out);
+    return out;
+}
+
+inline Panel<float> alpha001(const Panel<float>& close, const Panel<float>& returns) {
+    return alpha001(close, returns, close.layout());
+}
+
+// ====== 按股票分片、首次写入留在本地节点的 Alpha#1 ======
+
+/**
+ * @brief 按线程池参与者切分的股票分片：参与者 w 持有股票 [begin(w), end(w)) 的 TimeMajor 面板
+ *
+ * 分片由 shard_stocks 在参与者 w 自己的线程上分配并首次写入（first-touch），线程池以 numa_affinity()
+ * 绑定时，分片的物理页即落在该参与者所在的节点上。分块与 ThreadPool::parallel_for 相同，
+ * 参与者多于股票时末尾的分片为空。
+ */
+struct StockShards {
+    vector<size_t> bounds;  // bounds[w] .. bounds[w + 1]，共 parts.size() + 1 项
+    vector<Panel<float>> parts;
+
+    size_t shards() const { return parts.size(); }
+    size_t begin(size_t w) const { return bounds[w]; }
+    size_t end(size_t w) const { return bounds[w + 1]; }
+    size_t stocks() const { return bounds.empty() ? 0 : bounds.back(); }
+    size_t dates() const { return parts.empty() ? 0 : parts[0].dates(); }
+};
+
+/**
+ * @brief 把面板按股票切分给 pool 的各参与者，每个分片由对应参与者分配并拷入（一次性的跨节点读取）
+ *
+ * 输入可以是加载线程写入的任意布局面板；之后的求值只在各节点本地读取分片。
+ * out 已是同样切分、同样形状时复用其内存（页的归属不变），只重新拷入数据。
+ */
+inline void shard_stocks(const Panel<float>& in, ThreadPool& pool, StockShards& out) {
+    size_t S = in.stocks(), T = in.dates(), P = pool.size();
+    size_t blocks = std::min(S, P);
+    out.parts.resize(P);
+    out.bounds.resize(P + 1);
+    for (size_t w = 0; w <= P; ++w) out.bounds[w] = blocks ? S * std::min(w, blocks) / blocks : 0;
+    pool.run([&](size_t w) {
+        size_t b = out.begin(w), e = out.end(w);
+        Panel<float>& part = out.parts[w];
+        part.reset(e - b, T, PanelLayout::TimeMajor);  // 新分配时由本线程首次写入
+        if (b == e) return;
+        if (in.layout() == PanelLayout::TimeMajor) {
+            for (size_t t = 0; t < T; ++t) copy_n(in.row(t).data() + b, e - b, part.row(t).data());
+        } else {
+            transpose(in.row(b).data(), e - b, T, T, part.data(), e - b);
+        }
+    });
+}
+
+inline StockShards shard_stocks(const Panel<float>& in, ThreadPool& pool) {
+    StockShards out;
+    shard_stocks(in, pool, out);
+    return out;
+}
+
+/**
+ * @brief Alpha#1 的分片求值：Step 1 各参与者只读写本节点的分片，只有 Step 2 的截面排名跨节点汇集
+ *
+ * 参与者 w 在分片 w 上做 ts_argmax，结果留在 wss[w].argmax_tm（由 w 首次写入）；
+ * Step 2 按日期分块，每 kBlock 个日期从各分片汇集一次截面再排名。结果与单线程 Panel 版逐位相同。
+ * close / returns 必须由同一个 pool 切分；wss 按 pool.size() 调整，跨调用复用时 Step 1 不再分配。
+ *
+ * @param out 输出面板 [S × T]，布局由调用方预先设定；由调用线程分配，宜跨调用复用
+ */
+inline void alpha001(const StockShards& close, const StockShards& returns, Panel<float>& out, ThreadPool& pool,
+                     vector<AlphaWorkspace>& wss) {
+    if (close.bounds != returns.bounds || close.dates() != returns.dates())
+        throw std::invalid_argument("alpha001: close and returns must be sharded identically");
+    if (close.shards() != pool.size())
+        throw std::invalid_argument("alpha001: shards were not split by this thread pool");
+    size_t S = close.stocks(), T = close.dates(), P = pool.size();
+    out.reset(S, T, out.layout());
+    wss.resize(P);
+    if (S == 0 || T == 0) return;
+
+    // Step 1：分片内的时序阶段，输入、中间结果与 argmax 全在本节点
+    pool.run([&](size_t w) {
+        if (close.begin(w) < close.end(w)) alpha001_argmax_panel(close.parts[w], returns.parts[w], 0, T, wss[w]);
+    });
+
+    // Step 2：按日期分块，从各分片汇集截面后排名
+    constexpr size_t B = AlphaWorkspace::kBlock;
+    pool.parallel_for(T, [&](size_t t_begin, size_t t_end, size_t w) {
+        AlphaWorkspace& ws = wss[w];
+        ws.gathered.resize(B * S);
+        for (size_t t0 = t_begin; t0 < t_end; t0 += B) {
+            size_t nb = std::min(B, t_end - t0);
+            for (size_t k = 0; k < P; ++k) {
+                size_t b = close.begin(k), n = close.end(k) - b;
+                if (n == 0) continue;
+                for (size_t j = 0; j < nb; ++j) copy_n(wss[k].argmax_tm.row(t0 + j).data(), n, ws.gathered.data() + j * S + b);
+            }
+            if (out.layout() == PanelLayout::TimeMajor) {
+                Panel<float> rows = Panel<float>::view(out.row(t0).data(), S, nb, PanelLayout::TimeMajor);
+                alpha001_rank_panel(ws.gathered.data(), S, nb, rows, ws);
+            } else {
+                alpha001_rank_dates(ws.gathered.data(), S, 0, nb, [&](size_t s) { return out.row(s).data() + t0; }, ws);
+            }
+        }
+    });
+}
+
+inline Panel<float> alpha001(const StockShards& close, const StockShards& returns, ThreadPool& pool,
+                             PanelLayout out_layout = PanelLayout::TimeMajor) {
+    vector<AlphaWorkspace> wss;
+    Panel<float> out(0, 0, out_layout);
+    alpha001(close, returns, out, pool, wss);
+    return out;
 }
 
 #endif  // ALPHA101_H
@@ -0,0 +1,233 @@
+#ifndef ALPHA101ARENA_H
+#define ALPHA101ARENA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <set>
+#include <stdexcept>
+#include <vector>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#define ALPHA101_HAVE_HUGEPAGES 1
+#endif
+
+using namespace std;
+
+// ====== 面板 arena：按 2 MB 大页分块、64 字节对齐的指针碰撞分配，整批求值结束时 O(1) 回卷 ======
+//
+// S=5000、T=4000 时一个 float 面板 80 MB；按 4 KB 页即 2 万个 TLB 表项，一次批量求值要扫过数百个面板。
+// arena 以 2 MB 对齐的大块向系统申请内存并提示内核用大页映射，同一块内的面板连续排布；
+// 批量求值的中间结果逐个碰撞分配，结束时把游标回卷到起点，块保留给下一批复用（不再缺页、不再 munmap）。
+
+constexpr size_t kArenaHugePage = size_t(2) << 20;
+constexpr size_t kArenaAlignment = 64;
+constexpr size_t kArenaDefaultChunk = size_t(64) << 20;
+
+// 申请的页类型，以及实际得到的页类型
+enum class ArenaPages {
+    Normal,       // 普通 4 KB 页
+    Transparent,  // 2 MB 对齐并以 MADV_HUGEPAGE 提示透明大页（THP 为 madvise 或 always 模式时生效）
+    Explicit,     // MAP_HUGETLB 显式大页（需预留 vm.nr_hugepages）；申请失败时退回 Transparent
+};
+
+/**
+ * @brief 大页支撑的碰撞分配器
+ *
+ * 分配只移动游标；释放不逐个进行，而是以 mark() / rewind() 成批回卷，或 reset() 回到起点。
+ * 从 arena 取出的面板（Panel::in_arena）以 keepalive 持有 arena 的内存块：arena 对象先于面板析构时
+ * 内存仍然有效。每个租约记下所租内存在 arena 中的位置；回卷时若回卷点及其之后仍有存活的租约则拒绝回卷，
+ * 避免把仍在使用的内存再次分配出去（只看存活总数不够：mark 之前的面板析构、之后的面板仍存活时计数同样平衡）。
+ * 分配非线程安全：同一 arena 只在一个线程上分配；租约可在任意线程上释放。
+ *
+ * 用法：
+ *   PanelArena arena;                                   // 默认透明大页
+ *   auto out = batch.evaluate(fields, PanelLayout::TimeMajor, &arena);   // 中间结果取自 arena，结束时回卷
+ */
+class PanelArena {
+   public:
+    struct Mark {
+        size_t chunk = 0, offset = 0;
+    };
+
+    explicit PanelArena(ArenaPages pages = ArenaPages::Transparent, size_t chunk_bytes = kArenaDefaultChunk)
+        : state_(make_shared<State>()), requested_(pages), chunk_bytes_(round_up(chunk_bytes, kArenaHugePage)) {}
+
+    PanelArena(const PanelArena&) = delete;
+    PanelArena& operator=(const PanelArena&) = delete;
+
+    // 分配 bytes 字节（64 字节对齐）；当前块不足时前进到下一个放得下的块，或申请新块
+    void* allocate(size_t bytes) {
+        bytes = round_up(bytes == 0 ? 1 : bytes, kArenaAlignment);
+        vector<Chunk>& chunks = state_->chunks;
+        while (cursor_.chunk < chunks.size() && cursor_.offset + bytes > chunks[cursor_.chunk].size) {
+            ++cursor_.chunk;
+            cursor_.offset = 0;
+        }
+        if (cursor_.chunk == chunks.size()) chunks.push_back(map_chunk(std::max(bytes, chunk_bytes_)));
+        void* p = chunks[cursor_.chunk].data + cursor_.offset;
+        cursor_.offset += bytes;
+        used_ = std::max(used_, position());
+        return p;
+    }
+
+    // allocate 所得内存 p 的租约，作为面板的 keepalive：存活期间计入 live() 并阻止回卷越过 p，且保持 arena 的内存块映射。
+    // 租约指向 arena 的共享状态而非面板数据，面板据此判定自己不拥有内存（owns_memory() 为 false）
+    shared_ptr<void> lease(const void* p) {
+        size_t pos = position_of(p);
+        shared_ptr<State> state = state_;
+        {
+            lock_guard<mutex> lock(state->leases_mutex);
+            state->leases.insert(pos);
+        }
+        return shared_ptr<void>(state.get(), [state, pos](void*) {
+            lock_guard<mutex> lock(state->leases_mutex);
+            state->leases.erase(state->leases.find(pos));
+        });
+    }
+
+    Mark mark() const { return {cursor_.chunk, cursor_.offset}; }
+
+    // 回卷到 m：m 之后分配的面板必须都已析构，否则抛出 logic_error
+    void rewind(const Mark& m) {
+        if (!try_rewind(m)) throw std::logic_error("PanelArena::rewind: panels allocated after the mark are still alive");
+    }
+
+    // 回卷点及其之后仍有存活租约时返回 false，游标不动
+    bool try_rewind(const Mark& m) noexcept {
+        size_t pos = m.offset;
+        for (size_t i = 0; i < m.chunk; ++i) pos += state_->chunks[i].size;
+        {
+            lock_guard<mutex> lock(state_->leases_mutex);
+            if (!state_->leases.empty() && *state_->leases.rbegin() >= pos) return false;
+        }
+        cursor_.chunk = m.chunk;
+        cursor_.offset = m.offset;
+        return true;
+    }
+
+    void reset() { rewind(Mark{}); }
+
+    size_t live() const {
+        lock_guard<mutex> lock(state_->leases_mutex);
+        return state_->leases.size();
+    }
+    // 已向系统申请的字节数 / 游标到达过的最高位置
+    size_t capacity() const {
+        size_t total = 0;
+        for (const Chunk& c : state_->chunks) total += c.size;
+        return total;
+    }
+    size_t high_water() const { return used_; }
+    ArenaPages requested_pages() const { return requested_; }
+    // 实际得到的页类型：任一块退回时取较弱者
+    ArenaPages pages() const { return state_->chunks.empty() ? requested_ : state_->granted; }
+
+   private:
+    struct Chunk {
+        char* data = nullptr;
+        size_t size = 0;
+    };
+
+    // 块由面板 keepalive 共同持有：最后一个持有者析构时归还系统。
+    // leases 为存活租约在 arena 中的位置（块大小前缀和 + 块内偏移），分配顺序即位置顺序
+    struct State {
+        vector<Chunk> chunks;
+        mutable std::mutex leases_mutex;
+        multiset<size_t> leases;
+        ArenaPages granted = ArenaPages::Explicit;
+
+        ~State() {
+            for (Chunk& c : chunks) {
+#ifdef ALPHA101_HAVE_HUGEPAGES
+                ::munmap(c.data, c.size);
+#else
+                ::operator delete(c.data, std::align_val_t{kArenaHugePage});
+#endif
+            }
+        }
+    };
+
+    static size_t round_up(size_t n, size_t a) { return (n + a - 1) / a * a; }
+
+    size_t position() const {
+        size_t pos = cursor_.offset;
+        for (size_t i = 0; i < cursor_.chunk; ++i) pos += state_->chunks[i].size;
+        return pos;
+    }
+
+    size_t position_of(const void* p) const {
+        const char* c = static_cast<const char*>(p);
+        size_t base = 0;
+        for (const Chunk& chunk : state_->chunks) {
+            if (c >= chunk.data && c < chunk.data + chunk.size) return base + (size_t)(c - chunk.data);
+            base += chunk.size;
+        }
+        throw std::invalid_argument("PanelArena::lease: pointer was not allocated from this arena");
+    }
+
+    Chunk map_chunk(size_t bytes) {
+        bytes = round_up(bytes, kArenaHugePage);
+        ArenaPages got = ArenaPages::Normal;
+        Chunk c;
+        c.size = bytes;
+#ifdef ALPHA101_HAVE_HUGEPAGES
+        void* p = MAP_FAILED;
+        if (requested_ == ArenaPages::Explicit) {
+            p = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+            if (p != MAP_FAILED) got = ArenaPages::Explicit;
+        }
+        if (p == MAP_FAILED) {
+            // 多申请一个大页再裁掉首尾，使块起点 2 MB 对齐，THP 才能整页映射
+            size_t padded = bytes + kArenaHugePage;
+            void* raw = ::mmap(nullptr, padded, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (raw == MAP_FAILED) throw std::bad_alloc();
+            uintptr_t begin = (uintptr_t)raw, aligned = round_up(begin, kArenaHugePage);
+            if (aligned > begin) ::munmap(raw, aligned - begin);
+            if (aligned + bytes < begin + padded) ::munmap((void*)(aligned + bytes), begin + padded - aligned - bytes);
+            p = (void*)aligned;
+            if (requested_ != ArenaPages::Normal && ::madvise(p, bytes, MADV_HUGEPAGE) == 0) got = ArenaPages::Transparent;
+        }
+        c.data = static_cast<char*>(p);
+#else
+        c.data = static_cast<char*>(::operator new(bytes, std::align_val_t{kArenaHugePage}));
+#endif
+        if ((int)got < (int)state_->granted) state_->granted = got;
+        return c;
+    }
+
+    shared_ptr<State> state_;
+    ArenaPages requested_;
+    size_t chunk_bytes_;
+    struct {
+        size_t chunk = 0, offset = 0;
+    } cursor_;
+    size_t used_ = 0;
+};
+
+/**
+ * @brief 作用域内的 arena 帧：构造时记下位置，析构时回卷
+ *
+ * 帧内分配的面板须先于帧析构；若帧内分配的面板仍存活则不回卷（内存不被复用，留待下一次 reset）。
+ * arena 为空指针时什么也不做，便于可选 arena 的接口直接使用。
+ */
+class ArenaFrame {
+   public:
+    explicit ArenaFrame(PanelArena* arena) : arena_(arena) {
+        if (arena_) mark_ = arena_->mark();
+    }
+    ~ArenaFrame() {
+        if (arena_) arena_->try_rewind(mark_);
+    }
+    ArenaFrame(const ArenaFrame&) = delete;
+    ArenaFrame& operator=(const ArenaFrame&) = delete;
+
+   private:
+    PanelArena* arena_;
+    PanelArena::Mark mark_;
+};
+
+#endif  // ALPHA101ARENA_H
@@ -0,0 +1,1691 @@
+#ifndef ALPHA101EXPR_H
+#define ALPHA101EXPR_H
+
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Alpha101Panel.h"
+#include "Alpha101Utils.h"
+
+// ====== 表达式图：以 DAG 表示 alpha 公式，跨公式合并相同子表达式，每个唯一节点只计算一次 ======
+
+/**
+ * @brief 表达式节点的算子
+ *
+ * Field/Const 为叶子；逐元素算子对常数操作数做广播；时序算子沿时间轴、截面算子沿股票轴，
+ * 均直接调用 Alpha101Panel.h 中的 Panel 重载。
+ */
+enum class OpCode : uint8_t {
+    // 叶子
+    Field,  // 输入字段（open / close / volume ...）
+    Const,  // 标量常数
+    // 逐元素
+    Neg,
+    Abs,
+    Log,
+    Sign,
+    Add,
+    Sub,
+    Mul,
+    Div,
+    Pow,          // x ^ y
+    SignedPower,  // sign(x) * |x| ^ y
+    Max,          // 逐元素 max(x, y)
+    Min,          // 逐元素 min(x, y)
+    Lt,
+    Le,
+    Gt,
+    Ge,
+    Eq,
+    Or,
+    Where,  // cond ? x : y
+    // 时序（带窗口参数）
+    TsSum,
+    TsMean,
+    TsStddev,
+    TsRank,
+    TsProduct,
+    TsMin,
+    TsMax,
+    TsArgmax,
+    TsArgmin,
+    Delta,
+    Delay,
+    DecayLinear,
+    Correlation,
+    Covariance,
+    // 截面
+    Rank,
+    Scale,
+    IndNeutralize,  // 组内去均值，第二个参数为分类编码（industry / sector / subindustry）
+};
+
+enum class OpKind : uint8_t { Leaf, Elementwise, TimeSeries, CrossSection };
+
+struct OpInfo {
+    const char* name;
+    OpKind kind;
+    uint8_t arity;
+    bool commutative;
+};
+
+// 算子元信息表，顺序与 OpCode 一致
+inline const OpInfo& op_info(OpCode op) {
+    static constexpr OpInfo table[] = {
+        {"field", OpKind::Leaf, 0, false},
+        {"const", OpKind::Leaf, 0, false},
+        {"neg", OpKind::Elementwise, 1, false},
+        {"abs", OpKind::Elementwise, 1, false},
+        {"log", OpKind::Elementwise, 1, false},
+        {"sign", OpKind::Elementwise, 1, false},
+        {"add", OpKind::Elementwise, 2, true},
+        {"sub", OpKind::Elementwise, 2, false},
+        {"mul", OpKind::Elementwise, 2, true},
+        {"div", OpKind::Elementwise, 2, false},
+        {"pow", OpKind::Elementwise, 2, false},
+        {"signed_power", OpKind::Elementwise, 2, false},
+        {"max", OpKind::Elementwise, 2, true},
+        {"min", OpKind::Elementwise, 2, true},
+        {"lt", OpKind::Elementwise, 2, false},
+        {"le", OpKind::Elementwise, 2, false},
+        {"gt", OpKind::Elementwise, 2, false},
+        {"ge", OpKind::Elementwise, 2, false},
+        {"eq", OpKind::Elementwise, 2, true},
+        {"or", OpKind::Elementwise, 2, true},
+        {"where", OpKind::Elementwise, 3, false},
+        {"ts_sum", OpKind::TimeSeries, 1, false},
+        {"ts_mean", OpKind::TimeSeries, 1, false},
+        {"stddev", OpKind::TimeSeries, 1, false},
+        {"ts_rank", OpKind::TimeSeries, 1, false},
+        {"product", OpKind::TimeSeries, 1, false},
+        {"ts_min", OpKind::TimeSeries, 1, false},
+        {"ts_max", OpKind::TimeSeries, 1, false},
+        {"ts_argmax", OpKind::TimeSeries, 1, false},
+        {"ts_argmin", OpKind::TimeSeries, 1, false},
+        {"delta", OpKind::TimeSeries, 1, false},
+        {"delay", OpKind::TimeSeries, 1, false},
+        {"decay_linear", OpKind::TimeSeries, 1, false},
+        {"correlation", OpKind::TimeSeries, 2, false},
+        {"covariance", OpKind::TimeSeries, 2, false},
+        {"rank", OpKind::CrossSection, 1, false},
+        {"scale", OpKind::CrossSection, 1, false},
+        {"ind_neutralize", OpKind::CrossSection, 2, false},
+    };
+    return table[static_cast<size_t>(op)];
+}
+
+using NodeId = int32_t;
+
+/**
+ * @brief 表达式图中的一个节点
+ *
+ * window 为时序算子的窗口（论文中非整数的 d 向下取整），value 为 Const 的值或 Scale 的 k，
+ * field 为 Field 的字段名。未使用的参数保持默认值，以保证相同子树的节点逐字段相等。
+ */
+struct ExprNode {
+    OpCode op = OpCode::Const;
+    array<NodeId, 3> args = {-1, -1, -1};
+    int window = 0;
+    float value = 0.0f;
+    string field;
+
+    bool operator==(const ExprNode& o) const {
+        return op == o.op && args == o.args && window == o.window &&
+               bit_cast<uint32_t>(value) == bit_cast<uint32_t>(o.value) && field == o.field;
+    }
+};
+
+struct ExprNodeHash {
+    size_t operator()(const ExprNode& n) const {
+        size_t h = hash<string>()(n.field);
+        auto mix = [&](uint64_t v) { h ^= v + 0x9e3779b97f4a7c15ull + (h << 6) + (h >> 2); };
+        mix(static_cast<uint64_t>(n.op));
+        for (NodeId a : n.args) mix(static_cast<uint32_t>(a));
+        mix(static_cast<uint32_t>(n.window));
+        mix(bit_cast<uint32_t>(n.value));
+        return h;
+    }
+};
+
+// ====== 逐元素算子的标量语义（求值循环与常量折叠共用） ======
+// 比较与逻辑运算产生 1/0；任一操作数为 NaN 时结果为 NaN，使热身期沿公式向上传播。
+
+inline float expr_sign(float x) { return isnan(x) ? NAN : (float)((x > 0) - (x < 0)); }
+
+template <typename Visitor>
+inline decltype(auto) visit_unary(OpCode op, Visitor&& v) {
+    switch (op) {
+        case OpCode::Neg: return v([](float x) { return -x; });
+        case OpCode::Abs: return v([](float x) { return std::abs(x); });
+        case OpCode::Log: return v([](float x) { return std::log(x); });
+        case OpCode::Sign: return v([](float x) { return expr_sign(x); });
+        default: throw std::logic_error(string("visit_unary: not a unary op: ") + op_info(op).name);
+    }
+}
+
+template <typename Visitor>
+inline decltype(auto) visit_binary(OpCode op, Visitor&& v) {
+    auto cmp = [](bool r, float x, float y) { return isnan(x) || isnan(y) ? NAN : (float)r; };
+    switch (op) {
+        case OpCode::Add: return v([](float x, float y) { return x + y; });
+        case OpCode::Sub: return v([](float x, float y) { return x - y; });
+        case OpCode::Mul: return v([](float x, float y) { return x * y; });
+        case OpCode::Div: return v([](float x, float y) { return x / y; });
+        case OpCode::Pow: return v([](float x, float y) { return std::pow(x, y); });
+        case OpCode::SignedPower:
+            return v([](float x, float y) { return expr_sign(x) * std::pow(std::abs(x), y); });
+        case OpCode::Max: return v([](float x, float y) { return isnan(x) || isnan(y) ? NAN : std::max(x, y); });
+        case OpCode::Min: return v([](float x, float y) { return isnan(x) || isnan(y) ? NAN : std::min(x, y); });
+        case OpCode::Lt: return v([=](float x, float y) { return cmp(x < y, x, y); });
+        case OpCode::Le: return v([=](float x, float y) { return cmp(x <= y, x, y); });
+        case OpCode::Gt: return v([=](float x, float y) { return cmp(x > y, x, y); });
+        case OpCode::Ge: return v([=](float x, float y) { return cmp(x >= y, x, y); });
+        case OpCode::Eq: return v([=](float x, float y) { return cmp(x == y, x, y); });
+        case OpCode::Or: return v([=](float x, float y) { return cmp(x != 0 || y != 0, x, y); });
+        default: throw std::logic_error(string("visit_binary: not a binary op: ") + op_info(op).name);
+    }
+}
+
+inline float expr_where(float c, float x, float y) { return isnan(c) ? NAN : (c != 0 ? x : y); }
+
+// ====== ExprGraph：带哈希合并（hash-consing）的节点表 ======
+
+/**
+ * @brief 表达式 DAG
+ *
+ * add() 在插入前做规范化：交换律算子按子节点编号排序、全常数逐元素子树折叠为常数、
+ * 恒等变换（x*1、x+0、窗口为 1 的 sum/product/ts_min 等）直接返回子节点；
+ * 随后按节点内容查表，相同节点只保留一份。子节点总是先于父节点插入，
+ * 因此节点编号本身就是一个拓扑序。
+ */
+class ExprGraph {
+   public:
+    NodeId add(ExprNode n) {
+        const OpInfo& info = op_info(n.op);
+        if (info.commutative && n.args[1] < n.args[0]) std::swap(n.args[0], n.args[1]);
+        if (info.kind == OpKind::Elementwise) {
+            if (auto folded = fold(n); folded >= 0) return folded;
+        }
+        if (auto same = identity(n); same >= 0) return same;
+        auto it = index_.find(n);
+        if (it != index_.end()) return it->second;
+        NodeId id = (NodeId)nodes_.size();
+        nodes_.push_back(n);
+        index_.emplace(std::move(n), id);
+        return id;
+    }
+
+    NodeId field(const string& name) {
+        ExprNode n;
+        n.op = OpCode::Field;
+        n.field = name;
+        return add(std::move(n));
+    }
+
+    NodeId constant(float v) {
+        ExprNode n;
+        n.op = OpCode::Const;
+        n.value = v + 0.0f;  // -0.0 与 +0.0 合并
+        return add(std::move(n));
+    }
+
+    const ExprNode& node(NodeId id) const { return nodes_[id]; }
+    size_t size() const { return nodes_.size(); }
+
+    bool is_const(NodeId id) const { return nodes_[id].op == OpCode::Const; }
+    bool is_const(NodeId id, float v) const { return is_const(id) && nodes_[id].value == v; }
+
+   private:
+    NodeId fold(const ExprNode& n) {
+        uint8_t arity = op_info(n.op).arity;
+        for (uint8_t i = 0; i < arity; ++i)
+            if (!is_const(n.args[i])) return -1;
+        float a = nodes_[n.args[0]].value;
+        float b = arity > 1 ? nodes_[n.args[1]].value : 0.0f;
+        if (arity == 1) return constant(visit_unary(n.op, [&](auto f) { return f(a); }));
+        if (arity == 2) return constant(visit_binary(n.op, [&](auto f) { return f(a, b); }));
+        return constant(expr_where(a, b, nodes_[n.args[2]].value));
+    }
+
+    NodeId identity(const ExprNode& n) const {
+        NodeId x = n.args[0], y = n.args[1];
+        switch (n.op) {
+            case OpCode::Add:
+                if (is_const(x, 0.0f)) return y;
+                if (is_const(y, 0.0f)) return x;
+                return -1;
+            case OpCode::Mul:
+                if (is_const(x, 1.0f)) return y;
+                if (is_const(y, 1.0f)) return x;
+                return -1;
+            case OpCode::Sub: return is_const(y, 0.0f) ? x : -1;
+            case OpCode::Div:
+            case OpCode::Pow: return is_const(y, 1.0f) ? x : -1;
+            case OpCode::TsSum:
+            case OpCode::TsMean:
+            case OpCode::TsProduct:
+            case OpCode::TsMin:
+            case OpCode::TsMax:
+            case OpCode::DecayLinear: return n.window == 1 ? x : -1;
+            case OpCode::Delay: return n.window == 0 ? x : -1;
+            default: return -1;
+        }
+    }
+
+    vector<ExprNode> nodes_;
+    unordered_map<ExprNode, NodeId, ExprNodeHash> index_;
+};
+
+// ====== 构造公式的句柄与运算符 ======
+
+/**
+ * @brief 表达式图中节点的轻量句柄，重载运算符后公式可按论文写法书写
+ *
+ * 例：alpha_rank(ts_argmax(signed_power(where(returns < 0, stddev(returns, 20), close), 2), 5)) - 0.5
+ */
+struct Expr {
+    ExprGraph* graph = nullptr;
+    NodeId id = -1;
+};
+
+// 运算符的操作数：Expr 或数值常数
+struct ExprArg {
+    ExprArg(Expr e) : expr(e) {}
+    ExprArg(double v) : value(v) {}
+
+    Expr expr;
+    double value = 0.0;
+};
+
+// 论文约定：非整数窗口向下取整
+inline int expr_window(double d) { return (int)std::floor(d); }
+
+inline Expr make_expr(OpCode op, initializer_list<ExprArg> args, int window = 0, float value = 0.0f) {
+    ExprGraph* g = nullptr;
+    for (const ExprArg& a : args)
+        if (a.expr.graph) g = a.expr.graph;
+    if (!g) throw std::invalid_argument(string("make_expr: ") + op_info(op).name + " needs at least one Expr operand");
+    ExprNode n;
+    n.op = op;
+    n.window = window;
+    n.value = value;
+    size_t i = 0;
+    for (const ExprArg& a : args) n.args[i++] = a.expr.graph ? a.expr.id : g->constant((float)a.value);
+    return Expr{g, g->add(std::move(n))};
+}
+
+inline Expr operator-(ExprArg x) { return make_expr(OpCode::Neg, {x}); }
+inline Expr operator+(ExprArg x, ExprArg y) { return make_expr(OpCode::Add, {x, y}); }
+inline Expr operator-(ExprArg x, ExprArg y) { return make_expr(OpCode::Sub, {x, y}); }
+inline Expr operator*(ExprArg x, ExprArg y) { return make_expr(OpCode::Mul, {x, y}); }
+inline Expr operator/(ExprArg x, ExprArg y) { return make_expr(OpCode::Div, {x, y}); }
+inline Expr operator<(ExprArg x, ExprArg y) { return make_expr(OpCode::Lt, {x, y}); }
+inline Expr operator<=(ExprArg x, ExprArg y) { return make_expr(OpCode::Le, {x, y}); }
+inline Expr operator>(ExprArg x, ExprArg y) { return make_expr(OpCode::Gt, {x, y}); }
+inline Expr operator>=(ExprArg x, ExprArg y) { return make_expr(OpCode::Ge, {x, y}); }
+inline Expr operator||(ExprArg x, ExprArg y) { return make_expr(OpCode::Or, {x, y}); }
+inline Expr eq(ExprArg x, ExprArg y) { return make_expr(OpCode::Eq, {x, y}); }
+
+inline Expr abs(const Expr& x) { return make_expr(OpCode::Abs, {x}); }
+inline Expr log(const Expr& x) { return make_expr(OpCode::Log, {x}); }
+inline Expr sign(const Expr& x) { return make_expr(OpCode::Sign, {x}); }
+inline Expr power(ExprArg x, ExprArg y) { return make_expr(OpCode::Pow, {x, y}); }
+inline Expr signed_power(ExprArg x, ExprArg y) { return make_expr(OpCode::SignedPower, {x, y}); }
+inline Expr max(const Expr& x, const Expr& y) { return make_expr(OpCode::Max, {x, y}); }
+inline Expr min(const Expr& x, const Expr& y) { return make_expr(OpCode::Min, {x, y}); }
+inline Expr where(ExprArg cond, ExprArg x, ExprArg y) { return make_expr(OpCode::Where, {cond, x, y}); }
+
+inline Expr ts_sum(const Expr& x, double d) { return make_expr(OpCode::TsSum, {x}, expr_window(d)); }
+inline Expr ts_mean(const Expr& x, double d) { return make_expr(OpCode::TsMean, {x}, expr_window(d)); }
+inline Expr stddev(const Expr& x, double d) { return make_expr(OpCode::TsStddev, {x}, expr_window(d)); }
+inline Expr ts_rank(const Expr& x, double d) { return make_expr(OpCode::TsRank, {x}, expr_window(d)); }
+inline Expr product(const Expr& x, double d) { return make_expr(OpCode::TsProduct, {x}, expr_window(d)); }
+inline Expr ts_min(const Expr& x, double d) { return make_expr(OpCode::TsMin, {x}, expr_window(d)); }
+inline Expr ts_max(const Expr& x, double d) { return make_expr(OpCode::TsMax, {x}, expr_window(d)); }
+inline Expr ts_argmax(const Expr& x, double d) { return make_expr(OpCode::TsArgmax, {x}, expr_window(d)); }
+inline Expr ts_argmin(const Expr& x, double d) { return make_expr(OpCode::TsArgmin, {x}, expr_window(d)); }
+inline Expr delta(const Expr& x, double d) { return make_expr(OpCode::Delta, {x}, expr_window(d)); }
+inline Expr delay(const Expr& x, double d) { return make_expr(OpCode::Delay, {x}, expr_window(d)); }
+inline Expr decay_linear(const Expr& x, double d) { return make_expr(OpCode::DecayLinear, {x}, expr_window(d)); }
+inline Expr correlation(const Expr& x, const Expr& y, double d) {
+    return make_expr(OpCode::Correlation, {x, y}, expr_window(d));
+}
+inline Expr covariance(const Expr& x, const Expr& y, double d) {
+    return make_expr(OpCode::Covariance, {x, y}, expr_window(d));
+}
+inline Expr alpha_rank(const Expr& x) { return make_expr(OpCode::Rank, {x}); }
+inline Expr scale(const Expr& x, double k = 1.0) { return make_expr(OpCode::Scale, {x}, 0, (float)k); }
+inline Expr ind_neutralize(const Expr& x, const Expr& group) { return make_expr(OpCode::IndNeutralize, {x, group}); }
+
+// ====== ExprPlan：一组根节点的可达子图及求值顺序 ======
+
+/**
+ * @brief 对若干根节点编译出的求值计划
+ *
+ * order 为可达节点的拓扑序（升序节点编号）；uses[id] 为节点在计划内被引用的次数
+ * （父节点引用 + 作为根的引用），求值器据此在最后一次使用后回收中间结果的内存。
+ */
+struct ExprPlan {
+    vector<NodeId> roots;
+    vector<NodeId> order;
+    vector<uint32_t> uses;
+    vector<string> fields;  // 计划用到的输入字段
+};
+
+inline ExprPlan compile_plan(const ExprGraph& g, span<const NodeId> roots) {
+    ExprPlan plan;
+    plan.roots.assign(roots.begin(), roots.end());
+    plan.uses.assign(g.size(), 0);
+    vector<bool> reachable(g.size(), false);
+    for (NodeId r : roots) {
+        reachable[r] = true;
+        plan.uses[r]++;
+    }
+    for (NodeId id = (NodeId)g.size() - 1; id >= 0; --id) {
+        if (!reachable[id]) continue;
+        const ExprNode& n = g.node(id);
+        for (uint8_t i = 0; i < op_info(n.op).arity; ++i) {
+            reachable[n.args[i]] = true;
+            plan.uses[n.args[i]]++;
+        }
+    }
+    for (NodeId id = 0; id < (NodeId)g.size(); ++id) {
+        if (!reachable[id]) continue;
+        plan.order.push_back(id);
+        if (g.node(id).op == OpCode::Field) plan.fields.push_back(g.node(id).field);
+    }
+    return plan;
+}
+
+// 不做子表达式合并时的节点数（展开为树），用于衡量合并收益
+inline size_t expr_tree_size(const ExprGraph& g, NodeId root) {
+    vector<size_t> tree(g.size(), 0);
+    for (NodeId id = 0; id <= root; ++id) {
+        const ExprNode& n = g.node(id);
+        tree[id] = 1;
+        for (uint8_t i = 0; i < op_info(n.op).arity; ++i) tree[id] += tree[n.args[i]];
+    }
+    return tree[root];
+}
+
+// ====== 回看分析 ======
+
+// 节点自身在参数之上额外回看的日期数：delay / delta 为 period，滑动窗口算子为 window - 1，其余为 0
+inline size_t expr_node_lookback(const ExprNode& n) {
+    if (op_info(n.op).kind != OpKind::TimeSeries) return 0;
+    if (n.op == OpCode::Delay || n.op == OpCode::Delta) return n.window > 0 ? (size_t)n.window : 0;
+    return n.window > 1 ? (size_t)n.window - 1 : 0;
+}
+
+// 每 window 步以窗口均值重新锚定滑动和式的算子（stddev / correlation / covariance / decay_linear）：
+// 日期 t 的值还取决于 t 的窗口所在锚点段的起点，比窗口起点最多再早 window - 1 个日期
+inline size_t expr_node_anchor_slack(const ExprNode& n) {
+    switch (n.op) {
+        case OpCode::TsSum:
+        case OpCode::TsMean:
+        case OpCode::TsStddev:
+        case OpCode::Correlation:
+        case OpCode::Covariance:
+        case OpCode::DecayLinear: return n.window > 1 ? (size_t)n.window - 1 : 0;
+        default: return 0;
+    }
+}
+
+/**
+ * @brief 计划中每个节点的回看（按 NodeId 索引）：节点在日期 t 的值只依赖输入字段的 [t - lookback, t]
+ *
+ * 沿拓扑序传播：取各参数回看的最大值再加上节点自身的回看，嵌套窗口逐层累加。
+ * 回看 + 1 即求出一个日期所需的最少历史日期数（见 AlphaBatch::history）。
+ * anchored = true 时每个重新锚定的算子再加上 expr_node_anchor_slack：按绝对日期对齐锚点
+ * （evaluate 的 origin）求值时，截取这么多历史即与完整求值逐位一致。
+ */
+inline vector<size_t> plan_lookback(const ExprGraph& g, const ExprPlan& plan, bool anchored = false) {
+    vector<size_t> lookback(g.size(), 0);
+    for (NodeId id : plan.order) {
+        const ExprNode& n = g.node(id);
+        size_t args = 0;
+        for (uint8_t i = 0; i < op_info(n.op).arity; ++i) args = std::max(args, lookback[n.args[i]]);
+        lookback[id] = args + expr_node_lookback(n) + (anchored ? expr_node_anchor_slack(n) : 0);
+    }
+    return lookback;
+}
+
+// ====== 脏区传播：输入修订后只重算受影响的单元格 ======
+
+/**
+ * @brief 面板上的脏区：股票集合 × 若干互不相交的日期区间
+ *
+ * dates 为升序的 [d0, d1)，重叠或首尾相接的区间合并为一个，相隔的修订各自成段；
+ * stocks[s] != 0 标记脏股票（按需扩展），all_stocks 表示整个截面。
+ */
+struct DirtyRange {
+    vector<pair<size_t, size_t>> dates;
+    bool all_stocks = false;
+    vector<uint8_t> stocks;
+
+    bool empty() const { return dates.empty(); }
+    // 全部日期区间的包络 [d_begin(), d_end())
+    size_t d_begin() const { return empty() ? 0 : dates.front().first; }
+    size_t d_end() const { return empty() ? 0 : dates.back().second; }
+    bool has_stock(size_t s) const { return all_stocks || (s < stocks.size() && stocks[s]); }
+    bool has_date(size_t d) const {
+        auto it = upper_bound(dates.begin(), dates.end(), d, [](size_t x, const auto& r) { return x < r.first; });
+        return it != dates.begin() && d < std::prev(it)->second;
+    }
+    bool contains(size_t s, size_t d) const { return has_date(d) && has_stock(s); }
+
+    // 标记股票 s 在日期 [d0, d1) 上的单元格
+    void mark(size_t s, size_t d0, size_t d1) {
+        if (d0 >= d1) return;
+        if (s >= stocks.size()) stocks.resize(s + 1, 0);
+        stocks[s] = 1;
+        add_dates(d0, d1);
+    }
+    void mark(size_t s, size_t d) { mark(s, d, d + 1); }
+
+    void merge(const DirtyRange& o) {
+        for (auto [d0, d1] : o.dates) add_dates(d0, d1);
+        all_stocks = all_stocks || o.all_stocks;
+        if (o.stocks.size() > stocks.size()) stocks.resize(o.stocks.size(), 0);
+        for (size_t s = 0; s < o.stocks.size(); ++s) stocks[s] |= o.stocks[s];
+    }
+
+    // 每个日期区间换成 f(d0, d1) 返回的区间（空区间丢弃），重新合并
+    template <typename Fn>
+    void transform_dates(Fn&& f) {
+        vector<pair<size_t, size_t>> old;
+        old.swap(dates);
+        for (auto [d0, d1] : old) {
+            auto [e0, e1] = f(d0, d1);
+            add_dates(e0, e1);
+        }
+    }
+
+   private:
+    void add_dates(size_t d0, size_t d1) {
+        if (d0 >= d1) return;
+        // [lo, hi) 为与 [d0, d1) 重叠或相接的区间
+        auto lo = lower_bound(dates.begin(), dates.end(), d0, [](const auto& r, size_t x) { return r.second < x; });
+        auto hi = upper_bound(lo, dates.end(), d1, [](size_t x, const auto& r) { return x < r.first; });
+        if (lo != hi) {
+            d0 = std::min(d0, lo->first);
+            d1 = std::max(d1, std::prev(hi)->second);
+        }
+        dates.insert(dates.erase(lo, hi), {d0, d1});
+    }
+};
+
+// 修订前后两个面板逐位不同的单元格（NaN 与相同位模式的 NaN 视为相同）
+inline DirtyRange dirty_cells(const Panel<float>& before, const Panel<float>& after) {
+    if (before.stocks() != after.stocks() || before.dates() != after.dates())
+        throw std::invalid_argument("dirty_cells: panels have different shapes");
+    DirtyRange dirty;
+    for (size_t s = 0; s < before.stocks(); ++s)
+        for (size_t t = 0; t < before.dates(); ++t)
+            if (bit_cast<uint32_t>(before(s, t)) != bit_cast<uint32_t>(after(s, t))) dirty.mark(s, t);
+    return dirty;
+}
+
+/**
+ * @brief 沿计划传播输入字段的脏区（按 NodeId 索引），T 为日期数
+ *
+ * 逐元素算子取参数脏区的并；delay(x, d) 把每个区间整体后移 d；其余时序算子把每个区间的终点后延
+ * expr_node_lookback 个日期（滑动窗口为 window - 1，delta 为 period）；截面算子（rank / scale /
+ * IndNeutralize 等）污染区间内的整个截面。
+ * 重新锚定的算子（见 expr_node_anchor_slack）不止于此：脏值移出窗口后其舍入仍留在滑动和式中，
+ * 直到下一次锚定，终点因此延伸到最后一个脏日期之后第二个锚点窗口的末尾（同 alpha001_dirty_end）。
+ * 落在区间外的单元格与在修订后输入上完整求值逐位相同。
+ */
+inline vector<DirtyRange> plan_dirty(const ExprGraph& g, const ExprPlan& plan,
+                                     const unordered_map<string, DirtyRange>& inputs, size_t T) {
+    vector<DirtyRange> dirty(g.size());
+    for (NodeId id : plan.order) {
+        const ExprNode& n = g.node(id);
+        DirtyRange& d = dirty[id];
+        if (n.op == OpCode::Field) {
+            auto it = inputs.find(n.field);
+            if (it != inputs.end()) d = it->second;
+        }
+        for (uint8_t i = 0; i < op_info(n.op).arity; ++i) d.merge(dirty[n.args[i]]);
+        if (d.empty()) continue;
+        size_t k = expr_node_lookback(n), w = (size_t)std::max(n.window, 1);
+        bool anchored = expr_node_anchor_slack(n) > 0;
+        d.transform_dates([&](size_t d0, size_t d1) {
+            if (n.op == OpCode::Delay) d0 += k;
+            d1 = anchored ? ((d1 - 1) / w + 2) * w - 1 : d1 + k;
+            return pair{d0, std::min(T, d1)};
+        });
+        if (op_info(n.op).kind == OpKind::CrossSection) d.all_stocks = true;
+        if (d.empty()) d = DirtyRange{};
+    }
+    return dirty;
+}
+
+// ====== 代价估计 ======
+
+/**
+ * @brief 计划中一个节点的代价估计
+ *
+ * ops 为整个 S×T 面板上的标量运算次数（粗略模型，对应 TimeMajor 求值所走的内核）；
+ * bytes 为节点输出面板占用的内存，字段与常数为 0。
+ */
+struct NodeCost {
+    NodeId id;
+    double ops;
+    size_t bytes;
+};
+
+// 单元格（一只股票、一个日期）上的运算次数：窗口重算类内核与窗口长度成正比，滑动状态类为常数
+inline double expr_cell_cost(const ExprNode& n, size_t S) {
+    double w = n.window > 0 ? n.window : 1;
+    switch (n.op) {
+        case OpCode::Field:
+        case OpCode::Const: return 0.0;
+        case OpCode::Log:
+        case OpCode::Pow:
+        case OpCode::SignedPower: return 10.0;  // 超越函数按 10 次基本运算计
+        case OpCode::Where: return 2.0;
+        case OpCode::TsStddev: return 6.0;
+        case OpCode::TsSum:
+        case OpCode::TsMean: return 3.0;  // 滑动和，每格 O(1)
+        case OpCode::DecayLinear: return 5.0;  // 递推 weighted / sum，每格 O(1)
+        case OpCode::TsProduct:
+        case OpCode::TsMin:
+        case OpCode::TsMax: return w;
+        case OpCode::TsArgmax:
+        case OpCode::TsArgmin:
+        case OpCode::TsRank: return 2.0 * w;
+        case OpCode::Delta:
+        case OpCode::Delay: return 1.0;
+        case OpCode::Correlation:
+        case OpCode::Covariance: return 10.0;  // 滑动二阶矩：递推 5 个和式，每格 O(1)
+        case OpCode::Rank: return 2.0 * std::log2((double)std::max<size_t>(S, 2));  // 每个截面排序
+        case OpCode::Scale: return 2.0;
+        case OpCode::IndNeutralize: return 3.0;  // 按预先分好的组求和、相减，不排序
+        default: return 1.0;  // 其余逐元素算子
+    }
+}
+
+/**
+ * @brief 估计计划中每个节点在 S 只股票 × T 个日期上的代价
+ * @return 与 plan.order 一一对应
+ */
+inline vector<NodeCost> estimate_cost(const ExprGraph& g, const ExprPlan& plan, size_t S, size_t T) {
+    vector<NodeCost> costs;
+    costs.reserve(plan.order.size());
+    for (NodeId id : plan.order) {
+        const ExprNode& n = g.node(id);
+        bool leaf = op_info(n.op).kind == OpKind::Leaf;
+        costs.push_back({id, expr_cell_cost(n, S) * S * T, leaf ? 0 : S * T * sizeof(float)});
+    }
+    return costs;
+}
+
+// 节点的单行描述，如 "#12 ts_rank(#7, 10)"、"#3 const 0.5"、"#0 field close"
+inline string describe_node(const ExprGraph& g, NodeId id) {
+    const ExprNode& n = g.node(id);
+    const OpInfo& info = op_info(n.op);
+    string s = "#" + to_string(id) + " " + info.name;
+    if (n.op == OpCode::Field) return s + " " + n.field;
+    if (n.op == OpCode::Const) {
+        std::ostringstream v;
+        v << n.value;
+        return s + " " + v.str();
+    }
+    s += "(";
+    for (uint8_t i = 0; i < info.arity; ++i) s += (i ? ", #" : "#") + to_string(n.args[i]);
+    if (info.kind == OpKind::TimeSeries) s += ", " + to_string(n.window);
+    if (n.op == OpCode::Scale && n.value != 1.0f) {
+        std::ostringstream v;
+        v << n.value;
+        s += ", " + v.str();
+    }
+    return s + ")";
+}
+
+/**
+ * @brief 以文本表格列出计划的每个节点及其代价占比，按求值顺序排列
+ *
+ * 例：
+ *   #8   ts_rank(#7, 10)            1.00e+06 ops   27.0%
+ */
+inline string explain_plan(const ExprGraph& g, const ExprPlan& plan, size_t S, size_t T) {
+    vector<NodeCost> costs = estimate_cost(g, plan, S, T);
+    double total = 0.0;
+    size_t bytes = 0;
+    for (const NodeCost& c : costs) {
+        total += c.ops;
+        bytes += c.bytes;
+    }
+    std::ostringstream os;
+    for (const NodeCost& c : costs) {
+        os << std::left << std::setw(40) << describe_node(g, c.id) << std::right << std::scientific
+           << std::setprecision(2) << std::setw(10) << c.ops << " ops" << std::fixed << std::setprecision(1)
+           << std::setw(7) << (total > 0 ? 100.0 * c.ops / total : 0.0) << "%\n";
+    }
+    os << std::scientific << std::setprecision(2) << "total " << total << " ops, " << plan.order.size()
+       << " nodes, " << std::fixed << std::setprecision(1) << bytes / (1024.0 * 1024.0)
+       << " MiB of intermediate panels\n";
+    return os.str();
+}
+
+// ====== 求值 ======
+
+// 输入字段：名称 → 面板（全部字段形状相同）。分类字段（industry / sector / subindustry）以整数编码存放
+using FieldMap = unordered_map<string, const Panel<float>*>;
+
+// 预先计算好的 d 日平均成交量字段名："adv20" 等；求值时优先读取，代替 ts_mean(volume, d)
+inline string adv_field(int d) { return "adv" + to_string(d); }
+
+namespace expr_detail {
+
+struct PanelArg {
+    const float* p;
+    float operator[](size_t i) const { return p[i]; }
+};
+
+struct ScalarArg {
+    float c;
+    float operator[](size_t) const { return c; }
+};
+
+// 操作数为常数时以 ScalarArg 广播，否则直接读取面板内存
+template <typename Fn>
+inline void visit_operand(const Panel<float>* p, float c, Fn&& fn) {
+    if (p) fn(PanelArg{p->data()});
+    else fn(ScalarArg{c});
+}
+
+inline void copy_to_layout(const Panel<float>& in, Panel<float>& out) {
+    for (size_t s = 0; s < in.stocks(); ++s)
+        for (size_t t = 0; t < in.dates(); ++t) out(s, t) = in(s, t);
+}
+
+}  // namespace expr_detail
+
+/**
+ * @brief 按计划对全部根节点求值
+ *
+ * 每个唯一节点只计算一次；中间结果在最后一次被引用后回收到内存池，供后续节点复用，
+ * 峰值内存取决于 DAG 的"宽度"而非节点总数。常数节点不物化，由逐元素算子广播；
+ * 仅当时序/截面算子以常数为输入时才填充为面板。
+ *
+ * @param fields 输入字段；布局与 layout 不同的字段会先复制为 layout 布局。含 adv{d} 字段时
+ *               ts_mean(volume, d) 直接读取该字段（见 AlphaInputs），不再重新计算
+ * @param layout 求值与输出使用的布局。TimeMajor 下时序算子走跨股票 SIMD 内核
+ * @param arena  可选：中间结果改从 arena（大页）碰撞分配，返回前整帧回卷；结果面板仍在堆上
+ * @param origin 输入第 0 个日期的绝对日期（截取自更长历史时为截取起点）。ts_sum / ts_mean / stddev /
+ *               correlation / covariance / decay_linear 的锚点按绝对日期对齐，见 AlphaBatch::evaluate_range
+ * @return       与 plan.roots 一一对应的结果面板
+ */
+inline vector<Panel<float>> evaluate(const ExprGraph& g, const ExprPlan& plan, const FieldMap& fields,
+                                     PanelLayout layout = PanelLayout::TimeMajor, PanelArena* arena = nullptr,
+                                     size_t origin = 0) {
+    using namespace expr_detail;
+
+    // 形状取自计划用到的字段，全部字段必须一致
+    size_t S = 0, T = 0;
+    bool have_shape = false;
+    for (const string& name : plan.fields) {
+        auto it = fields.find(name);
+        if (it == fields.end() || !it->second)
+            throw std::invalid_argument("evaluate: missing input field '" + name + "'");
+        const Panel<float>& p = *it->second;
+        if (!have_shape) {
+            S = p.stocks();
+            T = p.dates();
+            have_shape = true;
+        } else if (p.stocks() != S || p.dates() != T) {
+            throw std::invalid_argument("evaluate: field '" + name + "' has a different shape");
+        }
+    }
+
+    // 给定 arena 时中间结果取自 arena，返回时整帧回卷；根节点的结果要交给调用方，仍在堆上分配。
+    // 帧在 owned / pool 之前构造，因而在它们析构之后才回卷
+    ArenaFrame frame(arena);
+    vector<uint8_t> is_root(g.size(), 0);
+    for (NodeId r : plan.roots) is_root[r] = 1;
+
+    vector<const Panel<float>*> value(g.size(), nullptr);  // 非常数节点的结果
+    vector<Panel<float>> owned(g.size());                  // 由求值器持有的结果
+    vector<uint32_t> remaining = plan.uses;
+    vector<Panel<float>> pool;                             // 给定 arena 时只含 arena 面板
+
+    auto acquire = [&](NodeId id) -> Panel<float>& {
+        bool heap = arena && is_root[id];
+        if (!pool.empty() && !heap) {
+            owned[id] = std::move(pool.back());
+            pool.pop_back();
+        } else if (arena && !heap) {
+            owned[id] = Panel<float>::in_arena(*arena, S, T, layout);
+        } else {
+            owned[id] = Panel<float>(S, T, layout);
+        }
+        value[id] = &owned[id];
+        return owned[id];
+    };
+
+    // 已缓存的 adv{d}：ts_mean(volume, d) 节点直接取对应字段
+    auto cached_adv = [&](const ExprNode& n) -> const Panel<float>* {
+        if (n.op != OpCode::TsMean) return nullptr;
+        const ExprNode& x = g.node(n.args[0]);
+        if (x.op != OpCode::Field || x.field != "volume") return nullptr;
+        auto it = fields.find(adv_field(n.window));
+        if (it == fields.end() || !it->second) return nullptr;
+        if (it->second->stocks() != S || it->second->dates() != T)
+            throw std::invalid_argument("evaluate: field '" + it->first + "' has a different shape");
+        return it->second;
+    };
+
+    // 分类字段的分组在第一次使用时构建，同一分类上的全部 IndNeutralize 共用
+    unordered_map<NodeId, GroupPartition> partitions;
+
+    auto release = [&](NodeId id) {
+        if (--remaining[id] > 0 || owned[id].empty()) return;
+        pool.push_back(std::move(owned[id]));
+        owned[id] = Panel<float>();
+        value[id] = nullptr;
+    };
+
+    // 时序/截面算子需要面板输入：常数在此按需填充
+    auto as_panel = [&](NodeId id) -> const Panel<float>& {
+        if (!value[id]) std::fill_n(acquire(id).data(), S * T, g.node(id).value);
+        return *value[id];
+    };
+
+    for (NodeId id : plan.order) {
+        const ExprNode& n = g.node(id);
+        const OpInfo& info = op_info(n.op);
+        NodeId a = n.args[0], b = n.args[1], c = n.args[2];
+
+        switch (info.kind) {
+            case OpKind::Leaf:
+                if (n.op == OpCode::Field) {
+                    const Panel<float>& src = *fields.at(n.field);
+                    if (src.layout() == layout) {
+                        value[id] = &src;
+                    } else {
+                        copy_to_layout(src, acquire(id));
+                    }
+                }
+                continue;  // 叶子没有子节点需要释放
+
+            case OpKind::Elementwise: {
+                // 先取出操作数指针，再分配输出（acquire 不会使已有结果失效）
+                const Panel<float>* pa = value[a];
+                const Panel<float>* pb = info.arity > 1 ? value[b] : nullptr;
+                const Panel<float>* pc = info.arity > 2 ? value[c] : nullptr;
+                float ca = g.node(a).value;
+                float cb = info.arity > 1 ? g.node(b).value : 0.0f;
+                float cc = info.arity > 2 ? g.node(c).value : 0.0f;
+                float* y = acquire(id).data();
+                size_t N = S * T;
+                if (info.arity == 1) {
+                    visit_unary(n.op, [&](auto f) {
+                        visit_operand(pa, ca, [&](auto x) {
+                            for (size_t i = 0; i < N; ++i) y[i] = f(x[i]);
+                        });
+                    });
+                } else if (info.arity == 2) {
+                    visit_binary(n.op, [&](auto f) {
+                        visit_operand(pa, ca, [&](auto x) {
+                            visit_operand(pb, cb, [&](auto z) {
+                                for (size_t i = 0; i < N; ++i) y[i] = f(x[i], z[i]);
+                            });
+                        });
+                    });
+                } else {
+                    visit_operand(pa, ca, [&](auto cond) {
+                        visit_operand(pb, cb, [&](auto x) {
+                            visit_operand(pc, cc, [&](auto z) {
+                                for (size_t i = 0; i < N; ++i) y[i] = expr_where(cond[i], x[i], z[i]);
+                            });
+                        });
+                    });
+                }
+                break;
+            }
+
+            case OpKind::TimeSeries: {
+                const Panel<float>& x = as_panel(a);
+                if (info.arity == 2) {
+                    const Panel<float>& z = as_panel(b);
+                    Panel<float>& out = acquire(id);
+                    if (n.op == OpCode::Correlation) rolling_correlation(x, z, n.window, out, origin);
+                    else rolling_covariance(x, z, n.window, out, origin);
+                    break;
+                }
+                if (const Panel<float>* adv = cached_adv(n)) {
+                    if (adv->layout() == layout) value[id] = adv;
+                    else copy_to_layout(*adv, acquire(id));
+                    break;
+                }
+                Panel<float>& out = acquire(id);
+                switch (n.op) {
+                    case OpCode::TsSum: rolling_ts_sum(x, n.window, out, origin); break;
+                    case OpCode::TsMean: rolling_sma(x, n.window, out, origin); break;
+                    case OpCode::TsStddev: rolling_stddev(x, n.window, out, origin); break;
+                    case OpCode::TsRank: ts_rank(x, n.window, out); break;
+                    case OpCode::TsProduct: product(x, n.window, out); break;
+                    case OpCode::TsMin: ts_min(x, n.window, out); break;
+                    case OpCode::TsMax: ts_max(x, n.window, out); break;
+                    case OpCode::TsArgmax: ts_argmax(x, n.window, out); break;
+                    case OpCode::TsArgmin: ts_argmin(x, n.window, out); break;
+                    case OpCode::Delta: delta(x, n.window, out); break;
+                    case OpCode::Delay: delay(x, n.window, out); break;
+                    case OpCode::DecayLinear: decay_linear(x, n.window, out, origin); break;
+                    default: throw std::logic_error(string("evaluate: unhandled op ") + info.name);
+                }
+                break;
+            }
+
+            case OpKind::CrossSection: {
+                const Panel<float>& x = as_panel(a);
+                if (n.op == OpCode::IndNeutralize) {
+                    auto [it, fresh] = partitions.try_emplace(b);
+                    if (fresh) it->second.build(as_panel(b));
+                    group_demean(x, it->second, acquire(id));
+                    break;
+                }
+                Panel<float>& out = acquire(id);
+                if (n.op == OpCode::Rank) alpha_rank(x, out);
+                else scale(x, n.value, out);
+                break;
+            }
+        }
+
+        for (uint8_t i = 0; i < info.arity; ++i) release(n.args[i]);
+    }
+
+    // 根节点：自有结果直接移出；字段或常数根复制一份
+    vector<Panel<float>> results;
+    results.reserve(plan.roots.size());
+    for (NodeId r : plan.roots) {
+        if (!value[r]) {
+            results.emplace_back(S, T, layout, g.node(r).value);
+        } else if (owned[r].empty() || --remaining[r] > 0) {
+            results.push_back(*value[r]);
+        } else {
+            results.push_back(std::move(owned[r]));
+            owned[r] = Panel<float>();
+        }
+    }
+    return results;
+}
+
+// ====== 派生输入字段 ======
+
+// 计划中出现的全部 adv 窗口：ts_mean(volume, d) 的 d，升序去重
+inline vector<int> plan_adv_windows(const ExprGraph& g, const ExprPlan& plan) {
+    vector<int> windows;
+    for (NodeId id : plan.order) {
+        const ExprNode& n = g.node(id);
+        if (n.op == OpCode::TsMean && g.node(n.args[0]).op == OpCode::Field && g.node(n.args[0]).field == "volume")
+            windows.push_back(n.window);
+    }
+    sort(windows.begin(), windows.end());
+    windows.erase(unique(windows.begin(), windows.end()), windows.end());
+    return windows;
+}
+
+/**
+ * @brief 导入阶段：由原始 OHLCV 面板派生 returns / vwap / adv{d}，并与原始字段一起缓存
+ *
+ * returns 与 vwap 由 derive_vwap_returns 一次遍历得到（有 amount 字段时 vwap = amount / volume，
+ * 否则为典型价）；adv{d} 由 rolling_sma 求出，与求值器中 ts_mean(volume, d) 逐位一致。
+ * 原始输入中已有的字段不会被覆盖。fields() 交给 evaluate / AlphaBatch 后，公式里的
+ * ts_mean(volume, d) 直接读取缓存，多次求值只派生一次。
+ *
+ * 用法：
+ *   AlphaBatch batch(alpha101_ids());
+ *   AlphaInputs in({{"open", &open}, {"high", &high}, {"low", &low}, {"close", &close}, {"volume", &volume}});
+ *   in.derive(batch.adv_windows());
+ *   auto out = batch.evaluate(in.fields());
+ *
+ * 原始面板由调用方持有，生命周期须覆盖 AlphaInputs。
+ */
+class AlphaInputs {
+   public:
+    explicit AlphaInputs(FieldMap raw) : raw_(std::move(raw)) {}
+
+    void derive(span<const int> adv_windows = {}) {
+        bool need_returns = !has("returns"), need_vwap = !has("vwap");
+        if (need_vwap) {
+            Panel<float> vwap, returns;
+            derive_vwap_returns(at("high"), at("low"), at("close"), at("volume"),
+                                has("amount") ? &at("amount") : nullptr, vwap, returns);
+            derived_["vwap"] = std::move(vwap);
+            if (need_returns) derived_["returns"] = std::move(returns);
+        } else if (need_returns) {
+            derive_returns(at("close"), derived_["returns"]);
+        }
+
+        for (int d : adv_windows)
+            if (!has(adv_field(d))) rolling_sma(at("volume"), d, derived_[adv_field(d)]);
+    }
+
+    void derive(const vector<int>& adv_windows) { derive(span<const int>(adv_windows)); }
+
+    bool has(const string& name) const { return raw_.count(name) || derived_.count(name); }
+
+    const Panel<float>& at(const string& name) const {
+        auto it = derived_.find(name);
+        if (it != derived_.end()) return it->second;
+        auto r = raw_.find(name);
+        if (r == raw_.end() || !r->second) throw std::invalid_argument("AlphaInputs: missing field '" + name + "'");
+        return *r->second;
+    }
+
+    // 原始字段与派生字段（同名时以原始字段为准）
+    FieldMap fields() const {
+        FieldMap all = raw_;
+        for (const auto& [name, p] : derived_) all.try_emplace(name, &p);
+        return all;
+    }
+
+    size_t derived_count() const { return derived_.size(); }
+
+   private:
+    FieldMap raw_;
+    unordered_map<string, Panel<float>> derived_;
+};
+
+// ====== 101 Formulaic Alphas 公式注册表 ======
+
+/**
+ * @brief 公式中可用的输入字段
+ *
+ * adv(d) 为 d 日平均成交量 ts_mean(volume, d)，同一 d 在图中只有一个节点；输入含 adv{d} 字段时直接读取。
+ * vwap / returns / cap 作为输入字段提供，其中 vwap / returns / adv{d} 可由 AlphaInputs 从 OHLCV 派生。
+ * sector / industry / subindustry 为 IndClass.* 分类字段，取值为每只股票每个日期的整数分类编码
+ * （负数或 NaN 表示未分类），只作为 ind_neutralize 的第二个参数。
+ */
+struct AlphaFields {
+    explicit AlphaFields(ExprGraph& g)
+        : open{&g, g.field("open")},
+          high{&g, g.field("high")},
+          low{&g, g.field("low")},
+          close{&g, g.field("close")},
+          volume{&g, g.field("volume")},
+          vwap{&g, g.field("vwap")},
+          returns{&g, g.field("returns")},
+          cap{&g, g.field("cap")},
+          sector{&g, g.field("sector")},
+          industry{&g, g.field("industry")},
+          subindustry{&g, g.field("subindustry")} {}
+
+    Expr adv(double d) const { return ts_mean(volume, d); }
+
+    Expr open, high, low, close, volume, vwap, returns, cap;
+    Expr sector, industry, subindustry;
+};
+
+/**
+ * @brief 一个 alpha 的注册项：编号、论文原式、以及在图中构造该公式的函数
+ *
+ * 构造函数与原式逐项对应；IndNeutralize 类 alpha 另需 sector / industry / subindustry 分类字段。
+ */
+struct AlphaFormula {
+    int id;
+    const char* formula;
+    Expr (*build)(const AlphaFields&);
+};
+
+// clang-format off
+inline const vector<AlphaFormula>& alpha101_formulas() {
+    static const vector<AlphaFormula> formulas = {
+        {1, "(rank(Ts_ArgMax(SignedPower(((returns < 0) ? stddev(returns, 20) : close), 2.), 5)) -0.5)",
+         [](const AlphaFields& f) {
+             return alpha_rank(ts_argmax(signed_power(where(f.returns < 0, stddev(f.returns, 20), f.close), 2.), 5)) - 0.5;
+         }},
+        {2, "(-1 * correlation(rank(delta(log(volume), 2)), rank(((close - open) / open)), 6))",
+         [](const AlphaFields& f) {
+             return -1 * correlation(alpha_rank(delta(log(f.volume), 2)), alpha_rank(((f.close - f.open) / f.open)), 6);
+         }},
+        {3, "(-1 * correlation(rank(open), rank(volume), 10))",
+         [](const AlphaFields& f) { return -1 * correlation(alpha_rank(f.open), alpha_rank(f.volume), 10); }},
+        {4, "(-1 * Ts_Rank(rank(low), 9))",
+         [](const AlphaFields& f) { return -1 * ts_rank(alpha_rank(f.low), 9); }},
+        {5, "(rank((open - (sum(vwap, 10) / 10))) * (-1 * abs(rank((close - vwap)))))",
+         [](const AlphaFields& f) {
+             return alpha_rank((f.open - (ts_sum(f.vwap, 10) / 10))) * (-1 * abs(alpha_rank((f.close - f.vwap))));
+         }},
+        {6, "(-1 * correlation(open, volume, 10))",
+         [](const AlphaFields& f) { return -1 * correlation(f.open, f.volume, 10); }},
+        {7, "((adv20 < volume) ? ((-1 * ts_rank(abs(delta(close, 7)), 60)) * sign(delta(close, 7))) : (-1* 1))",
+         [](const AlphaFields& f) {
+             return where(f.adv(20) < f.volume,
+                          (-1 * ts_rank(abs(delta(f.close, 7)), 60)) * sign(delta(f.close, 7)), (-1 * 1));
+         }},
+        {8, "(-1 * rank(((sum(open, 5) * sum(returns, 5)) - delay((sum(open, 5) * sum(returns, 5)),10))))",
+         [](const AlphaFields& f) {
+             return -1 * alpha_rank(((ts_sum(f.open, 5) * ts_sum(f.returns, 5)) -
+                                     delay((ts_sum(f.open, 5) * ts_sum(f.returns, 5)), 10)));
+         }},
+        {9, "((0 < ts_min(delta(close, 1), 5)) ? delta(close, 1) : ((ts_max(delta(close, 1), 5) < 0) ?delta(close, 1) : (-1 * delta(close, 1))))",
+         [](const AlphaFields& f) {
+             return where((0 < ts_min(delta(f.close, 1), 5)), delta(f.close, 1),
+                          where((ts_max(delta(f.close, 1), 5) < 0), delta(f.close, 1), (-1 * delta(f.close, 1))));
+         }},
+        {10, "rank(((0 < ts_min(delta(close, 1), 4)) ? delta(close, 1) : ((ts_max(delta(close, 1), 4) < 0)? delta(close, 1) : (-1 * delta(close, 1)))))",
+         [](const AlphaFields& f) {
+             return alpha_rank(where((0 < ts_min(delta(f.close, 1), 4)), delta(f.close, 1),
+                                     where((ts_max(delta(f.close, 1), 4) < 0), delta(f.close, 1), (-1 * delta(f.close, 1)))));
+         }},
+        {11, "((rank(ts_max((vwap - close), 3)) + rank(ts_min((vwap - close), 3))) *rank(delta(volume, 3)))",
+         [](const AlphaFields& f) {
+             return (alpha_rank(ts_max((f.vwap - f.close), 3)) + alpha_rank(ts_min((f.vwap - f.close), 3))) *
+                    alpha_rank(delta(f.volume, 3));
+         }},
+        {12, "(sign(delta(volume, 1)) * (-1 * delta(close, 1)))",
+         [](const AlphaFields& f) { return sign(delta(f.volume, 1)) * (-1 * delta(f.close, 1)); }},
+        {13, "(-1 * rank(covariance(rank(close), rank(volume), 5)))",
+         [](const AlphaFields& f) { return -1 * alpha_rank(covariance(alpha_rank(f.close), alpha_rank(f.volume), 5)); }},
+        {14, "((-1 * rank(delta(returns, 3))) * correlation(open, volume, 10))",
+         [](const AlphaFields& f) { return (-1 * alpha_rank(delta(f.returns, 3))) * correlation(f.open, f.volume, 10); }},
+        {15, "(-1 * sum(rank(correlation(rank(high), rank(volume), 3)), 3))",
+         [](const AlphaFields& f) {
+             return -1 * ts_sum(alpha_rank(correlation(alpha_rank(f.high), alpha_rank(f.volume), 3)), 3);
+         }},
+        {16, "(-1 * rank(covariance(rank(high), rank(volume), 5)))",
+         [](const AlphaFields& f) { return -1 * alpha_rank(covariance(alpha_rank(f.high), alpha_rank(f.volume), 5)); }},
+        {17, "(((-1 * rank(ts_rank(close, 10))) * rank(delta(delta(close, 1), 1))) *rank(ts_rank((volume / adv20), 5)))",
+         [](const AlphaFields& f) {
+             return ((-1 * alpha_rank(ts_rank(f.close, 10))) * alpha_rank(delta(delta(f.close, 1), 1))) *
+                    alpha_rank(ts_rank((f.volume / f.adv(20)), 5));
+         }},
+        {18, "(-1 * rank(((stddev(abs((close - open)), 5) + (close - open)) + correlation(close, open,10))))",
+         [](const AlphaFields& f) {
+             return -1 * alpha_rank(((stddev(abs((f.close - f.open)), 5) + (f.close - f.open)) +
+                                     correlation(f.close, f.open, 10)));
+         }},
+        {19, "((-1 * sign(((close - delay(close, 7)) + delta(close, 7)))) * (1 + rank((1 + sum(returns,250)))))",
+         [](const AlphaFields& f) {
+             return (-1 * sign(((f.close - delay(f.close, 7)) + delta(f.close, 7)))) *
+                    (1 + alpha_rank((1 + ts_sum(f.returns, 250))));
+         }},
+        {20, "(((-1 * rank((open - delay(high, 1)))) * rank((open - delay(close, 1)))) * rank((open -delay(low, 1))))",
+         [](const AlphaFields& f) {
+             return ((-1 * alpha_rank((f.open - delay(f.high, 1)))) * alpha_rank((f.open - delay(f.close, 1)))) *
+                    alpha_rank((f.open - delay(f.low, 1)));
+         }},
+        {21, "((((sum(close, 8) / 8) + stddev(close, 8)) < (sum(close, 2) / 2)) ? (-1 * 1) : (((sum(close,2) / 2) < ((sum(close, 8) / 8) - stddev(close, 8))) ? 1 : (((1 < (volume / adv20)) || ((volume /adv20) == 1)) ? 1 : (-1 * 1))))",
+         [](const AlphaFields& f) {
+             return where((((ts_sum(f.close, 8) / 8) + stddev(f.close, 8)) < (ts_sum(f.close, 2) / 2)), (-1 * 1),
+                          where(((ts_sum(f.close, 2) / 2) < ((ts_sum(f.close, 8) / 8) - stddev(f.close, 8))), 1,
+                                where(((1 < (f.volume / f.adv(20))) || eq((f.volume / f.adv(20)), 1)), 1, (-1 * 1))));
+         }},
+        {22, "(-1 * (delta(correlation(high, volume, 5), 5) * rank(stddev(close, 20))))",
+         [](const AlphaFields& f) {
+             return -1 * (delta(correlation(f.high, f.volume, 5), 5) * alpha_rank(stddev(f.close, 20)));
+         }},
+        {23, "(((sum(high, 20) / 20) < high) ? (-1 * delta(high, 2)) : 0)",
+         [](const AlphaFields& f) { return where(((ts_sum(f.high, 20) / 20) < f.high), (-1 * delta(f.high, 2)), 0); }},
+        {24, "((((delta((sum(close, 100) / 100), 100) / delay(close, 100)) < 0.05) ||((delta((sum(close, 100) / 100), 100) / delay(close, 100)) == 0.05)) ? (-1 * (close - ts_min(close,100))) : (-1 * delta(close, 3)))",
+         [](const AlphaFields& f) {
+             Expr c = delta((ts_sum(f.close, 100) / 100), 100) / delay(f.close, 100);
+             return where(((c < 0.05) || eq(c, 0.05)), (-1 * (f.close - ts_min(f.close, 100))), (-1 * delta(f.close, 3)));
+         }},
+        {25, "rank(((((-1 * returns) * adv20) * vwap) * (high - close)))",
+         [](const AlphaFields& f) {
+             return alpha_rank(((((-1 * f.returns) * f.adv(20)) * f.vwap) * (f.high - f.close)));
+         }},
+        {26, "(-1 * ts_max(correlation(ts_rank(volume, 5), ts_rank(high, 5), 5), 3))",
+         [](const AlphaFields& f) { return -1 * ts_max(correlation(ts_rank(f.volume, 5), ts_rank(f.high, 5), 5), 3); }},
+        {27, "((0.5 < rank((sum(correlation(rank(volume), rank(vwap), 6), 2) / 2.0))) ? (-1 * 1) : 1)",
+         [](const AlphaFields& f) {
+             return where((0.5 < alpha_rank((ts_sum(correlation(alpha_rank(f.volume), alpha_rank(f.vwap), 6), 2) / 2.0))),
+                          (-1 * 1), 1);
+         }},
+        {28, "scale(((correlation(adv20, low, 5) + ((high + low) / 2)) - close))",
+         [](const AlphaFields& f) { return scale(((correlation(f.adv(20), f.low, 5) + ((f.high + f.low) / 2)) - f.close)); }},
+        {29, "(min(product(rank(rank(scale(log(sum(ts_min(rank(rank((-1 * rank(delta((close - 1),5))))), 2), 1))))), 1), 5) + ts_rank(delay((-1 * returns), 6), 5))",
+         [](const AlphaFields& f) {
+             return ts_min(product(alpha_rank(alpha_rank(scale(log(ts_sum(
+                               ts_min(alpha_rank(alpha_rank((-1 * alpha_rank(delta((f.close - 1), 5))))), 2), 1))))), 1), 5) +
+                    ts_rank(delay((-1 * f.returns), 6), 5);
+         }},
+        {30, "(((1.0 - rank(((sign((close - delay(close, 1))) + sign((delay(close, 1) - delay(close, 2)))) +sign((delay(close, 2) - delay(close, 3)))))) * sum(volume, 5)) / sum(volume, 20))",
+         [](const AlphaFields& f) {
+             return ((1.0 - alpha_rank(((sign((f.close - delay(f.close, 1))) + sign((delay(f.close, 1) - delay(f.close, 2)))) +
+                                        sign((delay(f.close, 2) - delay(f.close, 3)))))) * ts_sum(f.volume, 5)) /
+                    ts_sum(f.volume, 20);
+         }},
+        {31, "((rank(rank(rank(decay_linear((-1 * rank(rank(delta(close, 10)))), 10)))) + rank((-1 *delta(close, 3)))) + sign(scale(correlation(adv20, low, 12))))",
+         [](const AlphaFields& f) {
+             return (alpha_rank(alpha_rank(alpha_rank(decay_linear((-1 * alpha_rank(alpha_rank(delta(f.close, 10)))), 10)))) +
+                     alpha_rank((-1 * delta(f.close, 3)))) + sign(scale(correlation(f.adv(20), f.low, 12)));
+         }},
+        {32, "(scale(((sum(close, 7) / 7) - close)) + (20 * scale(correlation(vwap, delay(close, 5),230))))",
+         [](const AlphaFields& f) {
+             return scale(((ts_sum(f.close, 7) / 7) - f.close)) + (20 * scale(correlation(f.vwap, delay(f.close, 5), 230)));
+         }},
+        {33, "rank((-1 * ((1 - (open / close))^1)))",
+         [](const AlphaFields& f) { return alpha_rank((-1 * power((1 - (f.open / f.close)), 1))); }},
+        {34, "rank(((1 - rank((stddev(returns, 2) / stddev(returns, 5)))) + (1 - rank(delta(close, 1)))))",
+         [](const AlphaFields& f) {
+             return alpha_rank(((1 - alpha_rank((stddev(f.returns, 2) / stddev(f.returns, 5)))) +
+                                (1 - alpha_rank(delta(f.close, 1)))));
+         }},
+        {35, "((Ts_Rank(volume, 32) * (1 - Ts_Rank(((close + high) - low), 16))) * (1 -Ts_Rank(returns, 32)))",
+         [](const AlphaFields& f) {
+             return (ts_rank(f.volume, 32) * (1 - ts_rank(((f.close + f.high) - f.low), 16))) * (1 - ts_rank(f.returns, 32));
+         }},
+        {36, "(((((2.21 * rank(correlation((close - open), delay(volume, 1), 15))) + (0.7 * rank((open- close)))) + (0.73 * rank(Ts_Rank(delay((-1 * returns), 6), 5)))) + rank(abs(correlation(vwap,adv20, 6)))) + (0.6 * rank((((sum(close, 200) / 200) - open) * (close - open)))))",
+         [](const AlphaFields& f) {
+             return ((((2.21 * alpha_rank(correlation((f.close - f.open), delay(f.volume, 1), 15))) +
+                       (0.7 * alpha_rank((f.open - f.close)))) +
+                      (0.73 * alpha_rank(ts_rank(delay((-1 * f.returns), 6), 5)))) +
+                     alpha_rank(abs(correlation(f.vwap, f.adv(20), 6)))) +
+                    (0.6 * alpha_rank((((ts_sum(f.close, 200) / 200) - f.open) * (f.close - f.open))));
+         }},
+        {37, "(rank(correlation(delay((open - close), 1), close, 200)) + rank((open - close)))",
+         [](const AlphaFields& f) {
+             return alpha_rank(correlation(delay((f.open - f.close), 1), f.close, 200)) + alpha_rank((f.open - f.close));
+         }},
+        {38, "((-1 * rank(Ts_Rank(close, 10))) * rank((close / open)))",
+         [](const AlphaFields& f) { return (-1 * alpha_rank(ts_rank(f.close, 10))) * alpha_rank((f.close / f.open)); }},
+        {39, "((-1 * rank((delta(close, 7) * (1 - rank(decay_linear((volume / adv20), 9)))))) * (1 +rank(sum(returns, 250))))",
+         [](const AlphaFields& f) {
+             return (-1 * alpha_rank((delta(f.close, 7) * (1 - alpha_rank(decay_linear((f.volume / f.adv(20)), 9)))))) *
+                    (1 + alpha_rank(ts_sum(f.returns, 250)));
+         }},
+        {40, "((-1 * rank(stddev(high, 10))) * correlation(high, volume, 10))",
+         [](const AlphaFields& f) { return (-1 * alpha_rank(stddev(f.high, 10))) * correlation(f.high, f.volume, 10); }},
+        {41, "(((high * low)^0.5) - vwap)",
+         [](const AlphaFields& f) { return power((f.high * f.low), 0.5) - f.vwap; }},
+        {42, "(rank((vwap - close)) / rank((vwap + close)))",
+         [](const AlphaFields& f) { return alpha_rank((f.vwap - f.close)) / alpha_rank((f.vwap + f.close)); }},
+        {43, "(ts_rank((volume / adv20), 20) * ts_rank((-1 * delta(close, 7)), 8))",
+         [](const AlphaFields& f) { return ts_rank((f.volume / f.adv(20)), 20) * ts_rank((-1 * delta(f.close, 7)), 8); }},
+        {44, "(-1 * correlation(high, rank(volume), 5))",
+         [](const AlphaFields& f) { return -1 * correlation(f.high, alpha_rank(f.volume), 5); }},
+        {45, "(-1 * ((rank((sum(delay(close, 5), 20) / 20)) * correlation(close, volume, 2)) *rank(correlation(sum(close, 5), sum(close, 20), 2))))",
+         [](const AlphaFields& f) {
+             return -1 * ((alpha_rank((ts_sum(delay(f.close, 5), 20) / 20)) * correlation(f.close, f.volume, 2)) *
+                          alpha_rank(correlation(ts_sum(f.close, 5), ts_sum(f.close, 20), 2)));
+         }},
+        {46, "((0.25 < (((delay(close, 20) - delay(close, 10)) / 10) - ((delay(close, 10) - close) / 10))) ?(-1 * 1) : (((((delay(close, 20) - delay(close, 10)) / 10) - ((delay(close, 10) - close) / 10)) < 0) ? 1 :((-1 * 1) * (close - delay(close, 1)))))",
+         [](const AlphaFields& f) {
+             Expr inner = ((delay(f.close, 20) - delay(f.close, 10)) / 10) - ((delay(f.close, 10) - f.close) / 10);
+             return where((0.25 < inner), (-1 * 1), where((inner < 0), 1, ((-1 * 1) * (f.close - delay(f.close, 1)))));
+         }},
+        {47, "((((rank((1 / close)) * volume) / adv20) * ((high * rank((high - close))) / (sum(high, 5) /5))) - rank((vwap - delay(vwap, 5))))",
+         [](const AlphaFields& f) {
+             return (((alpha_rank((1 / f.close)) * f.volume) / f.adv(20)) *
+                     ((f.high * alpha_rank((f.high - f.close))) / (ts_sum(f.high, 5) / 5))) -
+                    alpha_rank((f.vwap - delay(f.vwap, 5)));
+         }},
+        {48, "(IndNeutralize(((correlation(delta(close, 1), delta(delay(close, 1), 1), 250) *delta(close, 1)) / close), IndClass.subindustry) / sum(((delta(close, 1) / delay(close, 1))^2), 250))",
+         [](const AlphaFields& f) {
+             return ind_neutralize(((correlation(delta(f.close, 1), delta(delay(f.close, 1), 1), 250) * delta(f.close, 1)) /
+                                    f.close), f.subindustry) /
+                    ts_sum(power((delta(f.close, 1) / delay(f.close, 1)), 2), 250);
+         }},
+        {49, "(((((delay(close, 20) - delay(close, 10)) / 10) - ((delay(close, 10) - close) / 10)) < (-1 *0.1)) ? 1 : ((-1 * 1) * (close - delay(close, 1))))",
+         [](const AlphaFields& f) {
+             Expr inner = ((delay(f.close, 20) - delay(f.close, 10)) / 10) - ((delay(f.close, 10) - f.close) / 10);
+             return where((inner < (-1 * 0.1)), 1, ((-1 * 1) * (f.close - delay(f.close, 1))));
+         }},
+        {50, "(-1 * ts_max(rank(correlation(rank(volume), rank(vwap), 5)), 5))",
+         [](const AlphaFields& f) {
+             return -1 * ts_max(alpha_rank(correlation(alpha_rank(f.volume), alpha_rank(f.vwap), 5)), 5);
+         }},
+        {51, "(((((delay(close, 20) - delay(close, 10)) / 10) - ((delay(close, 10) - close) / 10)) < (-1 *0.05)) ? 1 : ((-1 * 1) * (close - delay(close, 1))))",
+         [](const AlphaFields& f) {
+             Expr inner = ((delay(f.close, 20) - delay(f.close, 10)) / 10) - ((delay(f.close, 10) - f.close) / 10);
+             return where((inner < (-1 * 0.05)), 1, ((-1 * 1) * (f.close - delay(f.close, 1))));
+         }},
+        {52, "((((-1 * ts_min(low, 5)) + delay(ts_min(low, 5), 5)) * rank(((sum(returns, 240) -sum(returns, 20)) / 220))) * ts_rank(volume, 5))",
+         [](const AlphaFields& f) {
+             return (((-1 * ts_min(f.low, 5)) + delay(ts_min(f.low, 5), 5)) *
+                     alpha_rank(((ts_sum(f.returns, 240) - ts_sum(f.returns, 20)) / 220))) *
+                    ts_rank(f.volume, 5);
+         }},
+        {53, "(-1 * delta((((close - low) - (high - close)) / (close - low)), 9))",
+         [](const AlphaFields& f) {
+             return -1 * delta((((f.close - f.low) - (f.high - f.close)) / (f.close - f.low)), 9);
+         }},
+        {54, "((-1 * ((low - close) * (open^5))) / ((low - high) * (close^5)))",
+         [](const AlphaFields& f) {
+             return (-1 * ((f.low - f.close) * power(f.open, 5))) / ((f.low - f.high) * power(f.close, 5));
+         }},
+        {55, "(-1 * correlation(rank(((close - ts_min(low, 12)) / (ts_max(high, 12) - ts_min(low,12)))), rank(volume), 6))",
+         [](const AlphaFields& f) {
+             return -1 * correlation(alpha_rank(((f.close - ts_min(f.low, 12)) / (ts_max(f.high, 12) - ts_min(f.low, 12)))),
+                                     alpha_rank(f.volume), 6);
+         }},
+        {56, "(0 - (1 * (rank((sum(returns, 10) / sum(sum(returns, 2), 3))) * rank((returns * cap)))))",
+         [](const AlphaFields& f) {
+             return 0 - (1 * (alpha_rank((ts_sum(f.returns, 10) / ts_sum(ts_sum(f.returns, 2), 3))) *
+                              alpha_rank((f.returns * f.cap))));
+         }},
+        {57, "(0 - (1 * ((close - vwap) / decay_linear(rank(ts_argmax(close, 30)), 2))))",
+         [](const AlphaFields& f) {
+             return 0 - (1 * ((f.close - f.vwap) / decay_linear(alpha_rank(ts_argmax(f.close, 30)), 2)));
+         }},
+        {58, "(-1 * Ts_Rank(decay_linear(correlation(IndNeutralize(vwap, IndClass.sector), volume, 3.92795), 7.89291), 5.50322))",
+         [](const AlphaFields& f) {
+             return -1 * ts_rank(decay_linear(correlation(ind_neutralize(f.vwap, f.sector), f.volume, 3.92795), 7.89291), 5.50322);
+         }},
+        {59, "(-1 * Ts_Rank(decay_linear(correlation(IndNeutralize(((vwap * 0.728317) + (vwap *(1 - 0.728317))), IndClass.industry), volume, 4.25197), 16.2289), 8.19648))",
+         [](const AlphaFields& f) {
+             return -1 * ts_rank(decay_linear(correlation(ind_neutralize(((f.vwap * 0.728317) + (f.vwap * (1 - 0.728317))),
+                                                                         f.industry), f.volume, 4.25197), 16.2289), 8.19648);
+         }},
+        {60, "(0 - (1 * ((2 * scale(rank(((((close - low) - (high - close)) / (high - low)) * volume)))) -scale(rank(ts_argmax(close, 10))))))",
+         [](const AlphaFields& f) {
+             return 0 - (1 * ((2 * scale(alpha_rank(((((f.close - f.low) - (f.high - f.close)) / (f.high - f.low)) * f.volume)))) -
+                              scale(alpha_rank(ts_argmax(f.close, 10)))));
+         }},
+        {61, "(rank((vwap - ts_min(vwap, 16.1219))) < rank(correlation(vwap, adv180, 17.9282)))",
+         [](const AlphaFields& f) {
+             return alpha_rank((f.vwap - ts_min(f.vwap, 16.1219))) < alpha_rank(correlation(f.vwap, f.adv(180), 17.9282));
+         }},
+        {62, "((rank(correlation(vwap, sum(adv20, 22.4101), 9.91009)) < rank(((rank(open) +rank(open)) < (rank(((high + low) / 2)) + rank(high))))) * -1)",
+         [](const AlphaFields& f) {
+             return (alpha_rank(correlation(f.vwap, ts_sum(f.adv(20), 22.4101), 9.91009)) <
+                     alpha_rank(((alpha_rank(f.open) + alpha_rank(f.open)) <
+                                 (alpha_rank(((f.high + f.low) / 2)) + alpha_rank(f.high))))) * -1;
+         }},
+        {63, "((rank(decay_linear(delta(IndNeutralize(close, IndClass.industry), 2.25164), 8.22237))- rank(decay_linear(correlation(((vwap * 0.318108) + (open * (1 - 0.318108))), sum(adv180,37.2467), 13.557), 12.2883))) * -1)",
+         [](const AlphaFields& f) {
+             return (alpha_rank(decay_linear(delta(ind_neutralize(f.close, f.industry), 2.25164), 8.22237)) -
+                     alpha_rank(decay_linear(correlation(((f.vwap * 0.318108) + (f.open * (1 - 0.318108))),
+                                                         ts_sum(f.adv(180), 37.2467), 13.557), 12.2883))) * -1;
+         }},
+        {64, "((rank(correlation(sum(((open * 0.178404) + (low * (1 - 0.178404))), 12.7054),sum(adv120, 12.7054), 16.6208)) < rank(delta(((((high + low) / 2) * 0.178404) + (vwap * (1 -0.178404))), 3.69741))) * -1)",
+         [](const AlphaFields& f) {
+             return (alpha_rank(correlation(ts_sum(((f.open * 0.178404) + (f.low * (1 - 0.178404))), 12.7054),
+                                            ts_sum(f.adv(120), 12.7054), 16.6208)) <
+                     alpha_rank(delta(((((f.high + f.low) / 2) * 0.178404) + (f.vwap * (1 - 0.178404))), 3.69741))) * -1;
+         }},
+        {65, "((rank(correlation(((open * 0.00817205) + (vwap * (1 - 0.00817205))), sum(adv60,8.6911), 6.40374)) < rank((open - ts_min(open, 13.635)))) * -1)",
+         [](const AlphaFields& f) {
+             return (alpha_rank(correlation(((f.open * 0.00817205) + (f.vwap * (1 - 0.00817205))),
+                                            ts_sum(f.adv(60), 8.6911), 6.40374)) <
+                     alpha_rank((f.open - ts_min(f.open, 13.635)))) * -1;
+         }},
+        {66, "((rank(decay_linear(delta(vwap, 3.51013), 7.23052)) + Ts_Rank(decay_linear(((((low* 0.96633) + (low * (1 - 0.96633))) - vwap) / (open - ((high + low) / 2))), 11.4157), 6.72611)) * -1)",
+         [](const AlphaFields& f) {
+             return (alpha_rank(decay_linear(delta(f.vwap, 3.51013), 7.23052)) +
+                     ts_rank(decay_linear(((((f.low * 0.96633) + (f.low * (1 - 0.96633))) - f.vwap) /
+                                           (f.open - ((f.high + f.low) / 2))), 11.4157), 6.72611)) * -1;
+         }},
+        {67, "((rank((high - ts_min(high, 2.14593)))^rank(correlation(IndNeutralize(vwap,IndClass.sector), IndNeutralize(adv20, IndClass.subindustry), 6.02936))) * -1)",
+         [](const AlphaFields& f) {
+             return power(alpha_rank((f.high - ts_min(f.high, 2.14593))),
+                          alpha_rank(correlation(ind_neutralize(f.vwap, f.sector), ind_neutralize(f.adv(20), f.subindustry),
+                                                 6.02936))) * -1;
+         }},
+        {68, "((Ts_Rank(correlation(rank(high), rank(adv15), 8.91644), 13.9333) <rank(delta(((close * 0.518371) + (low * (1 - 0.518371))), 1.06157))) * -1)",
+         [](const AlphaFields& f) {
+             return (ts_rank(correlation(alpha_rank(f.high), alpha_rank(f.adv(15)), 8.91644), 13.9333) <
+                     alpha_rank(delta(((f.close * 0.518371) + (f.low * (1 - 0.518371))), 1.06157))) * -1;
+         }},
+        {69, "((rank(ts_max(delta(IndNeutralize(vwap, IndClass.industry), 2.72412),4.79344))^Ts_Rank(correlation(((close * 0.490655) + (vwap * (1 - 0.490655))), adv20,4.92416), 9.0615)) * -1)",
+         [](const AlphaFields& f) {
+             return power(alpha_rank(ts_max(delta(ind_neutralize(f.vwap, f.industry), 2.72412), 4.79344)),
+                          ts_rank(correlation(((f.close * 0.490655) + (f.vwap * (1 - 0.490655))), f.adv(20), 4.92416),
+                                  9.0615)) * -1;
+         }},
+        {70, "((rank(delta(vwap, 1.29456))^Ts_Rank(correlation(IndNeutralize(close,IndClass.industry), adv50, 17.8256), 17.9171)) * -1)",
+         [](const AlphaFields& f) {
+             return power(alpha_rank(delta(f.vwap, 1.29456)),
+                          ts_rank(correlation(ind_neutralize(f.close, f.industry), f.adv(50), 17.8256), 17.9171)) * -1;
+         }},
+        {71, "max(Ts_Rank(decay_linear(correlation(Ts_Rank(close, 3.43976), Ts_Rank(adv180,12.0647), 18.0175), 4.20501), 15.6948), Ts_Rank(decay_linear((rank(((low + open) - (vwap +vwap)))^2), 16.4662), 4.4388))",
+         [](const AlphaFields& f) {
+             return max(ts_rank(decay_linear(correlation(ts_rank(f.close, 3.43976), ts_rank(f.adv(180), 12.0647), 18.0175),
+                                             4.20501), 15.6948),
+                        ts_rank(decay_linear(power(alpha_rank(((f.low + f.open) - (f.vwap + f.vwap))), 2), 16.4662), 4.4388));
+         }},
+        {72, "(rank(decay_linear(correlation(((high + low) / 2), adv40, 8.93345), 10.1519)) /rank(decay_linear(correlation(Ts_Rank(vwap, 3.72469), Ts_Rank(volume, 18.5188), 6.86671),2.95011)))",
+         [](const AlphaFields& f) {
+             return alpha_rank(decay_linear(correlation(((f.high + f.low) / 2), f.adv(40), 8.93345), 10.1519)) /
+                    alpha_rank(decay_linear(correlation(ts_rank(f.vwap, 3.72469), ts_rank(f.volume, 18.5188), 6.86671),
+                                            2.95011));
+         }},
+        {73, "(max(rank(decay_linear(delta(vwap, 4.72775), 2.91864)),Ts_Rank(decay_linear(((delta(((open * 0.147155) + (low * (1 - 0.147155))), 2.03608) / ((open *0.147155) + (low * (1 - 0.147155)))) * -1), 3.33829), 16.7411)) * -1)",
+         [](const AlphaFields& f) {
+             Expr mix = (f.open * 0.147155) + (f.low * (1 - 0.147155));
+             return max(alpha_rank(decay_linear(delta(f.vwap, 4.72775), 2.91864)),
+                        ts_rank(decay_linear(((delta(mix, 2.03608) / mix) * -1), 3.33829), 16.7411)) * -1;
+         }},
+        {74, "((rank(correlation(close, sum(adv30, 37.4843), 15.1365)) <rank(correlation(rank(((high * 0.0261661) + (vwap * (1 - 0.0261661)))), rank(volume), 11.4791)))* -1)",
+         [](const AlphaFields& f) {
+             return (alpha_rank(correlation(f.close, ts_sum(f.adv(30), 37.4843), 15.1365)) <
+                     alpha_rank(correlation(alpha_rank(((f.high * 0.0261661) + (f.vwap * (1 - 0.0261661)))),
+                                            alpha_rank(f.volume), 11.4791))) * -1;
+         }},
+        {75, "(rank(correlation(vwap, volume, 4.24304)) < rank(correlation(rank(low), rank(adv50),12.4413)))",
+         [](const AlphaFields& f) {
+             return alpha_rank(correlation(f.vwap, f.volume, 4.24304)) <
+                    alpha_rank(correlation(alpha_rank(f.low), alpha_rank(f.adv(50)), 12.4413));
+         }},
+        {76, "(max(rank(decay_linear(delta(vwap, 1.24383), 11.8259)),Ts_Rank(decay_linear(Ts_Rank(correlation(IndNeutralize(low, IndClass.sector), adv81,8.14941), 19.569), 17.1543), 19.383)) * -1)",
+         [](const AlphaFields& f) {
+             return max(alpha_rank(decay_linear(delta(f.vwap, 1.24383), 11.8259)),
+                        ts_rank(decay_linear(ts_rank(correlation(ind_neutralize(f.low, f.sector), f.adv(81), 8.14941), 19.569),
+                                             17.1543), 19.383)) * -1;
+         }},
+        {77, "min(rank(decay_linear(((((high + low) / 2) + high) - (vwap + high)), 20.0451)),rank(decay_linear(correlation(((high + low) / 2), adv40, 3.1614), 5.64125)))",
+         [](const AlphaFields& f) {
+             return min(alpha_rank(decay_linear(((((f.high + f.low) / 2) + f.high) - (f.vwap + f.high)), 20.0451)),
+                        alpha_rank(decay_linear(correlation(((f.high + f.low) / 2), f.adv(40), 3.1614), 5.64125)));
+         }},
+        {78, "(rank(correlation(sum(((low * 0.352233) + (vwap * (1 - 0.352233))), 19.7428),sum(adv40, 19.7428), 6.83313))^rank(correlation(rank(vwap), rank(volume), 5.77492)))",
+         [](const AlphaFields& f) {
+             return power(alpha_rank(correlation(ts_sum(((f.low * 0.352233) + (f.vwap * (1 - 0.352233))), 19.7428),
+                                                 ts_sum(f.adv(40), 19.7428), 6.83313)),
+                          alpha_rank(correlation(alpha_rank(f.vwap), alpha_rank(f.volume), 5.77492)));
+         }},
+        {79, "(rank(delta(IndNeutralize(((close * 0.60733) + (open * (1 - 0.60733))),IndClass.sector), 1.23438)) < rank(correlation(Ts_Rank(vwap, 3.60973), Ts_Rank(adv150,9.18637), 14.6644)))",
+         [](const AlphaFields& f) {
+             return alpha_rank(delta(ind_neutralize(((f.close * 0.60733) + (f.open * (1 - 0.60733))), f.sector), 1.23438)) <
+                    alpha_rank(correlation(ts_rank(f.vwap, 3.60973), ts_rank(f.adv(150), 9.18637), 14.6644));
+         }},
+        {80, "((rank(Sign(delta(IndNeutralize(((open * 0.868128) + (high * (1 - 0.868128))),IndClass.industry), 4.04545)))^Ts_Rank(correlation(high, adv10, 5.11456), 5.53756)) * -1)",
+         [](const AlphaFields& f) {
+             return power(alpha_rank(sign(delta(ind_neutralize(((f.open * 0.868128) + (f.high * (1 - 0.868128))), f.industry),
+                                                4.04545))),
+                          ts_rank(correlation(f.high, f.adv(10), 5.11456), 5.53756)) * -1;
+         }},
+        {81, "((rank(Log(product(rank((rank(correlation(vwap, sum(adv10, 49.6054),8.47743))^4)), 14.9655))) < rank(correlation(rank(vwap), rank(volume), 5.07914))) * -1)",
+         [](const AlphaFields& f) {
+             return (alpha_rank(log(product(alpha_rank(power(alpha_rank(correlation(f.vwap, ts_sum(f.adv(10), 49.6054),
+                                                                                  8.47743)), 4)), 14.9655))) <
+                     alpha_rank(correlation(alpha_rank(f.vwap), alpha_rank(f.volume), 5.07914))) * -1;
+         }},
+        {82, "(min(rank(decay_linear(delta(open, 1.46063), 14.8717)),Ts_Rank(decay_linear(correlation(IndNeutralize(volume, IndClass.sector), ((open * 0.634196) +(open * (1 - 0.634196))), 17.4842), 6.92131), 13.4283)) * -1)",
+         [](const AlphaFields& f) {
+             return min(alpha_rank(decay_linear(delta(f.open, 1.46063), 14.8717)),
+                        ts_rank(decay_linear(correlation(ind_neutralize(f.volume, f.sector),
+                                                         ((f.open * 0.634196) + (f.open * (1 - 0.634196))), 17.4842),
+                                             6.92131), 13.4283)) * -1;
+         }},
+        {83, "((rank(delay(((high - low) / (sum(close, 5) / 5)), 2)) * rank(rank(volume))) / (((high -low) / (sum(close, 5) / 5)) / (vwap - close)))",
+         [](const AlphaFields& f) {
+             return (alpha_rank(delay(((f.high - f.low) / (ts_sum(f.close, 5) / 5)), 2)) * alpha_rank(alpha_rank(f.volume))) /
+                    (((f.high - f.low) / (ts_sum(f.close, 5) / 5)) / (f.vwap - f.close));
+         }},
+        {84, "SignedPower(Ts_Rank((vwap - ts_max(vwap, 15.3217)), 20.7127), delta(close,4.96796))",
+         [](const AlphaFields& f) {
+             return signed_power(ts_rank((f.vwap - ts_max(f.vwap, 15.3217)), 20.7127), delta(f.close, 4.96796));
+         }},
+        {85, "(rank(correlation(((high * 0.876703) + (close * (1 - 0.876703))), adv30,9.61331))^rank(correlation(Ts_Rank(((high + low) / 2), 3.70596), Ts_Rank(volume, 10.1595),7.11408)))",
+         [](const AlphaFields& f) {
+             return power(alpha_rank(correlation(((f.high * 0.876703) + (f.close * (1 - 0.876703))), f.adv(30), 9.61331)),
+                          alpha_rank(correlation(ts_rank(((f.high + f.low) / 2), 3.70596), ts_rank(f.volume, 10.1595),
+                                                 7.11408)));
+         }},
+        {86, "((Ts_Rank(correlation(close, sum(adv20, 14.7444), 6.00049), 20.4195) < rank(((open+ close) - (vwap + open)))) * -1)",
+         [](const AlphaFields& f) {
+             return (ts_rank(correlation(f.close, ts_sum(f.adv(20), 14.7444), 6.00049), 20.4195) <
+                     alpha_rank(((f.open + f.close) - (f.vwap + f.open)))) * -1;
+         }},
+        {87, "(max(rank(decay_linear(delta(((close * 0.369701) + (vwap * (1 - 0.369701))),1.91233), 2.65461)), Ts_Rank(decay_linear(abs(correlation(IndNeutralize(adv81,IndClass.industry), close, 13.4132)), 4.89768), 14.4535)) * -1)",
+         [](const AlphaFields& f) {
+             return max(alpha_rank(decay_linear(delta(((f.close * 0.369701) + (f.vwap * (1 - 0.369701))), 1.91233), 2.65461)),
+                        ts_rank(decay_linear(abs(correlation(ind_neutralize(f.adv(81), f.industry), f.close, 13.4132)),
+                                             4.89768), 14.4535)) * -1;
+         }},
+        {88, "min(rank(decay_linear(((rank(open) + rank(low)) - (rank(high) + rank(close))),8.06882)), Ts_Rank(decay_linear(correlation(Ts_Rank(close, 8.44728), Ts_Rank(adv60,20.6966), 8.01266), 6.65053), 2.61957))",
+         [](const AlphaFields& f) {
+             return min(alpha_rank(decay_linear(((alpha_rank(f.open) + alpha_rank(f.low)) -
+                                                 (alpha_rank(f.high) + alpha_rank(f.close))), 8.06882)),
+                        ts_rank(decay_linear(correlation(ts_rank(f.close, 8.44728), ts_rank(f.adv(60), 20.6966), 8.01266),
+                                             6.65053), 2.61957));
+         }},
+        {89, "(Ts_Rank(decay_linear(correlation(((low * 0.967285) + (low * (1 - 0.967285))), adv10,6.94279), 5.51607), 3.79744) - Ts_Rank(decay_linear(delta(IndNeutralize(vwap,IndClass.industry), 3.48158), 10.1466), 15.3012))",
+         [](const AlphaFields& f) {
+             return ts_rank(decay_linear(correlation(((f.low * 0.967285) + (f.low * (1 - 0.967285))), f.adv(10), 6.94279),
+                                         5.51607), 3.79744) -
+                    ts_rank(decay_linear(delta(ind_neutralize(f.vwap, f.industry), 3.48158), 10.1466), 15.3012);
+         }},
+        {90, "((rank((close - ts_max(close, 4.66719)))^Ts_Rank(correlation(IndNeutralize(adv40,IndClass.subindustry), low, 5.38375), 3.21856)) * -1)",
+         [](const AlphaFields& f) {
+             return power(alpha_rank((f.close - ts_max(f.close, 4.66719))),
+                          ts_rank(correlation(ind_neutralize(f.adv(40), f.subindustry), f.low, 5.38375), 3.21856)) * -1;
+         }},
+        {91, "((Ts_Rank(decay_linear(decay_linear(correlation(IndNeutralize(close,IndClass.industry), volume, 9.74928), 16.398), 3.83219), 4.8667) -rank(decay_linear(correlation(vwap, adv30, 4.01303), 2.6809))) * -1)",
+         [](const AlphaFields& f) {
+             return (ts_rank(decay_linear(decay_linear(correlation(ind_neutralize(f.close, f.industry), f.volume, 9.74928),
+                                                       16.398), 3.83219), 4.8667) -
+                     alpha_rank(decay_linear(correlation(f.vwap, f.adv(30), 4.01303), 2.6809))) * -1;
+         }},
+        {92, "min(Ts_Rank(decay_linear(((((high + low) / 2) + close) < (low + open)), 14.7221),18.8683), Ts_Rank(decay_linear(correlation(rank(low), rank(adv30), 7.58555), 6.94024),6.80584))",
+         [](const AlphaFields& f) {
+             return min(ts_rank(decay_linear(((((f.high + f.low) / 2) + f.close) < (f.low + f.open)), 14.7221), 18.8683),
+                        ts_rank(decay_linear(correlation(alpha_rank(f.low), alpha_rank(f.adv(30)), 7.58555), 6.94024),
+                                6.80584));
+         }},
+        {93, "(Ts_Rank(decay_linear(correlation(IndNeutralize(vwap, IndClass.industry), adv81,17.4193), 19.848), 7.54455) / rank(decay_linear(delta(((close * 0.524434) + (vwap * (1 -0.524434))), 2.77377), 16.2664)))",
+         [](const AlphaFields& f) {
+             return ts_rank(decay_linear(correlation(ind_neutralize(f.vwap, f.industry), f.adv(81), 17.4193), 19.848), 7.54455) /
+                    alpha_rank(decay_linear(delta(((f.close * 0.524434) + (f.vwap * (1 - 0.524434))), 2.77377), 16.2664));
+         }},
+        {94, "((rank((vwap - ts_min(vwap, 11.5783)))^Ts_Rank(correlation(Ts_Rank(vwap,19.6462), Ts_Rank(adv60, 4.02992), 18.0926), 2.70756)) * -1)",
+         [](const AlphaFields& f) {
+             return power(alpha_rank((f.vwap - ts_min(f.vwap, 11.5783))),
+                          ts_rank(correlation(ts_rank(f.vwap, 19.6462), ts_rank(f.adv(60), 4.02992), 18.0926), 2.70756)) * -1;
+         }},
+        {95, "(rank((open - ts_min(open, 12.4105))) < Ts_Rank((rank(correlation(sum(((high + low)/ 2), 19.1351), sum(adv40, 19.1351), 12.8742))^5), 11.7584))",
+         [](const AlphaFields& f) {
+             return alpha_rank((f.open - ts_min(f.open, 12.4105))) <
+                    ts_rank(power(alpha_rank(correlation(ts_sum(((f.high + f.low) / 2), 19.1351), ts_sum(f.adv(40), 19.1351),
+                                                         12.8742)), 5), 11.7584);
+         }},
+        {96, "(max(Ts_Rank(decay_linear(correlation(rank(vwap), rank(volume), 3.83878),4.16783), 8.38151), Ts_Rank(decay_linear(Ts_ArgMax(correlation(Ts_Rank(close, 7.45404),Ts_Rank(adv60, 4.13242), 3.65459), 12.6556), 14.0365), 13.4143)) * -1)",
+         [](const AlphaFields& f) {
+             return max(ts_rank(decay_linear(correlation(alpha_rank(f.vwap), alpha_rank(f.volume), 3.83878), 4.16783), 8.38151),
+                        ts_rank(decay_linear(ts_argmax(correlation(ts_rank(f.close, 7.45404), ts_rank(f.adv(60), 4.13242),
+                                                                   3.65459), 12.6556), 14.0365), 13.4143)) * -1;
+         }},
+        {97, "((rank(decay_linear(delta(IndNeutralize(((low * 0.721001) + (vwap * (1 - 0.721001))),IndClass.industry), 3.3705), 20.4523)) - Ts_Rank(decay_linear(Ts_Rank(correlation(Ts_Rank(low,7.87871), Ts_Rank(adv60, 17.255), 4.97547), 18.5925), 16.2489), 6.84868)) * -1)",
+         [](const AlphaFields& f) {
+             return (alpha_rank(decay_linear(delta(ind_neutralize(((f.low * 0.721001) + (f.vwap * (1 - 0.721001))), f.industry),
+                                                   3.3705), 20.4523)) -
+                     ts_rank(decay_linear(ts_rank(correlation(ts_rank(f.low, 7.87871), ts_rank(f.adv(60), 17.255), 4.97547),
+                                                  18.5925), 16.2489), 6.84868)) * -1;
+         }},
+        {98, "(rank(decay_linear(correlation(vwap, sum(adv5, 26.4719), 4.58418), 7.18088)) -rank(decay_linear(Ts_Rank(Ts_ArgMin(correlation(rank(open), rank(adv15), 20.8187), 8.62571),6.95668), 8.07206)))",
+         [](const AlphaFields& f) {
+             return alpha_rank(decay_linear(correlation(f.vwap, ts_sum(f.adv(5), 26.4719), 4.58418), 7.18088)) -
+                    alpha_rank(decay_linear(ts_rank(ts_argmin(correlation(alpha_rank(f.open), alpha_rank(f.adv(15)), 20.8187),
+                                                              8.62571), 6.95668), 8.07206));
+         }},
+        {99, "((rank(correlation(sum(((high + low) / 2), 19.8975), sum(adv60, 19.8975), 8.8136)) <rank(correlation(low, volume, 6.28259))) * -1)",
+         [](const AlphaFields& f) {
+             return (alpha_rank(correlation(ts_sum(((f.high + f.low) / 2), 19.8975), ts_sum(f.adv(60), 19.8975), 8.8136)) <
+                     alpha_rank(correlation(f.low, f.volume, 6.28259))) * -1;
+         }},
+        {100, "(0 - (1 * (((1.5 * scale(indneutralize(indneutralize(rank(((((close - low) - (high -close)) / (high - low)) * volume)), IndClass.subindustry), IndClass.subindustry))) -scale(indneutralize((correlation(close, rank(adv20), 5) - rank(ts_argmin(close, 30))),IndClass.subindustry))) * (volume / adv20))))",
+         [](const AlphaFields& f) {
+             return 0 - (1 * (((1.5 * scale(ind_neutralize(ind_neutralize(alpha_rank(((((f.close - f.low) - (f.high - f.close)) /
+                                                                                          (f.high - f.low)) * f.volume)),
+                                                                           f.subindustry), f.subindustry))) -
+                               scale(ind_neutralize((correlation(f.close, alpha_rank(f.adv(20)), 5) -
+                                                     alpha_rank(ts_argmin(f.close, 30))), f.subindustry))) *
+                              (f.volume / f.adv(20))));
+         }},
+        {101, "((close - open) / ((high - low) + .001))",
+         [](const AlphaFields& f) { return (f.close - f.open) / ((f.high - f.low) + .001); }},
+    };
+    return formulas;
+}
+// clang-format on
+
+// 按编号查找注册项；未注册的编号返回 nullptr
+inline const AlphaFormula* find_alpha101(int id) {
+    for (const AlphaFormula& f : alpha101_formulas())
+        if (f.id == id) return &f;
+    return nullptr;
+}
+
+inline vector<int> alpha101_ids() {
+    vector<int> ids;
+    for (const AlphaFormula& f : alpha101_formulas()) ids.push_back(f.id);
+    return ids;
+}
+
+/**
+ * @brief 一批 alpha 的共享求值：全部公式构造在同一张图中，相同子表达式只计算一次
+ *
+ * 用法：
+ *   AlphaBatch batch(alpha101_ids());
+ *   auto out = batch.evaluate({{"open", &open}, {"close", &close}, ...});
+ *   // out[i] 对应 batch.ids()[i]
+ */
+class AlphaBatch {
+   public:
+    explicit AlphaBatch(span<const int> ids) : ids_(ids.begin(), ids.end()) {
+        AlphaFields f(graph_);
+        vector<NodeId> roots;
+        for (int id : ids_) {
+            const AlphaFormula* formula = find_alpha101(id);
+            if (!formula) throw std::invalid_argument("AlphaBatch: alpha " + to_string(id) + " is not registered");
+            roots.push_back(formula->build(f).id);
+        }
+        plan_ = compile_plan(graph_, roots);
+        lookback_ = plan_lookback(graph_, plan_);
+        vector<size_t> anchored = plan_lookback(graph_, plan_, true);
+        for (NodeId r : plan_.roots) {
+            history_ = std::max(history_, lookback_[r] + 1);
+            anchored_history_ = std::max(anchored_history_, anchored[r] + 1);
+        }
+    }
+
+    explicit AlphaBatch(const vector<int>& ids) : AlphaBatch(span<const int>(ids)) {}
+
+    // arena 非空时中间结果取自 arena（见 ::evaluate），适合逐批重复求值
+    vector<Panel<float>> evaluate(const FieldMap& fields, PanelLayout layout = PanelLayout::TimeMajor,
+                                  PanelArena* arena = nullptr) const {
+        return ::evaluate(graph_, plan_, fields, layout, arena);
+    }
+
+    /**
+     * @brief 只求日期 [t_begin, t_end) 的结果：输入先截取为 [t_begin - anchored_history() + 1, t_end) 再求值
+     *
+     * 返回的面板为 [S × (t_end - t_begin)]，第 0 个日期对应 t_begin。截取起点作为 origin 传给 evaluate，
+     * ts_sum / ts_mean / stddev / correlation / covariance / decay_linear 在与完整求值相同的日期上重新锚定；
+     * 多取的锚点段历史保证这些日期的窗口输入已与完整求值一致，因此结果与完整求值逐位一致。
+     */
+    vector<Panel<float>> evaluate_range(const FieldMap& fields, size_t t_begin, size_t t_end,
+                                        PanelLayout layout = PanelLayout::TimeMajor, PanelArena* arena = nullptr) const {
+        // 计划读取的字段以及可能被读取的缓存 adv{d}
+        vector<string> names = plan_.fields;
+        for (int d : adv_windows())
+            if (fields.count(adv_field(d))) names.push_back(adv_field(d));
+
+        size_t d_begin = t_begin + 1 < anchored_history_ ? 0 : t_begin + 1 - anchored_history_;
+        vector<Panel<float>> slices;
+        slices.reserve(names.size());
+        FieldMap sliced;
+        for (const string& name : names) {
+            auto it = fields.find(name);
+            if (it == fields.end() || !it->second)
+                throw std::invalid_argument("evaluate_range: missing input field '" + name + "'");
+            if (t_begin > t_end || t_end > it->second->dates())
+                throw std::invalid_argument("evaluate_range: date range out of bounds");
+            slices.push_back(slice_dates(*it->second, d_begin, t_end, layout));
+            sliced[name] = &slices.back();
+        }
+
+        vector<Panel<float>> out = ::evaluate(graph_, plan_, sliced, layout, arena, d_begin);
+        if (d_begin == t_begin) return out;
+        for (Panel<float>& p : out) p = slice_dates(p, t_begin - d_begin, t_end - d_begin, layout);
+        return out;
+    }
+
+    /**
+     * @brief 输入修订后的局部重算：只重写 outputs 中脏区内的单元格
+     *
+     * outputs 为此前在同一批输入上 evaluate 的结果（任意布局）；fields 为修订后的输入，
+     * dirty 给出各字段被修订的单元格（可用 dirty_cells 对比得到）。派生字段（returns / vwap / adv{d}）
+     * 须由调用方重新派生并一并标记。各 alpha 的脏区由 plan_dirty 传播得到；全部 alpha 的脏日期区间中
+     * 间隔不超过 anchored_history() 的合并成段（分开求值各需一段热身历史，间隔更短时合并更省），
+     * 每段经 evaluate_range 求值一次，代价 O((段内日期数 + anchored_history()) × S)，与 T 无关；
+     * 相隔较远的修订不会重算其间的日期。脏区外的单元格保持不变。evaluate_range 的锚点与完整求值对齐，重算后与在修订后输入上完整求值逐位一致。
+     *
+     * @return 每个 alpha 的输出脏区
+     */
+    vector<DirtyRange> recompute_dirty(const FieldMap& fields, const unordered_map<string, DirtyRange>& dirty,
+                                       vector<Panel<float>>& outputs) const {
+        if (outputs.size() != ids_.size())
+            throw std::invalid_argument("recompute_dirty: expected one output panel per alpha");
+        size_t T = outputs.empty() ? 0 : outputs[0].dates();
+        for (const Panel<float>& p : outputs)
+            if (p.dates() != T || p.stocks() != outputs[0].stocks())
+                throw std::invalid_argument("recompute_dirty: output panels have different shapes");
+
+        vector<DirtyRange> node_dirty = plan_dirty(graph_, plan_, dirty, T);
+        vector<DirtyRange> result;
+        DirtyRange all;
+        for (NodeId r : plan_.roots) {
+            result.push_back(node_dirty[r]);
+            all.merge(node_dirty[r]);
+        }
+        vector<pair<size_t, size_t>> segments;
+        for (auto [d0, d1] : all.dates) {
+            if (!segments.empty() && d0 - segments.back().second <= anchored_history_) segments.back().second = d1;
+            else segments.push_back({d0, d1});
+        }
+
+        for (auto [t0, t1] : segments) {
+            vector<Panel<float>> part = evaluate_range(fields, t0, t1, PanelLayout::TimeMajor);
+            for (size_t i = 0; i < outputs.size(); ++i) {
+                const DirtyRange& d = result[i];
+                if (part[i].stocks() != outputs[i].stocks())
+                    throw std::invalid_argument("recompute_dirty: outputs and fields have different shapes");
+                for (auto [d0, d1] : d.dates) {
+                    size_t lo = std::max(d0, t0), hi = std::min(d1, t1);
+                    for (size_t s = 0; s < outputs[i].stocks(); ++s) {
+                        if (!d.has_stock(s)) continue;
+                        for (size_t t = lo; t < hi; ++t) outputs[i](s, t) = part[i](s, t - t0);
+                    }
+                }
+            }
+        }
+        return result;
+    }
+
+    const vector<int>& ids() const { return ids_; }
+    const ExprGraph& graph() const { return graph_; }
+    // 这批公式用到的 adv 窗口，交给 AlphaInputs::derive 预先计算
+    vector<int> adv_windows() const { return plan_adv_windows(graph_, plan_); }
+
+    // 求出一个日期所需的最少历史日期数（含当日）：全部公式的最大值，或第 i 个公式的值。
+    // 加载器据此只读取最近 history() 个日期；前 history() - 1 个日期即结构性热身期
+    size_t history() const { return history_; }
+    size_t history(size_t i) const { return lookback_[plan_.roots[i]] + 1; }
+    // evaluate_range 实际截取的历史日期数：history() 再加上各层重新锚定算子的锚点段（见 plan_lookback）
+    size_t anchored_history() const { return anchored_history_; }
+    const ExprPlan& plan() const { return plan_; }
+
+    // 计划中唯一节点数 / 各公式展开为树后的节点数之和
+    size_t unique_nodes() const { return plan_.order.size(); }
+    size_t tree_nodes() const {
+        size_t total = 0;
+        for (NodeId r : plan_.roots) total += expr_tree_size(graph_, r);
+        return total;
+    }
+
+   private:
+    vector<int> ids_;
+    ExprGraph graph_;
+    ExprPlan plan_;
+    vector<size_t> lookback_;
+    size_t history_ = 1;
+    size_t anchored_history_ = 1;
+};
+
+#endif  // ALPHA101EXPR_H
@@ -0,0 +1,425 @@
+#ifndef ALPHA101FORMULA_H
+#define ALPHA101FORMULA_H
+
+#include <cctype>
+#include <charconv>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Alpha101Expr.h"
+
+// ====== 公式 DSL：把论文写法的 alpha 表达式解析为表达式图中的节点 ======
+//
+// 语法（优先级由低到高）：
+//   expr    := or ('?' expr ':' expr)?            三元运算，右结合
+//   or      := compare ('||' compare)*
+//   compare := sum (('<' | '<=' | '>' | '>=' | '==') sum)*
+//   sum     := product (('+' | '-') product)*
+//   product := unary (('*' | '/') unary)*
+//   unary   := '-' unary | power
+//   power   := primary ('^' unary)?               右结合，-x^2 = -(x^2)
+//   primary := number | field | advN | IndClass.name | func '(' expr (',' expr)* ')' | '(' expr ')'
+//
+// 函数名不区分大小写（Ts_ArgMax 与 ts_argmax 相同）；字段名区分大小写，任何非函数标识符都视为输入字段，
+// 求值时缺失的字段由 evaluate() 报错。advN 为 N 日平均成交量。窗口参数必须是数值，非整数向下取整。
+// min/max 的第二个参数为数值时按论文约定为 ts_min/ts_max，否则为逐元素 min/max。
+
+/**
+ * @brief 解析结果的类型
+ *
+ * Scalar 为数值常数（在 double 上折叠，与 C++ 中字面量运算一致），Series 为图中节点，
+ * Group 为 IndClass.* 分类，只能作为 IndNeutralize 的第二个参数；IndClass.name 求值时读取字段 name
+ * （如 IndClass.industry → 字段 industry）。
+ */
+enum class FormulaType : uint8_t { Scalar, Series, Group };
+
+struct FormulaValue {
+    FormulaType type = FormulaType::Scalar;
+    double number = 0.0;
+    Expr expr;
+    string group;
+};
+
+/**
+ * @brief 递归下降解析器
+ *
+ * 所有公式构造在 AlphaFields 所属的图中，因此与手写构造函数、以及同图中其他公式的相同子表达式
+ * 落在同一个节点上。语法或类型错误抛出 std::invalid_argument，消息包含出错的列号。
+ */
+class FormulaParser {
+   public:
+    explicit FormulaParser(const AlphaFields& fields) : f_(fields), g_(fields.open.graph) {}
+
+    Expr parse(string_view text) {
+        text_ = text;
+        pos_ = 0;
+        next();
+        FormulaValue v = parse_expr();
+        if (tok_.kind != Tok::End) fail("unexpected '" + string(tok_.text) + "'");
+        if (v.type == FormulaType::Group) fail("IndClass can only be used inside IndNeutralize", 0);
+        return series(v);
+    }
+
+   private:
+    enum class Tok : uint8_t { End, Number, Ident, Op };
+
+    struct Token {
+        Tok kind = Tok::End;
+        string_view text;
+        double number = 0.0;
+        size_t pos = 0;
+    };
+
+    [[noreturn]] void fail(const string& msg) const { fail(msg, tok_.pos); }
+    [[noreturn]] void fail(const string& msg, size_t pos) const {
+        throw std::invalid_argument("parse_formula: " + msg + " at column " + to_string(pos + 1) + " in \"" +
+                                    string(text_) + "\"");
+    }
+
+    // ---------- 词法 ----------
+
+    void next() {
+        while (pos_ < text_.size() && std::isspace((unsigned char)text_[pos_])) ++pos_;
+        tok_ = Token{};
+        tok_.pos = pos_;
+        if (pos_ >= text_.size()) return;
+        char c = text_[pos_];
+        if (std::isdigit((unsigned char)c) || (c == '.' && pos_ + 1 < text_.size() &&
+                                                std::isdigit((unsigned char)text_[pos_ + 1]))) {
+            const char* first = text_.data() + pos_;
+            auto [end, ec] = std::from_chars(first, text_.data() + text_.size(), tok_.number);
+            size_t len = (size_t)(end - first);
+            tok_.kind = Tok::Number;
+            tok_.text = text_.substr(pos_, len);
+            pos_ += len;
+            return;
+        }
+        if (std::isalpha((unsigned char)c) || c == '_') {
+            size_t start = pos_;
+            while (pos_ < text_.size() && (std::isalnum((unsigned char)text_[pos_]) || text_[pos_] == '_')) ++pos_;
+            tok_.kind = Tok::Ident;
+            tok_.text = text_.substr(start, pos_ - start);
+            return;
+        }
+        static constexpr string_view two_char[] = {"<=", ">=", "==", "||"};
+        for (string_view op : two_char) {
+            if (text_.substr(pos_, 2) == op) {
+                tok_.kind = Tok::Op;
+                tok_.text = op;
+                pos_ += 2;
+                return;
+            }
+        }
+        if (string_view("()+-*/^<>?:,.").find(c) == string_view::npos) {
+            tok_.text = text_.substr(pos_, 1);
+            fail("unexpected character '" + string(1, c) + "'");
+        }
+        tok_.kind = Tok::Op;
+        tok_.text = text_.substr(pos_++, 1);
+    }
+
+    bool accept(string_view op) {
+        if (tok_.kind != Tok::Op || tok_.text != op) return false;
+        next();
+        return true;
+    }
+
+    void expect(string_view op) {
+        if (!accept(op)) fail("expected '" + string(op) + "'");
+    }
+
+    // ---------- 类型转换 ----------
+
+    static FormulaValue scalar(double v) { return {FormulaType::Scalar, v, {}, {}}; }
+    static FormulaValue of(Expr e) { return {FormulaType::Series, 0.0, e, {}}; }
+
+    Expr series(const FormulaValue& v) const {
+        return v.type == FormulaType::Series ? v.expr : Expr{g_, g_->constant((float)v.number)};
+    }
+
+    ExprArg arg(const FormulaValue& v, size_t pos) const {
+        if (v.type == FormulaType::Group) fail("IndClass can only be used inside IndNeutralize", pos);
+        if (v.type == FormulaType::Scalar) return v.number;
+        return v.expr;
+    }
+
+    // 全部操作数为 Scalar 时在 double 上计算，否则在图中构造节点
+    template <typename Fn>
+    FormulaValue binary(const FormulaValue& x, const FormulaValue& y, size_t pos, double (*scalar_fn)(double, double),
+                        Fn&& build) const {
+        if (x.type == FormulaType::Scalar && y.type == FormulaType::Scalar) return scalar(scalar_fn(x.number, y.number));
+        return of(build(arg(x, pos), arg(y, pos)));
+    }
+
+    // ---------- 语法 ----------
+
+    FormulaValue parse_expr() {
+        size_t pos = tok_.pos;
+        FormulaValue cond = parse_or();
+        if (!accept("?")) return cond;
+        FormulaValue x = parse_expr();
+        expect(":");
+        FormulaValue y = parse_expr();
+        if (cond.type == FormulaType::Scalar) return std::isnan(cond.number) ? scalar(NAN) : (cond.number != 0 ? x : y);
+        return of(where(arg(cond, pos), arg(x, pos), arg(y, pos)));
+    }
+
+    FormulaValue parse_or() {
+        FormulaValue x = parse_compare();
+        while (true) {
+            size_t pos = tok_.pos;
+            if (!accept("||")) return x;
+            FormulaValue y = parse_compare();
+            x = binary(x, y, pos, [](double a, double b) { return (double)(a != 0 || b != 0); },
+                       [](ExprArg a, ExprArg b) { return a || b; });
+        }
+    }
+
+    FormulaValue parse_compare() {
+        FormulaValue x = parse_sum();
+        while (true) {
+            size_t pos = tok_.pos;
+            if (accept("<")) {
+                x = binary(x, parse_sum(), pos, [](double a, double b) { return (double)(a < b); },
+                           [](ExprArg a, ExprArg b) { return a < b; });
+            } else if (accept("<=")) {
+                x = binary(x, parse_sum(), pos, [](double a, double b) { return (double)(a <= b); },
+                           [](ExprArg a, ExprArg b) { return a <= b; });
+            } else if (accept(">")) {
+                x = binary(x, parse_sum(), pos, [](double a, double b) { return (double)(a > b); },
+                           [](ExprArg a, ExprArg b) { return a > b; });
+            } else if (accept(">=")) {
+                x = binary(x, parse_sum(), pos, [](double a, double b) { return (double)(a >= b); },
+                           [](ExprArg a, ExprArg b) { return a >= b; });
+            } else if (accept("==")) {
+                x = binary(x, parse_sum(), pos, [](double a, double b) { return (double)(a == b); },
+                           [](ExprArg a, ExprArg b) { return eq(a, b); });
+            } else {
+                return x;
+            }
+        }
+    }
+
+    FormulaValue parse_sum() {
+        FormulaValue x = parse_product();
+        while (true) {
+            size_t pos = tok_.pos;
+            if (accept("+")) {
+                x = binary(x, parse_product(), pos, [](double a, double b) { return a + b; },
+                           [](ExprArg a, ExprArg b) { return a + b; });
+            } else if (accept("-")) {
+                x = binary(x, parse_product(), pos, [](double a, double b) { return a - b; },
+                           [](ExprArg a, ExprArg b) { return a - b; });
+            } else {
+                return x;
+            }
+        }
+    }
+
+    FormulaValue parse_product() {
+        FormulaValue x = parse_unary();
+        while (true) {
+            size_t pos = tok_.pos;
+            if (accept("*")) {
+                x = binary(x, parse_unary(), pos, [](double a, double b) { return a * b; },
+                           [](ExprArg a, ExprArg b) { return a * b; });
+            } else if (accept("/")) {
+                x = binary(x, parse_unary(), pos, [](double a, double b) { return a / b; },
+                           [](ExprArg a, ExprArg b) { return a / b; });
+            } else {
+                return x;
+            }
+        }
+    }
+
+    FormulaValue parse_unary() {
+        size_t pos = tok_.pos;
+        if (!accept("-")) return parse_power();
+        FormulaValue x = parse_unary();
+        if (x.type == FormulaType::Scalar) return scalar(-x.number);
+        return of(-arg(x, pos));
+    }
+
+    FormulaValue parse_power() {
+        FormulaValue x = parse_primary();
+        size_t pos = tok_.pos;
+        if (!accept("^")) return x;
+        return binary(x, parse_unary(), pos, [](double a, double b) { return std::pow(a, b); },
+                      [](ExprArg a, ExprArg b) { return power(a, b); });
+    }
+
+    FormulaValue parse_primary() {
+        Token t = tok_;
+        if (t.kind == Tok::Number) {
+            next();
+            return scalar(t.number);
+        }
+        if (accept("(")) {
+            FormulaValue v = parse_expr();
+            expect(")");
+            return v;
+        }
+        if (t.kind != Tok::Ident) fail(t.kind == Tok::End ? "unexpected end of formula" : "expected an operand");
+        next();
+        if (t.text == "IndClass") {
+            expect(".");
+            if (tok_.kind != Tok::Ident) fail("expected a classification after 'IndClass.'");
+            FormulaValue v{FormulaType::Group, 0.0, {}, string(tok_.text)};
+            next();
+            return v;
+        }
+        if (accept("(")) {
+            vector<FormulaValue> args;
+            vector<size_t> positions;
+            if (!accept(")")) {
+                do {
+                    positions.push_back(tok_.pos);
+                    args.push_back(parse_expr());
+                } while (accept(","));
+                expect(")");
+            }
+            return call(t, args, positions);
+        }
+        if (t.text.size() > 3 && t.text.substr(0, 3) == "adv" &&
+            t.text.find_first_not_of("0123456789", 3) == string_view::npos) {
+            int d = 0;
+            auto [end, ec] = std::from_chars(t.text.data() + 3, t.text.data() + t.text.size(), d);
+            if (ec != std::errc{} || end != t.text.data() + t.text.size())
+                fail("adv window out of range: '" + string(t.text) + "'", t.pos);
+            return of(f_.adv(d));
+        }
+        return of(Expr{g_, g_->field(string(t.text))});
+    }
+
+    // ---------- 函数 ----------
+
+    FormulaValue call(const Token& name, const vector<FormulaValue>& args, const vector<size_t>& positions) {
+        string fn(name.text);
+        for (char& c : fn) c = (char)std::tolower((unsigned char)c);
+
+        auto arity = [&](size_t lo, size_t hi) {
+            if (args.size() < lo || args.size() > hi)
+                fail(string(name.text) + " expects " + to_string(lo) + (hi > lo ? "-" + to_string(hi) : string()) +
+                         " argument(s), got " + to_string(args.size()),
+                     name.pos);
+        };
+        auto x = [&](size_t i) {
+            if (args[i].type == FormulaType::Group)
+                fail("IndClass can only be used inside IndNeutralize", positions[i]);
+            return series(args[i]);
+        };
+        auto number = [&](size_t i) {
+            if (args[i].type != FormulaType::Scalar) fail(string(name.text) + " expects a numeric parameter", positions[i]);
+            return args[i].number;
+        };
+        auto window = [&](size_t i) {
+            double d = number(i);
+            if (!(d >= 0)) fail(string(name.text) + " window must be non-negative", positions[i]);
+            return d;
+        };
+
+        using Unary = Expr (*)(const Expr&);
+        using Windowed = Expr (*)(const Expr&, double);
+        static const unordered_map<string, Unary> unary = {
+            {"abs", [](const Expr& e) { return abs(e); }},
+            {"log", [](const Expr& e) { return log(e); }},
+            {"sign", [](const Expr& e) { return sign(e); }},
+            {"rank", [](const Expr& e) { return alpha_rank(e); }},
+        };
+        static const unordered_map<string, Windowed> windowed = {
+            {"sum", ts_sum},           {"ts_sum", ts_sum},       {"ts_mean", ts_mean},     {"stddev", stddev},
+            {"product", product},      {"ts_rank", ts_rank},     {"ts_min", ts_min},       {"ts_max", ts_max},
+            {"ts_argmax", ts_argmax},  {"ts_argmin", ts_argmin}, {"delta", delta},         {"delay", delay},
+            {"decay_linear", decay_linear},
+        };
+
+        if (auto it = unary.find(fn); it != unary.end()) {
+            arity(1, 1);
+            return of(it->second(x(0)));
+        }
+        if (auto it = windowed.find(fn); it != windowed.end()) {
+            arity(2, 2);
+            return of(it->second(x(0), window(1)));
+        }
+        if (fn == "correlation" || fn == "covariance") {
+            arity(3, 3);
+            return of(fn == "correlation" ? correlation(x(0), x(1), window(2)) : covariance(x(0), x(1), window(2)));
+        }
+        if (fn == "min" || fn == "max") {
+            arity(2, 2);
+            if (args[1].type == FormulaType::Scalar)
+                return of(fn == "min" ? ts_min(x(0), window(1)) : ts_max(x(0), window(1)));
+            return of(fn == "min" ? min(x(0), x(1)) : max(x(0), x(1)));
+        }
+        if (fn == "signedpower") {
+            arity(2, 2);
+            return of(signed_power(x(0), arg(args[1], positions[1])));
+        }
+        if (fn == "scale") {
+            arity(1, 2);
+            return of(scale(x(0), args.size() > 1 ? number(1) : 1.0));
+        }
+        if (fn == "indneutralize") {
+            arity(2, 2);
+            if (args[1].type != FormulaType::Group) fail("IndNeutralize expects an IndClass.* argument", positions[1]);
+            return of(ind_neutralize(x(0), Expr{g_, g_->field(args[1].group)}));
+        }
+        fail("unknown function '" + string(name.text) + "'", name.pos);
+    }
+
+    const AlphaFields& f_;
+    ExprGraph* g_;
+    string_view text_;
+    size_t pos_ = 0;
+    Token tok_;
+};
+
+/**
+ * @brief 将一条论文写法的公式解析为 fields 所属图中的节点
+ *
+ * 例：
+ *   ExprGraph g;
+ *   AlphaFields f(g);
+ *   Expr a = parse_formula(f, "rank(Ts_ArgMax(SignedPower(((returns < 0) ? stddev(returns, 20) : close), 2.), 5)) - 0.5");
+ */
+inline Expr parse_formula(const AlphaFields& fields, string_view text) { return FormulaParser(fields).parse(text); }
+
+/**
+ * @brief 一批自定义公式的共享求值，与 AlphaBatch 相同但输入为公式文本
+ *
+ * 用法：
+ *   FormulaBatch batch({"rank(delta(close, 1))", "-1 * correlation(open, volume, 10)"});
+ *   auto out = batch.evaluate(fields);
+ *   std::cout << batch.explain(S, T);  // 每个节点的代价估计
+ */
+class FormulaBatch {
+   public:
+    explicit FormulaBatch(const vector<string>& formulas) : formulas_(formulas) {
+        AlphaFields f(graph_);
+        FormulaParser parser(f);
+        vector<NodeId> roots;
+        for (const string& text : formulas_) roots.push_back(parser.parse(text).id);
+        plan_ = compile_plan(graph_, roots);
+    }
+
+    vector<Panel<float>> evaluate(const FieldMap& fields, PanelLayout layout = PanelLayout::TimeMajor) const {
+        return ::evaluate(graph_, plan_, fields, layout);
+    }
+
+    vector<NodeCost> costs(size_t S, size_t T) const { return estimate_cost(graph_, plan_, S, T); }
+    string explain(size_t S, size_t T) const { return explain_plan(graph_, plan_, S, T); }
+
+    const vector<string>& formulas() const { return formulas_; }
+    const ExprGraph& graph() const { return graph_; }
+    const ExprPlan& plan() const { return plan_; }
+
+   private:
+    vector<string> formulas_;
+    ExprGraph graph_;
+    ExprPlan plan_;
+};
+
+#endif  // ALPHA101FORMULA_H
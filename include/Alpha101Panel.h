@@ -0,0 +1,600 @@
+#ifndef ALPHA101PANEL_H
+#define ALPHA101PANEL_H
+
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <unordered_map>
+
+#include "Alpha101Arena.h"
+#include "Alpha101Simd.h"
+#include "Alpha101Utils.h"
+
+// ====== Panel：单次分配、64 字节对齐的 [股票 × 时间] 连续矩阵 ======
+
+/**
+ * @brief Panel 的内存布局
+ *
+ * StockMajor：按股票连续存放，data[s*T + t]，单只股票的时间序列是一段连续内存，
+ *             适合时序算子（rolling_*、ts_*、delta ...）
+ * TimeMajor ：按日期连续存放，data[t*S + s]，单个截面是一段连续内存，
+ *             适合截面算子（alpha_rank、scale）以及跨股票的 SIMD 扫描
+ */
+enum class PanelLayout { StockMajor, TimeMajor };
+
+/**
+ * @brief 带步长的一维视图，用于访问 Panel 的非主轴方向（"列"）
+ *
+ * span 只能描述连续内存；StockMajor 下的截面、TimeMajor 下的时间序列都是等步长分布，
+ * 由本视图表示。stride == 1 时可通过 as_span() 退化为 span。
+ */
+template <typename T>
+class StridedSpan {
+   public:
+    StridedSpan() = default;
+    StridedSpan(T* data, size_t size, size_t stride) : data_(data), size_(size), stride_(stride) {}
+
+    T& operator[](size_t i) const { return data_[i * stride_]; }
+    size_t size() const { return size_; }
+    size_t stride() const { return stride_; }
+    T* data() const { return data_; }
+    bool contiguous() const { return stride_ == 1; }
+    span<T> as_span() const { return span<T>(data_, size_); }
+
+   private:
+    T* data_ = nullptr;
+    size_t size_ = 0;
+    size_t stride_ = 1;
+};
+
+/**
+ * @brief [股票 × 时间] 面板数据容器
+ *
+ * 全部元素位于一块 64 字节对齐的连续内存中（替代 vector<vector<float>> 的逐行堆分配）。
+ * "行"（row）始终指主轴方向的一段连续内存，"列"（col）指非主轴方向的等步长视图：
+ *   StockMajor：row(s) = 股票 s 的时间序列，col(t) = 日期 t 的截面
+ *   TimeMajor ：row(t) = 日期 t 的截面，    col(s) = 股票 s 的时间序列
+ * 与布局无关的访问请使用 series(s) / cross_section(t) / operator()(s, t)。
+ *
+ * Panel 既可拥有内存（构造函数分配），也可是外部内存的零拷贝视图（Panel::view）；
+ * 视图通过 keepalive 持有底层资源的生命周期。拷贝构造总是深拷贝为新的自有内存。
+ */
+template <typename T>
+class Panel {
+   public:
+    static constexpr size_t kAlignment = 64;
+
+    Panel() = default;
+
+    Panel(size_t n_stocks, size_t n_dates, PanelLayout layout = PanelLayout::StockMajor, T init = default_value())
+        : n_stocks_(n_stocks), n_dates_(n_dates), layout_(layout) {
+        allocate();
+        std::fill(data_, data_ + size(), init);
+    }
+
+    Panel(const Panel& other) : n_stocks_(other.n_stocks_), n_dates_(other.n_dates_), layout_(other.layout_) {
+        allocate();
+        if (size()) std::memcpy(data_, other.data_, size() * sizeof(T));
+    }
+
+    Panel(Panel&& other) noexcept { swap(other); }
+
+    Panel& operator=(Panel other) noexcept {
+        swap(other);
+        return *this;
+    }
+
+    void swap(Panel& other) noexcept {
+        std::swap(data_, other.data_);
+        std::swap(holder_, other.holder_);
+        std::swap(n_stocks_, other.n_stocks_);
+        std::swap(n_dates_, other.n_dates_);
+        std::swap(layout_, other.layout_);
+    }
+
+    /**
+     * @brief 以外部连续内存构造零拷贝视图（不分配、不复制）
+     *
+     * @param data      外部内存首地址，元素个数至少 n_stocks * n_dates
+     * @param keepalive 可选：持有底层资源（如 mmap 映射、arena）的所有权，视图存活期间资源不被释放
+     */
+    static Panel view(T* data, size_t n_stocks, size_t n_dates, PanelLayout layout,
+                      shared_ptr<void> keepalive = nullptr) {
+        Panel p;
+        p.data_ = data;
+        p.holder_ = std::move(keepalive);
+        p.n_stocks_ = n_stocks;
+        p.n_dates_ = n_dates;
+        p.layout_ = layout;
+        return p;
+    }
+
+    /**
+     * @brief 在 arena 上分配（元素不初始化）：视图以 arena 的租约为 keepalive，随 arena 回卷成批释放
+     *
+     * 元素个数不变的 reset 照常复用这块内存；改变元素个数的 reset 会抛出（视图不能重新分配）。
+     */
+    static Panel in_arena(PanelArena& arena, size_t n_stocks, size_t n_dates, PanelLayout layout) {
+        void* p = arena.allocate(n_stocks * n_dates * sizeof(T));
+        return view(static_cast<T*>(p), n_stocks, n_dates, layout, arena.lease(p));
+    }
+
+    // 从嵌套 vector（mat[s][t]）构造，兼容旧接口
+    static Panel from_nested(const vector<vector<T>>& mat, PanelLayout layout = PanelLayout::StockMajor) {
+        size_t S = mat.size();
+        size_t n_dates = S ? mat[0].size() : 0;
+        Panel p(S, n_dates, layout);
+        for (size_t s = 0; s < S; ++s)
+            for (size_t t = 0; t < n_dates; ++t) p(s, t) = mat[s][t];
+        return p;
+    }
+
+    // 导出为嵌套 vector（result[s][t]），兼容旧接口
+    vector<vector<T>> to_nested() const {
+        vector<vector<T>> mat(n_stocks_, vector<T>(n_dates_));
+        for (size_t s = 0; s < n_stocks_; ++s)
+            for (size_t t = 0; t < n_dates_; ++t) mat[s][t] = (*this)(s, t);
+        return mat;
+    }
+
+    /**
+     * @brief 调整形状与布局；元素个数不变时复用现有内存，内容不保证保留
+     *
+     * 用于 out 参数：调用方可在循环外声明一个 Panel，多次传入而不重复分配。
+     */
+    void reset(size_t n_stocks, size_t n_dates, PanelLayout layout) {
+        if (n_stocks * n_dates != size()) {
+            if (data_ && !owns_memory()) throw std::logic_error("Panel::reset: cannot resize a non-owning view");
+            Panel(n_stocks, n_dates, layout).swap(*this);
+            return;
+        }
+        n_stocks_ = n_stocks;
+        n_dates_ = n_dates;
+        layout_ = layout;
+    }
+
+    void reset_like(const Panel& other) { reset(other.n_stocks_, other.n_dates_, other.layout_); }
+
+    size_t stocks() const { return n_stocks_; }
+    size_t dates() const { return n_dates_; }
+    size_t size() const { return n_stocks_ * n_dates_; }
+    bool empty() const { return size() == 0; }
+    PanelLayout layout() const { return layout_; }
+    T* data() { return data_; }
+    const T* data() const { return data_; }
+
+    // 主轴行数 / 每行长度
+    size_t rows() const { return layout_ == PanelLayout::StockMajor ? n_stocks_ : n_dates_; }
+    size_t cols() const { return layout_ == PanelLayout::StockMajor ? n_dates_ : n_stocks_; }
+
+    T& operator()(size_t s, size_t t) { return data_[index(s, t)]; }
+    const T& operator()(size_t s, size_t t) const { return data_[index(s, t)]; }
+
+    // 主轴方向的连续行
+    span<T> row(size_t r) { return span<T>(data_ + r * cols(), cols()); }
+    span<const T> row(size_t r) const { return span<const T>(data_ + r * cols(), cols()); }
+
+    // 非主轴方向的等步长列
+    StridedSpan<T> col(size_t c) { return StridedSpan<T>(data_ + c, rows(), cols()); }
+    StridedSpan<const T> col(size_t c) const { return StridedSpan<const T>(data_ + c, rows(), cols()); }
+
+    // 股票 s 的时间序列（StockMajor 下连续）
+    StridedSpan<T> series(size_t s) {
+        return layout_ == PanelLayout::StockMajor ? StridedSpan<T>(data_ + s * n_dates_, n_dates_, 1)
+                                                  : StridedSpan<T>(data_ + s, n_dates_, n_stocks_);
+    }
+    StridedSpan<const T> series(size_t s) const {
+        return layout_ == PanelLayout::StockMajor ? StridedSpan<const T>(data_ + s * n_dates_, n_dates_, 1)
+                                                  : StridedSpan<const T>(data_ + s, n_dates_, n_stocks_);
+    }
+
+    // 日期 t 的截面（TimeMajor 下连续）
+    StridedSpan<T> cross_section(size_t t) {
+        return layout_ == PanelLayout::TimeMajor ? StridedSpan<T>(data_ + t * n_stocks_, n_stocks_, 1)
+                                                 : StridedSpan<T>(data_ + t, n_stocks_, n_dates_);
+    }
+    StridedSpan<const T> cross_section(size_t t) const {
+        return layout_ == PanelLayout::TimeMajor ? StridedSpan<const T>(data_ + t * n_stocks_, n_stocks_, 1)
+                                                 : StridedSpan<const T>(data_ + t, n_stocks_, n_dates_);
+    }
+
+    bool owns_memory() const { return holder_.get() == static_cast<const void*>(data_); }
+
+   private:
+    static T default_value() {
+        if constexpr (std::numeric_limits<T>::has_quiet_NaN) return std::numeric_limits<T>::quiet_NaN();
+        else return T();
+    }
+
+    size_t index(size_t s, size_t t) const {
+        return layout_ == PanelLayout::StockMajor ? s * n_dates_ + t : t * n_stocks_ + s;
+    }
+
+    void allocate() {
+        static_assert(std::is_trivially_copyable_v<T>, "Panel<T> requires a trivially copyable element type");
+        if (size() == 0) return;
+        void* p = ::operator new(size() * sizeof(T), std::align_val_t{kAlignment});
+        data_ = static_cast<T*>(p);
+        holder_ = shared_ptr<void>(p, [](void* q) { ::operator delete(q, std::align_val_t{kAlignment}); });
+    }
+
+    T* data_ = nullptr;
+    shared_ptr<void> holder_;  // 自有内存时指向 data_；视图时持有外部资源（可为空）
+    size_t n_stocks_ = 0;
+    size_t n_dates_ = 0;
+    PanelLayout layout_ = PanelLayout::StockMajor;
+};
+
+/**
+ * @brief 复制日期区间 [d_begin, d_end) 为新的面板 [S × (d_end - d_begin)]，以 layout 布局存放
+ *
+ * 输入与输出同为 TimeMajor 时按行整块复制，同为 StockMajor 时逐股票复制连续子序列。
+ */
+template <typename T>
+inline Panel<T> slice_dates(const Panel<T>& in, size_t d_begin, size_t d_end, PanelLayout layout) {
+    if (d_begin > d_end || d_end > in.dates()) throw std::invalid_argument("slice_dates: date range out of bounds");
+    size_t S = in.stocks(), n = d_end - d_begin;
+    Panel<T> out(S, n, layout);
+    if (in.layout() == layout) {
+        if (layout == PanelLayout::TimeMajor) {
+            if (n) std::memcpy(out.data(), in.row(d_begin).data(), S * n * sizeof(T));
+        } else {
+            for (size_t s = 0; s < S; ++s) std::copy_n(in.row(s).data() + d_begin, n, out.row(s).data());
+        }
+    } else {
+        for (size_t s = 0; s < S; ++s)
+            for (size_t t = 0; t < n; ++t) out(s, t) = in(s, d_begin + t);
+    }
+    return out;
+}
+
+// ====== 逐序列 / 逐截面的调度辅助 ======
+// 主轴方向连续时直接以 span 传给算子（零拷贝）；
+// 否则经一块调用内复用的缓冲区聚合/回写（每次调用仅分配一次）。
+// 时序算子的 TimeMajor 输入不经过这里，而是直接走 SIMD 内核，见下方 Panel 重载。
+
+template <typename Fn>
+inline void for_each_series(const Panel<float>& in, Panel<float>& out, Fn&& fn) {
+    out.reset_like(in);
+    size_t S = in.stocks(), n_dates = in.dates();
+    if (in.layout() == PanelLayout::StockMajor) {
+        for (size_t s = 0; s < S; ++s) fn(in.row(s), out.row(s));
+        return;
+    }
+    vector<float> buf_in(n_dates), buf_out(n_dates);
+    for (size_t s = 0; s < S; ++s) {
+        auto src = in.series(s);
+        for (size_t t = 0; t < n_dates; ++t) buf_in[t] = src[t];
+        fn(span<const float>(buf_in), span<float>(buf_out));
+        auto dst = out.series(s);
+        for (size_t t = 0; t < n_dates; ++t) dst[t] = buf_out[t];
+    }
+}
+
+template <typename Fn>
+inline void for_each_series(const Panel<float>& a, const Panel<float>& b, Panel<float>& out, Fn&& fn) {
+    out.reset_like(a);
+    size_t S = a.stocks(), n_dates = a.dates();
+    if (a.layout() == PanelLayout::StockMajor && b.layout() == PanelLayout::StockMajor) {
+        for (size_t s = 0; s < S; ++s) fn(a.row(s), b.row(s), out.row(s));
+        return;
+    }
+    vector<float> buf_a(n_dates), buf_b(n_dates), buf_out(n_dates);
+    for (size_t s = 0; s < S; ++s) {
+        auto sa = a.series(s), sb = b.series(s);
+        for (size_t t = 0; t < n_dates; ++t) {
+            buf_a[t] = sa[t];
+            buf_b[t] = sb[t];
+        }
+        fn(span<const float>(buf_a), span<const float>(buf_b), span<float>(buf_out));
+        auto dst = out.series(s);
+        for (size_t t = 0; t < n_dates; ++t) dst[t] = buf_out[t];
+    }
+}
+
+// fn(x, y)，或需要日期下标时 fn(t, x, y)
+template <typename Fn>
+inline void for_each_cross_section(const Panel<float>& in, Panel<float>& out, Fn&& fn) {
+    out.reset_like(in);
+    size_t S = in.stocks(), n_dates = in.dates();
+    auto call = [&](size_t t, span<const float> x, span<float> y) {
+        if constexpr (is_invocable_v<Fn&, size_t, span<const float>, span<float>>) fn(t, x, y);
+        else fn(x, y);
+    };
+    if (in.layout() == PanelLayout::TimeMajor) {
+        for (size_t t = 0; t < n_dates; ++t) call(t, in.row(t), out.row(t));
+        return;
+    }
+    vector<float> buf_in(S), buf_out(S);
+    for (size_t t = 0; t < n_dates; ++t) {
+        auto src = in.cross_section(t);
+        for (size_t s = 0; s < S; ++s) buf_in[s] = src[s];
+        call(t, span<const float>(buf_in), span<float>(buf_out));
+        auto dst = out.cross_section(t);
+        for (size_t s = 0; s < S; ++s) dst[s] = buf_out[s];
+    }
+}
+
+// ====== Alpha101Utils 算子的 Panel 重载 ======
+// 每个算子提供两种形式：写入调用方 out 的 void 版（out 会按输入形状 reset），以及返回新 Panel 的版本。
+// 输出布局与输入相同。StockMajor 输入逐股票调用 span 算子；TimeMajor 输入走 Alpha101Simd.h 的
+// 跨股票 SIMD 内核（tm_<op>），一次推进全部股票的一个时间步。
+
+#define ALPHA101_PANEL_UNARY_OP(op, ParamT)                                                         \
+    inline void op(const Panel<float>& in, ParamT param, Panel<float>& out) {                       \
+        if (in.layout() == PanelLayout::TimeMajor) {                                                \
+            out.reset_like(in);                                                                     \
+            tm_##op(in.data(), in.stocks(), in.dates(), param, out.data());                         \
+            return;                                                                                 \
+        }                                                                                           \
+        for_each_series(in, out, [&](span<const float> x, span<float> y) { op(x, param, y); });    \
+    }                                                                                               \
+    inline Panel<float> op(const Panel<float>& in, ParamT param) {                                  \
+        Panel<float> out;                                                                           \
+        op(in, param, out);                                                                         \
+        return out;                                                                                 \
+    }
+
+ALPHA101_PANEL_UNARY_OP(ts_rank, int)
+ALPHA101_PANEL_UNARY_OP(product, int)
+ALPHA101_PANEL_UNARY_OP(ts_min, int)
+ALPHA101_PANEL_UNARY_OP(ts_max, int)
+ALPHA101_PANEL_UNARY_OP(delta, int)
+ALPHA101_PANEL_UNARY_OP(delay, int)
+ALPHA101_PANEL_UNARY_OP(ts_argmax, int)
+ALPHA101_PANEL_UNARY_OP(ts_argmin, int)
+
+#undef ALPHA101_PANEL_UNARY_OP
+
+// 每 window 步重新锚定滑动和式的算子：origin 为第 0 个日期的绝对日期，锚点按绝对日期对齐（见 span 版本）
+#define ALPHA101_PANEL_ANCHORED_OP(op)                                                              \
+    inline void op(const Panel<float>& in, int window, Panel<float>& out, size_t origin = 0) {      \
+        if (in.layout() == PanelLayout::TimeMajor) {                                                \
+            out.reset_like(in);                                                                     \
+            tm_##op(in.data(), in.stocks(), in.dates(), window, out.data(), origin);                \
+            return;                                                                                 \
+        }                                                                                           \
+        for_each_series(in, out, [&](span<const float> x, span<float> y) { op(x, window, y, origin); });\
+    }                                                                                               \
+    inline Panel<float> op(const Panel<float>& in, int window, size_t origin = 0) {                 \
+        Panel<float> out;                                                                           \
+        op(in, window, out, origin);                                                                \
+        return out;                                                                                 \
+    }
+
+ALPHA101_PANEL_ANCHORED_OP(rolling_ts_sum)
+ALPHA101_PANEL_ANCHORED_OP(rolling_sma)
+ALPHA101_PANEL_ANCHORED_OP(rolling_stddev)
+ALPHA101_PANEL_ANCHORED_OP(decay_linear)
+
+#undef ALPHA101_PANEL_ANCHORED_OP
+
+// 二阶矩同样每 window 步重新锚定，origin 同上
+#define ALPHA101_PANEL_BINARY_OP(op)                                                                   \
+    inline void op(const Panel<float>& a, const Panel<float>& b, int window, Panel<float>& out,        \
+                   size_t origin = 0) {                                                                \
+        if (a.layout() == PanelLayout::TimeMajor && b.layout() == PanelLayout::TimeMajor) {            \
+            out.reset_like(a);                                                                         \
+            tm_##op(a.data(), b.data(), a.stocks(), a.dates(), window, out.data(), origin);            \
+            return;                                                                                    \
+        }                                                                                              \
+        for_each_series(a, b, out, [&](span<const float> x, span<const float> y, span<float> z) {      \
+            op(x, y, window, z, origin);                                                               \
+        });                                                                                            \
+    }                                                                                                  \
+    inline Panel<float> op(const Panel<float>& a, const Panel<float>& b, int window, size_t origin = 0) {\
+        Panel<float> out;                                                                              \
+        op(a, b, window, out, origin);                                                                 \
+        return out;                                                                                    \
+    }
+
+ALPHA101_PANEL_BINARY_OP(rolling_correlation)
+ALPHA101_PANEL_BINARY_OP(rolling_covariance)
+
+#undef ALPHA101_PANEL_BINARY_OP
+
+// 截面百分位排名：逐日期对全部股票排名
+inline void alpha_rank(const Panel<float>& in, Panel<float>& out) {
+    vector<size_t> idx_buf;
+    idx_buf.reserve(in.stocks());
+    for_each_cross_section(in, out, [&](span<const float> x, span<float> y) { alpha_rank(x, y, idx_buf); });
+}
+
+inline Panel<float> alpha_rank(const Panel<float>& in) {
+    Panel<float> out;
+    alpha_rank(in, out);
+    return out;
+}
+
+// 截面缩放：逐日期使 sum(|x|) = k
+inline void scale(const Panel<float>& in, float k, Panel<float>& out) {
+    for_each_cross_section(in, out, [&](span<const float> x, span<float> y) { scale(x, k, y); });
+}
+
+inline Panel<float> scale(const Panel<float>& in, float k = 1.0f) {
+    Panel<float> out;
+    scale(in, k, out);
+    return out;
+}
+
+// ====== 分组分类与分组截面算子（IndNeutralize） ======
+
+/**
+ * @brief 随时间变化的分组分类（行业 / 板块 / 子行业），每个日期对应一个 GroupIndex
+ *
+ * 由 [S × T] 的整数编码面板构建：编码在构建时一次性映射为稠密组号，求值时只按组遍历，不再查表。
+ * 分类通常长期不变，相邻日期的编码完全相同时共用同一个 GroupIndex，只在变化点新建。
+ * 编码为负数或 NaN 的股票在该日期不属于任何组（分组算子输出 NaN）。
+ */
+class GroupPartition {
+   public:
+    GroupPartition() = default;
+    template <typename T>
+    explicit GroupPartition(const Panel<T>& codes) {
+        build(codes);
+    }
+
+    template <typename T>
+    void build(const Panel<T>& codes) {
+        S_ = codes.stocks();
+        T_ = codes.dates();
+        auto classified = [](T c) { return c == c && c >= 0; };  // NaN 或负数：未分类
+
+        // 第一遍：编码 → 稠密组号（只在构建时哈希）
+        unordered_map<int64_t, uint32_t> dense;
+        for (size_t i = 0; i < codes.size(); ++i)
+            if (classified(codes.data()[i])) dense.try_emplace((int64_t)codes.data()[i], (uint32_t)dense.size());
+        groups_ = dense.size();
+
+        // 第二遍：逐日期的稠密组号，与前一日期相同则共用同一段
+        segments_.clear();
+        segment_of_.assign(T_, 0);
+        vector<uint32_t> row(S_), prev;
+        for (size_t t = 0; t < T_; ++t) {
+            auto src = codes.cross_section(t);
+            for (size_t s = 0; s < S_; ++s) row[s] = classified(src[s]) ? dense.at((int64_t)src[s]) : GroupIndex::kNoGroup;
+            if (t > 0 && row == prev) {
+                segment_of_[t] = segment_of_[t - 1];
+                continue;
+            }
+            segment_of_[t] = (uint32_t)segments_.size();
+            segments_.emplace_back().build(row, groups_);
+            prev = row;
+        }
+    }
+
+    size_t stocks() const { return S_; }
+    size_t dates() const { return T_; }
+    size_t groups() const { return groups_; }
+    // 分类发生变化的次数 + 1（不同 GroupIndex 的个数）
+    size_t segments() const { return segments_.size(); }
+
+    const GroupIndex& at(size_t t) const { return segments_[segment_of_[t]]; }
+
+   private:
+    size_t S_ = 0, T_ = 0, groups_ = 0;
+    vector<GroupIndex> segments_;
+    vector<uint32_t> segment_of_;  // 日期 → 段
+};
+
+inline void check_group_shape(const char* op, const Panel<float>& in, const GroupPartition& groups) {
+    if (in.stocks() != groups.stocks() || in.dates() != groups.dates())
+        throw std::invalid_argument(string(op) + ": classification shape does not match the input panel");
+}
+
+// 组内去均值：IndNeutralize(x, IndClass.*)
+inline void group_demean(const Panel<float>& in, const GroupPartition& groups, Panel<float>& out) {
+    check_group_shape("group_demean", in, groups);
+    for_each_cross_section(in, out, [&](size_t t, span<const float> x, span<float> y) {
+        group_demean(x, groups.at(t), y);
+    });
+}
+
+inline Panel<float> group_demean(const Panel<float>& in, const GroupPartition& groups) {
+    Panel<float> out;
+    group_demean(in, groups, out);
+    return out;
+}
+
+// 组内截面百分位排名
+inline void group_rank(const Panel<float>& in, const GroupPartition& groups, Panel<float>& out) {
+    check_group_shape("group_rank", in, groups);
+    Workspace ws;
+    ws.reserve(in.stocks());
+    for_each_cross_section(in, out, [&](size_t t, span<const float> x, span<float> y) {
+        group_rank(x, groups.at(t), y, ws);
+    });
+}
+
+inline Panel<float> group_rank(const Panel<float>& in, const GroupPartition& groups) {
+    Panel<float> out;
+    group_rank(in, groups, out);
+    return out;
+}
+
+// 组内缩放：逐日期使每组 sum(|x|) = k
+inline void group_scale(const Panel<float>& in, const GroupPartition& groups, float k, Panel<float>& out) {
+    check_group_shape("group_scale", in, groups);
+    for_each_cross_section(in, out, [&](size_t t, span<const float> x, span<float> y) {
+        group_scale(x, groups.at(t), k, y);
+    });
+}
+
+inline Panel<float> group_scale(const Panel<float>& in, const GroupPartition& groups, float k = 1.0f) {
+    Panel<float> out;
+    group_scale(in, groups, k, out);
+    return out;
+}
+
+// ====== 派生输入字段（returns / vwap） ======
+
+/**
+ * @brief returns = close / delay(close, 1) - 1，首个日期为 NaN；输出布局与 close 相同
+ */
+inline void derive_returns(const Panel<float>& close, Panel<float>& returns) {
+    size_t S = close.stocks(), T = close.dates();
+    returns.reset(S, T, close.layout());
+    const float* c = close.data();
+    float* r = returns.data();
+    if (close.layout() == PanelLayout::TimeMajor) {
+        tm_fill_nan_rows(r, S, min<size_t>(1, T));
+        for (size_t i = S; i < S * T; ++i) r[i] = c[i] / c[i - S] - 1.0f;
+    } else {
+        for (size_t s = 0; s < S && T > 0; ++s) {
+            const float* x = c + s * T;
+            float* y = r + s * T;
+            y[0] = NAN;
+            for (size_t t = 1; t < T; ++t) y[t] = x[t] / x[t - 1] - 1.0f;
+        }
+    }
+}
+
+/**
+ * @brief 一次遍历同时派生 vwap 与 returns，输出布局与输入相同
+ *
+ * vwap：提供成交额 amount 时为 amount / volume（成交量为 0 时 NaN），否则以典型价
+ * (high + low + close) / 3 近似。returns 与 derive_returns 逐位一致。
+ * 全部输入必须形状与布局相同。
+ */
+inline void derive_vwap_returns(const Panel<float>& high, const Panel<float>& low, const Panel<float>& close,
+                                const Panel<float>& volume, const Panel<float>* amount, Panel<float>& vwap,
+                                Panel<float>& returns) {
+    size_t S = close.stocks(), T = close.dates();
+    PanelLayout layout = close.layout();
+    for (const Panel<float>* p : {&high, &low, &volume, amount}) {
+        if (p && (p->stocks() != S || p->dates() != T || p->layout() != layout))
+            throw std::invalid_argument("derive_vwap_returns: inputs must share shape and layout");
+    }
+    vwap.reset(S, T, layout);
+    returns.reset(S, T, layout);
+    const float *h = high.data(), *l = low.data(), *c = close.data(), *v = volume.data();
+    const float* a = amount ? amount->data() : nullptr;
+    float *w = vwap.data(), *r = returns.data();
+
+    // 连续区间 [i0, i1) 内逐元素计算；prev 为上一日期相对当前元素的偏移，0 表示首个日期
+    auto run = [&](size_t i0, size_t i1, size_t prev) {
+        if (a) {
+            for (size_t i = i0; i < i1; ++i) w[i] = v[i] > 0.0f ? a[i] / v[i] : NAN;
+        } else {
+            for (size_t i = i0; i < i1; ++i) w[i] = (h[i] + l[i] + c[i]) / 3.0f;
+        }
+        if (prev == 0) {
+            fill(r + i0, r + i1, NAN);
+        } else {
+            for (size_t i = i0; i < i1; ++i) r[i] = c[i] / c[i - prev] - 1.0f;
+        }
+    };
+    if (layout == PanelLayout::TimeMajor) {
+        for (size_t t = 0; t < T; ++t) run(t * S, (t + 1) * S, t ? S : 0);
+    } else {
+        for (size_t s = 0; s < S && T > 0; ++s) {
+            run(s * T, s * T + 1, 0);
+            run(s * T + 1, (s + 1) * T, 1);
+        }
+    }
+}
+
+#endif  // ALPHA101PANEL_H
@@ -0,0 +1,693 @@
+#ifndef ALPHA101SIMD_H
+#define ALPHA101SIMD_H
+
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+#if defined(__AVX512F__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+using namespace std;
+
+// ====== 跨股票 SIMD 时序内核（TimeMajor 布局） ======
+//
+// 单只股票的滑动循环每一步都依赖上一步，编译器无法向量化；
+// 这里反过来：S 只股票的滑动状态并排存放，外层按时间推进，内层一次处理一组 lane（8/16 只股票）。
+// 输入/输出均为 TimeMajor 连续内存：x[t*S + s]。每个内核的结果与对应的逐股票 span 算子语义一致
+// （热身期、NaN 规则、求和顺序相同）。
+//
+// lane 宽度由编译期指令集决定：AVX-512 → 16，AVX2 → 8，否则退化为标量；S 不整除时尾部走标量 lane。
+
+// 标量 lane：宽度 1，用于尾部处理以及无 SIMD 时的回退
+struct ScalarLanes {
+    static constexpr size_t width = 1;
+    using vec = float;
+    using mask = bool;
+
+    static vec load(const float* p) { return *p; }
+    static void store(float* p, vec v) { *p = v; }
+    static vec set1(float x) { return x; }
+    static vec add(vec a, vec b) { return a + b; }
+    static vec sub(vec a, vec b) { return a - b; }
+    static vec mul(vec a, vec b) { return a * b; }
+    static vec div(vec a, vec b) { return a / b; }
+    static vec sqrt(vec a) { return std::sqrt(a); }
+    // sqrt(max(a, 0))，a 为 NaN 时结果为 0（与 rolling_stddev 的 var > 0 ? var : 0 一致）
+    static vec sqrt0(vec a) { return std::sqrt(a > 0.0f ? a : 0.0f); }
+    static mask gt(vec a, vec b) { return a > b; }
+    static mask lt(vec a, vec b) { return a < b; }
+    static mask eq(vec a, vec b) { return a == b; }
+    static mask is_nan(vec a) { return a != a; }
+    static mask mask_or(mask a, mask b) { return a || b; }
+    static vec select(mask m, vec a, vec b) { return m ? a : b; }
+};
+
+#if defined(__AVX2__)
+struct Avx2Lanes {
+    static constexpr size_t width = 8;
+    using vec = __m256;
+    using mask = __m256;
+
+    static vec load(const float* p) { return _mm256_loadu_ps(p); }
+    static void store(float* p, vec v) { _mm256_storeu_ps(p, v); }
+    static vec set1(float x) { return _mm256_set1_ps(x); }
+    static vec add(vec a, vec b) { return _mm256_add_ps(a, b); }
+    static vec sub(vec a, vec b) { return _mm256_sub_ps(a, b); }
+    static vec mul(vec a, vec b) { return _mm256_mul_ps(a, b); }
+    static vec div(vec a, vec b) { return _mm256_div_ps(a, b); }
+    static vec sqrt(vec a) { return _mm256_sqrt_ps(a); }
+    // max_ps 在任一操作数为 NaN 时返回第二个操作数，即 0
+    static vec sqrt0(vec a) { return _mm256_sqrt_ps(_mm256_max_ps(a, _mm256_setzero_ps())); }
+    static mask gt(vec a, vec b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+    static mask lt(vec a, vec b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+    static mask eq(vec a, vec b) { return _mm256_cmp_ps(a, b, _CMP_EQ_OQ); }
+    static mask is_nan(vec a) { return _mm256_cmp_ps(a, a, _CMP_UNORD_Q); }
+    static mask mask_or(mask a, mask b) { return _mm256_or_ps(a, b); }
+    static vec select(mask m, vec a, vec b) { return _mm256_blendv_ps(b, a, m); }
+};
+#endif
+
+#if defined(__AVX512F__)
+struct Avx512Lanes {
+    static constexpr size_t width = 16;
+    using vec = __m512;
+    using mask = __mmask16;
+
+    static vec load(const float* p) { return _mm512_loadu_ps(p); }
+    static void store(float* p, vec v) { _mm512_storeu_ps(p, v); }
+    static vec set1(float x) { return _mm512_set1_ps(x); }
+    static vec add(vec a, vec b) { return _mm512_add_ps(a, b); }
+    static vec sub(vec a, vec b) { return _mm512_sub_ps(a, b); }
+    static vec mul(vec a, vec b) { return _mm512_mul_ps(a, b); }
+    static vec div(vec a, vec b) { return _mm512_div_ps(a, b); }
+    static vec sqrt(vec a) { return _mm512_sqrt_ps(a); }
+    static vec sqrt0(vec a) { return _mm512_sqrt_ps(_mm512_max_ps(a, _mm512_setzero_ps())); }
+    static mask gt(vec a, vec b) { return _mm512_cmp_ps_mask(a, b, _CMP_GT_OQ); }
+    static mask lt(vec a, vec b) { return _mm512_cmp_ps_mask(a, b, _CMP_LT_OQ); }
+    static mask eq(vec a, vec b) { return _mm512_cmp_ps_mask(a, b, _CMP_EQ_OQ); }
+    static mask is_nan(vec a) { return _mm512_cmp_ps_mask(a, a, _CMP_UNORD_Q); }
+    static mask mask_or(mask a, mask b) { return a | b; }
+    static vec select(mask m, vec a, vec b) { return _mm512_mask_blend_ps(m, b, a); }
+};
+using SimdLanes = Avx512Lanes;
+#elif defined(__AVX2__)
+using SimdLanes = Avx2Lanes;
+#else
+using SimdLanes = ScalarLanes;
+#endif
+
+// ---------- double lane：滑动状态需要 double 和式时使用（与逐股票 span 算子逐位一致） ----------
+//
+// 同一组 lane 操作的 double 版本，lane 宽度减半（AVX-512 → 8，AVX2 → 4）。
+// load_float / store_float 在 float 输入输出与 double 状态之间加宽、收窄（收窄按当前舍入模式，与 (float) 转换一致）。
+
+struct ScalarDoubleLanes {
+    static constexpr size_t width = 1;
+    using vec = double;
+    using mask = bool;
+
+    static vec load(const double* p) { return *p; }
+    static void store(double* p, vec v) { *p = v; }
+    static vec load_float(const float* p) { return *p; }
+    static void store_float(float* p, vec v) { *p = (float)v; }
+    static vec set1(double x) { return x; }
+    static vec add(vec a, vec b) { return a + b; }
+    static vec sub(vec a, vec b) { return a - b; }
+    static vec mul(vec a, vec b) { return a * b; }
+    static vec div(vec a, vec b) { return a / b; }
+    static vec sqrt(vec a) { return std::sqrt(a); }
+    static vec sqrt0(vec a) { return std::sqrt(a > 0.0 ? a : 0.0); }
+    static mask gt(vec a, vec b) { return a > b; }
+    static mask le(vec a, vec b) { return a <= b; }
+    static mask is_nan(vec a) { return a != a; }
+    static mask mask_or(mask a, mask b) { return a || b; }
+    static vec select(mask m, vec a, vec b) { return m ? a : b; }
+};
+
+#if defined(__AVX2__)
+struct Avx2DoubleLanes {
+    static constexpr size_t width = 4;
+    using vec = __m256d;
+    using mask = __m256d;
+
+    static vec load(const double* p) { return _mm256_loadu_pd(p); }
+    static void store(double* p, vec v) { _mm256_storeu_pd(p, v); }
+    static vec load_float(const float* p) { return _mm256_cvtps_pd(_mm_loadu_ps(p)); }
+    static void store_float(float* p, vec v) { _mm_storeu_ps(p, _mm256_cvtpd_ps(v)); }
+    static vec set1(double x) { return _mm256_set1_pd(x); }
+    static vec add(vec a, vec b) { return _mm256_add_pd(a, b); }
+    static vec sub(vec a, vec b) { return _mm256_sub_pd(a, b); }
+    static vec mul(vec a, vec b) { return _mm256_mul_pd(a, b); }
+    static vec div(vec a, vec b) { return _mm256_div_pd(a, b); }
+    static vec sqrt(vec a) { return _mm256_sqrt_pd(a); }
+    static vec sqrt0(vec a) { return _mm256_sqrt_pd(_mm256_max_pd(a, _mm256_setzero_pd())); }
+    static mask gt(vec a, vec b) { return _mm256_cmp_pd(a, b, _CMP_GT_OQ); }
+    static mask le(vec a, vec b) { return _mm256_cmp_pd(a, b, _CMP_LE_OQ); }
+    static mask is_nan(vec a) { return _mm256_cmp_pd(a, a, _CMP_UNORD_Q); }
+    static mask mask_or(mask a, mask b) { return _mm256_or_pd(a, b); }
+    static vec select(mask m, vec a, vec b) { return _mm256_blendv_pd(b, a, m); }
+};
+#endif
+
+#if defined(__AVX512F__)
+struct Avx512DoubleLanes {
+    static constexpr size_t width = 8;
+    using vec = __m512d;
+    using mask = __mmask8;
+
+    static vec load(const double* p) { return _mm512_loadu_pd(p); }
+    static void store(double* p, vec v) { _mm512_storeu_pd(p, v); }
+    static vec load_float(const float* p) { return _mm512_cvtps_pd(_mm256_loadu_ps(p)); }
+    static void store_float(float* p, vec v) { _mm256_storeu_ps(p, _mm512_cvtpd_ps(v)); }
+    static vec set1(double x) { return _mm512_set1_pd(x); }
+    static vec add(vec a, vec b) { return _mm512_add_pd(a, b); }
+    static vec sub(vec a, vec b) { return _mm512_sub_pd(a, b); }
+    static vec mul(vec a, vec b) { return _mm512_mul_pd(a, b); }
+    static vec div(vec a, vec b) { return _mm512_div_pd(a, b); }
+    static vec sqrt(vec a) { return _mm512_sqrt_pd(a); }
+    static vec sqrt0(vec a) { return _mm512_sqrt_pd(_mm512_max_pd(a, _mm512_setzero_pd())); }
+    static mask gt(vec a, vec b) { return _mm512_cmp_pd_mask(a, b, _CMP_GT_OQ); }
+    static mask le(vec a, vec b) { return _mm512_cmp_pd_mask(a, b, _CMP_LE_OQ); }
+    static mask is_nan(vec a) { return _mm512_cmp_pd_mask(a, a, _CMP_UNORD_Q); }
+    static mask mask_or(mask a, mask b) { return a | b; }
+    static vec select(mask m, vec a, vec b) { return _mm512_mask_blend_pd(m, b, a); }
+};
+using SimdDoubleLanes = Avx512DoubleLanes;
+#elif defined(__AVX2__)
+using SimdDoubleLanes = Avx2DoubleLanes;
+#else
+using SimdDoubleLanes = ScalarDoubleLanes;
+#endif
+
+/**
+ * @brief 以最宽 lane 扫过 [0, S)，尾部不足一组的股票用标量 lane
+ *
+ * fn 为泛型 lambda：[&]<typename L>(size_t s) { ... }，处理股票 [s, s + L::width)。
+ */
+template <typename Fn>
+inline void simd_sweep(size_t S, Fn&& fn) {
+    size_t s = 0;
+    for (; s + SimdLanes::width <= S; s += SimdLanes::width) fn.template operator()<SimdLanes>(s);
+    for (; s < S; ++s) fn.template operator()<ScalarLanes>(s);
+}
+
+// simd_sweep 的 double lane 版本：fn 处理股票 [s, s + L::width)，L 为 SimdDoubleLanes 或 ScalarDoubleLanes
+template <typename Fn>
+inline void simd_sweep_double(size_t S, Fn&& fn) {
+    size_t s = 0;
+    for (; s + SimdDoubleLanes::width <= S; s += SimdDoubleLanes::width) fn.template operator()<SimdDoubleLanes>(s);
+    for (; s < S; ++s) fn.template operator()<ScalarDoubleLanes>(s);
+}
+
+// 将 out 的前 rows 行（每行 S 个元素）置为 NaN，用于热身期
+inline void tm_fill_nan_rows(float* out, size_t S, size_t rows) {
+    fill(out, out + rows * S, NAN);
+}
+
+// ---------- 逐元素类 ----------
+
+inline void tm_delta(const float* in, size_t S, size_t T, int period, float* out) {
+    size_t p = period < 0 ? 0 : (size_t)period;
+    tm_fill_nan_rows(out, S, min(p, T));
+    for (size_t t = p; t < T; ++t) {
+        const float* x = in + t * S;
+        const float* x_old = in + (t - p) * S;
+        float* y = out + t * S;
+        simd_sweep(S, [&]<typename L>(size_t s) { L::store(y + s, L::sub(L::load(x + s), L::load(x_old + s))); });
+    }
+}
+
+inline void tm_delay(const float* in, size_t S, size_t T, int period, float* out) {
+    size_t p = period < 0 ? 0 : (size_t)period;
+    tm_fill_nan_rows(out, S, min(p, T));
+    if (T > p) copy(in, in + (T - p) * S, out + p * S);
+}
+
+// ---------- 窗口重算类（每步 O(window)，但每步整行向量化） ----------
+
+inline void tm_product(const float* in, size_t S, size_t T, int window, float* out) {
+    size_t w = window < 1 ? 1 : (size_t)window;
+    tm_fill_nan_rows(out, S, min(w - 1, T));
+    for (size_t t = w - 1; t < T; ++t) {
+        float* y = out + t * S;
+        simd_sweep(S, [&]<typename L>(size_t s) {
+            auto prod = L::set1(1.0f);
+            for (size_t j = t + 1 - w; j <= t; ++j) prod = L::mul(prod, L::load(in + j * S + s));
+            L::store(y + s, prod);
+        });
+    }
+}
+
+// 窗口内含 NaN 时输出 NaN；IsMax 选择 ts_max / ts_min
+template <bool IsMax>
+inline void tm_ts_extreme(const float* in, size_t S, size_t T, int window, float* out) {
+    size_t w = window < 1 ? 1 : (size_t)window;
+    tm_fill_nan_rows(out, S, min(w - 1, T));
+    for (size_t t = w - 1; t < T; ++t) {
+        float* y = out + t * S;
+        simd_sweep(S, [&]<typename L>(size_t s) {
+            auto best = L::load(in + t * S + s);
+            auto has_nan = L::is_nan(best);
+            for (size_t j = t + 1 - w; j < t; ++j) {
+                auto v = L::load(in + j * S + s);
+                has_nan = L::mask_or(has_nan, L::is_nan(v));
+                best = L::select(IsMax ? L::gt(v, best) : L::lt(v, best), v, best);
+            }
+            L::store(y + s, L::select(has_nan, L::set1(NAN), best));
+        });
+    }
+}
+
+inline void tm_ts_min(const float* in, size_t S, size_t T, int window, float* out) {
+    tm_ts_extreme<false>(in, S, T, window, out);
+}
+
+inline void tm_ts_max(const float* in, size_t S, size_t T, int window, float* out) {
+    tm_ts_extreme<true>(in, S, T, window, out);
+}
+
+// 窗口内位置（1 起，最旧为 1），相等时取最早出现者；窗口内含 NaN 时输出 NaN
+template <bool IsMax>
+inline void tm_ts_argextreme(const float* in, size_t S, size_t T, int window, float* out) {
+    size_t w = window < 1 ? 1 : (size_t)window;
+    tm_fill_nan_rows(out, S, min(w - 1, T));
+    for (size_t t = w - 1; t < T; ++t) {
+        const float* base = in + (t + 1 - w) * S;
+        float* y = out + t * S;
+        simd_sweep(S, [&]<typename L>(size_t s) {
+            auto best = L::load(base + s);
+            auto idx = L::set1(1.0f);
+            auto has_nan = L::is_nan(best);
+            for (size_t j = 1; j < w; ++j) {
+                auto v = L::load(base + j * S + s);
+                has_nan = L::mask_or(has_nan, L::is_nan(v));
+                auto better = IsMax ? L::gt(v, best) : L::lt(v, best);
+                best = L::select(better, v, best);
+                idx = L::select(better, L::set1((float)(j + 1)), idx);
+            }
+            L::store(y + s, L::select(has_nan, L::set1(NAN), idx));
+        });
+    }
+}
+
+inline void tm_ts_argmax(const float* in, size_t S, size_t T, int window, float* out) {
+    tm_ts_argextreme<true>(in, S, T, window, out);
+}
+
+inline void tm_ts_argmin(const float* in, size_t S, size_t T, int window, float* out) {
+    tm_ts_argextreme<false>(in, S, T, window, out);
+}
+
+// 平均名次 = 严格小于个数 + (相等个数 + 1) / 2
+inline void tm_ts_rank(const float* in, size_t S, size_t T, int window, float* out) {
+    size_t w = window < 1 ? 1 : (size_t)window;
+    tm_fill_nan_rows(out, S, min(w - 1, T));
+    for (size_t t = w - 1; t < T; ++t) {
+        float* y = out + t * S;
+        simd_sweep(S, [&]<typename L>(size_t s) {
+            auto last = L::load(in + t * S + s);
+            auto less = L::set1(0.0f), equal = L::set1(0.0f);
+            auto one = L::set1(1.0f), zero = L::set1(0.0f);
+            for (size_t j = t + 1 - w; j <= t; ++j) {
+                auto v = L::load(in + j * S + s);
+                less = L::add(less, L::select(L::lt(v, last), one, zero));
+                equal = L::add(equal, L::select(L::eq(v, last), one, zero));
+            }
+            auto r = L::add(L::add(L::add(less, less), one), equal);
+            L::store(y + s, L::div(r, L::set1(2.0f)));
+        });
+    }
+}
+
+// ---------- 滑动状态类（S 组运行状态并排，每步 O(1)） ----------
+
+/**
+ * @brief 跨股票滑动窗口和 / 均值：每只股票一个 double 和式与 NaN 计数，与 sliding_window_sum 逐位一致
+ *
+ * 运算顺序与单序列版本相同（加入新元素、移出旧元素，窗口起点为 window 的整数倍时从最旧到最新重算），
+ * 每步只在两行上做 O(S) 的工作。double 累加的内层循环交给编译器自动向量化。
+ * origin 为第 0 行的绝对日期，重算按绝对日期对齐（同 sliding_window_sum）。
+ */
+template <bool IsMean>
+inline void tm_sliding_window_sum(const float* in, size_t S, size_t T, int window, float* out, size_t origin = 0) {
+    size_t w = window < 1 ? 1 : (size_t)window;
+    tm_fill_nan_rows(out, S, min(w - 1, T));
+    if (T < w) return;
+    vector<double> sum(S);
+    vector<int> nan_count(S);
+    auto add = [&](const float* x) {
+        for (size_t s = 0; s < S; ++s) {
+            bool nan = isnan(x[s]);
+            sum[s] += nan ? 0.0 : (double)x[s];
+            nan_count[s] += nan;
+        }
+    };
+    auto remove = [&](const float* x) {
+        for (size_t s = 0; s < S; ++s) {
+            bool nan = isnan(x[s]);
+            sum[s] -= nan ? 0.0 : (double)x[s];
+            nan_count[s] -= nan;
+        }
+    };
+    for (size_t t = w - 1; t < T; ++t) {
+        size_t start = t + 1 - w;
+        if (start == 0 || (origin + start) % w == 0) {
+            fill(sum.begin(), sum.end(), 0.0);
+            fill(nan_count.begin(), nan_count.end(), 0);
+            for (size_t j = start; j <= t; ++j) add(in + j * S);
+        } else {
+            add(in + t * S);
+            remove(in + (start - 1) * S);
+        }
+        float* y = out + t * S;
+        for (size_t s = 0; s < S; ++s)
+            y[s] = nan_count[s] > 0 ? NAN : (float)(IsMean ? sum[s] / (int)w : sum[s]);
+    }
+}
+
+inline void tm_rolling_ts_sum(const float* in, size_t S, size_t T, int window, float* out, size_t origin = 0) {
+    tm_sliding_window_sum<false>(in, S, T, window, out, origin);
+}
+
+inline void tm_rolling_sma(const float* in, size_t S, size_t T, int window, float* out, size_t origin = 0) {
+    tm_sliding_window_sum<true>(in, S, T, window, out, origin);
+}
+
+// 与 decay_linear 相同的递推与重算时机（SlidingDecay）：每只股票一组 double 的 sum / weighted / NaN 计数。
+// origin 为第 0 行的绝对日期，重算按绝对日期对齐（同 decay_linear）
+inline void tm_decay_linear(const float* in, size_t S, size_t T, int period, float* out, size_t origin = 0) {
+    size_t p = period < 1 ? 1 : (size_t)period;
+    tm_fill_nan_rows(out, S, min(p - 1, T));
+    if (T < p) return;
+    vector<double> sum(S), weighted(S);
+    vector<int> nan_count(S);
+    double divisor = p * (p + 1.0) / 2.0;
+    for (size_t t = p - 1; t < T; ++t) {
+        size_t start = t + 1 - p;
+        if (start == 0 || (origin + start) % p == 0) {
+            fill(sum.begin(), sum.end(), 0.0);
+            fill(weighted.begin(), weighted.end(), 0.0);
+            fill(nan_count.begin(), nan_count.end(), 0);
+            for (size_t k = 0; k < p; ++k) {
+                const float* x = in + (start + k) * S;
+                for (size_t s = 0; s < S; ++s) {
+                    bool nan = isnan(x[s]);
+                    double v = nan ? 0.0 : (double)x[s];
+                    sum[s] += v;
+                    weighted[s] += (double)(k + 1) * v;
+                    nan_count[s] += nan;
+                }
+            }
+        } else {
+            const float* x_new = in + t * S;
+            const float* x_old = in + (start - 1) * S;
+            for (size_t s = 0; s < S; ++s) {
+                bool nan_new = isnan(x_new[s]), nan_old = isnan(x_old[s]);
+                double v_new = nan_new ? 0.0 : (double)x_new[s];
+                double v_old = nan_old ? 0.0 : (double)x_old[s];
+                weighted[s] += (double)p * v_new - sum[s];
+                sum[s] += v_new - v_old;
+                nan_count[s] += (int)nan_new - (int)nan_old;
+            }
+        }
+        float* y = out + t * S;
+        for (size_t s = 0; s < S; ++s) y[s] = nan_count[s] > 0 ? NAN : (float)(weighted[s] / divisor);
+    }
+}
+
+// 与 rolling_stddev（SlidingVariance）相同的锚点平移、double 和式、运算顺序与重新锚定时机，结果逐位一致。
+// 每只股票一组 double 运行状态并排存放，用 double lane 推进；NaN 以 0 增量参与（和式不变），只在 nan_count 中记数。
+// state 为调用方提供的运行状态存储（4·S 个 double），跨调用复用时零堆分配；origin 为第 0 行的绝对日期（同 rolling_stddev）
+inline void tm_rolling_stddev(const float* in, size_t S, size_t T, int window, float* out, vector<double>& state,
+                              size_t origin = 0) {
+    tm_fill_nan_rows(out, S, T);
+    if (window <= 1 || T < (size_t)window) return;
+    size_t w = (size_t)window;
+    double wd = (double)window, wm1 = (double)(window - 1);
+
+    state.resize(4 * S);
+    double* anchor = state.data();
+    double* sum = anchor + S;
+    double* sum_sq = sum + S;
+    double* nan_count = sum_sq + S;
+    auto accumulate = [&](const float* x, bool remove) {
+        simd_sweep_double(S, [&]<typename L>(size_t s) {
+            auto v = L::load_float(x + s);
+            auto nan = L::is_nan(v);
+            auto d = L::select(nan, L::set1(0.0), L::sub(v, L::load(&anchor[s])));
+            auto one = L::select(nan, L::set1(1.0), L::set1(0.0));
+            if (remove) {
+                L::store(&sum[s], L::sub(L::load(&sum[s]), d));
+                L::store(&sum_sq[s], L::sub(L::load(&sum_sq[s]), L::mul(d, d)));
+                L::store(&nan_count[s], L::sub(L::load(&nan_count[s]), one));
+            } else {
+                L::store(&sum[s], L::add(L::load(&sum[s]), d));
+                L::store(&sum_sq[s], L::add(L::load(&sum_sq[s]), L::mul(d, d)));
+                L::store(&nan_count[s], L::add(L::load(&nan_count[s]), one));
+            }
+        });
+    };
+    // 以窗口 [start, start + w) 的均值为新锚点，从头重算和式
+    auto rebuild = [&](size_t start) {
+        fill(sum, sum + S, 0.0);        // 暂存非 NaN 值之和
+        fill(sum_sq, sum_sq + S, 0.0);  // 暂存非 NaN 个数
+        for (size_t t = start; t < start + w; ++t) {
+            const float* x = in + t * S;
+            simd_sweep_double(S, [&]<typename L>(size_t s) {
+                auto v = L::load_float(x + s);
+                auto nan = L::is_nan(v);
+                L::store(&sum[s], L::add(L::load(&sum[s]), L::select(nan, L::set1(0.0), v)));
+                L::store(&sum_sq[s], L::add(L::load(&sum_sq[s]), L::select(nan, L::set1(0.0), L::set1(1.0))));
+            });
+        }
+        simd_sweep_double(S, [&]<typename L>(size_t s) {
+            auto valid = L::load(&sum_sq[s]);
+            auto mean = L::div(L::load(&sum[s]), valid);
+            L::store(&anchor[s], L::select(L::gt(valid, L::set1(0.0)), mean, L::set1(0.0)));
+        });
+        fill(sum, sum + S, 0.0);
+        fill(sum_sq, sum_sq + S, 0.0);
+        fill(nan_count, nan_count + S, 0.0);
+        for (size_t t = start; t < start + w; ++t) accumulate(in + t * S, false);
+    };
+    auto emit = [&](size_t t) {
+        float* y = out + t * S;
+        simd_sweep_double(S, [&]<typename L>(size_t s) {
+            auto su = L::load(&sum[s]);
+            auto var = L::div(L::sub(L::load(&sum_sq[s]), L::div(L::mul(su, su), L::set1(wd))), L::set1(wm1));
+            L::store_float(y + s, L::select(L::gt(L::load(&nan_count[s]), L::set1(0.0)), L::set1(NAN), L::sqrt0(var)));
+        });
+    };
+    for (size_t t = w - 1; t < T; ++t) {
+        size_t start = t + 1 - w;
+        if (start == 0 || (origin + start) % w == 0) {
+            rebuild(start);
+        } else {
+            accumulate(in + t * S, false);
+            accumulate(in + (start - 1) * S, true);
+        }
+        emit(t);
+    }
+}
+
+inline void tm_rolling_stddev(const float* in, size_t S, size_t T, int window, float* out, size_t origin = 0) {
+    vector<double> state;
+    tm_rolling_stddev(in, S, T, window, out, state, origin);
+}
+
+// ---------- 双输入 ----------
+
+/**
+ * @brief 跨股票滑动二阶矩：与 sliding_comoment 相同的锚点平移 double 和式、NaN 规则与重新锚定时机，逐位一致
+ *
+ * 每只股票一组运行状态（锚点 kx/ky，和式 Σdx、Σdy、Σdx²、Σdy²、Σdx·dy，NaN 计数）并排存放，用 double lane 推进：
+ * 非锚定步先移出旧点、再加入新点；任一侧为 NaN 的点以 0 增量参与，只在 nan_count 中记数。
+ * 窗口起点为 window 的整数倍时以当前窗口均值重新锚定并重算和式。相关系数的零方差判据同为
+ * ss <= Σd² · 1e-12（输出 NaN）。
+ *
+ * @tparam IsCorr true：SPD / sqrt(ss_a · ss_b)；false：SPD / (window - 1)
+ * @param origin  第 0 行的绝对日期，锚点按绝对日期对齐（同 sliding_comoment）
+ */
+template <bool IsCorr>
+inline void tm_rolling_comoment(const float* a, const float* b, size_t S, size_t T, int window, float* out,
+                                size_t origin = 0) {
+    if (window < 1 || T < (size_t)window) {
+        tm_fill_nan_rows(out, S, T);
+        return;
+    }
+    size_t w = (size_t)window;
+    tm_fill_nan_rows(out, S, w - 1);
+    double wd = (double)w;
+
+    vector<double> state(8 * S);
+    double* kx = state.data();
+    double* ky = kx + S;
+    double* sx = ky + S;
+    double* sy = sx + S;
+    double* sxx = sy + S;
+    double* syy = sxx + S;
+    double* sxy = syy + S;
+    double* nan_count = sxy + S;
+    // 以窗口 [start, start + w) 的均值为新锚点，从头重算和式
+    auto reanchor = [&](size_t start) {
+        fill(sx, sx + 6 * S, 0.0);  // sx、sy 暂存非 NaN 点的和，sxx 暂存非 NaN 点数
+        for (size_t j = start; j < start + w; ++j) {
+            const float* xa = a + j * S;
+            const float* xb = b + j * S;
+            simd_sweep_double(S, [&]<typename L>(size_t s) {
+                auto va = L::load_float(xa + s), vb = L::load_float(xb + s);
+                auto bad = L::mask_or(L::is_nan(va), L::is_nan(vb));
+                auto zero = L::set1(0.0);
+                L::store(&sx[s], L::add(L::load(&sx[s]), L::select(bad, zero, va)));
+                L::store(&sy[s], L::add(L::load(&sy[s]), L::select(bad, zero, vb)));
+                L::store(&sxx[s], L::add(L::load(&sxx[s]), L::select(bad, zero, L::set1(1.0))));
+            });
+        }
+        simd_sweep_double(S, [&]<typename L>(size_t s) {
+            auto valid = L::load(&sxx[s]);
+            auto has = L::gt(valid, L::set1(0.0));
+            L::store(&kx[s], L::select(has, L::div(L::load(&sx[s]), valid), L::set1(0.0)));
+            L::store(&ky[s], L::select(has, L::div(L::load(&sy[s]), valid), L::set1(0.0)));
+        });
+        fill(sx, sx + 6 * S, 0.0);
+    };
+    // 一步：remove_a/b 非空时先移出该行，add_a/b 非空时再加入该行，y 非空时写出输出行。
+    // 一只股票的整步在寄存器中完成，状态每步只读写一次
+    auto sweep = [&](const float* remove_a, const float* remove_b, const float* add_a, const float* add_b, float* y) {
+        simd_sweep_double(S, [&]<typename L>(size_t s) {
+            auto zero = L::set1(0.0), one = L::set1(1.0);
+            auto ax = L::load(&kx[s]), ay = L::load(&ky[s]);
+            auto cx = L::load(&sx[s]), cy = L::load(&sy[s]);
+            auto cxx = L::load(&sxx[s]), cyy = L::load(&syy[s]), cxy = L::load(&sxy[s]), cn = L::load(&nan_count[s]);
+            auto shift = [&](const float* pa, const float* pb, bool remove) {
+                auto va = L::load_float(pa + s), vb = L::load_float(pb + s);
+                auto bad = L::mask_or(L::is_nan(va), L::is_nan(vb));
+                auto dx = L::select(bad, zero, L::sub(va, ax));
+                auto dy = L::select(bad, zero, L::sub(vb, ay));
+                auto flag = L::select(bad, one, zero);
+                if (remove) {
+                    cx = L::sub(cx, dx);
+                    cy = L::sub(cy, dy);
+                    cxx = L::sub(cxx, L::mul(dx, dx));
+                    cyy = L::sub(cyy, L::mul(dy, dy));
+                    cxy = L::sub(cxy, L::mul(dx, dy));
+                    cn = L::sub(cn, flag);
+                } else {
+                    cx = L::add(cx, dx);
+                    cy = L::add(cy, dy);
+                    cxx = L::add(cxx, L::mul(dx, dx));
+                    cyy = L::add(cyy, L::mul(dy, dy));
+                    cxy = L::add(cxy, L::mul(dx, dy));
+                    cn = L::add(cn, flag);
+                }
+            };
+            if (remove_a) shift(remove_a, remove_b, true);
+            if (add_a) shift(add_a, add_b, false);
+            L::store(&sx[s], cx);
+            L::store(&sy[s], cy);
+            L::store(&sxx[s], cxx);
+            L::store(&syy[s], cyy);
+            L::store(&sxy[s], cxy);
+            L::store(&nan_count[s], cn);
+            if (!y) return;
+
+            auto n = L::set1(wd);
+            auto spd = L::sub(cxy, L::div(L::mul(cx, cy), n));
+            auto bad = L::gt(cn, zero);
+            if constexpr (IsCorr) {
+                auto ss_a = L::sub(cxx, L::div(L::mul(cx, cx), n));
+                auto ss_b = L::sub(cyy, L::div(L::mul(cy, cy), n));
+                auto flat = L::mask_or(L::le(ss_a, L::mul(cxx, L::set1(1e-12))), L::le(ss_b, L::mul(cyy, L::set1(1e-12))));
+                auto r = L::div(spd, L::sqrt(L::mul(ss_a, ss_b)));
+                L::store_float(y + s, L::select(L::mask_or(bad, flat), L::set1(NAN), r));
+            } else {
+                L::store_float(y + s, L::select(bad, L::set1(NAN), L::div(spd, L::set1(wd - 1.0))));
+            }
+        });
+    };
+    for (size_t t = w - 1; t < T; ++t) {
+        size_t start = t + 1 - w;
+        if (start == 0 || (origin + start) % w == 0) {
+            reanchor(start);
+            for (size_t j = start; j < t; ++j) sweep(nullptr, nullptr, a + j * S, b + j * S, nullptr);
+            sweep(nullptr, nullptr, a + t * S, b + t * S, out + t * S);
+        } else {
+            sweep(a + (start - 1) * S, b + (start - 1) * S, a + t * S, b + t * S, out + t * S);
+        }
+    }
+}
+
+inline void tm_rolling_correlation(const float* a, const float* b, size_t S, size_t T, int window, float* out,
+                                   size_t origin = 0) {
+    tm_rolling_comoment<true>(a, b, S, T, window, out, origin);
+}
+
+inline void tm_rolling_covariance(const float* a, const float* b, size_t S, size_t T, int window, float* out,
+                                  size_t origin = 0) {
+    tm_rolling_comoment<false>(a, b, S, T, window, out, origin);
+}
+
+// ====== 布局转换：分块转置 ======
+//
+// 时序阶段（逐股票）与截面阶段（逐日期）之间的切换点需要在 [股票][时间] 与 [时间][股票] 之间搬运数据。
+// 逐元素的跨步写入在 S、T 较大时每个元素都落在不同的缓存行/页上；分块后读写两侧都只涉及
+// 一个 kTransposeTile × kTransposeTile 的小块，块内 AVX2 下以 8×8 寄存器转置完成。
+
+constexpr size_t kTransposeTile = 32;
+
+#if defined(__AVX2__)
+// 8×8 寄存器转置：dst[c * dst_stride + r] = src[r * src_stride + c]，r, c < 8
+inline void transpose8x8(const float* src, size_t src_stride, float* dst, size_t dst_stride) {
+    __m256 r0 = _mm256_loadu_ps(src + 0 * src_stride), r1 = _mm256_loadu_ps(src + 1 * src_stride);
+    __m256 r2 = _mm256_loadu_ps(src + 2 * src_stride), r3 = _mm256_loadu_ps(src + 3 * src_stride);
+    __m256 r4 = _mm256_loadu_ps(src + 4 * src_stride), r5 = _mm256_loadu_ps(src + 5 * src_stride);
+    __m256 r6 = _mm256_loadu_ps(src + 6 * src_stride), r7 = _mm256_loadu_ps(src + 7 * src_stride);
+    // 两两交错 → 每 128 位内的 4×4 转置 → 交换 128 位半边
+    __m256 t0 = _mm256_unpacklo_ps(r0, r1), t1 = _mm256_unpackhi_ps(r0, r1);
+    __m256 t2 = _mm256_unpacklo_ps(r2, r3), t3 = _mm256_unpackhi_ps(r2, r3);
+    __m256 t4 = _mm256_unpacklo_ps(r4, r5), t5 = _mm256_unpackhi_ps(r4, r5);
+    __m256 t6 = _mm256_unpacklo_ps(r6, r7), t7 = _mm256_unpackhi_ps(r6, r7);
+    __m256 u0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0)), u1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+    __m256 u2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0)), u3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+    __m256 u4 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(1, 0, 1, 0)), u5 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(3, 2, 3, 2));
+    __m256 u6 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(1, 0, 1, 0)), u7 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(3, 2, 3, 2));
+    _mm256_storeu_ps(dst + 0 * dst_stride, _mm256_permute2f128_ps(u0, u4, 0x20));
+    _mm256_storeu_ps(dst + 1 * dst_stride, _mm256_permute2f128_ps(u1, u5, 0x20));
+    _mm256_storeu_ps(dst + 2 * dst_stride, _mm256_permute2f128_ps(u2, u6, 0x20));
+    _mm256_storeu_ps(dst + 3 * dst_stride, _mm256_permute2f128_ps(u3, u7, 0x20));
+    _mm256_storeu_ps(dst + 4 * dst_stride, _mm256_permute2f128_ps(u0, u4, 0x31));
+    _mm256_storeu_ps(dst + 5 * dst_stride, _mm256_permute2f128_ps(u1, u5, 0x31));
+    _mm256_storeu_ps(dst + 6 * dst_stride, _mm256_permute2f128_ps(u2, u6, 0x31));
+    _mm256_storeu_ps(dst + 7 * dst_stride, _mm256_permute2f128_ps(u3, u7, 0x31));
+}
+#endif
+
+/**
+ * @brief 分块转置：dst[c * dst_stride + r] = src[r * src_stride + c]，0 ≤ r < rows，0 ≤ c < cols
+ *
+ * 步长独立于 rows/cols，可把一个子矩阵写进更大矩阵的一列块（如 S×T 面板中的 [s0, s0 + rows) 列）。
+ * 纯数据搬运，结果与逐元素拷贝逐位相同；src 与 dst 不得重叠。
+ */
+inline void transpose(const float* src, size_t rows, size_t cols, size_t src_stride, float* dst, size_t dst_stride) {
+    for (size_t r0 = 0; r0 < rows; r0 += kTransposeTile) {
+        size_t r1 = min(rows, r0 + kTransposeTile);
+        for (size_t c0 = 0; c0 < cols; c0 += kTransposeTile) {
+            size_t c1 = min(cols, c0 + kTransposeTile);
+            size_t r = r0;
+#if defined(__AVX2__)
+            for (; r + 8 <= r1; r += 8) {
+                size_t c = c0;
+                for (; c + 8 <= c1; c += 8) transpose8x8(src + r * src_stride + c, src_stride, dst + c * dst_stride + r, dst_stride);
+                for (; c < c1; ++c)
+                    for (size_t i = r; i < r + 8; ++i) dst[c * dst_stride + i] = src[i * src_stride + c];
+            }
+#endif
+            for (; r < r1; ++r)
+                for (size_t c = c0; c < c1; ++c) dst[c * dst_stride + r] = src[r * src_stride + c];
+        }
+    }
+}
+
+#endif  // ALPHA101SIMD_H
@@ -0,0 +1,851 @@
+#ifndef ALPHA101STORE_H
+#define ALPHA101STORE_H
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define ALPHA101_HAVE_MMAP 1
+#endif
+
+#include "Alpha101Expr.h"
+#include "Alpha101Panel.h"
+
+using namespace std;
+
+static_assert(std::endian::native == std::endian::little, "Alpha101Store: file formats are little-endian");
+
+// ====== 列式面板文件：头部 + 按页对齐的连续列，mmap 后零拷贝交给 Panel ======
+//
+// 文件布局（小端序）：
+//   [0, 64)                 PanelFileHeader：魔数、版本、布局、S、T、字段数
+//   [64, 64 + 64 * fields)  PanelFileColumn × fields：字段名、数据类型、列的文件偏移
+//   之后按 kPanelFilePage 对齐的各列：每列为一个完整的 [S × T] 面板，按文件头的布局连续存放
+//
+// 列的起点对齐到页，mmap 后直接满足 Panel 的 64 字节对齐，整列即一个零拷贝 Panel 视图。
+
+constexpr size_t kPanelFilePage = 4096;
+constexpr char kPanelFileMagic[8] = {'A', '1', '0', '1', 'P', 'N', 'L', '\0'};
+constexpr uint32_t kPanelFileVersion = 1;
+
+enum class PanelDType : uint32_t { Float32 = 1, Int32 = 2 };
+
+template <typename T>
+constexpr PanelDType panel_dtype() {
+    static_assert(std::is_same_v<T, float> || std::is_same_v<T, int32_t>, "PanelFile: unsupported element type");
+    return std::is_same_v<T, float> ? PanelDType::Float32 : PanelDType::Int32;
+}
+
+struct PanelFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t layout;  // 0 = StockMajor，1 = TimeMajor
+    uint64_t stocks;
+    uint64_t dates;
+    uint32_t fields;
+    uint32_t page;
+    uint64_t reserved[3];
+};
+
+struct PanelFileColumn {
+    char name[48];  // 以 '\0' 结尾
+    uint32_t dtype;
+    uint32_t reserved;
+    uint64_t offset;  // 列在文件中的起点，kPanelFilePage 的整数倍
+};
+
+static_assert(sizeof(PanelFileHeader) == 64 && sizeof(PanelFileColumn) == 64);
+
+inline size_t align_to_page(size_t n) { return (n + kPanelFilePage - 1) / kPanelFilePage * kPanelFilePage; }
+
+/**
+ * @brief 待写出的一列：字段名 + 面板（float 或 int32 编码，如分类字段）
+ */
+struct PanelColumn {
+    string name;
+    PanelDType dtype;
+    const void* data;
+    size_t stocks, dates;
+    PanelLayout layout;
+
+    PanelColumn(string n, const Panel<float>& p)
+        : name(std::move(n)), dtype(PanelDType::Float32), data(p.data()), stocks(p.stocks()), dates(p.dates()),
+          layout(p.layout()) {}
+    PanelColumn(string n, const Panel<int32_t>& p)
+        : name(std::move(n)), dtype(PanelDType::Int32), data(p.data()), stocks(p.stocks()), dates(p.dates()),
+          layout(p.layout()) {}
+};
+
+// 所有列形状相同，字段名为 1 到 name_capacity - 1 字节且互不相同
+inline void check_columns(const char* fn, const vector<PanelColumn>& columns, size_t name_capacity) {
+    for (size_t i = 0; i < columns.size(); ++i) {
+        const PanelColumn& c = columns[i];
+        if (c.stocks != columns[0].stocks || c.dates != columns[0].dates)
+            throw std::invalid_argument(string(fn) + ": column '" + c.name + "' has a different shape");
+        if (c.name.empty() || c.name.size() >= name_capacity)
+            throw std::invalid_argument(string(fn) + ": column name '" + c.name + "' is empty or too long");
+        for (size_t j = 0; j < i; ++j)
+            if (columns[j].name == c.name) throw std::invalid_argument(string(fn) + ": duplicate column '" + c.name + "'");
+    }
+}
+
+/**
+ * @brief 写出列式面板文件
+ *
+ * 全部列形状必须相同；与 layout 不同布局的列在写出时转换。字段名为 1 到 47 字节且互不相同。
+ *
+ * 用法：
+ *   write_panel_file("ohlcv.a101", {{"open", open}, {"close", close}, {"industry", industry_codes}});
+ */
+inline void write_panel_file(const string& path, const vector<PanelColumn>& columns,
+                             PanelLayout layout = PanelLayout::TimeMajor) {
+    check_columns("write_panel_file", columns, sizeof(PanelFileColumn::name));
+    size_t S = columns.empty() ? 0 : columns[0].stocks;
+    size_t n_dates = columns.empty() ? 0 : columns[0].dates;
+    PanelFileHeader header{};
+    memcpy(header.magic, kPanelFileMagic, sizeof(header.magic));
+    header.version = kPanelFileVersion;
+    header.layout = layout == PanelLayout::TimeMajor ? 1 : 0;
+    header.stocks = S;
+    header.dates = n_dates;
+    header.fields = (uint32_t)columns.size();
+    header.page = kPanelFilePage;
+
+    size_t column_bytes = S * n_dates * sizeof(uint32_t);  // 两种数据类型均为 4 字节
+    size_t offset = align_to_page(sizeof(PanelFileHeader) + columns.size() * sizeof(PanelFileColumn));
+    vector<PanelFileColumn> table(columns.size());
+    for (size_t i = 0; i < columns.size(); ++i) {
+        const PanelColumn& c = columns[i];
+        memcpy(table[i].name, c.name.data(), c.name.size());
+        table[i].dtype = (uint32_t)c.dtype;
+        table[i].offset = offset;
+        offset += align_to_page(column_bytes);
+    }
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) throw std::runtime_error("write_panel_file: cannot open '" + path + "' for writing");
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(table.data()), table.size() * sizeof(PanelFileColumn));
+
+    vector<char> zeros(kPanelFilePage, 0);
+    auto pad_to = [&](size_t pos) {
+        size_t cur = (size_t)out.tellp();
+        if (pos > cur) out.write(zeros.data(), pos - cur);
+    };
+    vector<uint32_t> converted;
+    for (size_t i = 0; i < columns.size(); ++i) {
+        pad_to(table[i].offset);
+        const PanelColumn& c = columns[i];
+        const void* src = c.data;
+        if (c.layout != layout) {
+            // 按 4 字节元素转换布局（与元素类型无关）
+            const uint32_t* in = static_cast<const uint32_t*>(c.data);
+            converted.resize(S * n_dates);
+            for (size_t st = 0; st < S; ++st)
+                for (size_t t = 0; t < n_dates; ++t) {
+                    size_t from = c.layout == PanelLayout::StockMajor ? st * n_dates + t : t * S + st;
+                    size_t to = layout == PanelLayout::StockMajor ? st * n_dates + t : t * S + st;
+                    converted[to] = in[from];
+                }
+            src = converted.data();
+        }
+        out.write(static_cast<const char*>(src), column_bytes);
+    }
+    if (!columns.empty()) pad_to(table.back().offset + align_to_page(column_bytes));
+    if (!out) throw std::runtime_error("write_panel_file: write to '" + path + "' failed");
+}
+
+/**
+ * @brief 只读打开的文件映像：POSIX 下为 mmap（MAP_PRIVATE），否则整体读入内存
+ *
+ * 映射以 PROT_READ | PROT_WRITE + MAP_PRIVATE 建立：视图可按普通 Panel 使用，
+ * 意外写入只产生进程私有的页副本，不会写回文件。
+ */
+class FileMapping {
+   public:
+    explicit FileMapping(const string& path) {
+#ifdef ALPHA101_HAVE_MMAP
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) throw std::runtime_error("FileMapping: cannot open '" + path + "'");
+        struct stat st;
+        if (::fstat(fd, &st) != 0) {
+            ::close(fd);
+            throw std::runtime_error("FileMapping: cannot stat '" + path + "'");
+        }
+        size_ = (size_t)st.st_size;
+        if (size_ > 0) {
+            void* p = ::mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+            if (p == MAP_FAILED) {
+                ::close(fd);
+                throw std::runtime_error("FileMapping: mmap of '" + path + "' failed");
+            }
+            data_ = static_cast<char*>(p);
+        }
+        ::close(fd);  // 映射建立后不再需要文件描述符
+#else
+        std::ifstream in(path, std::ios::binary | std::ios::ate);
+        if (!in) throw std::runtime_error("FileMapping: cannot open '" + path + "'");
+        size_ = (size_t)in.tellg();
+        buffer_ = Panel<char>(1, size_);
+        in.seekg(0);
+        in.read(buffer_.data(), size_);
+        data_ = buffer_.data();
+#endif
+    }
+
+    FileMapping(const FileMapping&) = delete;
+    FileMapping& operator=(const FileMapping&) = delete;
+
+    ~FileMapping() {
+#ifdef ALPHA101_HAVE_MMAP
+        if (data_) ::munmap(data_, size_);
+#endif
+    }
+
+    char* data() const { return data_; }
+    size_t size() const { return size_; }
+
+    // 访问模式提示：即将顺序读取 [offset, offset + bytes)
+    void advise_sequential(size_t offset, size_t bytes) const {
+#ifdef ALPHA101_HAVE_MMAP
+        if (!data_ || bytes == 0) return;
+        size_t page = (size_t)::sysconf(_SC_PAGESIZE);
+        size_t begin = offset / page * page;
+        ::madvise(data_ + begin, offset + bytes - begin, MADV_SEQUENTIAL);
+        ::madvise(data_ + begin, offset + bytes - begin, MADV_WILLNEED);
+#else
+        (void)offset;
+        (void)bytes;
+#endif
+    }
+
+   private:
+    char* data_ = nullptr;
+    size_t size_ = 0;
+#ifndef ALPHA101_HAVE_MMAP
+    Panel<char> buffer_;
+#endif
+};
+
+/**
+ * @brief 列式面板文件的读取端：打开时只解析头部，列以零拷贝 Panel 视图交出
+ *
+ * 视图持有映射的所有权（Panel::view 的 keepalive），PanelFile 本身析构后视图仍然有效。
+ * 按需访问的列在交出时提示内核顺序预读；未访问的列不会被读入内存。
+ *
+ * 用法：
+ *   PanelFile file("ohlcv.a101");
+ *   Panel<float> close = file.panel("close");                 // 整列
+ *   Panel<float> recent = file.panel("close", T - 252, T);   // TimeMajor 文件：最近 252 个日期，仍为零拷贝
+ */
+class PanelFile {
+   public:
+    explicit PanelFile(const string& path) : path_(path), mapping_(make_shared<FileMapping>(path)) {
+        if (mapping_->size() < sizeof(PanelFileHeader)) fail("file is too small");
+        memcpy(&header_, mapping_->data(), sizeof(header_));
+        if (memcmp(header_.magic, kPanelFileMagic, sizeof(kPanelFileMagic)) != 0) fail("bad magic");
+        if (header_.version != kPanelFileVersion) fail("unsupported version " + to_string(header_.version));
+        if (header_.layout > 1) fail("bad layout");
+        size_t table_end = sizeof(PanelFileHeader) + (size_t)header_.fields * sizeof(PanelFileColumn);
+        if (mapping_->size() < table_end) fail("truncated column table");
+
+        columns_.resize(header_.fields);
+        memcpy(columns_.data(), mapping_->data() + sizeof(PanelFileHeader), columns_.size() * sizeof(PanelFileColumn));
+        for (size_t i = 0; i < columns_.size(); ++i) {
+            const PanelFileColumn& c = columns_[i];
+            string name(c.name, strnlen(c.name, sizeof(c.name)));
+            if (c.offset % kPanelFilePage != 0 || c.offset + column_bytes(c) > mapping_->size())
+                fail("column '" + name + "' lies outside the file");
+            index_.emplace(name, i);
+            names_.push_back(std::move(name));
+        }
+    }
+
+    size_t stocks() const { return header_.stocks; }
+    size_t dates() const { return header_.dates; }
+    PanelLayout layout() const { return header_.layout ? PanelLayout::TimeMajor : PanelLayout::StockMajor; }
+    const vector<string>& fields() const { return names_; }
+    bool has(const string& name) const { return index_.count(name) > 0; }
+
+    /**
+     * @brief 字段 name 在日期 [d_begin, d_end) 上的面板
+     *
+     * 整列，或 TimeMajor 文件中的任意日期区间，都是映射内存上的零拷贝视图；
+     * StockMajor 文件的部分日期区间不连续，复制为新的 StockMajor 面板。
+     */
+    template <typename T = float>
+    Panel<T> panel(const string& name, size_t d_begin = 0, size_t d_end = SIZE_MAX) const {
+        const PanelFileColumn& c = column(name);
+        if (c.dtype != (uint32_t)panel_dtype<T>()) fail("column '" + name + "' has a different dtype");
+        size_t S = stocks(), n_dates = dates();
+        d_end = std::min(d_end, n_dates);
+        if (d_begin > d_end) fail("date range out of bounds");
+        T* base = reinterpret_cast<T*>(mapping_->data() + c.offset);
+        if (layout() == PanelLayout::TimeMajor || (d_begin == 0 && d_end == n_dates)) {
+            size_t first = layout() == PanelLayout::TimeMajor ? d_begin * S : 0;
+            size_t count = layout() == PanelLayout::TimeMajor ? (d_end - d_begin) * S : S * n_dates;
+            mapping_->advise_sequential(c.offset + first * sizeof(T), count * sizeof(T));
+            return Panel<T>::view(base + first, S, d_end - d_begin, layout(), mapping_);
+        }
+        mapping_->advise_sequential(c.offset, S * n_dates * sizeof(T));
+        return slice_dates(Panel<T>::view(base, S, n_dates, layout(), mapping_), d_begin, d_end, layout());
+    }
+
+   private:
+    const PanelFileColumn& column(const string& name) const {
+        auto it = index_.find(name);
+        if (it == index_.end()) fail("no column '" + name + "'");
+        return columns_[it->second];
+    }
+
+    size_t column_bytes(const PanelFileColumn& c) const {
+        size_t elem = c.dtype == (uint32_t)PanelDType::Float32 || c.dtype == (uint32_t)PanelDType::Int32 ? 4 : 0;
+        if (elem == 0) fail("unknown dtype " + to_string(c.dtype));
+        return (size_t)header_.stocks * header_.dates * elem;
+    }
+
+    [[noreturn]] void fail(const string& what) const {
+        throw std::invalid_argument("PanelFile '" + path_ + "': " + what);
+    }
+
+    string path_;
+    shared_ptr<FileMapping> mapping_;
+    PanelFileHeader header_{};
+    vector<PanelFileColumn> columns_;
+    vector<string> names_;
+    unordered_map<string, size_t> index_;
+};
+
+// ====== 因子库：按 (alpha, 日期块) 分列、字节重排 + 游程压缩，带定长块索引 ======
+//
+// 文件布局（小端序）：
+//   [0, 64)                    FactorFileHeader：魔数、版本、块长、S、T、alpha 数、索引偏移
+//   数据区                     按日期块、块内按 alpha 顺序排列的压缩块
+//   [index_offset, ...)        FactorFileAlpha × alphas，之后 FactorFileBlock × (alphas × blocks)
+//
+// 文件只增不改：追加在文件尾写出重新编码的最后一个日期块、新日期块与新索引，落盘后只改写 64 字节的文件头。
+// 被替换的旧尾块与旧索引留作死区（每次追加至多一个日期块加一份索引），write_factor_store 重新写出时回收。
+//
+// 每块是一个 alpha 在 block_dates 个日期上的 TimeMajor [日期 × S] 子面板。块内先做字节重排
+// （byte-shuffle：把 4 字节元素拆成 4 个字节平面，符号/指数平面高度重复），再按 PackBits 游程编码；
+// 压缩后不更小的块原样存储。索引定长：(alpha a, 日期 d, 股票 s) 所在块为 a * blocks + d / block_dates，
+// 解码后位于块内 (d % block_dates) * S + s，读取任意日期区间只解码与之相交的块。
+
+constexpr char kFactorFileMagic[8] = {'A', '1', '0', '1', 'F', 'A', 'C', '\0'};
+constexpr uint32_t kFactorFileVersion = 1;
+constexpr size_t kFactorBlockDates = 64;
+
+enum class FactorCodec : uint32_t { Raw = 0, ShuffleRle = 1 };
+
+struct FactorFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t block_dates;
+    uint64_t stocks;
+    uint64_t dates;
+    uint32_t alphas;
+    uint32_t reserved0;
+    uint64_t index_offset;
+    uint64_t reserved[2];
+};
+
+struct FactorFileAlpha {
+    char name[48];  // 以 '\0' 结尾
+    uint32_t dtype;
+    uint32_t reserved0;
+    uint64_t reserved;
+};
+
+struct FactorFileBlock {
+    uint64_t offset;
+    uint32_t bytes;
+    uint32_t codec;
+};
+
+static_assert(sizeof(FactorFileHeader) == 64 && sizeof(FactorFileAlpha) == 64 && sizeof(FactorFileBlock) == 16);
+
+// 4 字节元素拆成字节平面：out[k * n + i] 为 in[i] 的第 k 个字节
+inline void byte_shuffle(const uint32_t* in, size_t n, uint8_t* out) {
+    for (size_t i = 0; i < n; ++i) {
+        uint32_t v = in[i];
+        out[i] = (uint8_t)v;
+        out[n + i] = (uint8_t)(v >> 8);
+        out[2 * n + i] = (uint8_t)(v >> 16);
+        out[3 * n + i] = (uint8_t)(v >> 24);
+    }
+}
+
+inline void byte_unshuffle(const uint8_t* in, size_t n, uint32_t* out) {
+    for (size_t i = 0; i < n; ++i)
+        out[i] = (uint32_t)in[i] | (uint32_t)in[n + i] << 8 | (uint32_t)in[2 * n + i] << 16 | (uint32_t)in[3 * n + i] << 24;
+}
+
+/**
+ * @brief PackBits 游程编码，追加到 out
+ *
+ * 控制字节 c < 128：其后 c + 1 个字面字节；c >= 128：其后一个字节重复 c - 125 次（3..130）。
+ * 最坏情况每 128 字节多 1 个控制字节。
+ */
+inline void rle_encode(const uint8_t* in, size_t n, vector<uint8_t>& out) {
+    size_t i = 0;
+    while (i < n) {
+        size_t run = 1;
+        while (i + run < n && run < 130 && in[i + run] == in[i]) ++run;
+        if (run >= 3) {
+            out.push_back((uint8_t)(run + 125));
+            out.push_back(in[i]);
+            i += run;
+            continue;
+        }
+        // 字面段：延伸到下一个长度 >= 3 的游程之前，最多 128 字节
+        size_t lit = 0;
+        while (i + lit < n && lit < 128) {
+            if (i + lit + 2 < n && in[i + lit] == in[i + lit + 1] && in[i + lit] == in[i + lit + 2]) break;
+            ++lit;
+        }
+        out.push_back((uint8_t)(lit - 1));
+        out.insert(out.end(), in + i, in + i + lit);
+        i += lit;
+    }
+}
+
+// 解码恰好 n 个字节；输入损坏（越界或长度不符）时返回 false
+inline bool rle_decode(const uint8_t* in, size_t bytes, uint8_t* out, size_t n) {
+    size_t i = 0, o = 0;
+    while (i < bytes) {
+        uint8_t c = in[i++];
+        if (c < 128) {
+            size_t lit = (size_t)c + 1;
+            if (i + lit > bytes || o + lit > n) return false;
+            memcpy(out + o, in + i, lit);
+            i += lit;
+            o += lit;
+        } else {
+            size_t run = (size_t)c - 125;
+            if (i >= bytes || o + run > n) return false;
+            memset(out + o, in[i++], run);
+            o += run;
+        }
+    }
+    return o == n;
+}
+
+// 取出列在日期 [d0, d1) 上的 TimeMajor 行（按 4 字节元素，与元素类型无关）
+inline void copy_time_major_rows(const PanelColumn& c, size_t d0, size_t d1, uint32_t* rows) {
+    const uint32_t* in = static_cast<const uint32_t*>(c.data);
+    size_t S = c.stocks;
+    if (c.layout == PanelLayout::TimeMajor) {
+        memcpy(rows, in + d0 * S, (d1 - d0) * S * sizeof(uint32_t));
+        return;
+    }
+    for (size_t st = 0; st < S; ++st)
+        for (size_t t = d0; t < d1; ++t) rows[(t - d0) * S + st] = in[st * c.dates + t];
+}
+
+// 压缩并写出一个块（n 个 TimeMajor 元素），offset 前进到块尾；planes / packed 为暂存区
+inline FactorFileBlock write_factor_block(std::ostream& out, const uint32_t* rows, size_t n, uint64_t& offset,
+                                          vector<uint8_t>& planes, vector<uint8_t>& packed) {
+    planes.resize(n * sizeof(uint32_t));
+    byte_shuffle(rows, n, planes.data());
+    packed.clear();
+    rle_encode(planes.data(), planes.size(), packed);
+
+    FactorFileBlock blk{};
+    blk.offset = offset;
+    if (packed.size() < planes.size()) {
+        blk.codec = (uint32_t)FactorCodec::ShuffleRle;
+        blk.bytes = (uint32_t)packed.size();
+        out.write(reinterpret_cast<const char*>(packed.data()), packed.size());
+    } else {
+        blk.codec = (uint32_t)FactorCodec::Raw;
+        blk.bytes = (uint32_t)planes.size();
+        out.write(reinterpret_cast<const char*>(rows), blk.bytes);
+    }
+    offset += blk.bytes;
+    return blk;
+}
+
+// 在 header.index_offset 处写出 alpha 表与块索引
+inline void write_factor_index(std::ostream& out, const FactorFileHeader& header, const vector<FactorFileAlpha>& table,
+                               const vector<FactorFileBlock>& blocks) {
+    out.seekp((std::streamoff)header.index_offset);
+    out.write(reinterpret_cast<const char*>(table.data()), table.size() * sizeof(FactorFileAlpha));
+    out.write(reinterpret_cast<const char*>(blocks.data()), blocks.size() * sizeof(FactorFileBlock));
+}
+
+// 回填文件头（魔数、版本、alpha 数由此填写）：索引写完之后调用，文件头指向的索引才是完整的
+inline void write_factor_header(std::ostream& out, FactorFileHeader header, size_t alphas) {
+    memcpy(header.magic, kFactorFileMagic, sizeof(header.magic));
+    header.version = kFactorFileVersion;
+    header.alphas = (uint32_t)alphas;
+    out.seekp(0);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+}
+
+// 把文件内容刷到磁盘（fsync）；没有 POSIX 接口的平台依赖关闭文件时的刷新
+inline void sync_file(const string& path) {
+#ifdef ALPHA101_HAVE_MMAP
+    int fd = ::open(path.c_str(), O_RDWR);
+    if (fd < 0) throw std::runtime_error("sync_file: cannot open '" + path + "'");
+    int rc = ::fsync(fd);
+    ::close(fd);
+    if (rc != 0) throw std::runtime_error("sync_file: fsync of '" + path + "' failed");
+#else
+    (void)path;
+#endif
+}
+
+/**
+ * @brief 写出因子库
+ *
+ * 每个 alpha 为一列（float，或 int32 编码的信号），形状相同、布局任意；按 block_dates 个日期
+ * 分块压缩。字段名规则同 write_panel_file。
+ *
+ * 用法：
+ *   write_factor_store("alphas.a101f", {{"alpha001", a1}, {"alpha002", a2}});
+ */
+inline void write_factor_store(const string& path, const vector<PanelColumn>& alphas,
+                               size_t block_dates = kFactorBlockDates) {
+    check_columns("write_factor_store", alphas, sizeof(FactorFileAlpha::name));
+    if (block_dates == 0 || block_dates > UINT32_MAX)
+        throw std::invalid_argument("write_factor_store: block_dates out of range");
+    size_t S = alphas.empty() ? 0 : alphas[0].stocks;
+    size_t n_dates = alphas.empty() ? 0 : alphas[0].dates;
+    size_t n_blocks = (n_dates + block_dates - 1) / block_dates;
+    if (S * block_dates * sizeof(uint32_t) > UINT32_MAX)
+        throw std::invalid_argument("write_factor_store: block too large, use fewer block_dates");
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) throw std::runtime_error("write_factor_store: cannot open '" + path + "' for writing");
+    FactorFileHeader header{};
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));  // 索引写完后回填
+
+    vector<FactorFileBlock> blocks(alphas.size() * n_blocks);
+    vector<uint32_t> rows(S * block_dates);
+    vector<uint8_t> planes, packed;
+    uint64_t offset = sizeof(header);
+    for (size_t b = 0; b < n_blocks; ++b) {
+        size_t d0 = b * block_dates, d1 = std::min(n_dates, d0 + block_dates);
+        for (size_t a = 0; a < alphas.size(); ++a) {
+            copy_time_major_rows(alphas[a], d0, d1, rows.data());
+            blocks[a * n_blocks + b] = write_factor_block(out, rows.data(), (d1 - d0) * S, offset, planes, packed);
+        }
+    }
+
+    vector<FactorFileAlpha> table(alphas.size());
+    for (size_t a = 0; a < alphas.size(); ++a) {
+        memcpy(table[a].name, alphas[a].name.data(), alphas[a].name.size());
+        table[a].dtype = (uint32_t)alphas[a].dtype;
+    }
+    header.block_dates = (uint32_t)block_dates;
+    header.stocks = S;
+    header.dates = n_dates;
+    header.index_offset = offset;
+    write_factor_index(out, header, table, blocks);
+    write_factor_header(out, header, table.size());
+    if (!out) throw std::runtime_error("write_factor_store: write to '" + path + "' failed");
+}
+
+/**
+ * @brief 因子库的读取端：打开时只解析头部与块索引，读取时只解码与日期区间相交的块
+ *
+ * 文件经 FileMapping 映射，压缩块直接从映射内存解码到结果面板，未访问的块不会被读入内存。
+ * 追加从不改写已有的块与索引，其他进程或对象在追加前建立的映射仍读到追加前的完整内容。
+ *
+ * 用法：
+ *   FactorStore store("alphas.a101f");
+ *   Panel<float> a1 = store.read("alpha001", T - 252, T);   // 最近 252 个日期，只解码 4~5 个块
+ */
+class FactorStore {
+   public:
+    explicit FactorStore(const string& path) : path_(path) { open(); }
+
+    size_t stocks() const { return header_.stocks; }
+    size_t dates() const { return header_.dates; }
+    size_t block_dates() const { return header_.block_dates; }
+    const vector<string>& alphas() const { return names_; }
+    bool has(const string& name) const { return index_.count(name) > 0; }
+
+    // 存储字节数与原始字节数之比（压缩率）
+    double compression_ratio(const string& name) const {
+        size_t a = alpha(name), stored = 0;
+        for (size_t b = 0; b < n_blocks_; ++b) stored += blocks_[a * n_blocks_ + b].bytes;
+        size_t raw = (size_t)header_.stocks * header_.dates * sizeof(uint32_t);
+        return raw ? (double)stored / raw : 1.0;
+    }
+
+    /**
+     * @brief 在文件末尾追加新日期：columns 为每个 alpha 在新日期上的 [S × 新日期数] 面板
+     *
+     * 只解码不完整的最后一个日期块（若有），与新日期拼接后连同新的日期块、新的索引写在文件尾，
+     * 落盘（fsync）后改写 64 字节的文件头使之生效，再落盘一次。已有字节除文件头外从不改写、文件从不截短，
+     * 已映射该文件的读者不会 SIGBUS，也不会读到改写中的块。代价为 O((block_dates + 新日期数) × S × alphas)
+     * 加一份索引，与已有历史长度无关；本对象随后读到追加后的文件。
+     * columns 须与已有 alpha 一一对应（顺序任意）。文件头改写前失败（如磁盘写满）时截掉已写的尾部后重新抛出；
+     * 进程中途崩溃则文件头仍指向旧索引，文件尾多出的字节不影响读取，下次追加写在其后。
+     *
+     * 用法：
+     *   FactorStore store("alphas.a101f");
+     *   store.append({{"alpha001", today_a1}, {"alpha002", today_a2}});
+     */
+    void append(const vector<PanelColumn>& columns) {
+        check_columns("FactorStore::append", columns, sizeof(FactorFileAlpha::name));
+        if (columns.size() != alphas_.size()) fail("append needs one column per alpha");
+        vector<const PanelColumn*> by_alpha(alphas_.size(), nullptr);
+        for (const PanelColumn& c : columns) {
+            size_t a = alpha(c.name);
+            if (c.stocks != stocks()) fail("column '" + c.name + "' has a different number of stocks");
+            if ((uint32_t)c.dtype != alphas_[a].dtype) fail("column '" + c.name + "' has a different dtype");
+            by_alpha[a] = &c;
+        }
+        size_t added = columns.empty() ? 0 : columns[0].dates;
+        if (added == 0) return;
+
+        // 解码不完整的最后一个日期块（若有）：它与新日期拼成的块写在文件尾，旧块成为死区
+        size_t S = stocks(), bd = block_dates(), T0 = dates(), T1 = T0 + added;
+        size_t b_tail = T0 / bd, tail_dates = T0 - b_tail * bd;
+        vector<vector<uint32_t>> tail(alphas_.size());
+        vector<uint8_t> planes, packed;
+        if (tail_dates > 0) {
+            for (size_t a = 0; a < alphas_.size(); ++a) {
+                tail[a].resize(tail_dates * S);
+                decode_block(a, b_tail, tail[a].data(), planes);
+            }
+        }
+
+        size_t n_blocks = (T1 + bd - 1) / bd;
+        vector<FactorFileBlock> blocks(alphas_.size() * n_blocks);
+        for (size_t a = 0; a < alphas_.size(); ++a)
+            for (size_t b = 0; b < b_tail; ++b) blocks[a * n_blocks + b] = blocks_[a * n_blocks_ + b];
+
+        uint64_t eof = std::filesystem::file_size(path_), offset = eof;
+        bool publishing = false;
+        try {
+            std::fstream out(path_, std::ios::binary | std::ios::in | std::ios::out);
+            if (!out) throw std::runtime_error("FactorStore::append: cannot open '" + path_ + "' for writing");
+            out.seekp((std::streamoff)offset);
+            vector<uint32_t> rows(S * bd);
+            for (size_t b = b_tail; b < n_blocks; ++b) {
+                size_t d0 = b * bd, d1 = std::min(T1, d0 + bd);
+                size_t old_end = std::clamp(T0, d0, d1);  // [d0, old_end) 来自旧的尾块，其余来自新日期
+                for (size_t a = 0; a < alphas_.size(); ++a) {
+                    if (old_end > d0) memcpy(rows.data(), tail[a].data(), (old_end - d0) * S * sizeof(uint32_t));
+                    if (d1 > old_end)
+                        copy_time_major_rows(*by_alpha[a], old_end - T0, d1 - T0, rows.data() + (old_end - d0) * S);
+                    blocks[a * n_blocks + b] = write_factor_block(out, rows.data(), (d1 - d0) * S, offset, planes, packed);
+                }
+            }
+
+            FactorFileHeader header = header_;
+            header.dates = T1;
+            header.index_offset = offset;
+            write_factor_index(out, header, alphas_, blocks);
+            out.flush();
+            if (!out) throw std::runtime_error("FactorStore::append: write to '" + path_ + "' failed");
+            sync_file(path_);  // 新块与新索引先落盘，文件头才能指向它们
+
+            publishing = true;
+            write_factor_header(out, header, alphas_.size());
+            out.close();
+            if (!out) throw std::runtime_error("FactorStore::append: cannot update the header of '" + path_ + "'");
+            sync_file(path_);
+        } catch (...) {
+            // 文件头改写前失败：截掉本次写在旧文件尾之后的字节，本对象的映射与索引仍是旧的
+            std::error_code ec;
+            if (!publishing) std::filesystem::resize_file(path_, eof, ec);
+            throw;
+        }
+        open();
+    }
+
+    /**
+     * @brief alpha name 在日期 [d_begin, d_end) 上的面板（新分配，layout 布局）
+     *
+     * 完整落在区间内的块直接解码到结果（TimeMajor），首尾不完整的块经一块大小的暂存区拷贝。
+     */
+    template <typename T = float>
+    Panel<T> read(const string& name, size_t d_begin = 0, size_t d_end = SIZE_MAX,
+                  PanelLayout layout = PanelLayout::TimeMajor) const {
+        size_t a = alpha(name);
+        if (alphas_[a].dtype != (uint32_t)panel_dtype<T>()) fail("alpha '" + name + "' has a different dtype");
+        size_t S = stocks();
+        d_end = std::min(d_end, dates());
+        if (d_begin > d_end) fail("date range out of bounds");
+
+        Panel<T> tm(S, d_end - d_begin, PanelLayout::TimeMajor);
+        uint32_t* dst = reinterpret_cast<uint32_t*>(tm.data());
+        vector<uint8_t> planes;
+        vector<uint32_t> partial;
+        size_t bd = block_dates();
+        for (size_t b = d_begin / bd; d_begin < d_end && b * bd < d_end; ++b) {
+            size_t d0 = b * bd, d1 = std::min(dates(), d0 + bd);
+            size_t lo = std::max(d0, d_begin), hi = std::min(d1, d_end);
+            if (lo == d0 && hi == d1) {
+                decode_block(a, b, dst + (d0 - d_begin) * S, planes);
+            } else {
+                partial.resize(block_elems(b));
+                decode_block(a, b, partial.data(), planes);
+                memcpy(dst + (lo - d_begin) * S, partial.data() + (lo - d0) * S, (hi - lo) * S * sizeof(uint32_t));
+            }
+        }
+        if (layout == PanelLayout::TimeMajor) return tm;
+        Panel<T> out(S, tm.dates(), layout);
+        for (size_t s = 0; s < S; ++s)
+            for (size_t t = 0; t < tm.dates(); ++t) out(s, t) = tm(s, t);
+        return out;
+    }
+
+   private:
+    // 映射文件并解析头部与索引（构造与追加后调用）
+    void open() {
+        mapping_ = make_shared<FileMapping>(path_);
+        index_.clear();
+        names_.clear();
+        if (mapping_->size() < sizeof(FactorFileHeader)) fail("file is too small");
+        memcpy(&header_, mapping_->data(), sizeof(header_));
+        if (memcmp(header_.magic, kFactorFileMagic, sizeof(kFactorFileMagic)) != 0) fail("bad magic");
+        if (header_.version != kFactorFileVersion) fail("unsupported version " + to_string(header_.version));
+        if (header_.block_dates == 0) fail("bad block length");
+        n_blocks_ = (header_.dates + header_.block_dates - 1) / header_.block_dates;
+        size_t table_bytes = (size_t)header_.alphas * sizeof(FactorFileAlpha);
+        size_t index_bytes = (size_t)header_.alphas * n_blocks_ * sizeof(FactorFileBlock);
+        if (header_.index_offset < sizeof(FactorFileHeader) ||
+            header_.index_offset + table_bytes + index_bytes > mapping_->size())
+            fail("truncated index");
+
+        const char* index = mapping_->data() + header_.index_offset;
+        alphas_.resize(header_.alphas);
+        memcpy(alphas_.data(), index, table_bytes);
+        blocks_.resize(header_.alphas * n_blocks_);
+        memcpy(blocks_.data(), index + table_bytes, index_bytes);
+        for (size_t a = 0; a < alphas_.size(); ++a) {
+            string name(alphas_[a].name, strnlen(alphas_[a].name, sizeof(alphas_[a].name)));
+            if (alphas_[a].dtype != (uint32_t)PanelDType::Float32 && alphas_[a].dtype != (uint32_t)PanelDType::Int32)
+                fail("alpha '" + name + "' has unknown dtype " + to_string(alphas_[a].dtype));
+            for (size_t b = 0; b < n_blocks_; ++b) {
+                const FactorFileBlock& blk = blocks_[a * n_blocks_ + b];
+                bool known = blk.codec == (uint32_t)FactorCodec::Raw || blk.codec == (uint32_t)FactorCodec::ShuffleRle;
+                if (!known || blk.offset < sizeof(FactorFileHeader) || blk.offset + blk.bytes > header_.index_offset ||
+                    (blk.codec == (uint32_t)FactorCodec::Raw && blk.bytes != block_elems(b) * sizeof(uint32_t)))
+                    fail("alpha '" + name + "' has a corrupt block " + to_string(b));
+            }
+            index_.emplace(name, a);
+            names_.push_back(std::move(name));
+        }
+    }
+
+    size_t alpha(const string& name) const {
+        auto it = index_.find(name);
+        if (it == index_.end()) fail("no alpha '" + name + "'");
+        return it->second;
+    }
+
+    size_t block_elems(size_t b) const {
+        size_t d0 = b * header_.block_dates;
+        return (std::min<size_t>(header_.dates, d0 + header_.block_dates) - d0) * header_.stocks;
+    }
+
+    // 把块 (a, b) 解码为 TimeMajor 的 4 字节元素写入 dst；planes 为字节平面暂存区
+    void decode_block(size_t a, size_t b, uint32_t* dst, vector<uint8_t>& planes) const {
+        const FactorFileBlock& blk = blocks_[a * n_blocks_ + b];
+        const uint8_t* src = reinterpret_cast<const uint8_t*>(mapping_->data() + blk.offset);
+        size_t n = block_elems(b);
+        if (blk.codec == (uint32_t)FactorCodec::Raw) {
+            memcpy(dst, src, n * sizeof(uint32_t));
+            return;
+        }
+        planes.resize(n * sizeof(uint32_t));
+        if (!rle_decode(src, blk.bytes, planes.data(), planes.size()))
+            fail("alpha '" + names_[a] + "' block " + to_string(b) + " does not decode");
+        byte_unshuffle(planes.data(), n, dst);
+    }
+
+    [[noreturn]] void fail(const string& what) const {
+        throw std::invalid_argument("FactorStore '" + path_ + "': " + what);
+    }
+
+    string path_;
+    shared_ptr<FileMapping> mapping_;
+    FactorFileHeader header_{};
+    size_t n_blocks_ = 0;
+    vector<FactorFileAlpha> alphas_;
+    vector<FactorFileBlock> blocks_;
+    vector<string> names_;
+    unordered_map<string, size_t> index_;
+};
+
+// ====== 增量扩展：只读入回看尾部，求出新日期并追加到因子库 ======
+
+// 因子库中 alpha 的列名："alpha001" 等
+inline string alpha_column_name(int id) {
+    char buf[16];
+    snprintf(buf, sizeof(buf), "alpha%03d", id);
+    return buf;
+}
+
+// AlphaBatch 的求值结果按 alpha_column_name 命名，交给 write_factor_store / FactorStore::append
+inline vector<PanelColumn> alpha_columns(const AlphaBatch& batch, const vector<Panel<float>>& results) {
+    if (results.size() != batch.ids().size())
+        throw std::invalid_argument("alpha_columns: expected one result per alpha");
+    vector<PanelColumn> columns;
+    columns.reserve(results.size());
+    for (size_t i = 0; i < results.size(); ++i) columns.emplace_back(alpha_column_name(batch.ids()[i]), results[i]);
+    return columns;
+}
+
+/**
+ * @brief 把因子库扩展到输入的最新日期，返回追加的日期数
+ *
+ * fields 为完整历史的输入面板（通常是 PanelFile 的零拷贝视图，日期 0 与因子库对齐）。
+ * 因子库已有 store.dates() 个日期时，只对 [store.dates(), 输入日期数) 求值：evaluate_range 截取
+ * 最近 batch.anchored_history() - 1 个日期作为热身，映射文件中更早的页不会被读入。
+ * 求值代价 O((history + 新日期数) × S)，追加代价 O((block_dates + 新日期数) × S)，均与 T 无关。
+ *
+ * 用法（每日收盘后，inputs 已含当日数据）：
+ *   PanelFile inputs("ohlcv.a101");
+ *   Panel<float> close = inputs.panel("close"), returns = inputs.panel("returns");
+ *   extend_factor_store("alphas.a101f", {{"close", &close}, {"returns", &returns}}, AlphaBatch({1}));
+ */
+inline size_t extend_factor_store(FactorStore& store, const FieldMap& fields, const AlphaBatch& batch) {
+    size_t t_end = SIZE_MAX;
+    for (const string& name : batch.plan().fields) {
+        auto it = fields.find(name);
+        if (it == fields.end() || !it->second)
+            throw std::invalid_argument("extend_factor_store: missing input field '" + name + "'");
+        if (it->second->stocks() != store.stocks())
+            throw std::invalid_argument("extend_factor_store: field '" + name + "' has a different number of stocks");
+        if (t_end != SIZE_MAX && it->second->dates() != t_end)
+            throw std::invalid_argument("extend_factor_store: input fields have different lengths");
+        t_end = it->second->dates();
+    }
+    size_t t_done = store.dates();
+    if (t_end == SIZE_MAX || t_end < t_done)
+        throw std::invalid_argument("extend_factor_store: inputs are shorter than the stored history");
+    if (t_end == t_done) return 0;
+
+    vector<Panel<float>> fresh = batch.evaluate_range(fields, t_done, t_end, PanelLayout::TimeMajor);
+    store.append(alpha_columns(batch, fresh));
+    return t_end - t_done;
+}
+
+inline size_t extend_factor_store(const string& path, const FieldMap& fields, const AlphaBatch& batch) {
+    FactorStore store(path);
+    return extend_factor_store(store, fields, batch);
+}
+
+#endif  // ALPHA101STORE_H
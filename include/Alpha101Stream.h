@@ -0,0 +1,539 @@
+#ifndef ALPHA101STREAM_H
+#define ALPHA101STREAM_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "Alpha101Utils.h"
+
+using namespace std;
+
+// ====== 流式（增量）算子：每来一个 bar 调用一次 push(x)，返回该 bar 的算子输出 ======
+//
+// 批量算子每次都在整段历史上重算；流式算子只保存窗口所需的状态（环形缓冲区 + 滑动和式 / 单调队列 / 有序窗口），
+// 第 t 次 push 的返回值等于对应批量算子在位置 t 的输出（热身期、NaN 规则相同）。
+// 标注"逐位一致"的算子与批量版本的运算顺序完全相同；其余算子以 double 滑动状态实现，误差在 float 舍入量级。
+
+/**
+ * @brief 定长环形缓冲区，保存最近 capacity 个值
+ *
+ * 下标 0 为最旧元素；满时 push 覆盖最旧元素。
+ */
+class RingBuffer {
+   public:
+    explicit RingBuffer(size_t capacity = 1) : data_(capacity < 1 ? 1 : capacity) {}
+
+    void push(float x) {
+        if (size_ < data_.size()) {
+            data_[wrap(head_ + size_)] = x;
+            ++size_;
+        } else {
+            data_[head_] = x;
+            head_ = wrap(head_ + 1);
+        }
+    }
+
+    float operator[](size_t k) const { return data_[wrap(head_ + k)]; }
+    float front() const { return data_[head_]; }
+    float back() const { return (*this)[size_ - 1]; }
+
+    size_t size() const { return size_; }
+    size_t capacity() const { return data_.size(); }
+    bool full() const { return size_ == data_.size(); }
+
+    void clear() {
+        head_ = 0;
+        size_ = 0;
+    }
+
+   private:
+    size_t wrap(size_t i) const { return i < data_.size() ? i : i - data_.size(); }
+
+    vector<float> data_;
+    size_t head_ = 0;
+    size_t size_ = 0;
+};
+
+// ---------- 平移类 ----------
+
+// delay(x, period)：逐位一致
+class DelayStream {
+   public:
+    explicit DelayStream(int period) : buf_(period < 0 ? 1 : (size_t)period + 1) {}
+
+    float push(float x) {
+        buf_.push(x);
+        return buf_.full() ? buf_.front() : NAN;
+    }
+
+    void reset() { buf_.clear(); }
+
+   private:
+    RingBuffer buf_;
+};
+
+// delta(x, period)：逐位一致
+class DeltaStream {
+   public:
+    explicit DeltaStream(int period) : buf_(period < 0 ? 1 : (size_t)period + 1) {}
+
+    float push(float x) {
+        buf_.push(x);
+        return buf_.full() ? x - buf_.front() : NAN;
+    }
+
+    void reset() { buf_.clear(); }
+
+   private:
+    RingBuffer buf_;
+};
+
+// ---------- 滑动和式类（每步 O(1)） ----------
+
+/**
+ * @brief ts_sum(x, window)：与 rolling_ts_sum 逐位一致
+ *
+ * 共用 SlidingSum，从头重算的时机（窗口起点为 window 的整数倍）也相同；NaN 只计数不累加。
+ */
+class TsSumStream {
+   public:
+    explicit TsSumStream(int window) : buf_(window < 1 ? 1 : (size_t)window) {}
+
+    float push(float x) {
+        size_t w = buf_.capacity();
+        size_t i = t_++;
+        float old = buf_.front();
+        bool evicted = buf_.full();
+        buf_.push(x);
+        if (i + 1 < w) {
+            acc_.add(x);  // 热身期内为已有元素之和，供 sum() 查询
+            return NAN;
+        }
+        if ((i + 1 - w) % w == 0) {
+            acc_.rebuild(w, [&](size_t k) { return buf_[k]; });
+        } else {
+            acc_.add(x);
+            if (evicted) acc_.remove(old);
+        }
+        return acc_.total();
+    }
+
+    // 当前窗口的和（double），热身期内为已有元素之和
+    double sum() const { return acc_.sum; }
+    bool has_nan() const { return acc_.nan_count > 0; }
+    size_t window() const { return buf_.capacity(); }
+
+    void reset() {
+        buf_.clear();
+        t_ = 0;
+        acc_ = SlidingSum{};
+    }
+
+   private:
+    RingBuffer buf_;
+    size_t t_ = 0;
+    SlidingSum acc_;
+};
+
+// ts_mean(x, window) = ts_sum / window，与 rolling_sma 逐位一致
+class TsMeanStream {
+   public:
+    explicit TsMeanStream(int window) : sum_(window) {}
+
+    float push(float x) {
+        float s = sum_.push(x);
+        return isnan(s) ? NAN : (float)(sum_.sum() / (int)sum_.window());
+    }
+
+    void reset() { sum_.reset(); }
+
+   private:
+    TsSumStream sum_;
+};
+
+/**
+ * @brief stddev(x, window)：与 rolling_stddev 逐位一致
+ *
+ * 共用 SlidingVariance，重新锚定的时机（窗口起点为 window 的整数倍）也相同；窗口内含 NaN 时输出 NaN。
+ */
+class StddevStream {
+   public:
+    explicit StddevStream(int window) : window_(window), buf_(window < 1 ? 1 : (size_t)window) {}
+
+    float push(float x) {
+        if (window_ <= 1) return NAN;
+        size_t w = (size_t)window_;
+        size_t i = t_++;
+        float old = buf_.front();
+        bool evicted = buf_.full();
+        buf_.push(x);
+        if (i + 1 < w) return NAN;
+        if ((i + 1 - w) % w == 0) {
+            acc_.rebuild(w, [&](size_t k) { return buf_[k]; });
+        } else {
+            acc_.add(x);
+            if (evicted) acc_.remove(old);
+        }
+        return acc_.stddev(window_);
+    }
+
+    void reset() {
+        buf_.clear();
+        t_ = 0;
+        acc_ = SlidingVariance{};
+    }
+
+   private:
+    int window_;
+    RingBuffer buf_;
+    size_t t_ = 0;
+    SlidingVariance acc_;
+};
+
+/**
+ * @brief correlation / covariance(x, y, window)：与 sliding_comoment 逐位一致
+ *
+ * 锚点平移的 double 和式；窗口起点为 window 的整数倍时以当前窗口均值重新锚定，与批量版本的时机相同。
+ */
+template <bool IsCorr>
+class ComomentStream {
+   public:
+    explicit ComomentStream(int window) : window_(window), a_(window < 1 ? 1 : window), b_(window < 1 ? 1 : window) {}
+
+    float push(float x, float y) {
+        if (window_ < 1) return NAN;
+        size_t w = (size_t)window_;
+        size_t i = t_++;
+        float old_x = a_.front(), old_y = b_.front();
+        bool evicted = a_.full();
+        a_.push(x);
+        b_.push(y);
+        if (i + 1 < w) return NAN;
+
+        size_t start = i + 1 - w;
+        if (start % w == 0) {
+            reanchor();
+        } else {
+            if (evicted) {
+                if (isnan(old_x) || isnan(old_y)) --nan_count_;
+                else add(old_x, old_y, -1.0);
+            }
+            if (isnan(x) || isnan(y)) ++nan_count_;
+            else add(x, y, 1.0);
+        }
+        if (nan_count_ > 0) return NAN;
+
+        double wd = (double)w;
+        double spd = sxy_ - sx_ * sy_ / wd;
+        if constexpr (IsCorr) {
+            double ss_a = sxx_ - sx_ * sx_ / wd;
+            double ss_b = syy_ - sy_ * sy_ / wd;
+            if (ss_a <= sxx_ * 1e-12 || ss_b <= syy_ * 1e-12) return NAN;
+            return (float)(spd / sqrt(ss_a * ss_b));
+        } else {
+            return (float)(spd / (wd - 1.0));
+        }
+    }
+
+    void reset() {
+        a_.clear();
+        b_.clear();
+        t_ = 0;
+        nan_count_ = 0;
+        kx_ = ky_ = sx_ = sy_ = sxx_ = syy_ = sxy_ = 0.0;
+    }
+
+   private:
+    void add(float x, float y, double sign) {
+        double dx = x - kx_, dy = y - ky_;
+        sx_ += sign * dx;
+        sy_ += sign * dy;
+        sxx_ += sign * dx * dx;
+        syy_ += sign * dy * dy;
+        sxy_ += sign * dx * dy;
+    }
+
+    void reanchor() {
+        double mx = 0, my = 0;
+        size_t valid = 0;
+        nan_count_ = 0;
+        for (size_t k = 0; k < a_.size(); ++k) {
+            if (isnan(a_[k]) || isnan(b_[k])) {
+                ++nan_count_;
+                continue;
+            }
+            mx += a_[k];
+            my += b_[k];
+            ++valid;
+        }
+        kx_ = valid ? mx / valid : 0.0;
+        ky_ = valid ? my / valid : 0.0;
+        sx_ = sy_ = sxx_ = syy_ = sxy_ = 0;
+        for (size_t k = 0; k < a_.size(); ++k)
+            if (!isnan(a_[k]) && !isnan(b_[k])) add(a_[k], b_[k], 1.0);
+    }
+
+    int window_;
+    RingBuffer a_, b_;
+    size_t t_ = 0;
+    size_t nan_count_ = 0;
+    double kx_ = 0, ky_ = 0;
+    double sx_ = 0, sy_ = 0, sxx_ = 0, syy_ = 0, sxy_ = 0;
+};
+
+using CorrelationStream = ComomentStream<true>;
+using CovarianceStream = ComomentStream<false>;
+
+/**
+ * @brief decay_linear(x, period)：与 decay_linear 逐位一致
+ *
+ * 共用 SlidingDecay 的 O(1) 递推，从头重算的时机（窗口起点为 period 的整数倍）也相同。
+ */
+class DecayLinearStream {
+   public:
+    explicit DecayLinearStream(int period) : buf_(period < 1 ? 1 : (size_t)period) {}
+
+    float push(float x) {
+        size_t p = buf_.capacity();
+        size_t i = t_++;
+        float old = buf_.front();
+        buf_.push(x);
+        if (i + 1 < p) return NAN;
+        if ((i + 1 - p) % p == 0) acc_.rebuild(p, [&](size_t k) { return buf_[k]; });
+        else acc_.slide(x, old, (int)p);
+        return acc_.value((int)p);
+    }
+
+    void reset() {
+        buf_.clear();
+        t_ = 0;
+        acc_ = SlidingDecay{};
+    }
+
+   private:
+    RingBuffer buf_;
+    size_t t_ = 0;
+    SlidingDecay acc_;
+};
+
+// ---------- 单调队列类（均摊每步 O(1)） ----------
+
+/**
+ * @brief ts_min / ts_max / ts_argmax / ts_argmin：与 monotonic_window 逐位一致
+ *
+ * 队列保存 (bar 编号, 值)，容量为 window；NaN 清空队列并记录位置，包含该位置的窗口输出 NaN。
+ *
+ * @tparam Max true：最大值；false：最小值
+ * @tparam Arg true：输出最优元素在窗口内的位置（1 起，最旧为 1，并列取最早者）；false：输出值
+ */
+template <bool Max, bool Arg>
+class MonotonicStream {
+   public:
+    explicit MonotonicStream(int window)
+        : w_(window < 1 ? 0 : (size_t)window), idx_(w_ ? w_ : 1), val_(w_ ? w_ : 1) {}
+
+    float push(float x) {
+        size_t i = t_++;
+        if (w_ == 0) return NAN;
+        size_t start = i + 1 < w_ ? 0 : i + 1 - w_;
+        while (count_ > 0 && idx_[head_] < start) {
+            head_ = wrap(head_ + 1);
+            --count_;
+        }
+        if (isnan(x)) {
+            count_ = 0;
+            last_nan_ = i;
+        } else {
+            while (count_ > 0 && better(x, val_[wrap(head_ + count_ - 1)])) --count_;
+            size_t tail = wrap(head_ + count_);
+            idx_[tail] = i;
+            val_[tail] = x;
+            ++count_;
+        }
+        if (i + 1 < w_) return NAN;
+        if (last_nan_ != SIZE_MAX && last_nan_ >= start) return NAN;
+        if constexpr (Arg) return (float)(idx_[head_] - start + 1);
+        else return val_[head_];
+    }
+
+    void reset() {
+        t_ = head_ = count_ = 0;
+        last_nan_ = SIZE_MAX;
+    }
+
+   private:
+    static bool better(float x, float y) { return Max ? x > y : x < y; }
+    size_t wrap(size_t i) const { return i < idx_.size() ? i : i - idx_.size(); }
+
+    size_t w_;
+    vector<size_t> idx_;
+    vector<float> val_;
+    size_t t_ = 0, head_ = 0, count_ = 0;
+    size_t last_nan_ = SIZE_MAX;
+};
+
+using TsMinStream = MonotonicStream<false, false>;
+using TsMaxStream = MonotonicStream<true, false>;
+using TsArgmaxStream = MonotonicStream<true, true>;
+using TsArgminStream = MonotonicStream<false, true>;
+
+// ---------- 有序窗口 / 累乘类 ----------
+
+/**
+ * @brief ts_rank(x, window)：与 ts_rank 逐位一致
+ *
+ * 平均名次 = 严格小于个数 + (相等个数 + 1) / 2。窗口内的非 NaN 值另存为一个有序数组，
+ * 两次二分查找得到小于 / 相等的个数（O(log window)）；进出窗口各一次有序插入 / 删除，
+ * 只移动 window 个 float（一次 memmove）。NaN 不参与比较，与批量版本相同。
+ */
+class TsRankStream {
+   public:
+    explicit TsRankStream(int window) : buf_(window < 1 ? 1 : (size_t)window) { sorted_.reserve(buf_.capacity()); }
+
+    float push(float x) {
+        if (buf_.full()) {
+            float old = buf_.front();
+            if (!isnan(old)) sorted_.erase(lower_bound(sorted_.begin(), sorted_.end(), old));
+        }
+        buf_.push(x);
+        if (!isnan(x)) sorted_.insert(upper_bound(sorted_.begin(), sorted_.end(), x), x);
+        if (!buf_.full()) return NAN;
+        if (isnan(x)) return 0.5f;  // 没有值小于或等于 NaN
+        auto [lo, hi] = equal_range(sorted_.begin(), sorted_.end(), x);
+        size_t less = lo - sorted_.begin(), equal = hi - lo;
+        return (2 * less + 1 + equal) / 2.0f;
+    }
+
+    void reset() {
+        buf_.clear();
+        sorted_.clear();
+    }
+
+   private:
+    RingBuffer buf_;
+    vector<float> sorted_;  // 窗口内的非 NaN 值，升序
+};
+
+/**
+ * @brief product(x, window)：每步乘入新值、除去旧值，O(1)
+ *
+ * 非零有限值的绝对值以 double 累乘；0、±inf、NaN 与负数（含 -0）只计数，输出时据此决定 NaN / 0 / inf 与符号。
+ * 窗口起点为 window 的整数倍时从头重算，使乘除累积的舍入有界。与 product 的差异在 float 舍入量级；
+ * 批量版本 float 连乘中途上溢 / 下溢而最终值仍在 float 范围内的窗口除外（double 累乘不会中途溢出）。
+ */
+class ProductStream {
+   public:
+    explicit ProductStream(int window) : buf_(window < 1 ? 1 : (size_t)window) {}
+
+    float push(float x) {
+        size_t w = buf_.capacity();
+        size_t i = t_++;
+        float old = buf_.front();
+        buf_.push(x);
+        if (i + 1 < w) return NAN;
+        if ((i + 1 - w) % w == 0) {
+            clear_state();
+            for (size_t k = 0; k < w; ++k) update(buf_[k], 1);
+        } else {
+            update(x, 1);
+            update(old, -1);
+        }
+        if (nan_count_ > 0 || (zero_count_ > 0 && inf_count_ > 0)) return NAN;
+        double sign = neg_count_ % 2 ? -1.0 : 1.0;
+        if (zero_count_ > 0) return (float)(sign * 0.0);
+        if (inf_count_ > 0) return (float)(sign * INFINITY);
+        return (float)(sign * magnitude_);
+    }
+
+    void reset() {
+        buf_.clear();
+        t_ = 0;
+        clear_state();
+    }
+
+   private:
+    // 把 x 乘入（dir = 1）或除去（dir = -1）
+    void update(float x, int dir) {
+        if (isnan(x)) {
+            nan_count_ += dir;
+            return;
+        }
+        neg_count_ += signbit(x) ? dir : 0;
+        if (x == 0.0f) zero_count_ += dir;
+        else if (isinf(x)) inf_count_ += dir;
+        else if (dir > 0) magnitude_ *= fabs((double)x);
+        else magnitude_ /= fabs((double)x);
+    }
+
+    void clear_state() {
+        magnitude_ = 1.0;
+        nan_count_ = zero_count_ = inf_count_ = neg_count_ = 0;
+    }
+
+    RingBuffer buf_;
+    size_t t_ = 0;
+    double magnitude_ = 1.0;
+    long nan_count_ = 0, zero_count_ = 0, inf_count_ = 0, neg_count_ = 0;
+};
+
+// ====== Alpha#1 流式版本 ======
+
+/**
+ * @brief Alpha#1 的逐 bar 增量计算
+ *
+ * 每只股票保存 stddev(returns, 20) 与 ts_argmax(·, 5) 的流式状态；每个 bar 输入全部股票的
+ * close/returns 截面，O(S) 更新状态后做一次 O(S log S) 截面排名。第 t 次 push 的输出与
+ * alpha001() 在日期 t 的截面逐位一致。
+ *
+ * 用法（日终任务）：先按日期顺序 push 历史数据预热，之后每天只 push 当天的截面。
+ */
+class Alpha001Stream {
+   public:
+    explicit Alpha001Stream(size_t stocks)
+        : stddev_(stocks, StddevStream(20)), argmax_(stocks, TsArgmaxStream(5)), argmax_out_(stocks), ranked_(stocks) {
+        idx_buf_.reserve(stocks);
+    }
+
+    /**
+     * @param close   当日收盘价截面，长度为 stocks()
+     * @param returns 当日收益率截面
+     * @param out     输出：当日因子截面，值域 (-0.5, 0.5]，热身期为 NaN
+     */
+    void push(span<const float> close, span<const float> returns, span<float> out) {
+        size_t S = stddev_.size();
+        for (size_t s = 0; s < S; ++s) {
+            float sd = stddev_[s].push(returns[s]);
+            float inner = NAN;
+            if (!isnan(sd)) {
+                float val = (returns[s] < 0.0f) ? sd : close[s];
+                inner = val * val;
+            }
+            argmax_out_[s] = argmax_[s].push(inner);
+        }
+        alpha_rank(span<const float>(argmax_out_), span<float>(ranked_), idx_buf_);
+        for (size_t s = 0; s < S; ++s) out[s] = ranked_[s] - 0.5f;  // NaN - 0.5 仍为 NaN
+        ++bars_;
+    }
+
+    size_t stocks() const { return stddev_.size(); }
+    size_t bars() const { return bars_; }
+
+    void reset() {
+        for (auto& s : stddev_) s.reset();
+        for (auto& a : argmax_) a.reset();
+        bars_ = 0;
+    }
+
+   private:
+    vector<StddevStream> stddev_;
+    vector<TsArgmaxStream> argmax_;
+    vector<float> argmax_out_, ranked_;
+    vector<size_t> idx_buf_;
+    size_t bars_ = 0;
+};
+
+#endif  // ALPHA101STREAM_H
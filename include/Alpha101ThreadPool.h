@@ -0,0 +1,260 @@
+#ifndef ALPHA101THREADPOOL_H
+#define ALPHA101THREADPOOL_H
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cstddef>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#define ALPHA101_HAVE_AFFINITY 1
+#endif
+
+using namespace std;
+
+// ====== NUMA 拓扑与线程绑定 ======
+//
+// 双路机器上内存按页归属于首次写入它的线程所在的节点（first-touch）。面板若由加载线程写入，
+// 其他节点上的线程只能以远端带宽读取；按节点切分数据、由绑定在该节点上的线程首次写入并处理，才能留在本地。
+// 拓扑直接读 sysfs，不依赖 libnuma。
+
+/**
+ * @brief 解析 Linux cpulist 格式（如 "0-3,8,10-11"），返回升序的 CPU 编号
+ */
+inline vector<int> parse_cpu_list(const string& text) {
+    vector<int> cpus;
+    size_t pos = 0;
+    while (pos < text.size()) {
+        size_t end = text.find(',', pos);
+        if (end == string::npos) end = text.size();
+        string item = text.substr(pos, end - pos);
+        item.erase(remove_if(item.begin(), item.end(), [](char c) { return isspace((unsigned char)c); }), item.end());
+        if (!item.empty()) {
+            size_t dash = item.find('-');
+            try {
+                int lo = stoi(item.substr(0, dash)), hi = dash == string::npos ? lo : stoi(item.substr(dash + 1));
+                if (lo < 0 || hi < lo) throw invalid_argument(item);
+                for (int c = lo; c <= hi; ++c) cpus.push_back(c);
+            } catch (const logic_error&) {
+                throw invalid_argument("parse_cpu_list: malformed entry '" + item + "'");
+            }
+        }
+        pos = end + 1;
+    }
+    sort(cpus.begin(), cpus.end());
+    cpus.erase(unique(cpus.begin(), cpus.end()), cpus.end());
+    return cpus;
+}
+
+struct NumaNode {
+    int id = 0;
+    vector<int> cpus;
+};
+
+/**
+ * @brief 读取 NUMA 节点及其 CPU（sysfs_root 下的 node<N>/cpulist），按节点编号升序
+ *
+ * 没有 CPU 的节点（纯内存节点）被跳过。拓扑不可读（非 Linux、容器内未挂载 sysfs）时视为单节点，
+ * 包含 hardware_concurrency() 个 CPU。
+ */
+inline vector<NumaNode> numa_nodes(const string& sysfs_root = "/sys/devices/system/node") {
+    vector<NumaNode> nodes;
+    error_code ec;
+    for (const auto& entry : filesystem::directory_iterator(sysfs_root, ec)) {
+        string name = entry.path().filename().string();
+        if (name.size() <= 4 || name.compare(0, 4, "node") != 0 ||
+            !all_of(name.begin() + 4, name.end(), [](char c) { return isdigit((unsigned char)c); }))
+            continue;
+        ifstream in(entry.path() / "cpulist");
+        string text;
+        if (!in || !getline(in, text)) continue;
+        NumaNode node{stoi(name.substr(4)), parse_cpu_list(text)};
+        if (!node.cpus.empty()) nodes.push_back(std::move(node));
+    }
+    if (nodes.empty()) {
+        NumaNode all;
+        for (unsigned c = 0, n = max(1u, thread::hardware_concurrency()); c < n; ++c) all.cpus.push_back((int)c);
+        nodes.push_back(std::move(all));
+    }
+    sort(nodes.begin(), nodes.end(), [](const NumaNode& a, const NumaNode& b) { return a.id < b.id; });
+    return nodes;
+}
+
+/**
+ * @brief 按节点依次排列的线程池参与者绑定：节点 0 的 threads_per_node 个参与者在前，随后是节点 1 ……
+ *
+ * 每个参与者可在其节点的任一 CPU 上运行（绑定到节点而非单个核）。threads_per_node == 0 时取该节点的 CPU 数。
+ * ThreadPool::parallel_for 的连续分块因此按节点聚集：每个节点处理一段连续的下标。
+ */
+inline vector<vector<int>> numa_affinity(const vector<NumaNode>& nodes, size_t threads_per_node = 0) {
+    vector<vector<int>> affinity;
+    for (const NumaNode& node : nodes) {
+        size_t k = threads_per_node ? threads_per_node : max<size_t>(1, node.cpus.size());
+        affinity.insert(affinity.end(), k, node.cpus);
+    }
+    return affinity;
+}
+
+// 把调用线程限制在 cpus 上；cpus 为空、平台不支持或内核拒绝（CPU 不在允许集合内）时返回 false 且不改变绑定
+inline bool pin_this_thread(const vector<int>& cpus) {
+#ifdef ALPHA101_HAVE_AFFINITY
+    if (cpus.empty()) return false;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int c : cpus)
+        if (c >= 0 && c < CPU_SETSIZE) CPU_SET(c, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    (void)cpus;
+    return false;
+#endif
+}
+
+// ====== 线程池：固定的一组工作线程，跨调用复用，避免每次调用创建/销毁线程 ======
+
+/**
+ * @brief 固定大小的线程池，按"所有参与者执行同一个任务"的方式并行
+ *
+ * size() 个参与者 = size() - 1 个常驻工作线程 + 调用 run() 的线程本身（编号 0）。
+ * run(fn) 让每个参与者执行一次 fn(worker)，全部完成后返回；任一参与者抛出的第一个异常在 run() 中重新抛出。
+ * size() == 1 时不创建线程，run() 直接在调用线程上执行。同一时刻只允许一个 run()，并发调用会排队。
+ *
+ * 以绑定列表构造时，参与者 w 只在 affinity[w] 的 CPU 上运行：工作线程启动时绑定一次；
+ * 调用线程（参与者 0）只在 run() 期间绑定，返回前恢复原来的绑定。空列表表示不绑定。
+ */
+class ThreadPool {
+   public:
+    explicit ThreadPool(size_t threads = thread::hardware_concurrency())
+        : ThreadPool(vector<vector<int>>(threads < 1 ? 1 : threads)) {}
+
+    // 每个参与者一个 CPU 列表，参与者个数为 affinity.size()（至少 1）；见 numa_affinity()
+    explicit ThreadPool(vector<vector<int>> affinity) : affinity_(std::move(affinity)) {
+        if (affinity_.empty()) affinity_.resize(1);
+        size_t threads = affinity_.size();
+        workers_.reserve(threads - 1);
+        for (size_t i = 1; i < threads; ++i) workers_.emplace_back([this, i] { worker_loop(i); });
+    }
+
+    ~ThreadPool() {
+        stop_.store(true, memory_order_relaxed);
+        generation_.fetch_add(1, memory_order_release);
+        generation_.notify_all();
+        for (thread& t : workers_) t.join();
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    size_t size() const { return workers_.size() + 1; }
+    const vector<int>& affinity(size_t w) const { return affinity_[w]; }
+
+    void run(const function<void(size_t)>& fn) {
+        lock_guard<mutex> serial(run_mutex_);
+        CallerAffinity pinned(affinity_[0]);
+        if (workers_.empty()) {
+            fn(0);
+            return;
+        }
+        job_ = &fn;
+        error_ = nullptr;
+        pending_.store(workers_.size(), memory_order_relaxed);
+        generation_.fetch_add(1, memory_order_release);  // 发布 job_，唤醒全部工作线程
+        generation_.notify_all();
+        try {
+            fn(0);
+        } catch (...) {
+            record_error();
+        }
+        for (size_t p; (p = pending_.load(memory_order_acquire)) != 0;) pending_.wait(p, memory_order_acquire);
+        job_ = nullptr;
+        if (error_) rethrow_exception(error_);
+    }
+
+    /**
+     * @brief 把 [0, n) 均分为至多 size() 个连续块，fn(begin, end, worker) 各处理一块
+     *
+     * 块 w 为 [n·w/k, n·(w+1)/k)，k = min(size(), n)；划分只取决于 n 与 size()，与调度无关。
+     */
+    template <typename Fn>
+    void parallel_for(size_t n, Fn&& fn) {
+        size_t blocks = n < size() ? n : size();
+        if (blocks <= 1) {
+            if (n > 0) fn(size_t(0), n, size_t(0));
+            return;
+        }
+        run([&](size_t w) {
+            if (w < blocks) fn(n * w / blocks, n * (w + 1) / blocks, w);
+        });
+    }
+
+   private:
+    // run() 期间把调用线程绑定到参与者 0 的 CPU，析构时恢复
+    class CallerAffinity {
+       public:
+        explicit CallerAffinity(const vector<int>& cpus) {
+#ifdef ALPHA101_HAVE_AFFINITY
+            if (!cpus.empty() && pthread_getaffinity_np(pthread_self(), sizeof(saved_), &saved_) == 0)
+                restore_ = pin_this_thread(cpus);
+#else
+            (void)cpus;
+#endif
+        }
+        ~CallerAffinity() {
+#ifdef ALPHA101_HAVE_AFFINITY
+            if (restore_) pthread_setaffinity_np(pthread_self(), sizeof(saved_), &saved_);
+#endif
+        }
+        CallerAffinity(const CallerAffinity&) = delete;
+        CallerAffinity& operator=(const CallerAffinity&) = delete;
+
+       private:
+#ifdef ALPHA101_HAVE_AFFINITY
+        cpu_set_t saved_;
+#endif
+        bool restore_ = false;
+    };
+
+    // 等待/唤醒用 atomic::wait/notify（futex），不经过 condition_variable
+    void worker_loop(size_t id) {
+        pin_this_thread(affinity_[id]);
+        size_t seen = 0;
+        while (true) {
+            generation_.wait(seen, memory_order_acquire);
+            seen = generation_.load(memory_order_acquire);
+            if (stop_.load(memory_order_relaxed)) return;
+            try {
+                (*job_)(id);
+            } catch (...) {
+                record_error();
+            }
+            if (pending_.fetch_sub(1, memory_order_acq_rel) == 1) pending_.notify_one();
+        }
+    }
+
+    void record_error() {
+        lock_guard<mutex> lock(error_mutex_);
+        if (!error_) error_ = current_exception();
+    }
+
+    vector<vector<int>> affinity_;
+    vector<thread> workers_;
+    mutex run_mutex_, error_mutex_;
+    atomic<size_t> generation_{0};
+    atomic<size_t> pending_{0};
+    atomic<bool> stop_{false};
+    const function<void(size_t)>* job_ = nullptr;
+    exception_ptr error_;
+};
+
+#endif  // ALPHA101THREADPOOL_H
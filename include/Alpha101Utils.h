@@ -2,7 +2,9 @@
 #define ALPHA101UTILS_H
 
 #include <algorithm>  // Stellt Algorithmen wie sort, upper_bound usw. bereit
+#include <bit>
 #include <cmath>
+#include <cstdint>
 #include <iostream>
 #include <numeric>
 #include <ranges>  // Stellt sliding_window bereit (C++23)
@@ -18,10 +20,10 @@ using namespace std;
 void print_result(const vector<float>& result);
 
 // Rollende Summe
-vector<float> rolling_ts_sum(vector<float> DataFrame, int window);
+vector<float> rolling_ts_sum(const vector<float>& DataFrame, int window);
 
 // Rollender einfacher gleitender Durchschnitt
-vector<float> rolling_sma(vector<float> DataFrame, int window);
+vector<float> rolling_sma(const vector<float>& DataFrame, int window);
 
 // Rollende Standardabweichung
 vector<float> rolling_stddev(const vector<float>& DataFrame, int window);
@@ -30,16 +32,16 @@ vector<float> rolling_stddev(const vector<float>& DataFrame, int window);
 float correlation(vector<float> a, vector<float> b, int window);
 
 // Rollender Korrelationskoeffizient
-vector<float> rolling_correlation(vector<float> a, vector<float> b, int window);
+vector<float> rolling_correlation(const vector<float>& a, const vector<float>& b, int window);
 
 // Kovarianz für ein einzelnes Fenster
 float covariance(vector<float> a, vector<float> b, int window);
 
 // Rollende Kovarianz
-vector<float> rolling_covariance(vector<float> a, vector<float> b, int window);
+vector<float> rolling_covariance(const vector<float>& a, const vector<float>& b, int window);
 
 // Linearer gewichteter gleitender Durchschnitt (LWMA)
-vector<float> decay_linear(vector<float> a, int period = 10);
+vector<float> decay_linear(const vector<float>& a, int period = 10);
 
 // ====== Implementierung ======
 
@@ -56,90 +58,224 @@ void print_result(const vector<float>& result) {
     cout << "]" << endl;
 }
 
-vector<float> rolling_ts_sum(vector<float> DataFrame, int window) {
-    vector<float> result;
-    for (size_t i = 0; i < DataFrame.size(); i++) {
-        if (i + 1 < window) {
-            result.push_back(NAN);
+/**
+ * @brief rolling_ts_sum / rolling_sma 的滑动状态：double 和式，NaN 只记数
+ *
+ * 与 SlidingVariance 相同的重算时机：窗口起点为 window 的整数倍时 rebuild()，使增删累积的舍入漂移有界。
+ * 批量版与流式版 TsSumStream / TsMeanStream 共用此结构，二者逐位一致。
+ */
+struct SlidingSum {
+    double sum = 0.0;
+    int nan_count = 0;
+
+    void add(float x) {
+        if (isnan(x)) ++nan_count;
+        else sum += x;
+    }
+
+    void remove(float x) {
+        if (isnan(x)) --nan_count;
+        else sum -= x;
+    }
+
+    // 以 at(0..n-1) 构成的窗口从头重算和式（从最旧到最新）
+    template <typename At>
+    void rebuild(size_t n, At&& at) {
+        sum = 0.0;
+        nan_count = 0;
+        for (size_t k = 0; k < n; ++k) add(at(k));
+    }
+
+    // 窗口和 / 窗口均值；窗口内含 NaN 时为 NaN
+    float total() const { return nan_count > 0 ? NAN : (float)sum; }
+    float mean(int window) const { return nan_count > 0 ? NAN : (float)(sum / window); }
+};
+
+/**
+ * @brief 滑动窗口和 / 均值的单遍 O(n) 实现，零堆分配
+ *
+ * 每步只加入新元素、移出旧元素；窗口起点为 window 的整数倍时重算（O(window)，均摊每步 O(1)）。
+ *
+ * @tparam IsMean true：输出 sum / window；false：输出 sum
+ * @param origin  a[0] 的绝对日期：重算落在绝对日期 window 整数倍的窗口上（首个窗口总是重算），同 rolling_stddev
+ */
+template <bool IsMean>
+inline void sliding_window_sum(span<const float> a, int window, span<float> out, size_t origin = 0) {
+    size_t n = a.size(), w = window < 1 ? 1 : (size_t)window;
+    fill(out.begin(), out.begin() + min(w - 1, n), NAN);
+    SlidingSum acc;
+    for (size_t i = w - 1; i < n; ++i) {
+        size_t start = i + 1 - w;
+        if (start == 0 || (origin + start) % w == 0) {
+            acc.rebuild(w, [&](size_t k) { return a[start + k]; });
         } else {
-            float sum = 0;
-            for (int j = 0; j < window; j++) {
-                sum += DataFrame[i - j];
-            }
-            result.push_back(sum);
+            acc.add(a[i]);
+            acc.remove(a[start - 1]);
         }
+        out[i] = IsMean ? acc.mean((int)w) : acc.total();
     }
+}
+
+// span 重载：写入调用方提供的 out（与 DataFrame 等长），单遍 O(n)，零堆分配
+// origin 为 DataFrame[0] 的绝对日期（同 rolling_stddev）
+inline void rolling_ts_sum(span<const float> DataFrame, int window, span<float> out, size_t origin = 0) {
+    sliding_window_sum<false>(DataFrame, window, out, origin);
+}
+
+vector<float> rolling_ts_sum(const vector<float>& DataFrame, int window) {
+    vector<float> result(DataFrame.size());
+    rolling_ts_sum(span<const float>(DataFrame), window, span<float>(result));
     return result;
 }
 
-vector<float> rolling_sma(vector<float> DataFrame, int window) {
-    vector<float> result;
-    for (int i = 0; i < DataFrame.size(); ++i) {
-        if (i + 1 < window) {
-            result.push_back(NAN);
+// span 重载：写入调用方提供的 out（与 DataFrame 等长），单遍 O(n)，零堆分配
+// origin 为 DataFrame[0] 的绝对日期（同 rolling_stddev）
+inline void rolling_sma(span<const float> DataFrame, int window, span<float> out, size_t origin = 0) {
+    sliding_window_sum<true>(DataFrame, window, out, origin);
+}
+
+vector<float> rolling_sma(const vector<float>& DataFrame, int window) {
+    vector<float> result(DataFrame.size());
+    rolling_sma(span<const float>(DataFrame), window, span<float>(result));
+    return result;
+}
+
+/**
+ * @brief 前缀和：一次 O(n) 构建后，任意窗口长度的滑动和 / 均值每个输出 O(1)
+ *
+ * sum[i] 为前 i 个元素中非 NaN 值的 double 累加和，nan_count[i] 为其中 NaN 的个数，
+ * 窗口 [i+1-w, i] 的和为 sum[i+1] - sum[i+1-w]。同一序列上的多个窗口（adv5…adv180、各个 sum(x, w)）
+ * 共用一个前缀数组；结果与 rolling_ts_sum / rolling_sma 只差 double 舍入量级。
+ */
+struct PrefixSum {
+    vector<double> sum;
+    vector<uint32_t> nan_count;
+
+    PrefixSum() = default;
+    explicit PrefixSum(span<const float> x) { build(x); }
+
+    void build(span<const float> x) {
+        size_t n = x.size();
+        sum.resize(n + 1);
+        nan_count.resize(n + 1);
+        sum[0] = 0.0;
+        nan_count[0] = 0;
+        for (size_t i = 0; i < n; ++i) {
+            bool nan = isnan(x[i]);
+            sum[i + 1] = sum[i] + (nan ? 0.0 : (double)x[i]);
+            nan_count[i + 1] = nan_count[i] + nan;
+        }
+    }
+
+    size_t size() const { return sum.empty() ? 0 : sum.size() - 1; }
+
+    // 对应 rolling_ts_sum(x, window, out)：热身期、NaN 规则一致，数值差 double 舍入量级
+    void rolling_sum(int window, span<float> out) const { emit<false>(window, out); }
+
+    // 对应 rolling_sma(x, window, out)，同上
+    void rolling_mean(int window, span<float> out) const { emit<true>(window, out); }
+
+   private:
+    template <bool IsMean>
+    void emit(int window, span<float> out) const {
+        size_t n = size(), w = window < 1 ? 1 : (size_t)window;
+        fill(out.begin(), out.begin() + min(w - 1, n), NAN);
+        for (size_t i = w; i <= n; ++i) {
+            double s = sum[i] - sum[i - w];
+            out[i - 1] = nan_count[i] != nan_count[i - w] ? NAN : (float)(IsMean ? s / (double)w : s);
+        }
+    }
+};
+
+/**
+ * @brief rolling_stddev 的滑动状态：以锚点 anchor 平移后的 double 和式 Σd、Σd²，NaN 只记数
+ *
+ * 与 sliding_comoment 相同的做法：平移消除价格量级数据上 Σx² - (Σx)²/n 的灾难性抵消；
+ * 调用方每 window 步用 rebuild() 以当前窗口均值重新锚定并重算和式，使增删累积的舍入漂移有界
+ * （流式版本可能连续运行数年，这一点尤其重要）。批量版 rolling_stddev 与流式版 StddevStream 共用此结构。
+ */
+struct SlidingVariance {
+    double anchor = 0.0, sum = 0.0, sum_sq = 0.0;
+    int nan_count = 0;
+
+    void add(float x) {
+        if (isnan(x)) {
+            ++nan_count;
+            return;
+        }
+        double d = x - anchor;
+        sum += d;
+        sum_sq += d * d;
+    }
+
+    void remove(float x) {
+        if (isnan(x)) {
+            --nan_count;
+            return;
+        }
+        double d = x - anchor;
+        sum -= d;
+        sum_sq -= d * d;
+    }
+
+    // 以 at(0..n-1) 构成的窗口重新锚定并重算和式
+    template <typename At>
+    void rebuild(size_t n, At&& at) {
+        double mean = 0.0;
+        size_t valid = 0;
+        for (size_t k = 0; k < n; ++k) {
+            float x = at(k);
+            if (isnan(x)) continue;
+            mean += x;
+            ++valid;
+        }
+        anchor = valid ? mean / valid : 0.0;
+        sum = sum_sq = 0.0;
+        nan_count = 0;
+        for (size_t k = 0; k < n; ++k) add(at(k));
+    }
+
+    // 样本标准差；窗口内含 NaN 时为 NaN，方差因舍入为负时截为 0
+    float stddev(int window) const {
+        if (nan_count > 0) return NAN;
+        double var = (sum_sq - sum * sum / window) / (window - 1);
+        return (float)std::sqrt(var > 0.0 ? var : 0.0);
+    }
+};
+
+// span 重载：写入调用方提供的 out（与 DataFrame 等长），零堆分配。
+// origin 为 DataFrame[0] 的绝对日期：重新锚定落在绝对日期 window 整数倍的窗口上（首个窗口总是重算），
+// 序列截取自更长历史时，截取点之后第一个锚点窗口起的输出与在完整历史上求值逐位一致
+inline void rolling_stddev(span<const float> DataFrame, int window, span<float> out, size_t origin = 0) {
+    size_t n = DataFrame.size();
+    fill(out.begin(), out.end(), NAN);
+    if (window <= 1 || n < (size_t)window) return;
+    size_t w = (size_t)window;
+
+    // 滑动：每步 O(1)，仅加入新元素、移出旧元素；窗口起点为 window 的整数倍时重新锚定
+    SlidingVariance acc;
+    for (size_t i = w - 1; i < n; ++i) {
+        size_t start = i + 1 - w;
+        if (start == 0 || (origin + start) % w == 0) {
+            acc.rebuild(w, [&](size_t k) { return DataFrame[start + k]; });
         } else {
-            float sum = 0;
-            for (int j = 0; j < window; ++j) {
-                sum += DataFrame[i - j];
-            }
-            float avg = sum / window;
-            result.push_back(avg);
+            acc.add(DataFrame[i]);
+            acc.remove(DataFrame[start - 1]);
         }
+        out[i] = acc.stddev(window);
     }
-    return result;
 }
 
 inline vector<float> rolling_stddev(const vector<float>& DataFrame, int window) {
-    int n = (int)DataFrame.size();
-    vector<float> result(n, NAN);
-    if (window <= 1 || n < window) return result;
-
-    // 初始化第一个窗口的 sum 和 sum_sq
-    float sum = 0.0f, sum_sq = 0.0f;
-    for (int i = 0; i < window; ++i) {
-        sum    += DataFrame[i];
-        sum_sq += DataFrame[i] * DataFrame[i];
-    }
-    // 第一个有效输出
-    {
-        float var = (sum_sq - sum * sum / window) / (window - 1);
-        result[window - 1] = std::sqrt(var > 0.0f ? var : 0.0f);
-    }
-    // 滑动：每步 O(1)，仅加入新元素、移出旧元素
-    for (int i = window; i < n; ++i) {
-        float x_new = DataFrame[i];
-        float x_old = DataFrame[i - window];
-        sum    += x_new - x_old;
-        sum_sq += x_new * x_new - x_old * x_old;
-        float var = (sum_sq - sum * sum / window) / (window - 1);
-        result[i] = std::sqrt(var > 0.0f ? var : 0.0f);
-    }
+    vector<float> result(DataFrame.size());
+    rolling_stddev(span<const float>(DataFrame), window, span<float>(result));
     return result;
 }
 
 // in-place 重载：写入调用方提供的 out，容量足够时零堆分配
 inline void rolling_stddev(const vector<float>& DataFrame, int window, vector<float>& out) {
-    int n = (int)DataFrame.size();
-    out.assign(n, NAN);
-    if (window <= 1 || n < window) return;
-
-    float sum = 0.0f, sum_sq = 0.0f;
-    for (int i = 0; i < window; ++i) {
-        sum    += DataFrame[i];
-        sum_sq += DataFrame[i] * DataFrame[i];
-    }
-    {
-        float var = (sum_sq - sum * sum / window) / (window - 1);
-        out[window - 1] = std::sqrt(var > 0.0f ? var : 0.0f);
-    }
-    for (int i = window; i < n; ++i) {
-        float x_new = DataFrame[i];
-        float x_old = DataFrame[i - window];
-        sum    += x_new - x_old;
-        sum_sq += x_new * x_new - x_old * x_old;
-        float var = (sum_sq - sum * sum / window) / (window - 1);
-        out[i] = std::sqrt(var > 0.0f ? var : 0.0f);
-    }
+    out.resize(DataFrame.size());
+    rolling_stddev(span<const float>(DataFrame), window, span<float>(out));
 }
 
 float correlation(vector<float> a, vector<float> b, int window) {
@@ -170,27 +306,6 @@ float correlation(vector<float> a, vector<float> b, int window) {
     return result;
 }
 
-vector<float> rolling_correlation(vector<float> a, vector<float> b, int window) {
-    vector<float> result;
-
-    for (int i = 0; i < a.size(); ++i) {
-        if (i + 1 < window) {
-            result.push_back(NAN);
-        } else {
-            vector<float> window_a, window_b;
-            for (int j = 0; j < window; ++j) {
-                window_a.push_back(a[i - j]);
-                window_b.push_back(b[i - j]);
-            }
-
-            float corr = correlation(window_a, window_b, window_a.size());
-            result.push_back(corr);
-        }
-    }
-
-    return result;
-}
-
 float covariance(vector<float> a, vector<float> b, int window) {
     float avg_a = rolling_sma(a, a.size()).back();
     float avg_b = rolling_sma(b, b.size()).back();
@@ -211,22 +326,114 @@ float covariance(vector<float> a, vector<float> b, int window) {
     return SPD / (a.size() - 1);
 }
 
-vector<float> rolling_covariance(vector<float> a, vector<float> b, int window) {
-    vector<float> result;
-    for (int i = 0; i < a.size(); ++i) {
-        if (i + 1 < window) {
-            result.push_back(NAN);
+/**
+ * @brief 滑动二阶矩：单遍 O(n) 计算 rolling_correlation / rolling_covariance
+ *
+ * 以锚点 (kx, ky) 平移后的 double 和式维护 Σdx、Σdy、Σdx²、Σdy²、Σdx·dy，每步只加入新点、移出旧点。
+ * 平移消除了大均值下 Σx² - (Σx)²/n 的灾难性抵消；每 window 步以当前窗口均值重新锚定并重算和式
+ * （O(window)，均摊每步 O(1)），使增删累积的舍入漂移有界。
+ * 窗口内任一侧含 NaN 时输出 NaN；相关系数在任一侧方差为零（相对 Σd² 低于 1e-12）时输出 NaN，
+ * 与逐窗口两遍算法的 0/0 一致。
+ *
+ * @tparam IsCorr true：SPD / sqrt(ss_a · ss_b)；false：SPD / (window - 1)
+ * @param origin  a[0] 的绝对日期：锚点窗口按绝对日期对齐（首个窗口总是重算），同 rolling_stddev
+ */
+template <bool IsCorr>
+inline void sliding_comoment(span<const float> a, span<const float> b, int window, span<float> out, size_t origin = 0) {
+    size_t n = a.size();
+    if (window < 1 || n < (size_t)window) {
+        fill(out.begin(), out.end(), NAN);
+        return;
+    }
+    size_t w = (size_t)window;
+    fill(out.begin(), out.begin() + (w - 1), NAN);
+
+    double kx = 0, ky = 0;                             // 锚点
+    double sx = 0, sy = 0, sxx = 0, syy = 0, sxy = 0;  // 平移后的和式
+    size_t nan_count = 0;                              // 窗口内含 NaN 的点数
+
+    auto is_bad = [&](size_t j) { return isnan(a[j]) || isnan(b[j]); };
+    auto add = [&](size_t j, double sign) {
+        double dx = a[j] - kx, dy = b[j] - ky;
+        sx += sign * dx;
+        sy += sign * dy;
+        sxx += sign * dx * dx;
+        syy += sign * dy * dy;
+        sxy += sign * dx * dy;
+    };
+    // 以窗口 [start, start + w) 的均值为新锚点，从头重算和式
+    auto reanchor = [&](size_t start) {
+        double mx = 0, my = 0;
+        size_t valid = 0;
+        nan_count = 0;
+        for (size_t j = start; j < start + w; ++j) {
+            if (is_bad(j)) {
+                ++nan_count;
+                continue;
+            }
+            mx += a[j];
+            my += b[j];
+            ++valid;
+        }
+        kx = valid ? mx / valid : 0.0;
+        ky = valid ? my / valid : 0.0;
+        sx = sy = sxx = syy = sxy = 0;
+        for (size_t j = start; j < start + w; ++j)
+            if (!is_bad(j)) add(j, 1.0);
+    };
+
+    double wd = (double)w;
+    for (size_t i = w - 1; i < n; ++i) {
+        size_t start = i + 1 - w;
+        if (start == 0 || (origin + start) % w == 0) {
+            reanchor(start);
         } else {
-            vector<float> window_a, window_b;
-            for (int j = 0; j < window; ++j) {
-                window_a.push_back(a[i - j]);
-                window_b.push_back(b[i - j]);
+            size_t old = start - 1;
+            if (is_bad(old)) --nan_count;
+            else add(old, -1.0);
+            if (is_bad(i)) ++nan_count;
+            else add(i, 1.0);
+        }
+        if (nan_count > 0) {
+            out[i] = NAN;
+            continue;
+        }
+        double spd = sxy - sx * sy / wd;
+        if constexpr (IsCorr) {
+            double ss_a = sxx - sx * sx / wd;
+            double ss_b = syy - sy * sy / wd;
+            if (ss_a <= sxx * 1e-12 || ss_b <= syy * 1e-12) {
+                out[i] = NAN;
+                continue;
             }
-            float cov = covariance(window_a, window_b, window_a.size());
-            result.push_back(cov);
+            out[i] = (float)(spd / sqrt(ss_a * ss_b));
+        } else {
+            out[i] = (float)(spd / (wd - 1.0));
         }
     }
+}
 
+// span 重载：滑动二阶矩，单遍 O(n)，零堆分配
+inline void rolling_correlation(span<const float> a, span<const float> b, int window, span<float> out,
+                                size_t origin = 0) {
+    sliding_comoment<true>(a, b, window, out, origin);
+}
+
+// span 重载：滑动二阶矩，单遍 O(n)，零堆分配
+inline void rolling_covariance(span<const float> a, span<const float> b, int window, span<float> out,
+                               size_t origin = 0) {
+    sliding_comoment<false>(a, b, window, out, origin);
+}
+
+vector<float> rolling_correlation(const vector<float>& a, const vector<float>& b, int window) {
+    vector<float> result(a.size());
+    rolling_correlation(span<const float>(a), span<const float>(b), window, span<float>(result));
+    return result;
+}
+
+vector<float> rolling_covariance(const vector<float>& a, const vector<float>& b, int window) {
+    vector<float> result(a.size());
+    rolling_covariance(span<const float>(a), span<const float>(b), window, span<float>(result));
     return result;
 }
 
@@ -309,6 +516,24 @@ vector<float> ts_rank_optimized(const vector<float>& a, int window) {
     return result;
 }
 
+// span 重载：平均名次 = 严格小于个数 + (相等个数 + 1) / 2，计数即可，无需排序与临时向量
+inline void ts_rank(span<const float> a, int window, span<float> out) {
+    size_t w = (size_t)window;
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (i + 1 < w) {
+            out[i] = NAN;
+            continue;
+        }
+        float last_value = a[i];
+        size_t less = 0, equal = 0;
+        for (size_t j = i + 1 - w; j <= i; ++j) {
+            less += a[j] < last_value;
+            equal += a[j] == last_value;
+        }
+        out[i] = (2 * less + 1 + equal) / 2.0f;
+    }
+}
+
 // Hochoptimierte Version: gleitendes Fenster + multiset, Komplexität: O(n × log
 // window) statt O(n × window × log window)
 vector<float> ts_rank_ultra(const vector<float>& a, int window) {
@@ -349,6 +574,89 @@ vector<float> ts_rank_ultra(const vector<float>& a, int window) {
     return result;
 }
 
+/**
+ * @brief 树状数组（Fenwick 树）计数器：在值域压缩后的下标上维护窗口内各值出现次数
+ *
+ * insert / erase / 前缀计数均为 O(log m)，m 为不同取值个数。
+ */
+class FenwickCounter {
+   public:
+    void reset(size_t m) { tree_.assign(m + 1, 0); }
+    void reserve(size_t m) { tree_.reserve(m + 1); }
+    void insert(size_t code) { update(code, 1); }
+    void erase(size_t code) { update(code, -1); }
+
+    // 下标严格小于 code 的元素个数
+    size_t count_less(size_t code) const {
+        int64_t c = 0;
+        for (size_t i = code; i > 0; i -= i & (~i + 1)) c += tree_[i];
+        return (size_t)c;
+    }
+
+    // 等于 code 的元素个数
+    size_t count_equal(size_t code) const { return count_less(code + 1) - count_less(code); }
+
+   private:
+    void update(size_t code, int32_t delta) {
+        for (size_t i = code + 1; i < tree_.size(); i += i & (~i + 1)) tree_[i] += delta;
+    }
+
+    vector<int32_t> tree_;
+};
+
+/**
+ * @brief 基于树状数组的 ts_rank：整段序列先做值域压缩，窗口滑动时 O(log w) 增删、O(log w) 求名次
+ *
+ * 平均名次 = 严格小于个数 + (相等个数 + 1) / 2，与 rolling_rank 的并列处理一致。
+ * NaN 不进入树（与任何值比较都为假），NaN 处的结果与计数版 ts_rank 相同。
+ * codes / domain / tree 由调用方提供，可跨调用复用以避免分配。
+ */
+inline void ts_rank_fenwick(span<const float> a, int window, span<float> out, vector<uint32_t>& codes,
+                            vector<float>& domain, FenwickCounter& tree) {
+    size_t n = a.size();
+    domain.clear();
+    for (float v : a)
+        if (!isnan(v)) domain.push_back(v);
+    sort(domain.begin(), domain.end());
+    domain.erase(unique(domain.begin(), domain.end()), domain.end());
+
+    const uint32_t kNaNCode = (uint32_t)domain.size();
+    codes.resize(n);
+    for (size_t i = 0; i < n; ++i)
+        codes[i] = isnan(a[i]) ? kNaNCode : (uint32_t)(lower_bound(domain.begin(), domain.end(), a[i]) - domain.begin());
+
+    size_t w = (size_t)window;
+    tree.reset(domain.size());
+    for (size_t i = 0; i < n; ++i) {
+        if (codes[i] != kNaNCode) tree.insert(codes[i]);
+        if (i >= w && codes[i - w] != kNaNCode) tree.erase(codes[i - w]);
+
+        if (i + 1 < w) {
+            out[i] = NAN;
+        } else if (codes[i] == kNaNCode) {
+            out[i] = 0.5f;
+        } else {
+            size_t less = tree.count_less(codes[i]);
+            size_t equal = tree.count_equal(codes[i]);
+            out[i] = (2 * less + 1 + equal) / 2.0f;
+        }
+    }
+}
+
+inline void ts_rank_fenwick(span<const float> a, int window, span<float> out) {
+    vector<uint32_t> codes;
+    vector<float> domain;
+    FenwickCounter tree;
+    ts_rank_fenwick(a, window, out, codes, domain, tree);
+}
+
+// 树状数组版本：O(n log n) 值域压缩 + O(n log window) 滑动
+inline vector<float> ts_rank_fenwick(const vector<float>& a, int window) {
+    vector<float> result(a.size());
+    ts_rank_fenwick(span<const float>(a), window, span<float>(result));
+    return result;
+}
+
 float rolling_prod(vector<float> a) {
     float result = 1;
 
@@ -373,47 +681,106 @@ vector<float> product(vector<float> a, int window) {
     return result;
 }
 
-vector<float> ts_min(vector<float> a, int window) {
-    vector<float> result;
-
-    auto getminval = [](vector<float> aa) {
-        sort(aa.begin(), aa.end());
-        return aa.front();
-    };
+// span 重载：写入调用方提供的 out，零堆分配
+inline void product(span<const float> a, int window, span<float> out) {
+    size_t w = (size_t)window;
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (i + 1 < w) {
+            out[i] = NAN;
+            continue;
+        }
+        float prod = 1;
+        for (size_t j = i + 1 - w; j <= i; ++j) prod *= a[j];
+        out[i] = prod;
+    }
+}
 
-    // Alternative ohne auto: Funktionszeiger auf Lambda mit Parameter
-    // float (*getminval_without_auto)(vector<float>) = [](vector<float> aa) {
-    //     sort(aa.begin(), aa.end());
-    //     return aa.front();
-    // };
+/**
+ * @brief 单调队列滑动窗口内核：每个元素至多入队、出队各一次，均摊每步 O(1)
+ *
+ * 队列中保存窗口内"仍可能成为最优"的下标，按值单调排列，队首即当前窗口最优元素。
+ * Better(x, y) 为真表示 x 严格优于 y（ts_max: x > y，ts_min: x < y）；值相等时先入队者保留在前，
+ * 因此队首总是最早出现的最优元素（与 ts_argmax/ts_argmin 的并列规则一致）。
+ * NaN 不入队：遇到 NaN 时清空队列并记录其位置，包含该位置的窗口输出 NaN。
+ *
+ * @param idx_buf 调用方提供的环形队列存储，容量至少为 window，循环内复用即零堆分配
+ * @param emit    emit(i, best, start) 返回窗口 [start, i] 的输出值，best 为最优元素下标
+ */
+template <typename Better, typename Emit>
+inline void monotonic_window(span<const float> a, int window, span<float> out, vector<size_t>& idx_buf,
+                             Better better, Emit emit) {
+    size_t n = a.size();
+    if (window < 1) {
+        fill(out.begin(), out.end(), NAN);
+        return;
+    }
+    size_t w = (size_t)window;
+    // 环形队列容量取 >= window 的 2 的幂，以位与代替取模
+    size_t cap = bit_ceil(w), mask = cap - 1;
+    if (idx_buf.size() < cap) idx_buf.resize(cap);
 
-    for (int i = 0; i < a.size(); ++i) {
-        if (i + 1 < window) {
-            result.push_back(NAN);
+    size_t head = 0, count = 0;  // 队首位于 idx_buf[head & mask]，共 count 个元素
+    size_t last_nan = SIZE_MAX;  // 最近一次 NaN 的位置，SIZE_MAX 表示尚未出现
+    for (size_t i = 0; i < n; ++i) {
+        size_t start = i + 1 < w ? 0 : i + 1 - w;
+        // 先让滑出窗口的队首出队，保证队列长度不超过 window
+        while (count > 0 && idx_buf[head & mask] < start) {
+            ++head;
+            --count;
+        }
+        float x = a[i];
+        if (isnan(x)) {
+            count = 0;
+            last_nan = i;
         } else {
-            result.push_back(getminval(vector<float>(&a[i - window + 1], &a[i + 1])));
+            // 队尾中不优于 x 的元素永远不会再成为最优，弹出
+            while (count > 0 && better(x, a[idx_buf[(head + count - 1) & mask]])) --count;
+            idx_buf[(head + count) & mask] = i;
+            ++count;
+        }
+        if (i + 1 < w) {
+            out[i] = NAN;
+            continue;
         }
+        out[i] = (last_nan != SIZE_MAX && last_nan >= start) ? NAN : emit(i, idx_buf[head & mask], start);
     }
+}
 
-    return result;
+// 单调队列 O(n)：窗口内含 NaN 时输出 NaN（与 pandas min_periods=window 一致）
+inline void ts_min(span<const float> a, int window, span<float> out, vector<size_t>& idx_buf) {
+    monotonic_window(
+        a, window, out, idx_buf, [](float x, float y) { return x < y; },
+        [&](size_t, size_t best, size_t) { return a[best]; });
 }
 
-vector<float> ts_max(vector<float> a, int window) {
-    vector<float> result;
+// span 重载：写入调用方提供的 out，队列存储在调用内分配一次
+inline void ts_min(span<const float> a, int window, span<float> out) {
+    vector<size_t> idx_buf;
+    ts_min(a, window, out, idx_buf);
+}
 
-    auto getmaxval = [](vector<float> aa) {
-        sort(aa.begin(), aa.end());
-        return aa.back();
-    };
+vector<float> ts_min(const vector<float>& a, int window) {
+    vector<float> result(a.size());
+    ts_min(span<const float>(a), window, span<float>(result));
+    return result;
+}
 
-    for (int i = 0; i < a.size(); ++i) {
-        if (i + 1 < window) {
-            result.push_back(NAN);
-        } else {
-            result.push_back(getmaxval(vector<float>(&a[i - window + 1], &a[i + 1])));
-        }
-    }
+// 单调队列 O(n)：窗口内含 NaN 时输出 NaN（与 pandas min_periods=window 一致）
+inline void ts_max(span<const float> a, int window, span<float> out, vector<size_t>& idx_buf) {
+    monotonic_window(
+        a, window, out, idx_buf, [](float x, float y) { return x > y; },
+        [&](size_t, size_t best, size_t) { return a[best]; });
+}
+
+// span 重载：写入调用方提供的 out，队列存储在调用内分配一次
+inline void ts_max(span<const float> a, int window, span<float> out) {
+    vector<size_t> idx_buf;
+    ts_max(a, window, out, idx_buf);
+}
 
+vector<float> ts_max(const vector<float>& a, int window) {
+    vector<float> result(a.size());
+    ts_max(span<const float>(a), window, span<float>(result));
     return result;
 }
 
@@ -430,6 +797,12 @@ vector<float> delta(vector<float> a, int period) {
     return result;
 }
 
+// span 重载：写入调用方提供的 out，零堆分配
+inline void delta(span<const float> a, int period, span<float> out) {
+    size_t p = (size_t)period;
+    for (size_t i = 0; i < a.size(); ++i) out[i] = i < p ? NAN : a[i] - a[i - p];
+}
+
 inline vector<float> delay(vector<float> a, int period) {
     vector<float> result;
 
@@ -445,69 +818,88 @@ inline vector<float> delay(vector<float> a, int period) {
     return result;
 }
 
-inline vector<float> alpha_rank(const vector<float>& a) {
-    size_t n = a.size();
-    vector<float> result(n, NAN);
-
-    // NAN-Werte ausschließen: std::sort mit NAN ist undefiniertes Verhalten
-    vector<size_t> valid_idx;
-    for (size_t i = 0; i < n; ++i)
-        if (!isnan(a[i])) valid_idx.push_back(i);
+// span 重载：写入调用方提供的 out，零堆分配
+inline void delay(span<const float> a, int period, span<float> out) {
+    size_t p = (size_t)period;
+    for (size_t i = 0; i < a.size(); ++i) out[i] = i < p ? NAN : a[i - p];
+}
 
-    size_t m = valid_idx.size();
-    if (m == 0) return result;
+/// 截面规模不小于该阈值时 alpha_rank 自动改用基数排序（交叉点见 BM_Rank_Radix_VaryingSize）
+constexpr size_t kAlphaRankRadixThreshold = 512;
 
-    // valid_idx 原地排序，省去 sorted_idx 的额外拷贝和堆分配
-    sort(valid_idx.begin(), valid_idx.end(), [&](size_t i, size_t j) { return a[i] < a[j]; });
+/**
+ * @brief 将 float 映射为保序的 uint32 键：负数按位取反，非负数翻转符号位
+ *
+ * -0.0 先规范化为 +0.0，使键相等当且仅当浮点值相等（调用方保证非 NaN）。
+ */
+inline uint32_t float_order_key(float v) {
+    uint32_t bits = bit_cast<uint32_t>(v + 0.0f);
+    return bits ^ ((bits >> 31) ? 0xFFFFFFFFu : 0x80000000u);
+}
 
-    // Perzentilrang mit Mittelwert bei Gleichstand zuweisen
-    size_t i = 0;
-    while (i < m) {
-        size_t j = i;
-        while (j < m && a[valid_idx[i]] == a[valid_idx[j]]) j++;
-        float avg_rank = (i + 1 + j) / 2.0f;
-        float pct_rank = avg_rank / (float)m;
-        for (size_t k = i; k < j; ++k) result[valid_idx[k]] = pct_rank;
-        i = j;
+/**
+ * @brief 按 64 位键的高 32 位做稳定 LSD 基数排序（4 趟 8 位），返回有序数据所在的缓冲区
+ *
+ * 所有字节的直方图在一趟扫描中得到，某字节全部相同时跳过该趟；keys 与 tmp 各需 m 个元素。
+ */
+template <typename U>
+inline U* radix_sort_by_high32(U* keys, U* tmp, size_t m) {
+    size_t hist[4][256] = {};
+    for (size_t i = 0; i < m; ++i) {
+        uint32_t k = (uint32_t)(keys[i] >> 32);
+        for (int b = 0; b < 4; ++b) hist[b][(k >> (8 * b)) & 0xFF]++;
     }
-
-    return result;
+    for (int b = 0; b < 4; ++b) {
+        int shift = 32 + 8 * b;
+        if (hist[b][(keys[0] >> shift) & 0xFF] == m) continue;  // 该字节全部相同
+        size_t offset = 0;
+        for (size_t d = 0; d < 256; ++d) {
+            size_t c = hist[b][d];
+            hist[b][d] = offset;
+            offset += c;
+        }
+        for (size_t i = 0; i < m; ++i) tmp[hist[b][(keys[i] >> shift) & 0xFF]++] = keys[i];
+        swap(keys, tmp);
+    }
+    return keys;
 }
 
 /**
- * @brief alpha_rank 的 span 重载，避免调用方额外拷贝
+ * @brief alpha_rank 的 LSD 基数排序路径
  *
- * 与 vector 版语义完全相同：对输入数据做百分位截面排名（NaN 保留）。
- * 供截面因子函数直接传入连续内存视图，无需构造临时 vector。
- *
- * @param a      输入数据的只读视图（连续内存）
- * @return       与 a 等长的排名结果，NaN 位置保持 NaN，有效值域 (0, 1]
+ * 每个有效值打包为 (保序键 << 32 | 下标) 的 64 位整数，交给 radix_sort_by_high32 排序。
+ * 并列判断直接比较键，输出与比较排序路径逐位一致。buf 前半段存键、后半段作乒乓缓冲区，循环内复用不再分配。
  */
-inline vector<float> alpha_rank(span<const float> a) {
+template <typename U>
+    requires(is_unsigned_v<U> && sizeof(U) == sizeof(uint64_t))
+inline void alpha_rank_radix(span<const float> a, span<float> out, vector<U>& buf) {
     size_t n = a.size();
-    vector<float> result(n, NAN);
+    buf.resize(2 * n);
+    U* keys = buf.data();
+    U* tmp = buf.data() + n;
 
-    vector<size_t> valid_idx;
-    for (size_t i = 0; i < n; ++i)
-        if (!isnan(a[i])) valid_idx.push_back(i);
-
-    size_t m = valid_idx.size();
-    if (m == 0) return result;
+    size_t m = 0;
+    for (size_t i = 0; i < n; ++i) {
+        if (isnan(a[i])) {
+            out[i] = NAN;
+        } else {
+            keys[m++] = (U)float_order_key(a[i]) << 32 | (U)i;
+        }
+    }
+    if (m == 0) return;
 
-    // valid_idx 原地排序，省去 sorted_idx 的额外拷贝和堆分配
-    sort(valid_idx.begin(), valid_idx.end(), [&](size_t i, size_t j) { return a[i] < a[j]; });
+    keys = radix_sort_by_high32(keys, tmp, m);
 
     size_t i = 0;
     while (i < m) {
+        uint32_t key = (uint32_t)(keys[i] >> 32);
         size_t j = i;
-        while (j < m && a[valid_idx[i]] == a[valid_idx[j]]) j++;
+        while (j < m && (uint32_t)(keys[j] >> 32) == key) j++;
         float avg_rank = (i + 1 + j) / 2.0f;
         float pct_rank = avg_rank / (float)m;
-        for (size_t k = i; k < j; ++k) result[valid_idx[k]] = pct_rank;
+        for (size_t k = i; k < j; ++k) out[(uint32_t)keys[k]] = pct_rank;
         i = j;
     }
-
-    return result;
 }
 
 /**
@@ -521,11 +913,18 @@ inline vector<float> alpha_rank(span<const float> a) {
  * @param idx_buf 调用方提供的临时索引缓冲区，循环内复用；建议循环外 reserve(n)
  *
  * 排序策略：
- *   m <= 32  → 插入排序（O(m²) 但常数极小，分支预测友好）
- *   m >  32  → std::sort（introsort，O(m log m)）
+ *   m <= 32                          → 插入排序（O(m²) 但常数极小，分支预测友好）
+ *   m >  32                          → std::sort（introsort，O(m log m)）
+ *   n >= kAlphaRankRadixThreshold    → LSD 基数排序（O(n)，见 alpha_rank_radix）
  */
 inline void alpha_rank(span<const float> a, span<float> out, vector<size_t>& idx_buf) {
     size_t n = a.size();
+    if constexpr (sizeof(size_t) == sizeof(uint64_t)) {
+        if (n >= kAlphaRankRadixThreshold && n <= UINT32_MAX) {
+            alpha_rank_radix(a, out, idx_buf);  // idx_buf 充当 64 位键缓冲区，保持零分配
+            return;
+        }
+    }
     fill(out.begin(), out.end(), NAN);
 
     idx_buf.clear();
@@ -562,6 +961,24 @@ inline void alpha_rank(span<const float> a, span<float> out, vector<size_t>& idx
     }
 }
 
+/**
+ * @brief alpha_rank 的 span 重载，避免调用方额外拷贝
+ *
+ * 与 vector 版语义完全相同：对输入数据做百分位截面排名（NaN 保留）。
+ * 供截面因子函数直接传入连续内存视图，无需构造临时 vector。
+ *
+ * @param a      输入数据的只读视图（连续内存）
+ * @return       与 a 等长的排名结果，NaN 位置保持 NaN，有效值域 (0, 1]
+ */
+inline vector<float> alpha_rank(span<const float> a) {
+    vector<float> result(a.size());
+    vector<size_t> idx_buf;
+    alpha_rank(a, span<float>(result), idx_buf);
+    return result;
+}
+
+inline vector<float> alpha_rank(const vector<float>& a) { return alpha_rank(span<const float>(a)); }
+
 inline vector<float> scale(vector<float> a, float k = 1.0f) {
     float sum = 0;
     for (size_t i = 0; i < a.size(); i++) {
@@ -577,85 +994,332 @@ inline vector<float> scale(vector<float> a, float k = 1.0f) {
     return result;
 }
 
-inline vector<float> ts_argmax(const vector<float>& a, int window = 10) {
-    size_t n = a.size();
-    vector<float> result(n, NAN);
-
-    for (size_t i = window - 1; i < n; ++i) {
-        bool has_nan = false;
-        int maxIdx = 0;
-        for (int j = 0; j < window; ++j) {
-            if (isnan(a[i - window + 1 + j])) {
-                has_nan = true;
-                break;
-            }
-            if (a[i - window + 1 + j] > a[i - window + 1 + maxIdx]) maxIdx = j;
-        }
-        if (!has_nan) result[i] = (float)(maxIdx + 1);
+// span 重载：写入调用方提供的 out，零堆分配
+inline void scale(span<const float> a, float k, span<float> out) {
+    float sum = 0;
+    for (size_t i = 0; i < a.size(); i++) {
+        sum += std::abs(a[i]);
+    }
+    for (size_t i = 0; i < a.size(); i++) {
+        out[i] = a[i] * k / sum;
     }
+}
+
+// 单调队列 O(n)：输出最大值在窗口内的位置（1 起，最旧为 1），并列取最早者；窗口内含 NaN 时输出 NaN
+inline void ts_argmax(span<const float> a, int window, span<float> out, vector<size_t>& idx_buf) {
+    monotonic_window(
+        a, window, out, idx_buf, [](float x, float y) { return x > y; },
+        [](size_t, size_t best, size_t start) { return (float)(best - start + 1); });
+}
+
+// span 重载：写入调用方提供的 out（与 a 等长），队列存储在调用内分配一次
+inline void ts_argmax(span<const float> a, int window, span<float> out) {
+    vector<size_t> idx_buf;
+    ts_argmax(a, window, out, idx_buf);
+}
 
+inline vector<float> ts_argmax(const vector<float>& a, int window = 10) {
+    vector<float> result(a.size());
+    ts_argmax(span<const float>(a), window, span<float>(result));
     return result;
 }
 
 // in-place 重载：写入调用方提供的 out，容量足够时零堆分配
 inline void ts_argmax(const vector<float>& a, int window, vector<float>& out) {
-    size_t n = a.size();
-    out.assign(n, NAN);
+    out.resize(a.size());
+    ts_argmax(span<const float>(a), window, span<float>(out));
+}
 
-    for (size_t i = window - 1; i < n; ++i) {
-        bool has_nan = false;
-        int maxIdx = 0;
-        for (int j = 0; j < window; ++j) {
-            if (isnan(a[i - window + 1 + j])) { has_nan = true; break; }
-            if (a[i - window + 1 + j] > a[i - window + 1 + maxIdx]) maxIdx = j;
-        }
-        if (!has_nan) out[i] = (float)(maxIdx + 1);
-    }
+// 单调队列 O(n)：输出最小值在窗口内的位置（1 起，最旧为 1），并列取最早者；窗口内含 NaN 时输出 NaN
+inline void ts_argmin(span<const float> a, int window, span<float> out, vector<size_t>& idx_buf) {
+    monotonic_window(
+        a, window, out, idx_buf, [](float x, float y) { return x < y; },
+        [](size_t, size_t best, size_t start) { return (float)(best - start + 1); });
+}
+
+// span 重载：写入调用方提供的 out（与 a 等长），队列存储在调用内分配一次
+inline void ts_argmin(span<const float> a, int window, span<float> out) {
+    vector<size_t> idx_buf;
+    ts_argmin(a, window, out, idx_buf);
 }
 
 inline vector<float> ts_argmin(const vector<float>& a, int window = 10) {
-    size_t n = a.size();
-    vector<float> result(n, NAN);
-
-    for (size_t i = window - 1; i < n; ++i) {
-        bool has_nan = false;
-        int minIdx = 0;
-        for (int j = 0; j < window; ++j) {
-            if (isnan(a[i - window + 1 + j])) {
-                has_nan = true;
-                break;
+    vector<float> result(a.size());
+    ts_argmin(span<const float>(a), window, span<float>(result));
+    return result;
+}
+
+/**
+ * @brief decay_linear 的滑动状态：窗口和 sum 与线性加权和 weighted = Σ (k+1)·x_k（k = 0 为最旧），double 累加
+ *
+ * 窗口右移一步时 weighted' = weighted + period·x_new - sum（每个旧元素的权重减 1，最旧者减到 0 移出），
+ * sum' = sum + x_new - x_old，每步 O(1)。NaN 按 0 参与两个和式并单独记数，窗口内含 NaN 时输出 NaN。
+ * 调用方在窗口起点为 period 的整数倍时 rebuild()，使递推累积的舍入漂移有界。
+ * (k+1)·x 与 period·x 在 double 中是精确乘积，是否收缩为 FMA 不影响结果，批量、SIMD、流式三个版本逐位一致。
+ */
+struct SlidingDecay {
+    double sum = 0.0, weighted = 0.0;
+    int nan_count = 0;
+
+    // x_new 进入窗口、x_old 移出窗口（均按 0 计入 NaN）
+    void slide(float x_new, float x_old, int period) {
+        double v_new = isnan(x_new) ? 0.0 : (double)x_new;
+        double v_old = isnan(x_old) ? 0.0 : (double)x_old;
+        weighted += period * v_new - sum;
+        sum += v_new - v_old;
+        nan_count += (int)isnan(x_new) - (int)isnan(x_old);
+    }
+
+    // 以 at(0..n-1) 构成的窗口（0 为最旧）从头重算
+    template <typename At>
+    void rebuild(size_t n, At&& at) {
+        sum = weighted = 0.0;
+        nan_count = 0;
+        for (size_t k = 0; k < n; ++k) {
+            float x = at(k);
+            if (isnan(x)) {
+                ++nan_count;
+                continue;
             }
-            if (a[i - window + 1 + j] < a[i - window + 1 + minIdx]) minIdx = j;
+            sum += x;
+            weighted += (double)(k + 1) * x;
         }
-        if (!has_nan) result[i] = (float)(minIdx + 1);
     }
 
+    float value(int period) const {
+        return nan_count > 0 ? NAN : (float)(weighted / (period * (period + 1.0) / 2.0));
+    }
+};
+
+/**
+ * @brief 线性加权移动平均：权重 (k+1)/divisor，k = 0 为窗口最旧元素，divisor = 1+2+…+period
+ *
+ * 递推实现，每步 O(1)，与 period 无关；窗口起点为 period 的整数倍时从头重算（均摊 O(1)）。
+ * 窗口内含 NaN 时输出 NaN，热身期（前 period - 1 个位置）为 NaN。零堆分配。
+ * origin 为 a[0] 的绝对日期：重算落在绝对日期 period 整数倍的窗口上（首个窗口总是重算），同 rolling_stddev。
+ */
+inline void decay_linear(span<const float> a, int period, span<float> out, size_t origin = 0) {
+    size_t n = a.size(), p = period < 1 ? 1 : (size_t)period;
+    fill(out.begin(), out.begin() + min(p - 1, n), NAN);
+    SlidingDecay acc;
+    for (size_t i = p - 1; i < n; ++i) {
+        size_t start = i + 1 - p;
+        if (start == 0 || (origin + start) % p == 0) acc.rebuild(p, [&](size_t k) { return a[start + k]; });
+        else acc.slide(a[i], a[start - 1], (int)p);
+        out[i] = acc.value((int)p);
+    }
+}
+
+inline vector<float> decay_linear(const vector<float>& a, int period) {
+    vector<float> result(a.size());
+    decay_linear(span<const float>(a), period, span<float>(result));
     return result;
 }
 
-inline vector<float> decay_linear(vector<float> a, int period) {
-    size_t n = a.size();
-    vector<float> result(n, NAN);
+// ====== 统一的 Workspace 重载：op(span<const float> in..., params, span<float> out, Workspace&) ======
 
-    // divisor = 1+2+...+period，用等差数列公式计算
-    float divisor = period * (period + 1) / 2.0f;
+/**
+ * @brief 算子临时存储：需要临时缓冲区的算子从这里取，容量只增不减
+ *
+ * 同一个 Workspace 在循环中反复传入时，缓冲区增长到所需的最大规模后不再分配（稳态零堆分配）。
+ * 不需要临时存储的算子同样接受 Workspace&，使全部算子具有相同的调用形式。
+ * 非线程安全：每个线程使用自己的 Workspace。
+ */
+struct Workspace {
+    vector<size_t> idx;      // 单调队列 / alpha_rank 下标（基数排序路径下兼作 64 位键缓冲区）
+    vector<uint32_t> codes;  // ts_rank_fenwick：值域压缩后的编码
+    vector<float> domain;    // ts_rank_fenwick：去重后的值域
+    FenwickCounter tree;     // ts_rank_fenwick：窗口计数
+    vector<float> group_in, group_out;  // group_rank：一组股票的值聚合为连续序列后排名
+
+    // 预留容量：n 为序列 / 截面长度，window 为最大窗口；之后同规模的调用不再分配
+    void reserve(size_t n, size_t window = 0) {
+        idx.reserve(max(2 * n, bit_ceil(max<size_t>(window, 1))));
+        codes.reserve(n);
+        domain.reserve(n);
+        tree.reserve(n);
+        group_in.reserve(n);
+        group_out.reserve(n);
+    }
+};
 
-    // 预计算权重：y[k] = (k+1)/divisor，k=0 对应窗口最旧元素，k=period-1
-    // 对应最新元素
-    vector<float> y(period);
-    for (int k = 0; k < period; ++k) {
-        y[k] = (k + 1) / divisor;
+// 重新锚定的算子带 origin（a[0] 的绝对日期），与 span 版本相同
+inline void rolling_ts_sum(span<const float> a, int window, span<float> out, Workspace&, size_t origin = 0) {
+    rolling_ts_sum(a, window, out, origin);
+}
+inline void rolling_sma(span<const float> a, int window, span<float> out, Workspace&, size_t origin = 0) {
+    rolling_sma(a, window, out, origin);
+}
+inline void rolling_stddev(span<const float> a, int window, span<float> out, Workspace&, size_t origin = 0) {
+    rolling_stddev(a, window, out, origin);
+}
+inline void rolling_correlation(span<const float> a, span<const float> b, int window, span<float> out, Workspace&,
+                                size_t origin = 0) {
+    rolling_correlation(a, b, window, out, origin);
+}
+inline void rolling_covariance(span<const float> a, span<const float> b, int window, span<float> out, Workspace&,
+                               size_t origin = 0) {
+    rolling_covariance(a, b, window, out, origin);
+}
+inline void ts_rank(span<const float> a, int window, span<float> out, Workspace&) { ts_rank(a, window, out); }
+inline void ts_rank_fenwick(span<const float> a, int window, span<float> out, Workspace& ws) {
+    ts_rank_fenwick(a, window, out, ws.codes, ws.domain, ws.tree);
+}
+inline void product(span<const float> a, int window, span<float> out, Workspace&) { product(a, window, out); }
+inline void ts_min(span<const float> a, int window, span<float> out, Workspace& ws) { ts_min(a, window, out, ws.idx); }
+inline void ts_max(span<const float> a, int window, span<float> out, Workspace& ws) { ts_max(a, window, out, ws.idx); }
+inline void ts_argmax(span<const float> a, int window, span<float> out, Workspace& ws) {
+    ts_argmax(a, window, out, ws.idx);
+}
+inline void ts_argmin(span<const float> a, int window, span<float> out, Workspace& ws) {
+    ts_argmin(a, window, out, ws.idx);
+}
+inline void delta(span<const float> a, int period, span<float> out, Workspace&) { delta(a, period, out); }
+inline void delay(span<const float> a, int period, span<float> out, Workspace&) { delay(a, period, out); }
+inline void decay_linear(span<const float> a, int period, span<float> out, Workspace&, size_t origin = 0) {
+    decay_linear(a, period, out, origin);
+}
+inline void alpha_rank(span<const float> a, span<float> out, Workspace& ws) { alpha_rank(a, out, ws.idx); }
+inline void scale(span<const float> a, float k, span<float> out, Workspace&) { scale(a, k, out); }
+
+// ====== 分组截面算子（IndNeutralize）：行业 / 板块 / 子行业内的 demean、rank、scale ======
+
+/**
+ * @brief 单个截面的分组：同组股票的下标按组连续存放
+ *
+ * members[offsets[g] .. offsets[g+1]) 为第 g 组的股票下标（升序）。由稠密组号（0..G-1）经一次计数排序构建，
+ * 分组算子按组顺序遍历，热循环中没有哈希查找；组号为 kNoGroup 的股票不属于任何组，输出 NaN。
+ */
+struct GroupIndex {
+    static constexpr uint32_t kNoGroup = UINT32_MAX;
+
+    vector<uint32_t> offsets;  // G + 1 个
+    vector<uint32_t> members;  // 已分类的股票下标
+    vector<uint32_t> codes;    // 每只股票的组号（kNoGroup 表示未分类）
+
+    /**
+     * @param codes  每只股票的稠密组号，< groups 或为 kNoGroup
+     * @param groups 组数 G
+     */
+    void build(span<const uint32_t> codes, size_t groups) {
+        this->codes.assign(codes.begin(), codes.end());
+        offsets.assign(groups + 1, 0);
+        for (uint32_t c : codes)
+            if (c != kNoGroup) ++offsets[c + 1];
+        for (size_t g = 0; g < groups; ++g) offsets[g + 1] += offsets[g];
+        members.resize(offsets[groups]);
+        vector<uint32_t> next(offsets.begin(), offsets.end() - 1);
+        for (size_t i = 0; i < codes.size(); ++i)
+            if (codes[i] != kNoGroup) members[next[codes[i]]++] = (uint32_t)i;
+    }
+
+    size_t groups() const { return offsets.empty() ? 0 : offsets.size() - 1; }
+    span<const uint32_t> group(size_t g) const {
+        return span<const uint32_t>(members.data() + offsets[g], offsets[g + 1] - offsets[g]);
+    }
+};
+
+/**
+ * @brief 组内去均值：out[i] = a[i] - mean(a[同组非 NaN])，即论文的 IndNeutralize(x, IndClass.*)
+ *
+ * 组均值以 double 累加。NaN 与未分类的股票输出 NaN；全组为 NaN 时整组输出 NaN。
+ */
+inline void group_demean(span<const float> a, const GroupIndex& groups, span<float> out) {
+    fill(out.begin(), out.end(), NAN);
+    for (size_t g = 0; g < groups.groups(); ++g) {
+        auto members = groups.group(g);
+        double sum = 0.0;
+        size_t valid = 0;
+        for (uint32_t i : members) {
+            if (isnan(a[i])) continue;
+            sum += a[i];
+            ++valid;
+        }
+        if (valid == 0) continue;
+        float mean = (float)(sum / (double)valid);
+        for (uint32_t i : members) out[i] = a[i] - mean;
     }
+}
 
-    for (size_t i = period - 1; i < n; ++i) {
-        float val = 0.0f;
-        for (int k = 0; k < period; ++k) {
-            val += a[i - period + 1 + k] * y[k];
+/**
+ * @brief 组内截面排名：与 alpha_rank 相同的百分位排名（并列取平均），在每个组内单独计算
+ *
+ * 截面不小于 kAlphaRankRadixThreshold 时，整个截面只做一次基数排序，再按组号做一趟稳定的
+ * 计数分桶，每组即得到升序序列，开销与一次 alpha_rank 相当；小截面逐组聚合后调用 alpha_rank。
+ * 临时存储取自 ws（容量足够时零堆分配）。
+ */
+inline void group_rank(span<const float> a, const GroupIndex& groups, span<float> out, Workspace& ws) {
+    fill(out.begin(), out.end(), NAN);
+    size_t n = a.size();
+    size_t G = groups.groups();
+    if constexpr (sizeof(size_t) == sizeof(uint64_t)) {
+        if (n >= kAlphaRankRadixThreshold && n <= UINT32_MAX && groups.codes.size() == n) {
+            ws.idx.resize(2 * n + G + 1);
+            size_t* keys = ws.idx.data();
+            size_t* tmp = keys + n;
+            size_t* pos = keys + 2 * n;
+            fill(pos, pos + G + 1, 0);
+
+            size_t m = 0;
+            for (size_t i = 0; i < n; ++i) {
+                uint32_t c = groups.codes[i];
+                if (c == GroupIndex::kNoGroup || isnan(a[i])) continue;
+                keys[m++] = (size_t)float_order_key(a[i]) << 32 | i;
+                ++pos[c + 1];
+            }
+            if (m == 0) return;
+            keys = radix_sort_by_high32(keys, tmp, m);
+            tmp = keys == ws.idx.data() ? ws.idx.data() + n : ws.idx.data();
+
+            for (size_t g = 0; g < G; ++g) pos[g + 1] += pos[g];
+            for (size_t k = 0; k < m; ++k) tmp[pos[groups.codes[(uint32_t)keys[k]]]++] = keys[k];
+
+            // 分桶后 pos[g] 指向第 g 组的末尾
+            size_t begin = 0;
+            for (size_t g = 0; g < G; ++g) {
+                size_t end = pos[g];
+                float cnt = (float)(end - begin);
+                size_t i = begin;
+                while (i < end) {
+                    uint32_t key = (uint32_t)(tmp[i] >> 32);
+                    size_t j = i;
+                    while (j < end && (uint32_t)(tmp[j] >> 32) == key) j++;
+                    float pct_rank = ((i - begin) + 1 + (j - begin)) / 2.0f / cnt;
+                    for (size_t k = i; k < j; ++k) out[(uint32_t)tmp[k]] = pct_rank;
+                    i = j;
+                }
+                begin = end;
+            }
+            return;
         }
-        result[i] = val;
     }
+    for (size_t g = 0; g < G; ++g) {
+        auto members = groups.group(g);
+        size_t k = members.size();
+        ws.group_in.resize(k);
+        ws.group_out.resize(k);
+        for (size_t j = 0; j < k; ++j) ws.group_in[j] = a[members[j]];
+        alpha_rank(span<const float>(ws.group_in), span<float>(ws.group_out), ws.idx);
+        for (size_t j = 0; j < k; ++j) out[members[j]] = ws.group_out[j];
+    }
+}
 
-    return result;
+inline void group_rank(span<const float> a, const GroupIndex& groups, span<float> out) {
+    Workspace ws;
+    group_rank(a, groups, out, ws);
+}
+
+/**
+ * @brief 组内缩放：每组内 sum(|x|) = k，与 scale 相同的 NaN 规则（组内任一 NaN 使整组为 NaN）
+ */
+inline void group_scale(span<const float> a, const GroupIndex& groups, float k, span<float> out) {
+    fill(out.begin(), out.end(), NAN);
+    for (size_t g = 0; g < groups.groups(); ++g) {
+        auto members = groups.group(g);
+        float sum = 0;
+        for (uint32_t i : members) sum += std::abs(a[i]);
+        for (uint32_t i : members) out[i] = a[i] * k / sum;
+    }
 }
 
 #endif  // ALPHA101UTILS_H
@@ -44,15 +44,132 @@ BENCHMARK(BM_Alpha001Cross_VaryingT)->Arg(100)->Arg(250)->Arg(500)->Arg(1000)->A
 static void BM_Alpha001Cross_VaryingS(benchmark::State& state) {
     size_t S = static_cast<size_t>(state.range(0));
     size_t T = 250;
+    size_t threads = static_cast<size_t>(state.range(1));
     auto close   = gen_close_mat(S, T);
     auto returns = gen_returns_mat(S, T);
+    ThreadPool pool(threads);  // 线程在计时循环外创建，迭代间复用
 
     for (auto _ : state) {
-        auto result = alpha001(close, returns);
+        auto result = threads == 1 ? alpha001(close, returns) : alpha001(close, returns, pool);
         benchmark::DoNotOptimize(result);
     }
     state.SetItemsProcessed(state.iterations() * S * T);
 }
-BENCHMARK(BM_Alpha001Cross_VaryingS)->Arg(50)->Arg(100)->Arg(300)->Arg(500)->Arg(1000);
+// threads=1 走单线程版本（基线），threads>1 走线程池版本；多线程下以墙钟时间计
+BENCHMARK(BM_Alpha001Cross_VaryingS)
+    ->ArgsProduct({{50, 100, 300, 500, 1000}, {1, 2, 4, 8}})
+    ->ArgNames({"S", "threads"})
+    ->UseRealTime();
+
+// Panel 版：单块连续内存输入/输出，与嵌套 vector 版对比（固定 T=250，改变股票数）
+// layout=0：StockMajor 输入（逐股票 Step 1）；layout=1：TimeMajor 输入（跨股票 SIMD Step 1）
+static void BM_Alpha001Panel_VaryingS(benchmark::State& state) {
+    size_t S = static_cast<size_t>(state.range(0));
+    size_t T = 250;
+    auto layout = state.range(1) ? PanelLayout::TimeMajor : PanelLayout::StockMajor;
+    auto close   = Panel<float>::from_nested(gen_close_mat(S, T), layout);
+    auto returns = Panel<float>::from_nested(gen_returns_mat(S, T), layout);
+    Panel<float> result(S, T, PanelLayout::TimeMajor);
+
+    for (auto _ : state) {
+        alpha001(close, returns, result);
+        benchmark::DoNotOptimize(result.data());
+    }
+    state.SetItemsProcessed(state.iterations() * S * T);
+}
+BENCHMARK(BM_Alpha001Panel_VaryingS)
+    ->ArgsProduct({{50, 100, 300, 500, 1000, 5000}, {0, 1}})
+    ->ArgNames({"S", "layout"});
+
+// AlphaWorkspace 复用：ws=0 每次调用重新分配全部中间结果，ws=1 复用同一工作区（稳态零堆分配）
+static void BM_Alpha001Panel_Workspace(benchmark::State& state) {
+    size_t S = static_cast<size_t>(state.range(0));
+    size_t T = 250;
+    bool reuse = state.range(1) != 0;
+    auto close   = Panel<float>::from_nested(gen_close_mat(S, T), PanelLayout::TimeMajor);
+    auto returns = Panel<float>::from_nested(gen_returns_mat(S, T), PanelLayout::TimeMajor);
+    Panel<float> result(S, T, PanelLayout::TimeMajor);
+    AlphaWorkspace ws;
+
+    for (auto _ : state) {
+        if (reuse) alpha001(close, returns, result, ws);
+        else alpha001(close, returns, result);
+        benchmark::DoNotOptimize(result.data());
+    }
+    state.SetItemsProcessed(state.iterations() * S * T);
+}
+BENCHMARK(BM_Alpha001Panel_Workspace)
+    ->ArgsProduct({{50, 500, 5000}, {0, 1}})
+    ->ArgNames({"S", "ws"});
+
+// 实盘只取最新一个日期（T=2500，TimeMajor）：tail=0 完整求值全部 T 个日期，tail=1 只求最后一个日期
+static void BM_Alpha001Panel_LatestDate(benchmark::State& state) {
+    size_t S = static_cast<size_t>(state.range(0));
+    size_t T = 2500;
+    bool tail = state.range(1) != 0;
+    auto close   = Panel<float>::from_nested(gen_close_mat(S, T), PanelLayout::TimeMajor);
+    auto returns = Panel<float>::from_nested(gen_returns_mat(S, T), PanelLayout::TimeMajor);
+    Panel<float> result(0, 0, PanelLayout::TimeMajor);
+    AlphaWorkspace ws;
+
+    for (auto _ : state) {
+        if (tail) alpha001_tail(close, returns, T - 1, T, result, ws);
+        else alpha001(close, returns, result, ws);
+        benchmark::DoNotOptimize(result.data());
+    }
+    state.SetItemsProcessed(state.iterations() * S);
+}
+BENCHMARK(BM_Alpha001Panel_LatestDate)
+    ->ArgsProduct({{50, 500, 5000}, {0, 1}})
+    ->ArgNames({"S", "tail"});
+
+// 历史修订（T=2500，TimeMajor）：某一天的 close / returns 被修订后，dirty=0 完整重算，
+// dirty=1 alpha001_recompute 只重写受影响的日期（修订日之后约 30 个日期）
+static void BM_Alpha001Panel_RecomputeCorrection(benchmark::State& state) {
+    size_t S = static_cast<size_t>(state.range(0));
+    size_t T = 2500, day = T / 2;
+    bool dirty = state.range(1) != 0;
+    auto close   = Panel<float>::from_nested(gen_close_mat(S, T), PanelLayout::TimeMajor);
+    auto returns = Panel<float>::from_nested(gen_returns_mat(S, T), PanelLayout::TimeMajor);
+    Panel<float> result(0, 0, PanelLayout::TimeMajor);
+    AlphaWorkspace ws;
+    alpha001(close, returns, result, ws);
+    for (size_t s = 0; s < S; s += 7) returns(s, day) *= -1.0f;
+
+    for (auto _ : state) {
+        if (dirty) alpha001_recompute(close, returns, day, day + 1, result, ws);
+        else alpha001(close, returns, result, ws);
+        benchmark::DoNotOptimize(result.data());
+    }
+}
+BENCHMARK(BM_Alpha001Panel_RecomputeCorrection)
+    ->ArgsProduct({{50, 500, 5000}, {0, 1}})
+    ->ArgNames({"S", "dirty"});
+
+// 按股票分片（S=5000，T=1000）：threads=0 为单线程 Panel 版（基线），threads>0 为按 NUMA 节点绑定的线程池，
+// 各参与者首次写入并处理自己的分片，只有截面排名跨节点汇集。单节点机器上只体现分片与汇集的开销
+static void BM_Alpha001Panel_Sharded(benchmark::State& state) {
+    size_t S = 5000, T = 1000;
+    size_t threads = static_cast<size_t>(state.range(0));
+    auto close   = Panel<float>::from_nested(gen_close_mat(S, T), PanelLayout::TimeMajor);
+    auto returns = Panel<float>::from_nested(gen_returns_mat(S, T), PanelLayout::TimeMajor);
+    Panel<float> result(0, 0, PanelLayout::TimeMajor);
+    auto nodes = numa_nodes();
+    ThreadPool pool(numa_affinity(nodes, std::max<size_t>(1, threads / nodes.size())));
+    StockShards sc, sr;
+    shard_stocks(close, pool, sc);
+    shard_stocks(returns, pool, sr);
+    AlphaWorkspace ws;
+    vector<AlphaWorkspace> wss;
+
+    for (auto _ : state) {
+        if (threads == 0) alpha001(close, returns, result, ws);
+        else alpha001(sc, sr, result, pool, wss);
+        benchmark::DoNotOptimize(result.data());
+    }
+    state.counters["nodes"] = nodes.size();
+    state.SetItemsProcessed(state.iterations() * S * T);
+}
+BENCHMARK(BM_Alpha001Panel_Sharded)->Arg(0)->Arg(1)->Arg(2)->Arg(4)->ArgNames({"threads"})->UseRealTime();
 
 BENCHMARK_MAIN();
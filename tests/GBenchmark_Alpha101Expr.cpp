@@ -0,0 +1,160 @@
+#include <benchmark/benchmark.h>
+
+#include <random>
+
+#include "Alpha101Expr.h"
+
+// ========== 表达式图引擎 Benchmarks ==========
+// 参数：S=股票数，T=时间长度，layout：0=StockMajor，1=TimeMajor
+
+struct BenchMarket {
+    vector<Panel<float>> panels;
+    FieldMap fields;
+
+    BenchMarket(size_t S, size_t T, PanelLayout layout, int seed = 42) {
+        static const char* names[] = {"open", "high", "low", "close", "volume", "vwap", "returns", "cap"};
+        std::mt19937 gen(seed);
+        std::uniform_real_distribution<float> price(10.0f, 200.0f), vol(1e4f, 1e6f);
+        std::normal_distribution<float> ret(0.0f, 0.02f);
+        panels.reserve(11);
+        for (const char* name : names) {
+            Panel<float> p(S, T, layout);
+            string n = name;
+            for (size_t i = 0; i < p.size(); ++i)
+                p.data()[i] = n == "returns" ? ret(gen) : (n == "volume" || n == "cap") ? vol(gen) : price(gen);
+            panels.push_back(std::move(p));
+            fields[n] = &panels.back();
+        }
+        // IndClass.* 分类：10 个板块、50 个行业、150 个子行业
+        static const pair<const char*, size_t> classes[] = {{"sector", 10}, {"industry", 50}, {"subindustry", 150}};
+        for (auto [name, groups] : classes) {
+            Panel<float> p(S, T, layout);
+            for (size_t s = 0; s < S; ++s)
+                for (size_t t = 0; t < T; ++t) p(s, t) = float(s * 7919 % groups);
+            panels.push_back(std::move(p));
+            fields[name] = &panels.back();
+        }
+    }
+};
+
+// 全部已注册 alpha 在同一张图中求值，共享子表达式只算一次
+static void BM_AlphaBatch_All(benchmark::State& state) {
+    size_t S = state.range(0), T = 300;
+    auto layout = state.range(1) ? PanelLayout::TimeMajor : PanelLayout::StockMajor;
+    BenchMarket md(S, T, layout);
+    AlphaBatch batch(alpha101_ids());
+
+    for (auto _ : state) {
+        auto out = batch.evaluate(md.fields, layout);
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.counters["alphas"] = batch.ids().size();
+    state.counters["nodes"] = batch.unique_nodes();
+    state.SetItemsProcessed(state.iterations() * S * T * batch.ids().size());
+}
+BENCHMARK(BM_AlphaBatch_All)->ArgsProduct({{100, 500}, {0, 1}})->ArgNames({"S", "layout"})->Unit(benchmark::kMillisecond);
+
+// 逐批重复求值全部公式（TimeMajor, T=500）：pages=-1 中间结果在堆上逐个分配释放；
+// 0 / 1 取自同一个 arena（普通页 / 透明大页），首批之后不再向系统申请内存
+static void BM_AlphaBatch_Arena(benchmark::State& state) {
+    size_t S = state.range(0), T = 500;
+    BenchMarket md(S, T, PanelLayout::TimeMajor);
+    AlphaBatch batch(alpha101_ids());
+    auto pages = state.range(1) ? ArenaPages::Transparent : ArenaPages::Normal;
+    PanelArena arena(pages);
+    PanelArena* a = state.range(1) < 0 ? nullptr : &arena;
+
+    for (auto _ : state) {
+        auto out = batch.evaluate(md.fields, PanelLayout::TimeMajor, a);
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.counters["arena_MB"] = arena.capacity() >> 20;
+    state.SetItemsProcessed(state.iterations() * S * T * batch.ids().size());
+}
+BENCHMARK(BM_AlphaBatch_Arena)->ArgsProduct({{500, 2000}, {-1, 0, 1}})->ArgNames({"S", "pages"})->Unit(benchmark::kMillisecond);
+
+// 导入阶段：由 OHLCV 派生 returns / vwap 以及全部公式用到的 adv{d}
+static void BM_AlphaInputs_Derive(benchmark::State& state) {
+    size_t S = state.range(0), T = 300;
+    auto layout = state.range(1) ? PanelLayout::TimeMajor : PanelLayout::StockMajor;
+    BenchMarket md(S, T, layout);
+    auto windows = AlphaBatch(alpha101_ids()).adv_windows();
+    FieldMap ohlcv;
+    for (const char* name : {"open", "high", "low", "close", "volume"}) ohlcv[name] = md.fields.at(name);
+
+    for (auto _ : state) {
+        AlphaInputs in(ohlcv);
+        in.derive(windows);
+        benchmark::DoNotOptimize(in.at("returns").data());
+    }
+    state.counters["adv_windows"] = windows.size();
+    state.SetItemsProcessed(state.iterations() * S * T);
+}
+BENCHMARK(BM_AlphaInputs_Derive)->ArgsProduct({{100, 500}, {0, 1}})->ArgNames({"S", "layout"})->Unit(benchmark::kMillisecond);
+
+// 与 BM_AlphaBatch_All 相同，但 adv{d} 已在导入阶段缓存，求值时直接读取
+static void BM_AlphaBatch_AllCachedAdv(benchmark::State& state) {
+    size_t S = state.range(0), T = 300;
+    auto layout = state.range(1) ? PanelLayout::TimeMajor : PanelLayout::StockMajor;
+    BenchMarket md(S, T, layout);
+    AlphaBatch batch(alpha101_ids());
+    AlphaInputs in(md.fields);
+    in.derive(batch.adv_windows());
+    FieldMap fields = in.fields();
+
+    for (auto _ : state) {
+        auto out = batch.evaluate(fields, layout);
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.counters["alphas"] = batch.ids().size();
+    state.SetItemsProcessed(state.iterations() * S * T * batch.ids().size());
+}
+BENCHMARK(BM_AlphaBatch_AllCachedAdv)
+    ->ArgsProduct({{100, 500}, {0, 1}})
+    ->ArgNames({"S", "layout"})
+    ->Unit(benchmark::kMillisecond);
+
+// 实盘只取最新一个日期（T=1000）：range=0 完整求值后取最后一行，range=1 只截取 history() 个日期求值
+static void BM_AlphaBatch_LatestDate(benchmark::State& state) {
+    size_t S = state.range(0), T = 1000;
+    bool range = state.range(1) != 0;
+    BenchMarket md(S, T, PanelLayout::TimeMajor);
+    AlphaBatch batch(alpha101_ids());
+
+    for (auto _ : state) {
+        auto out = range ? batch.evaluate_range(md.fields, T - 1, T) : batch.evaluate(md.fields);
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.counters["history"] = batch.history();
+    state.SetItemsProcessed(state.iterations() * S * batch.ids().size());
+}
+BENCHMARK(BM_AlphaBatch_LatestDate)->ArgsProduct({{100, 500}, {0, 1}})->ArgNames({"S", "range"})->Unit(benchmark::kMillisecond);
+
+// 对照组：每个 alpha 单独建图求值（相当于逐个手写实现，中间结果不共享）
+static void BM_AlphaBatch_Individually(benchmark::State& state) {
+    size_t S = state.range(0), T = 300;
+    auto layout = state.range(1) ? PanelLayout::TimeMajor : PanelLayout::StockMajor;
+    BenchMarket md(S, T, layout);
+    vector<AlphaBatch> singles;
+    size_t nodes = 0;
+    for (int id : alpha101_ids()) {
+        singles.emplace_back(vector<int>{id});
+        nodes += singles.back().unique_nodes();
+    }
+
+    for (auto _ : state) {
+        for (const AlphaBatch& b : singles) {
+            auto out = b.evaluate(md.fields, layout);
+            benchmark::DoNotOptimize(out.data());
+        }
+    }
+    state.counters["alphas"] = singles.size();
+    state.counters["nodes"] = nodes;
+    state.SetItemsProcessed(state.iterations() * S * T * singles.size());
+}
+BENCHMARK(BM_AlphaBatch_Individually)
+    ->ArgsProduct({{100, 500}, {0, 1}})
+    ->ArgNames({"S", "layout"})
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
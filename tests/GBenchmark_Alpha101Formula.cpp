@@ -0,0 +1,36 @@
+#include <benchmark/benchmark.h>
+
+#include "Alpha101Formula.h"
+
+// ========== 公式解析 Benchmarks ==========
+
+// 解析全部已注册公式（论文原文）到同一张图：衡量解析 + 哈希合并的开销
+static void BM_ParseFormula_AllRegistered(benchmark::State& state) {
+    size_t chars = 0;
+    for (const AlphaFormula& a : alpha101_formulas()) chars += string_view(a.formula).size();
+
+    for (auto _ : state) {
+        ExprGraph g;
+        AlphaFields f(g);
+        FormulaParser parser(f);
+        for (const AlphaFormula& a : alpha101_formulas()) benchmark::DoNotOptimize(parser.parse(a.formula).id);
+        benchmark::DoNotOptimize(g.size());
+    }
+    state.counters["formulas"] = alpha101_formulas().size();
+    state.SetBytesProcessed(state.iterations() * chars);
+}
+BENCHMARK(BM_ParseFormula_AllRegistered)->Unit(benchmark::kMicrosecond);
+
+// 对照组：同样的图由手写构造函数生成
+static void BM_BuildFormula_AllRegistered(benchmark::State& state) {
+    for (auto _ : state) {
+        ExprGraph g;
+        AlphaFields f(g);
+        for (const AlphaFormula& a : alpha101_formulas()) benchmark::DoNotOptimize(a.build(f).id);
+        benchmark::DoNotOptimize(g.size());
+    }
+    state.counters["formulas"] = alpha101_formulas().size();
+}
+BENCHMARK(BM_BuildFormula_AllRegistered)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,97 @@
+#include <benchmark/benchmark.h>
+
+#include <random>
+
+#include "Alpha101Panel.h"
+
+// ========== Panel 算子 Benchmarks ==========
+// 比较同一算子在两种布局下的吞吐：
+//   layout=0：StockMajor，逐股票调用 span 算子（每只股票一条依赖链，无法向量化）
+//   layout=1：TimeMajor，跨股票 SIMD 内核（S 组状态并排，每步处理 8/16 只股票）
+
+static Panel<float> gen_panel(size_t S, size_t T, PanelLayout layout, int seed = 42) {
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<float> dis(1.0f, 100.0f);
+    Panel<float> p(S, T, layout);
+    for (size_t i = 0; i < p.size(); ++i) p.data()[i] = dis(gen);
+    return p;
+}
+
+static PanelLayout layout_arg(const benchmark::State& state) {
+    return state.range(1) ? PanelLayout::TimeMajor : PanelLayout::StockMajor;
+}
+
+#define ALPHA101_PANEL_BENCH(name, call)                                        \
+    static void name(benchmark::State& state) {                                 \
+        size_t S = static_cast<size_t>(state.range(0));                         \
+        size_t T = 500;                                                         \
+        auto x = gen_panel(S, T, layout_arg(state));                            \
+        auto y = gen_panel(S, T, layout_arg(state), 43);                        \
+        Panel<float> out;                                                       \
+        for (auto _ : state) {                                                  \
+            call;                                                               \
+            benchmark::DoNotOptimize(out.data());                               \
+        }                                                                       \
+        state.SetItemsProcessed(state.iterations() * S * T);                    \
+    }                                                                           \
+    BENCHMARK(name)->ArgsProduct({{100, 1000, 5000}, {0, 1}})->ArgNames({"S", "layout"});
+
+ALPHA101_PANEL_BENCH(BM_Panel_RollingStddev, rolling_stddev(x, 20, out))
+ALPHA101_PANEL_BENCH(BM_Panel_DecayLinear, decay_linear(x, 10, out))
+ALPHA101_PANEL_BENCH(BM_Panel_Delta, delta(x, 1, out))
+ALPHA101_PANEL_BENCH(BM_Panel_TsArgmax, ts_argmax(x, 10, out))
+ALPHA101_PANEL_BENCH(BM_Panel_TsMin, ts_min(x, 10, out))
+ALPHA101_PANEL_BENCH(BM_Panel_TsRank, ts_rank(x, 10, out))
+ALPHA101_PANEL_BENCH(BM_Panel_RollingCorrelation, rolling_correlation(x, y, 10, out))
+
+#undef ALPHA101_PANEL_BENCH
+
+// 分组截面算子与不分组的 alpha_rank 对照（T=500，50 个行业，TimeMajor）：op=0 alpha_rank，
+// op=1 group_demean（IndNeutralize），op=2 group_rank，op=3 group_scale；分组在循环外构建一次
+static void BM_Panel_GroupOps(benchmark::State& state) {
+    size_t S = static_cast<size_t>(state.range(0));
+    size_t T = 500;
+    auto x = gen_panel(S, T, PanelLayout::TimeMajor);
+    Panel<int32_t> codes(S, T, PanelLayout::TimeMajor);
+    for (size_t s = 0; s < S; ++s)
+        for (size_t t = 0; t < T; ++t) codes(s, t) = (int32_t)(s * 7919 % 50);
+    GroupPartition groups(codes);
+    Panel<float> out;
+    for (auto _ : state) {
+        switch (state.range(1)) {
+            case 0: alpha_rank(x, out); break;
+            case 1: group_demean(x, groups, out); break;
+            case 2: group_rank(x, groups, out); break;
+            default: group_scale(x, groups, 1.0f, out); break;
+        }
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(state.iterations() * S * T);
+}
+BENCHMARK(BM_Panel_GroupOps)->ArgsProduct({{100, 1000, 5000}, {0, 1, 2, 3}})->ArgNames({"S", "op"});
+
+// StockMajor [S × T] → TimeMajor 的布局切换（T=250）：tiled=0 逐元素以步长 S 写入，tiled=1 分块转置
+static void BM_Transpose_StockToTimeMajor(benchmark::State& state) {
+    size_t S = static_cast<size_t>(state.range(0));
+    size_t T = 250;
+    auto in = gen_panel(S, T, PanelLayout::StockMajor);
+    Panel<float> out(S, T, PanelLayout::TimeMajor);
+    const float* src = in.data();
+    float* dst = out.data();
+    for (auto _ : state) {
+        if (state.range(1)) {
+            transpose(src, S, T, T, dst, S);
+        } else {
+            for (size_t s = 0; s < S; ++s)
+                for (size_t t = 0; t < T; ++t) dst[t * S + s] = src[s * T + t];
+        }
+        benchmark::DoNotOptimize(dst);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * S * T);
+}
+BENCHMARK(BM_Transpose_StockToTimeMajor)
+    ->ArgsProduct({{100, 1000, 5000, 20000}, {0, 1}})
+    ->ArgNames({"S", "tiled"});
+
+BENCHMARK_MAIN();
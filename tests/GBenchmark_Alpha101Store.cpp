@@ -0,0 +1,145 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <random>
+
+#include "Alpha101Store.h"
+
+// ========== 列式面板文件 Benchmarks ==========
+// 参数：S=股票数，T=日期数；5 个 OHLCV 字段。对比启动时把数据变成可用 Panel 的代价：
+//   BM_PanelFile_Open：mmap 打开并取出全部列的零拷贝视图，再完整读一遍（含缺页）
+//   BM_PanelFile_ReadText：从文本（每行一个数）解析为 Panel，即原先的加载方式
+
+static const char* kFields[] = {"open", "high", "low", "close", "volume"};
+
+static string bench_path(const char* kind, size_t S, size_t T) {
+    return (std::filesystem::temp_directory_path() /
+            ("alpha101_bench_" + string(kind) + "_" + to_string(S) + "x" + to_string(T)))
+        .string();
+}
+
+static vector<Panel<float>> gen_fields(size_t S, size_t T) {
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<float> dis(1.0f, 100.0f);
+    vector<Panel<float>> panels;
+    for (size_t f = 0; f < 5; ++f) {
+        Panel<float> p(S, T, PanelLayout::TimeMajor);
+        for (size_t i = 0; i < p.size(); ++i) p.data()[i] = dis(gen);
+        panels.push_back(std::move(p));
+    }
+    return panels;
+}
+
+static double sum_all(const Panel<float>& p) {
+    double acc = 0;
+    for (size_t i = 0; i < p.size(); ++i) acc += p.data()[i];
+    return acc;
+}
+
+static void BM_PanelFile_Open(benchmark::State& state) {
+    size_t S = state.range(0), T = state.range(1);
+    string path = bench_path("bin", S, T);
+    {
+        auto panels = gen_fields(S, T);
+        vector<PanelColumn> cols;
+        for (size_t f = 0; f < 5; ++f) cols.emplace_back(kFields[f], panels[f]);
+        write_panel_file(path, cols);
+    }
+    for (auto _ : state) {
+        PanelFile file(path);
+        double acc = 0;
+        for (const char* name : kFields) acc += sum_all(file.panel(name));
+        benchmark::DoNotOptimize(acc);
+    }
+    std::remove(path.c_str());
+    state.SetBytesProcessed(state.iterations() * 5 * S * T * sizeof(float));
+}
+BENCHMARK(BM_PanelFile_Open)->Args({1000, 2500})->Args({5000, 1000})->ArgNames({"S", "T"})->Unit(benchmark::kMillisecond);
+
+static void BM_PanelFile_ReadText(benchmark::State& state) {
+    size_t S = state.range(0), T = state.range(1);
+    string path = bench_path("txt", S, T);
+    {
+        auto panels = gen_fields(S, T);
+        std::ofstream out(path);
+        for (const auto& p : panels)
+            for (size_t i = 0; i < p.size(); ++i) out << p.data()[i] << '\n';
+    }
+    for (auto _ : state) {
+        std::ifstream in(path);
+        double acc = 0;
+        for (size_t f = 0; f < 5; ++f) {
+            Panel<float> p(S, T, PanelLayout::TimeMajor);
+            for (size_t i = 0; i < p.size(); ++i) in >> p.data()[i];
+            acc += sum_all(p);
+        }
+        benchmark::DoNotOptimize(acc);
+    }
+    std::remove(path.c_str());
+    state.SetBytesProcessed(state.iterations() * 5 * S * T * sizeof(float));
+}
+BENCHMARK(BM_PanelFile_ReadText)->Args({1000, 2500})->Args({5000, 1000})->ArgNames({"S", "T"})->Unit(benchmark::kMillisecond);
+
+// ========== 因子库 Benchmarks ==========
+// 一个 alpha（截面排名值 k/S - 0.5，逐日随机排列，稠密数据的最坏情况）写入 T=2500 的因子库，
+// 读取最近 days 个日期：只解码相交的块；days=2500 即解码全部历史
+
+static void BM_FactorStore_ReadRange(benchmark::State& state) {
+    size_t S = state.range(0), T = 2500, days = state.range(1);
+    string path = bench_path("factor", S, T);
+    {
+        std::mt19937 gen(42);
+        Panel<float> alpha(S, T, PanelLayout::TimeMajor);
+        vector<size_t> order(S);
+        for (size_t t = 0; t < T; ++t) {
+            for (size_t s = 0; s < S; ++s) order[s] = s;
+            std::shuffle(order.begin(), order.end(), gen);
+            for (size_t s = 0; s < S; ++s) alpha(s, t) = (float)(order[s] + 1) / S - 0.5f;
+        }
+        write_factor_store(path, {{"alpha001", alpha}});
+    }
+    FactorStore store(path);
+    for (auto _ : state) {
+        auto recent = store.read("alpha001", T - days, T);
+        benchmark::DoNotOptimize(recent.data());
+    }
+    state.counters["ratio"] = store.compression_ratio("alpha001");
+    std::remove(path.c_str());
+    state.SetItemsProcessed(state.iterations() * S * days);
+}
+BENCHMARK(BM_FactorStore_ReadRange)->ArgsProduct({{1000, 5000}, {20, 252, 2500}})->ArgNames({"S", "days"})->Unit(benchmark::kMillisecond);
+
+// 新到一个交易日后更新 alpha001 的因子库（S=1000）：mode=0 在完整 T+1 历史上重算并重写整个文件，
+// mode=1 extend_factor_store 只读回看尾部、求出新日期并追加
+static void BM_FactorStore_ExtendOneDay(benchmark::State& state) {
+    size_t S = 1000, T = state.range(0);
+    auto panels = gen_fields(S, T + 1);
+    Panel<float> returns;
+    derive_returns(panels[3], returns);
+    FieldMap fields = {{"close", &panels[3]}, {"returns", &returns}};
+    AlphaBatch batch(vector<int>{1});
+    string path = bench_path("extend", S, T), base = path + ".base";
+    {
+        auto full = batch.evaluate(fields);
+        auto head = slice_dates(full[0], 0, T, PanelLayout::TimeMajor);
+        write_factor_store(base, {{alpha_column_name(1), head}});
+    }
+    for (auto _ : state) {
+        state.PauseTiming();
+        std::filesystem::copy_file(base, path, std::filesystem::copy_options::overwrite_existing);
+        state.ResumeTiming();
+        if (state.range(1)) {
+            benchmark::DoNotOptimize(extend_factor_store(path, fields, batch));
+        } else {
+            write_factor_store(path, alpha_columns(batch, batch.evaluate(fields)));
+        }
+    }
+    std::remove(path.c_str());
+    std::remove(base.c_str());
+}
+BENCHMARK(BM_FactorStore_ExtendOneDay)->ArgsProduct({{500, 2500}, {0, 1}})->ArgNames({"T", "mode"})->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,82 @@
+#include <benchmark/benchmark.h>
+
+#include <random>
+
+#include "Alpha101.h"
+#include "Alpha101Stream.h"
+
+// ========== 流式算子 Benchmarks ==========
+// 参数：S=股票数，T=已有历史长度
+
+// 生成 TimeMajor 的 close / returns 面板
+static void gen_market(size_t S, size_t T, Panel<float>& close, Panel<float>& returns, int seed = 42) {
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<float> price(10.0f, 200.0f);
+    std::normal_distribution<float> ret(0.0f, 0.02f);
+    close.reset(S, T, PanelLayout::TimeMajor);
+    returns.reset(S, T, PanelLayout::TimeMajor);
+    for (size_t i = 0; i < close.size(); ++i) {
+        close.data()[i] = price(gen);
+        returns.data()[i] = ret(gen);
+    }
+}
+
+// 日终增量：状态已用 T 天历史预热，每次迭代只 push 一个新截面
+static void BM_Alpha001Stream_PushBar(benchmark::State& state) {
+    size_t S = static_cast<size_t>(state.range(0));
+    size_t T = 1000;
+    Panel<float> close, returns;
+    gen_market(S, T, close, returns);
+    Alpha001Stream stream(S);
+    vector<float> out(S);
+    for (size_t t = 0; t < T; ++t) stream.push(close.row(t), returns.row(t), out);
+
+    size_t t = 0;
+    for (auto _ : state) {
+        stream.push(close.row(t), returns.row(t), out);
+        benchmark::DoNotOptimize(out.data());
+        t = t + 1 == T ? 0 : t + 1;
+    }
+    state.SetItemsProcessed(state.iterations() * S);
+}
+BENCHMARK(BM_Alpha001Stream_PushBar)->Arg(500)->Arg(1000)->Arg(5000)->Unit(benchmark::kMicrosecond);
+
+// 对照组：每天在全部 T 天历史上重算 alpha001（TimeMajor Panel 版），只取最后一个截面
+static void BM_Alpha001Recompute_LastBar(benchmark::State& state) {
+    size_t S = static_cast<size_t>(state.range(0));
+    size_t T = 1000;
+    Panel<float> close, returns;
+    gen_market(S, T, close, returns);
+    Panel<float> out(S, T, PanelLayout::TimeMajor);
+
+    for (auto _ : state) {
+        alpha001(close, returns, out);
+        benchmark::DoNotOptimize(out.row(T - 1).data());
+    }
+    state.SetItemsProcessed(state.iterations() * S);
+}
+BENCHMARK(BM_Alpha001Recompute_LastBar)->Arg(500)->Arg(1000)->Arg(5000)->Unit(benchmark::kMicrosecond);
+
+// 单个算子的逐 bar 开销（窗口 20）
+template <typename Stream>
+static void BM_StreamOperator(benchmark::State& state) {
+    std::mt19937 gen(7);
+    std::normal_distribution<float> dis(100.0f, 5.0f);
+    vector<float> x(4096);
+    for (auto& v : x) v = dis(gen);
+    Stream stream(20);
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(stream.push(x[i]));
+        i = (i + 1) & 4095;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_TEMPLATE(BM_StreamOperator, TsSumStream);
+BENCHMARK_TEMPLATE(BM_StreamOperator, StddevStream);
+BENCHMARK_TEMPLATE(BM_StreamOperator, TsMaxStream);
+BENCHMARK_TEMPLATE(BM_StreamOperator, TsArgmaxStream);
+BENCHMARK_TEMPLATE(BM_StreamOperator, TsRankStream);
+BENCHMARK_TEMPLATE(BM_StreamOperator, DecayLinearStream);
+
+BENCHMARK_MAIN();
@@ -57,6 +57,53 @@ static void BM_RollingTsSum_Large(benchmark::State& state) {
 }
 BENCHMARK(BM_RollingTsSum_Large);
 
+// 滑动和：每步 O(1)，耗时应与窗口长度无关
+static void BM_RollingTsSum_VaryingWindow(benchmark::State& state) {
+    int window = state.range(0);
+    vector<float> data = generate_random_data(10000);
+    vector<float> out(data.size());
+
+    for (auto _ : state) {
+        rolling_ts_sum(span<const float>(data), window, span<float>(out));
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(state.iterations() * data.size());
+}
+BENCHMARK(BM_RollingTsSum_VaryingWindow)->Arg(5)->Arg(20)->Arg(60)->Arg(180)->Arg(250);
+
+// adv5/10/20/30/40/50/60/81/120/150/180：逐个窗口滑动 vs 一次前缀和 + 每窗口 O(1) 相减
+static const int kAdvWindows[] = {5, 10, 20, 30, 40, 50, 60, 81, 120, 150, 180};
+
+static void BM_MultiWindowMean_Sliding(benchmark::State& state) {
+    vector<float> data = generate_random_data(state.range(0));
+    vector<float> out(data.size());
+
+    for (auto _ : state) {
+        for (int w : kAdvWindows) {
+            rolling_sma(span<const float>(data), w, span<float>(out));
+            benchmark::DoNotOptimize(out.data());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * data.size() * size(kAdvWindows));
+}
+BENCHMARK(BM_MultiWindowMean_Sliding)->Arg(1000)->Arg(10000);
+
+static void BM_MultiWindowMean_Prefix(benchmark::State& state) {
+    vector<float> data = generate_random_data(state.range(0));
+    vector<float> out(data.size());
+    PrefixSum prefix;
+
+    for (auto _ : state) {
+        prefix.build(data);
+        for (int w : kAdvWindows) {
+            prefix.rolling_mean(w, span<float>(out));
+            benchmark::DoNotOptimize(out.data());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * data.size() * size(kAdvWindows));
+}
+BENCHMARK(BM_MultiWindowMean_Prefix)->Arg(1000)->Arg(10000);
+
 // ========== Product (rollendes Produkt) Benchmarks ==========
 
 static void BM_Product_Small(benchmark::State& state) {
@@ -155,7 +202,22 @@ static void BM_TsMin_VaryingWindow(benchmark::State& state) {
     }
     state.SetItemsProcessed(state.iterations() * data.size());
 }
-BENCHMARK(BM_TsMin_VaryingWindow)->Arg(5)->Arg(10)->Arg(20)->Arg(50)->Arg(100);
+BENCHMARK(BM_TsMin_VaryingWindow)->Arg(5)->Arg(10)->Arg(20)->Arg(50)->Arg(100)->Arg(250);
+
+// 单调队列 + 调用方缓冲区：每步均摊 O(1)，耗时应与窗口长度无关
+static void BM_TsMin_Deque_VaryingWindow(benchmark::State& state) {
+    int window = state.range(0);
+    vector<float> data = generate_random_data(10000);
+    vector<float> out(data.size());
+    vector<size_t> idx_buf;
+
+    for (auto _ : state) {
+        ts_min(span<const float>(data), window, span<float>(out), idx_buf);
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(state.iterations() * data.size());
+}
+BENCHMARK(BM_TsMin_Deque_VaryingWindow)->Arg(5)->Arg(10)->Arg(20)->Arg(50)->Arg(100)->Arg(250);
 
 // ========== TS Max (rollendes Maximum) Benchmarks ==========
 
@@ -205,7 +267,7 @@ static void BM_TsMax_VaryingWindow(benchmark::State& state) {
     }
     state.SetItemsProcessed(state.iterations() * data.size());
 }
-BENCHMARK(BM_TsMax_VaryingWindow)->Arg(5)->Arg(10)->Arg(20)->Arg(50)->Arg(100);
+BENCHMARK(BM_TsMax_VaryingWindow)->Arg(5)->Arg(10)->Arg(20)->Arg(50)->Arg(100)->Arg(250);
 
 // ========== Delta (Differenz) Benchmarks ==========
 
@@ -482,6 +544,21 @@ static void BM_RollingCorrelation_VaryingDataSize(benchmark::State& state) {
 }
 BENCHMARK(BM_RollingCorrelation_VaryingDataSize)->Arg(100)->Arg(500)->Arg(1000)->Arg(5000)->Arg(10000);
 
+// 滑动二阶矩 + 调用方缓冲区：单遍 O(n)，耗时应与窗口长度无关
+static void BM_RollingCorrelation_VaryingWindow(benchmark::State& state) {
+    int window = state.range(0);
+    vector<float> x = generate_random_data(10000, 42);
+    vector<float> y = generate_random_data(10000, 43);
+    vector<float> out(x.size());
+
+    for (auto _ : state) {
+        rolling_correlation(span<const float>(x), span<const float>(y), window, span<float>(out));
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(state.iterations() * x.size());
+}
+BENCHMARK(BM_RollingCorrelation_VaryingWindow)->Arg(5)->Arg(10)->Arg(20)->Arg(50)->Arg(100)->Arg(250);
+
 // ========== TS Rank Leistungsvergleich ==========
 
 static void BM_TsRank_Original_Small(benchmark::State& state) {
@@ -630,7 +707,7 @@ BENCHMARK(BM_TsRank_Ultra_Large);
 static void BM_TsRank_ThreeWay_Compare(benchmark::State& state) {
     size_t data_size = state.range(0);
     int window = state.range(1);
-    int version = state.range(2);  // 0=Original, 1=Optimized, 2=Ultra
+    int version = state.range(2);  // 0=Original, 1=Optimized, 2=Ultra, 3=Fenwick
 
     vector<float> data = generate_random_data(data_size, 42);
 
@@ -641,19 +718,25 @@ static void BM_TsRank_ThreeWay_Compare(benchmark::State& state) {
         } else if (version == 1) {
             auto result = ts_rank_optimized(data, window);
             benchmark::DoNotOptimize(result);
-        } else {
+        } else if (version == 2) {
             auto result = ts_rank_ultra(data, window);
             benchmark::DoNotOptimize(result);
+        } else {
+            auto result = ts_rank_fenwick(data, window);
+            benchmark::DoNotOptimize(result);
         }
     }
     state.SetItemsProcessed(state.iterations() * data_size);
 }
 
-// Vergleich der drei Versionen: Original, span-optimiert, gleitendes-Fenster-optimiert
+// Vergleich der Versionen: Original, span-optimiert, gleitendes-Fenster-optimiert, Fenwick-Baum
 BENCHMARK(BM_TsRank_ThreeWay_Compare)
-    ->Args({10000, 50, 0})  // 10000 Datenpunkte, Fenster 50, Originalversion
-    ->Args({10000, 50, 1})  // 10000 Datenpunkte, Fenster 50, span-optimiert
-    ->Args({10000, 50, 2})  // 10000 Datenpunkte, Fenster 50, ultra-optimiert
+    ->Args({10000, 50, 0})   // 10000 Datenpunkte, Fenster 50, Originalversion
+    ->Args({10000, 50, 1})   // 10000 Datenpunkte, Fenster 50, span-optimiert
+    ->Args({10000, 50, 2})   // 10000 Datenpunkte, Fenster 50, ultra-optimiert
+    ->Args({10000, 50, 3})   // 10000 Datenpunkte, Fenster 50, Fenwick-Baum
+    ->Args({10000, 250, 2})  // 10000 Datenpunkte, Fenster 250, ultra-optimiert
+    ->Args({10000, 250, 3})  // 10000 Datenpunkte, Fenster 250, Fenwick-Baum
     ->ArgNames({"data_size", "window", "version"});
 
 // ========== Rank (Querschnittsrang) Benchmarks ==========
@@ -720,6 +803,28 @@ static void BM_Rank_VaryingSize(benchmark::State& state) {
 }
 BENCHMARK(BM_Rank_VaryingSize)->Arg(10)->Arg(100)->Arg(1000)->Arg(5000)->Arg(10000)->Arg(50000)->Arg(100000);
 
+// Vergleichsbasis vs. Radix-Sortierung mit Aufrufer-Puffern; version 0 = alpha_rank (automatisch), 1 = alpha_rank_radix
+static void BM_Rank_Radix_VaryingSize(benchmark::State& state) {
+    size_t size = state.range(0);
+    int version = state.range(1);
+    vector<float> data = generate_random_data(size, 42);
+    vector<float> out(size);
+    vector<size_t> buf;
+
+    for (auto _ : state) {
+        if (version == 0) {
+            alpha_rank(span<const float>(data), span<float>(out), buf);
+        } else {
+            alpha_rank_radix(span<const float>(data), span<float>(out), buf);
+        }
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(state.iterations() * size);
+}
+BENCHMARK(BM_Rank_Radix_VaryingSize)
+    ->ArgsProduct({{64, 256, 512, 1000, 10000, 100000}, {0, 1}})
+    ->ArgNames({"size", "version"});
+
 // ========== Leistungstest bei verschiedenen Duplikatanteilen ==========
 
 // Hilfsfunktion: Daten mit bestimmtem Duplikatanteil erzeugen
@@ -1066,7 +1171,22 @@ static void BM_TsArgmax_VaryingWindow(benchmark::State& state) {
     }
     state.SetItemsProcessed(state.iterations() * data.size());
 }
-BENCHMARK(BM_TsArgmax_VaryingWindow)->Arg(5)->Arg(10)->Arg(20)->Arg(50)->Arg(100);
+BENCHMARK(BM_TsArgmax_VaryingWindow)->Arg(5)->Arg(10)->Arg(20)->Arg(50)->Arg(100)->Arg(250);
+
+// 单调队列 + 调用方缓冲区：每步均摊 O(1)，耗时应与窗口长度无关
+static void BM_TsArgmax_Deque_VaryingWindow(benchmark::State& state) {
+    int window = state.range(0);
+    vector<float> data = generate_random_data(10000);
+    vector<float> out(data.size());
+    vector<size_t> idx_buf;
+
+    for (auto _ : state) {
+        ts_argmax(span<const float>(data), window, span<float>(out), idx_buf);
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(state.iterations() * data.size());
+}
+BENCHMARK(BM_TsArgmax_Deque_VaryingWindow)->Arg(5)->Arg(10)->Arg(20)->Arg(50)->Arg(100)->Arg(250);
 
 // Vergleich ts_argmax vs ts_max (strukturell ähnlich, unterschiedliche Rückgabetypen)
 static void BM_TsArgmax_vs_TsMax(benchmark::State& state) {
@@ -1135,7 +1255,7 @@ static void BM_TsArgmin_VaryingWindow(benchmark::State& state) {
     }
     state.SetItemsProcessed(state.iterations() * data.size());
 }
-BENCHMARK(BM_TsArgmin_VaryingWindow)->Arg(5)->Arg(10)->Arg(20)->Arg(50)->Arg(100);
+BENCHMARK(BM_TsArgmin_VaryingWindow)->Arg(5)->Arg(10)->Arg(20)->Arg(50)->Arg(100)->Arg(250);
 
 // Vergleich ts_argmin vs ts_min (strukturell ähnlich, unterschiedliche Rückgabetypen)
 static void BM_TsArgmin_vs_TsMin(benchmark::State& state) {
@@ -1194,7 +1314,7 @@ static void BM_DecayLinear_Large(benchmark::State& state) {
 }
 BENCHMARK(BM_DecayLinear_Large);
 
-// Fenstergröße als Parameter variieren
+// Fenstergröße als Parameter variieren（递推实现：耗时应与窗口长度无关）
 static void BM_DecayLinear_VaryWindow(benchmark::State& state) {
     vector<float> data = generate_random_data(5000);
     int window = static_cast<int>(state.range(0));
@@ -1205,6 +1325,48 @@ static void BM_DecayLinear_VaryWindow(benchmark::State& state) {
     }
     state.SetItemsProcessed(state.iterations() * data.size());
 }
-BENCHMARK(BM_DecayLinear_VaryWindow)->Arg(5)->Arg(20)->Arg(50)->Arg(100)->ArgNames({"window"});
+BENCHMARK(BM_DecayLinear_VaryWindow)->Arg(5)->Arg(20)->Arg(50)->Arg(100)->Arg(250)->ArgNames({"window"});
+
+// span 版本（零堆分配），同样按窗口长度扫描
+static void BM_DecayLinear_Span_VaryWindow(benchmark::State& state) {
+    vector<float> data = generate_random_data(5000);
+    vector<float> out(data.size());
+    int window = static_cast<int>(state.range(0));
+
+    for (auto _ : state) {
+        decay_linear(span<const float>(data), window, span<float>(out));
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(state.iterations() * data.size());
+}
+BENCHMARK(BM_DecayLinear_Span_VaryWindow)->Arg(5)->Arg(20)->Arg(50)->Arg(100)->Arg(250)->ArgNames({"window"});
+
+// ========== Workspace-Overloads ==========
+// 同一批短序列反复求值：workspace=0 每次调用自行分配临时存储，workspace=1 复用 Workspace（稳态零分配）
+
+static void BM_Ops_WorkspaceReuse(benchmark::State& state) {
+    vector<float> a = generate_random_data(250, 42), b = generate_random_data(250, 43);
+    vector<float> out(a.size());
+    bool reuse = state.range(0) != 0;
+    Workspace ws;
+
+    for (auto _ : state) {
+        if (reuse) {
+            ts_argmax(span<const float>(a), 10, span<float>(out), ws);
+            ts_min(span<const float>(a), 20, span<float>(out), ws);
+            ts_rank_fenwick(span<const float>(a), 10, span<float>(out), ws);
+            alpha_rank(span<const float>(a), span<float>(out), ws);
+        } else {
+            ts_argmax(span<const float>(a), 10, span<float>(out));
+            ts_min(span<const float>(a), 20, span<float>(out));
+            ts_rank_fenwick(span<const float>(a), 10, span<float>(out));
+            vector<size_t> idx_buf;
+            alpha_rank(span<const float>(a), span<float>(out), idx_buf);
+        }
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(state.iterations() * a.size());
+}
+BENCHMARK(BM_Ops_WorkspaceReuse)->Arg(0)->Arg(1)->ArgNames({"workspace"});
 
 BENCHMARK_MAIN();
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include <cmath>
 
 #include "Alpha101.h"
+#include "HeapAllocationCounter.h"
 
 // ========== Alpha001 截面版测试 ==========
 // alpha001(vector<vector<float>>, vector<vector<float>>)
@@ -104,4 +105,349 @@ TEST_F(Alpha001CrossTest, CrossSectionalRankSumIsFixed) {
     }
 }
 
+// ========== Alpha001 Panel 重载测试 ==========
+
+TEST_F(Alpha001CrossTest, PanelMatchesNestedVersion) {
+    // S = 21：TimeMajor 输入走 SIMD 路径，覆盖整组 lane 与标量尾部
+    size_t S = 21, T = 60;
+    auto close   = linspace_mat(S, T, 50.0f, 0.7f);
+    auto returns = linspace_mat(S, T, -0.05f, 0.002f);
+    auto expected = alpha001(close, returns);
+
+    for (auto in_layout : {PanelLayout::StockMajor, PanelLayout::TimeMajor}) {
+        for (auto out_layout : {PanelLayout::StockMajor, PanelLayout::TimeMajor}) {
+            Panel<float> out(0, 0, out_layout);
+            alpha001(Panel<float>::from_nested(close, in_layout), Panel<float>::from_nested(returns, in_layout), out);
+            ASSERT_EQ(out.layout(), out_layout);
+            ASSERT_EQ(out.stocks(), S);
+            ASSERT_EQ(out.dates(), T);
+            for (size_t s = 0; s < S; ++s)
+                for (size_t t = 0; t < T; ++t) {
+                    if (isnan(expected[s][t])) EXPECT_TRUE(isnan(out(s, t))) << "s=" << s << " t=" << t;
+                    else EXPECT_FLOAT_EQ(out(s, t), expected[s][t]) << "s=" << s << " t=" << t;
+                }
+        }
+    }
+}
+
+// 价格量级的随机游走输入：TimeMajor（SIMD 内核）与 StockMajor（逐股票 span 算子）逐位一致
+TEST_F(Alpha001CrossTest, TimeMajorMatchesStockMajorOnPriceLevels) {
+    size_t S = 64, T = 400;
+    vector<vector<float>> close(S, vector<float>(T)), returns(S, vector<float>(T));
+    uint32_t state = 2024;
+    for (size_t s = 0; s < S; ++s) {
+        float price = 80.0f + 3.0f * s;
+        for (size_t t = 0; t < T; ++t) {
+            state = state * 1664525u + 1013904223u;
+            float r = ((state >> 8) / 16777216.0f - 0.5f) * 0.06f;
+            price *= 1.0f + r;
+            close[s][t] = price;
+            returns[s][t] = t == 0 ? NAN : r;
+        }
+    }
+    Panel<float> sm_out(0, 0, PanelLayout::StockMajor), tm_out(0, 0, PanelLayout::StockMajor);
+    alpha001(Panel<float>::from_nested(close, PanelLayout::StockMajor),
+             Panel<float>::from_nested(returns, PanelLayout::StockMajor), sm_out);
+    alpha001(Panel<float>::from_nested(close, PanelLayout::TimeMajor),
+             Panel<float>::from_nested(returns, PanelLayout::TimeMajor), tm_out);
+    for (size_t s = 0; s < S; ++s)
+        for (size_t t = 0; t < T; ++t) {
+            if (isnan(sm_out(s, t))) {
+                EXPECT_TRUE(isnan(tm_out(s, t))) << "s=" << s << " t=" << t;
+            } else {
+                EXPECT_EQ(tm_out(s, t), sm_out(s, t)) << "s=" << s << " t=" << t;
+            }
+        }
+}
+
+// ========== Alpha001 多线程版测试 ==========
+
+TEST_F(Alpha001CrossTest, ThreadPoolMatchesSerialBitForBit) {
+    // S、T 均不能被线程数整除，且含缺失值，覆盖不均匀分块与 NaN 传播
+    size_t S = 23, T = 97;
+    auto close   = linspace_mat(S, T, 50.0f, 0.7f);
+    auto returns = linspace_mat(S, T, -0.05f, 0.002f);
+    for (size_t s = 0; s < S; ++s)
+        for (size_t t = 0; t < T; ++t) {
+            close[s][t] += std::sin(0.37f * t + s);
+            returns[s][t] = 0.03f * std::sin(0.91f * t + 2.0f * s);
+        }
+    close[4][40] = NAN;
+    returns[11][70] = NAN;
+    auto expected = alpha001(close, returns);
+
+    for (size_t threads : {1u, 2u, 3u, 8u, 64u}) {
+        ThreadPool pool(threads);
+        for (int rep = 0; rep < 3; ++rep) {  // 同一线程池跨调用复用
+            auto result = alpha001(close, returns, pool);
+            ASSERT_EQ(result.size(), S);
+            for (size_t s = 0; s < S; ++s)
+                for (size_t t = 0; t < T; ++t) {
+                    if (isnan(expected[s][t])) EXPECT_TRUE(isnan(result[s][t])) << "s=" << s << " t=" << t;
+                    else EXPECT_EQ(result[s][t], expected[s][t]) << "threads=" << threads << " s=" << s << " t=" << t;
+                }
+        }
+    }
+}
+
+// ========== AlphaWorkspace 测试 ==========
+
+class AlphaWorkspaceTest : public Alpha001CrossTest {
+   protected:
+    // 含缺失值的正弦扰动数据，保证截面排名里有并列、NaN 与正负收益
+    static void noisy_inputs(size_t S, size_t T, vector<vector<float>>& close, vector<vector<float>>& returns) {
+        close = linspace_mat(S, T, 50.0f, 0.7f);
+        returns = linspace_mat(S, T, -0.05f, 0.002f);
+        for (size_t s = 0; s < S; ++s)
+            for (size_t t = 0; t < T; ++t) {
+                close[s][t] += std::sin(0.37f * t + s);
+                returns[s][t] = 0.03f * std::sin(0.91f * t + 2.0f * s);
+            }
+        // 缺失值的位置随 T 取，任意形状下都落在序列内
+        close[2 % S][T / 2] = NAN;
+        returns[S - 1][T * 5 / 8] = NAN;
+    }
+
+    static void expect_same_bits(float a, float b, size_t s, size_t t) {
+        if (isnan(a)) EXPECT_TRUE(isnan(b)) << "s=" << s << " t=" << t;
+        else EXPECT_EQ(a, b) << "s=" << s << " t=" << t;
+    }
+};
+
+TEST_F(AlphaWorkspaceTest, NestedRepeatedCallsDoNotAllocate) {
+    size_t S = 21, T = 80;
+    vector<vector<float>> close, returns;
+    noisy_inputs(S, T, close, returns);
+    auto expected = alpha001(close, returns);
+
+    AlphaWorkspace ws;
+    alpha001(close, returns, ws);  // 第一次调用按形状分配
+    size_t before = g_heap_allocations.load();
+    for (int rep = 0; rep < 3; ++rep) {
+        const auto& result = alpha001(close, returns, ws);
+        ASSERT_EQ(&result, &ws.result);
+    }
+    EXPECT_EQ(g_heap_allocations.load() - before, 0u);
+
+    ASSERT_EQ(ws.result.size(), S);
+    for (size_t s = 0; s < S; ++s) {
+        ASSERT_EQ(ws.result[s].size(), T);
+        for (size_t t = 0; t < T; ++t) expect_same_bits(expected[s][t], ws.result[s][t], s, t);
+    }
+}
+
+TEST_F(AlphaWorkspaceTest, PanelRepeatedCallsDoNotAllocate) {
+    size_t S = 21, T = 80;
+    vector<vector<float>> close, returns;
+    noisy_inputs(S, T, close, returns);
+
+    for (auto layout : {PanelLayout::StockMajor, PanelLayout::TimeMajor}) {
+        auto pc = Panel<float>::from_nested(close, layout), pr = Panel<float>::from_nested(returns, layout);
+        Panel<float> expected(0, 0, layout);
+        alpha001(pc, pr, expected);
+
+        AlphaWorkspace ws;
+        Panel<float> out(0, 0, layout);
+        alpha001(pc, pr, out, ws);
+        size_t before = g_heap_allocations.load();
+        for (int rep = 0; rep < 3; ++rep) alpha001(pc, pr, out, ws);
+        EXPECT_EQ(g_heap_allocations.load() - before, 0u) << "layout=" << (int)layout;
+
+        for (size_t s = 0; s < S; ++s)
+            for (size_t t = 0; t < T; ++t) expect_same_bits(expected(s, t), out(s, t), s, t);
+    }
+}
+
+TEST_F(AlphaWorkspaceTest, ReshapesWhenInputShapeChanges) {
+    // 同一工作区先后用于不同形状，结果仍与一次性调用逐位相同，且旧形状残留不会泄漏到新结果
+    AlphaWorkspace ws;
+    for (auto [S, T] : {pair<size_t, size_t>{21, 80}, {5, 120}, {33, 30}, {21, 80}}) {
+        vector<vector<float>> close, returns;
+        noisy_inputs(S, T, close, returns);
+        auto expected = alpha001(close, returns);
+        const auto& result = alpha001(close, returns, ws);
+        ASSERT_EQ(result.size(), S);
+        for (size_t s = 0; s < S; ++s) {
+            ASSERT_EQ(result[s].size(), T);
+            for (size_t t = 0; t < T; ++t) expect_same_bits(expected[s][t], result[s][t], s, t);
+        }
+    }
+}
+
+TEST_F(AlphaWorkspaceTest, ArenaReservedWorkspaceMatchesHeap) {
+    size_t S = 21, T = 80;
+    vector<vector<float>> close, returns;
+    noisy_inputs(S, T, close, returns);
+    PanelArena arena(ArenaPages::Normal);
+    for (auto layout : {PanelLayout::StockMajor, PanelLayout::TimeMajor}) {
+        auto pc = Panel<float>::from_nested(close, layout), pr = Panel<float>::from_nested(returns, layout);
+        Panel<float> expected(0, 0, layout), out(0, 0, layout);
+        alpha001(pc, pr, expected);
+
+        AlphaWorkspace ws;
+        ws.reserve(arena, S, T);
+        EXPECT_FALSE(ws.work.owns_memory());
+        alpha001(pc, pr, out, ws);
+        for (size_t s = 0; s < S; ++s)
+            for (size_t t = 0; t < T; ++t) expect_same_bits(expected(s, t), out(s, t), s, t);
+    }
+}
+
+TEST_F(AlphaWorkspaceTest, ArenaReservedWorkspaceServesTailAndRecompute) {
+    size_t S = 21, T = 80;
+    vector<vector<float>> close, returns;
+    noisy_inputs(S, T, close, returns);
+    auto pc = Panel<float>::from_nested(close, PanelLayout::TimeMajor);
+    auto pr = Panel<float>::from_nested(returns, PanelLayout::TimeMajor);
+    auto full = alpha001(pc, pr);
+    PanelArena arena(ArenaPages::Normal);
+    AlphaWorkspace ws;
+    ws.reserve(arena, S, T);
+
+    // 形状不同：arena 面板换成堆面板，结果不变
+    Panel<float> tail(0, 0, PanelLayout::TimeMajor);
+    alpha001_tail(pc, pr, T - 5, T, tail, ws);
+    for (size_t s = 0; s < S; ++s)
+        for (size_t t = T - 5; t < T; ++t) expect_same_bits(full(s, t), tail(s, t - (T - 5)), s, t);
+    EXPECT_TRUE(ws.argmax_tm.owns_memory());
+    EXPECT_EQ(arena.live(), 0u);
+
+    Panel<float> out = full;
+    alpha001_recompute(pc, pr, 40, 41, out, ws);
+    Panel<float> again(0, 0, PanelLayout::TimeMajor);
+    alpha001(pc, pr, again, ws);
+    for (size_t s = 0; s < S; ++s)
+        for (size_t t = 0; t < T; ++t) {
+            expect_same_bits(full(s, t), out(s, t), s, t);
+            expect_same_bits(full(s, t), again(s, t), s, t);
+        }
+}
+
+// ========== 按股票分片求值 ==========
+
+TEST_F(AlphaWorkspaceTest, ShardedMatchesSerialBitForBit) {
+    size_t S = 23, T = 97;
+    vector<vector<float>> close, returns;
+    noisy_inputs(S, T, close, returns);
+    for (auto in_layout : {PanelLayout::StockMajor, PanelLayout::TimeMajor}) {
+        auto pc = Panel<float>::from_nested(close, in_layout), pr = Panel<float>::from_nested(returns, in_layout);
+        auto expected = alpha001(pc, pr);
+        for (size_t threads : {1u, 2u, 3u, 8u, 64u}) {
+            ThreadPool pool(threads);
+            StockShards sc, sr;
+            vector<AlphaWorkspace> wss;
+            for (auto out_layout : {PanelLayout::StockMajor, PanelLayout::TimeMajor}) {
+                shard_stocks(pc, pool, sc);  // 第二轮复用分片内存
+                shard_stocks(pr, pool, sr);
+                ASSERT_EQ(sc.shards(), threads);
+                ASSERT_EQ(sc.stocks(), S);
+                Panel<float> out(0, 0, out_layout);
+                alpha001(sc, sr, out, pool, wss);
+                ASSERT_EQ(out.stocks(), S);
+                ASSERT_EQ(out.dates(), T);
+                for (size_t s = 0; s < S; ++s)
+                    for (size_t t = 0; t < T; ++t) expect_same_bits(expected(s, t), out(s, t), s, t);
+            }
+        }
+    }
+}
+
+TEST_F(AlphaWorkspaceTest, ShardedRejectsMismatchedShards) {
+    Panel<float> close(10, 30, PanelLayout::TimeMajor, 1.0f), shorter(9, 30, PanelLayout::TimeMajor, 1.0f);
+    ThreadPool pool(2), other(3);
+    auto sc = shard_stocks(close, pool);
+    EXPECT_THROW(alpha001(sc, shard_stocks(shorter, pool), pool), std::invalid_argument);
+    EXPECT_THROW(alpha001(sc, sc, other), std::invalid_argument);
+    EXPECT_EQ(alpha001(sc, sc, pool).stocks(), 10u);
+}
+
+// ========== 尾部求值 ==========
+
+TEST_F(AlphaWorkspaceTest, TailMatchesFullEvaluationBitForBit) {
+    size_t S = 19, T = 137;
+    vector<vector<float>> close, returns;
+    noisy_inputs(S, T, close, returns);
+    // 各种起点相位（含落在热身期内、恰好对齐窗口、最后一个日期）与全部布局组合
+    for (auto in_layout : {PanelLayout::StockMajor, PanelLayout::TimeMajor})
+        for (auto out_layout : {PanelLayout::StockMajor, PanelLayout::TimeMajor}) {
+            auto pc = Panel<float>::from_nested(close, in_layout), pr = Panel<float>::from_nested(returns, in_layout);
+            auto full = alpha001(pc, pr);
+            for (auto [t_begin, t_end] : {pair<size_t, size_t>{T - 1, T}, {0, T}, {10, 30}, {60, 61}, {64, 100}, {43, T}}) {
+                auto tail = alpha001_tail(pc, pr, t_begin, t_end, out_layout);
+                ASSERT_EQ(tail.stocks(), S);
+                ASSERT_EQ(tail.dates(), t_end - t_begin);
+                EXPECT_EQ(tail.layout(), out_layout);
+                for (size_t s = 0; s < S; ++s)
+                    for (size_t t = t_begin; t < t_end; ++t) expect_same_bits(full(s, t), tail(s, t - t_begin), s, t);
+            }
+        }
+}
+
+TEST_F(AlphaWorkspaceTest, TailOfLatestDateDoesNotAllocateAndRejectsBadRange) {
+    size_t S = 21, T = 300;
+    vector<vector<float>> close, returns;
+    noisy_inputs(S, T, close, returns);
+    auto pc = Panel<float>::from_nested(close, PanelLayout::TimeMajor);
+    auto pr = Panel<float>::from_nested(returns, PanelLayout::TimeMajor);
+    AlphaWorkspace ws;
+    Panel<float> out(0, 0, PanelLayout::TimeMajor);
+    alpha001_tail(pc, pr, T - 1, T, out, ws);
+    // 回看只展开到最近的窗口对齐点：argmax 缓冲区远小于完整的 T 个日期
+    EXPECT_LE(ws.argmax_tm.dates(), kAlpha001Lookback + kAlpha001StddevWindow);
+    size_t before = g_heap_allocations.load();
+    for (int rep = 0; rep < 3; ++rep) alpha001_tail(pc, pr, T - 1, T, out, ws);
+    EXPECT_EQ(g_heap_allocations.load() - before, 0u);
+
+    EXPECT_THROW(alpha001_tail(pc, pr, 5, T + 1, out, ws), std::invalid_argument);
+    EXPECT_THROW(alpha001_tail(pc, pr, 9, 8, out, ws), std::invalid_argument);
+}
+
+// ========== 输入修订后的局部重算 ==========
+
+TEST_F(AlphaWorkspaceTest, RecomputeAfterCorrectionMatchesFullEvaluationBitForBit) {
+    size_t S = 17, T = 180;
+    vector<vector<float>> close, returns;
+    noisy_inputs(S, T, close, returns);
+    EXPECT_EQ(alpha001_dirty_end(57, 60, T), 83u);  // 锚点 60 的窗口结束于 79，再加 argmax 的 4 个日期
+    EXPECT_EQ(alpha001_dirty_end(170, 171, T), T);
+    EXPECT_EQ(alpha001_dirty_end(9, 9, T), 9u);
+
+    for (auto in_layout : {PanelLayout::StockMajor, PanelLayout::TimeMajor})
+        for (auto out_layout : {PanelLayout::StockMajor, PanelLayout::TimeMajor}) {
+            auto pc = Panel<float>::from_nested(close, in_layout), pr = Panel<float>::from_nested(returns, in_layout);
+            AlphaWorkspace ws;
+            Panel<float> out(0, 0, out_layout);
+            alpha001(pc, pr, out, ws);
+
+            // 修订：一只股票的三个日期，另一只股票在热身期内的一个日期，以及最后一个日期
+            for (size_t t = 57; t < 60; ++t) {
+                pc(3, t) *= 1.01f;
+                pr(3, t) = -pr(3, t);
+            }
+            pr(11, 7) = 0.05f;
+            pc(0, T - 1) += 1.0f;
+            EXPECT_EQ(alpha001_recompute(pc, pr, 57, 60, out, ws), 83u);
+            EXPECT_EQ(alpha001_recompute(pc, pr, 7, 8, out, ws), 43u);
+            EXPECT_EQ(alpha001_recompute(pc, pr, T - 1, T, out, ws), T);
+
+            auto full = alpha001(pc, pr);
+            for (size_t s = 0; s < S; ++s)
+                for (size_t t = 0; t < T; ++t) expect_same_bits(full(s, t), out(s, t), s, t);
+        }
+}
+
+TEST_F(AlphaWorkspaceTest, RecomputeRejectsBadArguments) {
+    size_t S = 5, T = 60;
+    vector<vector<float>> close, returns;
+    noisy_inputs(S, T, close, returns);
+    auto pc = Panel<float>::from_nested(close, PanelLayout::TimeMajor);
+    auto pr = Panel<float>::from_nested(returns, PanelLayout::TimeMajor);
+    AlphaWorkspace ws;
+    Panel<float> out(S, T - 1, PanelLayout::TimeMajor);
+    EXPECT_THROW(alpha001_recompute(pc, pr, 3, 4, out, ws), std::invalid_argument);
+    out.reset(S, T, PanelLayout::TimeMajor);
+    EXPECT_THROW(alpha001_recompute(pc, pr, 3, T + 1, out, ws), std::invalid_argument);
+    EXPECT_THROW(alpha001_recompute(pc, pr, 4, 3, out, ws), std::invalid_argument);
+}
+
 // main-Funktion wird von GTest::gtest_main bereitgestellt, kein manuelles Schreiben nötig
@@ -0,0 +1,585 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <random>
+
+#include "Alpha101.h"
+#include "Alpha101Expr.h"
+
+// ========== 测试数据 ==========
+
+// 随机 OHLCV 面板：收盘价为随机游走，open/high/low/vwap 围绕收盘价生成，returns 为日收益率；
+// 分类字段为整数编码，股票 1 在中途换入另一个子行业
+struct MarketData {
+    Panel<float> open, high, low, close, volume, vwap, returns, cap;
+    Panel<float> sector, industry, subindustry;
+
+    MarketData(size_t S, size_t T, PanelLayout layout = PanelLayout::TimeMajor, unsigned seed = 7)
+        : open(S, T, layout),
+          high(S, T, layout),
+          low(S, T, layout),
+          close(S, T, layout),
+          volume(S, T, layout),
+          vwap(S, T, layout),
+          returns(S, T, layout),
+          cap(S, T, layout),
+          sector(S, T, layout),
+          industry(S, T, layout),
+          subindustry(S, T, layout) {
+        std::mt19937 gen(seed);
+        std::normal_distribution<float> step(0.0f, 0.02f);
+        std::uniform_real_distribution<float> u(0.0f, 1.0f);
+        for (size_t s = 0; s < S; ++s) {
+            float c = 20.0f + 5.0f * s;
+            for (size_t t = 0; t < T; ++t) {
+                float prev = c;
+                c *= std::exp(step(gen));
+                float o = prev * (1.0f + 0.01f * (u(gen) - 0.5f));
+                float h = std::max(o, c) * (1.0f + 0.01f * u(gen));
+                float l = std::min(o, c) * (1.0f - 0.01f * u(gen));
+                open(s, t) = o;
+                high(s, t) = h;
+                low(s, t) = l;
+                close(s, t) = c;
+                vwap(s, t) = l + (h - l) * u(gen);
+                // 周期分量使 adv 的截面排名随时间变化，否则 correlation(·, rank(adv20)) 在排名不变的窗口上为 NaN
+                volume(s, t) = std::round(1e5f * (0.5f + u(gen)) * (1.5f + std::sin(0.2f * t + s)));
+                returns(s, t) = t == 0 ? NAN : c / prev - 1.0f;
+                cap(s, t) = c * 1e6f * (1.0f + s);
+                sector(s, t) = float(s % 2);
+                industry(s, t) = float(s % 4);
+                subindustry(s, t) = float(s == 1 && t >= T / 2 ? 104 : 100 + s % 5);
+            }
+        }
+    }
+
+    FieldMap fields() const {
+        return {{"open", &open},     {"high", &high}, {"low", &low},         {"close", &close},
+                {"volume", &volume}, {"vwap", &vwap}, {"returns", &returns}, {"cap", &cap},
+                {"sector", &sector}, {"industry", &industry}, {"subindustry", &subindustry}};
+    }
+};
+
+// 逐位比较（NaN 视为相等）
+static void expect_panel_identical(const Panel<float>& a, const Panel<float>& b, const string& what) {
+    ASSERT_EQ(a.stocks(), b.stocks()) << what;
+    ASSERT_EQ(a.dates(), b.dates()) << what;
+    for (size_t s = 0; s < a.stocks(); ++s)
+        for (size_t t = 0; t < a.dates(); ++t) {
+            float x = a(s, t), y = b(s, t);
+            if (isnan(x) || isnan(y)) {
+                ASSERT_EQ(isnan(x), isnan(y)) << what << " s=" << s << " t=" << t;
+            } else {
+                ASSERT_EQ(x, y) << what << " s=" << s << " t=" << t;
+            }
+        }
+}
+
+// ========== ExprGraph：子表达式合并与规范化 ==========
+
+TEST(ExprGraphTest, IdenticalSubtreesShareOneNode) {
+    ExprGraph g;
+    AlphaFields f(g);
+    Expr a = alpha_rank(delta(f.close, 1));
+    Expr b = alpha_rank(delta(f.close, 1));
+    EXPECT_EQ(a.id, b.id);
+    EXPECT_NE(delta(f.close, 1).id, delta(f.close, 2).id);
+    EXPECT_NE(delta(f.close, 1).id, delta(f.open, 1).id);
+}
+
+TEST(ExprGraphTest, CommutativeOperandsAreCanonicalised) {
+    ExprGraph g;
+    AlphaFields f(g);
+    EXPECT_EQ((f.close + f.open).id, (f.open + f.close).id);
+    EXPECT_EQ((f.high * f.low).id, (f.low * f.high).id);
+    EXPECT_NE((f.close - f.open).id, (f.open - f.close).id);
+    EXPECT_NE((f.close < f.open).id, (f.open < f.close).id);
+}
+
+TEST(ExprGraphTest, FractionalWindowsAreFloored) {
+    ExprGraph g;
+    AlphaFields f(g);
+    EXPECT_EQ(ts_min(f.vwap, 16.1219).id, ts_min(f.vwap, 16).id);
+    EXPECT_EQ(g.node(correlation(f.vwap, f.volume, 4.24304).id).window, 4);
+}
+
+TEST(ExprGraphTest, ConstantsFoldAndIdentitiesVanish) {
+    ExprGraph g;
+    AlphaFields f(g);
+    Expr c = (-1 * 1) + f.close * 0;  // f.close * 0 不能折叠（NaN * 0 = NaN）
+    EXPECT_FALSE(g.is_const(c.id));
+    EXPECT_EQ((1 * f.close).id, f.close.id);
+    EXPECT_EQ((f.close + 0).id, f.close.id);
+    EXPECT_EQ(power(f.close, 1).id, f.close.id);
+    EXPECT_EQ(ts_sum(f.close, 1).id, f.close.id);
+    EXPECT_EQ(product(f.close, 1.46).id, f.close.id);
+
+    Expr k = where(f.close < 0, 2 * 3, 1 - 0.5);
+    const ExprNode& n = g.node(k.id);
+    EXPECT_TRUE(g.is_const(n.args[1], 6.0f));
+    EXPECT_TRUE(g.is_const(n.args[2], 0.5f));
+}
+
+TEST(ExprGraphTest, PlanVisitsOnlyReachableNodesInTopologicalOrder) {
+    ExprGraph g;
+    AlphaFields f(g);
+    Expr unused = ts_rank(f.high, 10);
+    Expr root = alpha_rank(f.close - f.open);
+    vector<NodeId> roots = {root.id};
+    ExprPlan plan = compile_plan(g, roots);
+    for (NodeId id : plan.order) EXPECT_NE(id, unused.id);
+    for (size_t i = 1; i < plan.order.size(); ++i) EXPECT_LT(plan.order[i - 1], plan.order[i]);
+    EXPECT_EQ(plan.fields, (vector<string>{"open", "close"}));
+}
+
+// ========== 求值 ==========
+
+TEST(ExprEvaluateTest, ElementwiseSemantics) {
+    ExprGraph g;
+    Expr x{&g, g.field("x")}, y{&g, g.field("y")};
+    Panel<float> px(1, 4, PanelLayout::TimeMajor), py(1, 4, PanelLayout::TimeMajor);
+    float xs[] = {-2.0f, 0.0f, 3.0f, NAN}, ys[] = {1.0f, 1.0f, -1.0f, 1.0f};
+    for (size_t t = 0; t < 4; ++t) {
+        px(0, t) = xs[t];
+        py(0, t) = ys[t];
+    }
+    vector<NodeId> roots = {sign(x).id, (x < y).id, where(x < y, x, y).id, signed_power(x, 2).id, max(x, y).id};
+    auto out = evaluate(g, compile_plan(g, roots), {{"x", &px}, {"y", &py}});
+
+    EXPECT_EQ(out[0](0, 0), -1.0f);
+    EXPECT_EQ(out[0](0, 1), 0.0f);
+    EXPECT_TRUE(isnan(out[0](0, 3)));
+    EXPECT_EQ(out[1](0, 0), 1.0f);
+    EXPECT_EQ(out[1](0, 2), 0.0f);
+    EXPECT_TRUE(isnan(out[1](0, 3)));  // 比较的操作数为 NaN 时结果为 NaN
+    EXPECT_EQ(out[2](0, 0), -2.0f);
+    EXPECT_EQ(out[2](0, 2), -1.0f);
+    EXPECT_EQ(out[3](0, 0), -4.0f);
+    EXPECT_EQ(out[4](0, 2), 3.0f);
+    EXPECT_TRUE(isnan(out[4](0, 3)));
+}
+
+TEST(ExprEvaluateTest, WindowSumsFromSharedPrefixMatchOperators) {
+    MarketData md(9, 260);
+    ExprGraph g;
+    AlphaFields f(g);
+    vector<int> windows = {5, 20, 60, 180, 250};
+    vector<NodeId> roots;
+    for (int w : windows) {
+        roots.push_back(f.adv(w).id);
+        roots.push_back(ts_sum(f.volume, w).id);
+    }
+    auto out = evaluate(g, compile_plan(g, roots), md.fields());
+    for (size_t i = 0; i < windows.size(); ++i) {
+        Panel<float> mean = rolling_sma(md.volume, windows[i]), sum = rolling_ts_sum(md.volume, windows[i]);
+        for (size_t s = 0; s < 9; ++s)
+            for (size_t t = 0; t < 260; ++t) {
+                ASSERT_EQ(isnan(out[2 * i](s, t)), isnan(mean(s, t))) << "w=" << windows[i] << " t=" << t;
+                if (isnan(mean(s, t))) continue;
+                EXPECT_NEAR(out[2 * i](s, t), mean(s, t), mean(s, t) * 1e-6f);
+                EXPECT_NEAR(out[2 * i + 1](s, t), sum(s, t), sum(s, t) * 1e-6f);
+            }
+    }
+}
+
+TEST(ExprEvaluateTest, MissingFieldThrows) {
+    MarketData md(4, 30);
+    FieldMap fields = md.fields();
+    fields.erase("vwap");
+    AlphaBatch batch(vector<int>{5});
+    EXPECT_THROW(batch.evaluate(fields), std::invalid_argument);
+}
+
+TEST(ExprEvaluateTest, UnknownAlphaThrows) {
+    EXPECT_THROW(AlphaBatch(vector<int>{102}), std::invalid_argument);
+    EXPECT_EQ(find_alpha101(102), nullptr);
+}
+
+TEST(ExprEvaluateTest, Alpha101MatchesHandWrittenFormula) {
+    MarketData md(6, 40);
+    auto out = AlphaBatch(vector<int>{101}).evaluate(md.fields());
+    for (size_t s = 0; s < 6; ++s)
+        for (size_t t = 0; t < 40; ++t) {
+            float expected = (md.close(s, t) - md.open(s, t)) / ((md.high(s, t) - md.low(s, t)) + 0.001f);
+            EXPECT_EQ(out[0](s, t), expected);
+        }
+}
+
+TEST(ExprEvaluateTest, IndNeutralizeMatchesGroupDemean) {
+    // 同一分类上的两个 IndNeutralize 共用一份分组；结果与直接调用 group_demean 逐位一致
+    MarketData md(12, 60);
+    ExprGraph g;
+    AlphaFields f(g);
+    NodeId roots[] = {ind_neutralize(f.close, f.subindustry).id, ind_neutralize(f.vwap, f.subindustry).id,
+                      ind_neutralize(f.close, f.sector).id};
+    auto out = evaluate(g, compile_plan(g, roots), md.fields());
+    GroupPartition sub(md.subindustry), sector(md.sector);
+    EXPECT_EQ(sub.segments(), 2u);
+    expect_panel_identical(out[0], group_demean(md.close, sub), "close/subindustry");
+    expect_panel_identical(out[1], group_demean(md.vwap, sub), "vwap/subindustry");
+    expect_panel_identical(out[2], group_demean(md.close, sector), "close/sector");
+}
+
+TEST(ExprEvaluateTest, Alpha001MatchesPanelImplementation) {
+    // returns[0] 为 NaN，stddev(returns, 20) 从 t = 20 起有效，再经 ts_argmax(·, 5) 后从 t = 24 起逐位一致
+    MarketData md(25, 120);
+    auto engine = AlphaBatch(vector<int>{1}).evaluate(md.fields())[0];
+    auto hand = alpha001(md.close, md.returns, PanelLayout::TimeMajor);
+    for (size_t s = 0; s < 25; ++s)
+        for (size_t t = 24; t < 120; ++t) EXPECT_EQ(engine(s, t), hand(s, t)) << "s=" << s << " t=" << t;
+}
+
+TEST(ExprEvaluateTest, EveryRegisteredAlphaEvaluates) {
+    MarketData md(20, 300);
+    AlphaBatch batch(alpha101_ids());
+    auto out = batch.evaluate(md.fields());
+    ASSERT_EQ(out.size(), batch.ids().size());
+    for (size_t i = 0; i < out.size(); ++i) {
+        EXPECT_EQ(out[i].stocks(), 20u);
+        EXPECT_EQ(out[i].dates(), 300u);
+        EXPECT_EQ(out[i].layout(), PanelLayout::TimeMajor);
+        size_t finite = 0;
+        for (size_t s = 0; s < 20; ++s) finite += !isnan(out[i](s, 299));
+        EXPECT_GT(finite, 0u) << "alpha" << batch.ids()[i] << " is all NaN on the last date";
+    }
+}
+
+TEST(ExprEvaluateTest, BatchMatchesIndividualEvaluationBitForBit) {
+    MarketData md(16, 280);
+    FieldMap fields = md.fields();
+    vector<int> ids = alpha101_ids();
+    auto batch = AlphaBatch(ids).evaluate(fields);
+    for (size_t i = 0; i < ids.size(); ++i) {
+        auto single = AlphaBatch(vector<int>{ids[i]}).evaluate(fields);
+        expect_panel_identical(batch[i], single[0], "alpha" + to_string(ids[i]));
+    }
+}
+
+TEST(ExprEvaluateTest, ArenaEvaluationMatchesHeapAndRewinds) {
+    MarketData md(16, 280);
+    FieldMap fields = md.fields();
+    AlphaBatch batch(alpha101_ids());
+    auto heap = batch.evaluate(fields);
+    PanelArena arena(ArenaPages::Normal);
+    for (int run = 0; run < 2; ++run) {
+        auto out = batch.evaluate(fields, PanelLayout::TimeMajor, &arena);
+        ASSERT_EQ(out.size(), heap.size());
+        for (size_t i = 0; i < out.size(); ++i) {
+            EXPECT_TRUE(out[i].owns_memory());  // 结果在堆上，可越过下一批
+            expect_panel_identical(out[i], heap[i], "alpha" + to_string(batch.ids()[i]));
+        }
+        EXPECT_EQ(arena.live(), 0u);
+    }
+    size_t capacity = arena.capacity();
+    EXPECT_GT(capacity, 0u);
+    batch.evaluate_range(fields, 200, 280, PanelLayout::TimeMajor, &arena);
+    EXPECT_EQ(arena.capacity(), capacity);  // 回卷后复用已有的块
+}
+
+TEST(ExprEvaluateTest, StockMajorEvaluationOfElementwiseAlphas) {
+    MarketData tm(8, 50, PanelLayout::TimeMajor), sm(8, 50, PanelLayout::StockMajor);
+    AlphaBatch batch(vector<int>{12, 41, 101});
+    auto a = batch.evaluate(tm.fields(), PanelLayout::TimeMajor);
+    auto b = batch.evaluate(sm.fields(), PanelLayout::StockMajor);
+    auto c = batch.evaluate(tm.fields(), PanelLayout::StockMajor);  // 输入先转换布局
+    for (size_t i = 0; i < a.size(); ++i) {
+        EXPECT_EQ(b[i].layout(), PanelLayout::StockMajor);
+        expect_panel_identical(a[i], b[i], "layout " + to_string(i));
+        expect_panel_identical(a[i], c[i], "converted " + to_string(i));
+    }
+}
+
+TEST(ExprEvaluateTest, SharedSubexpressionsShrinkTheBatch) {
+    AlphaBatch batch(alpha101_ids());
+    size_t individual = 0;
+    for (int id : alpha101_ids()) individual += AlphaBatch(vector<int>{id}).unique_nodes();
+    // 合并后的唯一节点数小于各 alpha 单独求值的节点数之和，后者又小于展开成树的节点数
+    EXPECT_LT(batch.unique_nodes(), individual);
+    EXPECT_LT(individual, batch.tree_nodes());
+}
+
+// ========== 派生输入字段 ==========
+
+static Panel<float> adv_reference(const Panel<float>& volume, int d) {
+    Panel<float> out;
+    rolling_sma(volume, d, out);
+    return out;
+}
+
+TEST(AlphaInputsTest, DerivesReturnsVwapAndAdvFromOhlcv) {
+    MarketData md(6, 60);
+    AlphaInputs in({{"open", &md.open}, {"high", &md.high}, {"low", &md.low}, {"close", &md.close},
+                    {"volume", &md.volume}});
+    in.derive(vector<int>{5, 20});
+    EXPECT_EQ(in.derived_count(), 4u);  // returns、vwap、adv5、adv20
+    // MarketData 的 returns 同样按 c / prev - 1 生成
+    expect_panel_identical(in.at("returns"), md.returns, "returns");
+    expect_panel_identical(in.at("adv20"), adv_reference(md.volume, 20), "adv20");
+    EXPECT_EQ(in.at("vwap")(2, 9), (md.high(2, 9) + md.low(2, 9) + md.close(2, 9)) / 3.0f);
+    EXPECT_THROW(in.at("adv10"), std::invalid_argument);
+
+    // 已提供的字段不会被派生覆盖
+    AlphaInputs given(md.fields());
+    given.derive(vector<int>{20});
+    EXPECT_EQ(given.derived_count(), 1u);
+    EXPECT_EQ(&given.at("vwap"), &md.vwap);
+}
+
+TEST(AlphaInputsTest, CachedAdvMatchesRecomputationBitForBit) {
+    MarketData md(9, 260, PanelLayout::StockMajor);
+    AlphaBatch batch(alpha101_ids());
+    auto windows = batch.adv_windows();
+    EXPECT_GE(windows.size(), 10u);
+    AlphaInputs in(md.fields());
+    in.derive(windows);
+
+    // 派生为 StockMajor，求值为 TimeMajor：跨布局读取缓存同样逐位一致
+    auto plain = batch.evaluate(md.fields());
+    auto cached = batch.evaluate(in.fields());
+    for (size_t i = 0; i < plain.size(); ++i)
+        expect_panel_identical(cached[i], plain[i], "alpha" + to_string(batch.ids()[i]));
+}
+
+TEST(AlphaInputsTest, EvaluatorReadsCachedAdvInsteadOfRecomputing) {
+    MarketData md(4, 30);
+    ExprGraph g;
+    AlphaFields f(g);
+    NodeId roots[] = {f.adv(20).id, (f.volume / f.adv(20)).id, f.adv(5).id};
+    auto plan = compile_plan(g, roots);
+    Panel<float> sentinel(4, 30, PanelLayout::TimeMajor, 2.0f);
+    auto fields = md.fields();
+    fields[adv_field(20)] = &sentinel;
+    auto out = evaluate(g, plan, fields);
+    expect_panel_identical(out[0], sentinel, "adv20");
+    EXPECT_EQ(out[1](1, 3), md.volume(1, 3) / 2.0f);
+    expect_panel_identical(out[2], adv_reference(md.volume, 5), "adv5");  // 未缓存的窗口照常计算
+
+    Panel<float> wrong_shape(4, 29, PanelLayout::TimeMajor, 2.0f);
+    fields[adv_field(20)] = &wrong_shape;
+    EXPECT_THROW(evaluate(g, plan, fields), std::invalid_argument);
+}
+
+// ========== 回看分析 ==========
+
+TEST(LookbackTest, PropagatesThroughNestedWindows) {
+    ExprGraph g;
+    AlphaFields f(g);
+    NodeId roots[] = {
+        delay(f.close, 3).id,                                                   // 3
+        ts_sum(delta(f.close, 2), 5).id,                                        // 2 + 4
+        correlation(ts_mean(f.close, 3), delay(f.volume, 4), 10).id,            // max(2, 4) + 9
+        (alpha_rank(ts_max(f.high, 7)) + delay(f.low, 1)).id,                   // 截面与逐元素不增加回看
+        ind_neutralize(stddev(f.returns, 20), f.industry).id,                   // 19
+        (f.open * 2).id,                                                        // 0
+    };
+    auto plan = compile_plan(g, roots);
+    auto lookback = plan_lookback(g, plan);
+    vector<size_t> expected = {3, 6, 13, 6, 19, 0};
+    for (size_t i = 0; i < expected.size(); ++i) EXPECT_EQ(lookback[roots[i]], expected[i]) << "root " << i;
+}
+
+TEST(LookbackTest, AlphaHistoryMatchesHandDerivedWarmup) {
+    AlphaBatch a1(vector<int>{1});
+    EXPECT_EQ(a1.history(), kAlpha001Lookback);  // stddev(·, 20) → ts_argmax(·, 5)
+    EXPECT_EQ(AlphaBatch(vector<int>{101}).history(), 1u);  // 纯逐元素
+    EXPECT_EQ(AlphaBatch(vector<int>{12}).history(), 2u);   // delta(·, 1)
+
+    AlphaBatch all(alpha101_ids());
+    size_t widest = 0;
+    for (size_t i = 0; i < all.ids().size(); ++i) {
+        size_t h = AlphaBatch(vector<int>{all.ids()[i]}).history();
+        EXPECT_EQ(all.history(i), h) << "alpha" << all.ids()[i];
+        widest = std::max(widest, h);
+    }
+    EXPECT_EQ(all.history(), widest);
+}
+
+TEST(LookbackTest, RangeEvaluationMatchesFullEvaluation) {
+    size_t T = 300;
+    MarketData md(9, T);
+    AlphaBatch batch(alpha101_ids());
+    auto full = batch.evaluate(md.fields());
+    for (auto [t_begin, t_end] : {pair<size_t, size_t>{T - 1, T}, {T - 20, T - 7}, {0, 4}}) {
+        auto part = batch.evaluate_range(md.fields(), t_begin, t_end);
+        ASSERT_EQ(part.size(), full.size());
+        for (size_t i = 0; i < full.size(); ++i) {
+            ASSERT_EQ(part[i].dates(), t_end - t_begin);
+            for (size_t s = 0; s < 9; ++s)
+                for (size_t t = t_begin; t < t_end; ++t) {
+                    float x = full[i](s, t), y = part[i](s, t - t_begin);
+                    ASSERT_EQ(isnan(x), isnan(y)) << "alpha" << batch.ids()[i] << " s=" << s << " t=" << t;
+                    if (!isnan(x)) {
+                        EXPECT_EQ(y, x) << "alpha" << batch.ids()[i] << " s=" << s << " t=" << t;
+                    }
+                }
+        }
+    }
+    EXPECT_THROW(batch.evaluate_range(md.fields(), 5, T + 1), std::invalid_argument);
+}
+
+// 锚点按绝对日期对齐后，每个公式单独求值时在任意区间上都与完整求值逐位一致
+TEST(LookbackTest, RangeEvaluationIsBitExactPerAlpha) {
+    EXPECT_EQ(AlphaBatch(vector<int>{1}).anchored_history(), kAlpha001Lookback + kAlpha001StddevWindow - 1);
+
+    size_t T = 300, S = 9;
+    MarketData md(S, T);
+    for (int id : alpha101_ids()) {
+        AlphaBatch batch(vector<int>{id});
+        auto full = batch.evaluate(md.fields());
+        for (auto [t_begin, t_end] : {pair<size_t, size_t>{T - 1, T}, {T - 33, T - 11}}) {
+            auto part = batch.evaluate_range(md.fields(), t_begin, t_end);
+            for (size_t s = 0; s < S; ++s)
+                for (size_t t = t_begin; t < t_end; ++t) {
+                    float x = full[0](s, t), y = part[0](s, t - t_begin);
+                    ASSERT_EQ(isnan(x), isnan(y)) << "alpha" << id << " s=" << s << " t=" << t;
+                    if (!isnan(x)) {
+                        EXPECT_EQ(y, x) << "alpha" << id << " s=" << s << " t=" << t;
+                    }
+                }
+        }
+    }
+}
+
+TEST(LookbackTest, OneDateLessHistoryChangesTheLatestValue) {
+    // history() 是最小值：少读一个日期，alpha001 的最新截面就不再与完整求值相同
+    size_t T = 100, S = 6;
+    MarketData md(S, T);
+    AlphaBatch batch(vector<int>{1});
+    size_t h = batch.history();
+    auto close = slice_dates(md.close, T - h + 1, T, PanelLayout::TimeMajor);
+    auto returns = slice_dates(md.returns, T - h + 1, T, PanelLayout::TimeMajor);
+    auto shorter = batch.evaluate({{"close", &close}, {"returns", &returns}});
+    auto exact = batch.evaluate_range(md.fields(), T - 1, T);
+    auto full = batch.evaluate(md.fields());
+    size_t changed = 0;
+    for (size_t s = 0; s < S; ++s) {
+        EXPECT_EQ(exact[0](s, 0), full[0](s, T - 1));
+        float y = shorter[0](s, h - 2);
+        changed += isnan(y) || y != exact[0](s, 0);
+    }
+    EXPECT_GT(changed, 0u);
+}
+
+// ========== 脏区传播与局部重算 ==========
+
+TEST(DirtyRangeTest, PropagatesThroughWindowsAndCrossSections) {
+    ExprGraph g;
+    AlphaFields f(g);
+    NodeId roots[] = {
+        delay(f.close, 3).id,                          // 整体后移 3
+        ts_sum(delta(f.close, 2), 5).id,               // 后延 2，再延伸到 [40, 45) 锚点窗口的末尾
+        (f.close * f.volume).id,                       // 两个字段的并
+        alpha_rank(ts_max(f.close, 7)).id,             // 后延 6，整个截面
+        (f.open * 2).id,                               // 未修订
+        stddev(f.close, 10).id,                        // 重新锚定：延伸到 [50, 60) 锚点窗口的末尾
+    };
+    auto plan = compile_plan(g, roots);
+    unordered_map<string, DirtyRange> inputs;
+    inputs["close"].mark(2, 40, 42);
+    inputs["volume"].mark(5, 10);
+    auto dirty = plan_dirty(g, plan, inputs, 100);
+
+    auto expect_range = [&](size_t root, size_t d0, size_t d1, bool all) {
+        const DirtyRange& d = dirty[roots[root]];
+        EXPECT_EQ(d.d_begin(), d0) << "root " << root;
+        EXPECT_EQ(d.d_end(), d1) << "root " << root;
+        EXPECT_EQ(d.all_stocks, all) << "root " << root;
+    };
+    expect_range(0, 43, 45, false);
+    expect_range(1, 40, 49, false);
+    expect_range(2, 10, 42, false);
+    expect_range(3, 40, 48, true);
+    expect_range(5, 40, 59, false);
+    EXPECT_TRUE(dirty[roots[4]].empty());
+    EXPECT_TRUE(dirty[roots[0]].has_stock(2));
+    EXPECT_FALSE(dirty[roots[0]].has_stock(5));
+    EXPECT_TRUE(dirty[roots[2]].contains(5, 10) && dirty[roots[2]].contains(2, 41) && !dirty[roots[2]].contains(3, 41));
+    // 相隔的修订各自成段，其间的日期不脏
+    EXPECT_EQ(dirty[roots[2]].dates, (vector<pair<size_t, size_t>>{{10, 11}, {40, 42}}));
+    EXPECT_FALSE(dirty[roots[2]].contains(5, 20));
+
+    // 区间被截断到 T；delay 移出末尾后为空
+    auto late = plan_dirty(g, plan, {{"close", [] { DirtyRange d; d.mark(0, 98, 100); return d; }()}}, 100);
+    EXPECT_TRUE(late[roots[0]].empty());
+    EXPECT_EQ(late[roots[1]].d_end(), 100u);
+}
+
+TEST(DirtyRangeTest, RecomputeMatchesFullEvaluationAfterCorrection) {
+    size_t S = 9, T = 160;
+    MarketData md(S, T);
+    AlphaBatch batch(alpha101_ids());
+    Panel<float> returns0;
+    derive_returns(md.close, returns0);
+    FieldMap fields = md.fields();
+    fields["returns"] = &returns0;
+    auto outputs = batch.evaluate(fields);
+
+    // 供应商修订：两只股票的若干收盘价与成交量，returns 随之重新派生
+    Panel<float> close = md.close, volume = md.volume, returns;
+    close(4, 70) *= 1.02f;
+    close(4, 71) *= 0.99f;
+    close(1, 150) *= 1.05f;
+    volume(7, 100) *= 3.0f;
+    derive_returns(close, returns);
+    fields["close"] = &close;
+    fields["volume"] = &volume;
+    fields["returns"] = &returns;
+    unordered_map<string, DirtyRange> dirty = {{"close", dirty_cells(md.close, close)},
+                                               {"volume", dirty_cells(md.volume, volume)},
+                                               {"returns", dirty_cells(returns0, returns)}};
+    EXPECT_EQ(dirty["close"].dates, (vector<pair<size_t, size_t>>{{70, 72}, {150, 151}}));
+    EXPECT_EQ(dirty["returns"].dates, (vector<pair<size_t, size_t>>{{70, 73}, {150, 152}}));
+
+    auto before = outputs;
+    auto out_dirty = batch.recompute_dirty(fields, dirty, outputs);
+    auto full = batch.evaluate(fields);
+    size_t untouched = 0;
+    for (size_t i = 0; i < full.size(); ++i) {
+        // 重算与脏区外的单元格都与完整求值逐位一致
+        for (size_t s = 0; s < S; ++s)
+            for (size_t t = 0; t < T; ++t) {
+                float x = full[i](s, t), y = outputs[i](s, t);
+                if (!out_dirty[i].contains(s, t)) {
+                    // 脏区外保持原值
+                    EXPECT_EQ(bit_cast<uint32_t>(y), bit_cast<uint32_t>(before[i](s, t)));
+                    ++untouched;
+                }
+                ASSERT_EQ(isnan(x), isnan(y)) << "alpha" << batch.ids()[i] << " s=" << s << " t=" << t;
+                if (!isnan(x)) {
+                    EXPECT_EQ(y, x) << "alpha" << batch.ids()[i] << " s=" << s << " t=" << t;
+                }
+            }
+    }
+    EXPECT_GT(untouched, full.size() * S * 60);  // 修订前的日期无需重算
+    // alpha012 = sign(delta(volume, 1)) * (-1 * delta(close, 1))：三次修订各自成段，其间的日期保持原值
+    size_t i12 = std::find(batch.ids().begin(), batch.ids().end(), 12) - batch.ids().begin();
+    EXPECT_EQ(out_dirty[i12].dates, (vector<pair<size_t, size_t>>{{70, 73}, {100, 102}, {150, 152}}));
+    EXPECT_FALSE(out_dirty[i12].contains(4, 120));
+
+    // 无修订时不求值、不改写
+    auto again = batch.recompute_dirty(fields, {}, outputs);
+    for (const DirtyRange& d : again) EXPECT_TRUE(d.empty());
+}
+
+// 热身期短的公式：相距较远的修订分段求值，每段都与完整求值逐位一致
+TEST(DirtyRangeTest, DistantCorrectionsAreRecomputedSegmentBySegment) {
+    size_t S = 7, T = 160;
+    MarketData md(S, T);
+    AlphaBatch batch(vector<int>{12, 101});
+    ASSERT_LT(batch.anchored_history(), 30u);
+    auto outputs = batch.evaluate(md.fields());
+
+    Panel<float> close = md.close;
+    close(2, 40) *= 1.03f;
+    close(5, 120) *= 0.97f;
+    FieldMap fields = md.fields();
+    fields["close"] = &close;
+    auto out_dirty = batch.recompute_dirty(fields, {{"close", dirty_cells(md.close, close)}}, outputs);
+    EXPECT_EQ(out_dirty[0].dates, (vector<pair<size_t, size_t>>{{40, 42}, {120, 122}}));
+    auto full = batch.evaluate(fields);
+    for (size_t i = 0; i < full.size(); ++i)
+        for (size_t s = 0; s < S; ++s)
+            for (size_t t = 0; t < T; ++t)
+                EXPECT_EQ(bit_cast<uint32_t>(outputs[i](s, t)), bit_cast<uint32_t>(full[i](s, t)))
+                    << "alpha" << batch.ids()[i] << " s=" << s << " t=" << t;
+}
@@ -0,0 +1,190 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <random>
+
+#include "Alpha101Formula.h"
+
+// ========== 测试数据 ==========
+
+// 随机 OHLCV 面板（正价格、正成交量），returns 首日为 NaN
+struct FormulaMarket {
+    vector<Panel<float>> panels;
+    FieldMap fields;
+
+    FormulaMarket(size_t S, size_t T, unsigned seed = 11) {
+        static const char* names[] = {"open", "high", "low", "close", "volume", "vwap", "returns", "cap"};
+        std::mt19937 gen(seed);
+        std::uniform_real_distribution<float> price(10.0f, 200.0f), vol(1e4f, 1e6f);
+        std::normal_distribution<float> ret(0.0f, 0.02f);
+        panels.reserve(8);
+        for (const char* name : names) {
+            Panel<float> p(S, T, PanelLayout::TimeMajor);
+            string n = name;
+            for (size_t s = 0; s < S; ++s)
+                for (size_t t = 0; t < T; ++t)
+                    p(s, t) = n == "returns" ? (t == 0 ? NAN : ret(gen))
+                              : (n == "volume" || n == "cap") ? vol(gen)
+                                                              : price(gen);
+            panels.push_back(std::move(p));
+            fields[n] = &panels.back();
+        }
+    }
+};
+
+// ========== 与注册表中的手写构造一致 ==========
+
+TEST(FormulaParserTest, EveryRegisteredFormulaParsesToTheHandBuiltNode) {
+    // 同一张图中节点哈希合并，解析结果与手写构造落在同一节点即说明两者结构完全相同
+    ExprGraph g;
+    AlphaFields f(g);
+    for (const AlphaFormula& a : alpha101_formulas()) {
+        NodeId built = a.build(f).id;
+        NodeId parsed = parse_formula(f, a.formula).id;
+        EXPECT_EQ(parsed, built) << "alpha" << a.id << ": " << a.formula;
+    }
+}
+
+TEST(FormulaParserTest, FormulaBatchMatchesAlphaBatch) {
+    FormulaMarket md(12, 120);
+    vector<int> ids = {1, 7, 21, 54, 101};
+    vector<string> texts;
+    for (int id : ids) texts.push_back(find_alpha101(id)->formula);
+    auto a = AlphaBatch(ids).evaluate(md.fields);
+    auto b = FormulaBatch(texts).evaluate(md.fields);
+    ASSERT_EQ(a.size(), b.size());
+    for (size_t i = 0; i < a.size(); ++i)
+        for (size_t k = 0; k < a[i].size(); ++k) {
+            float x = a[i].data()[k], y = b[i].data()[k];
+            if (isnan(x)) {
+                EXPECT_TRUE(isnan(y));
+            } else {
+                EXPECT_EQ(x, y);
+            }
+        }
+}
+
+// ========== 语法 ==========
+
+TEST(FormulaParserTest, PrecedenceAndAssociativity) {
+    ExprGraph g;
+    AlphaFields f(g);
+    auto value = [&](const char* text) {
+        Expr e = parse_formula(f, text);
+        EXPECT_TRUE(g.is_const(e.id)) << text;
+        return g.node(e.id).value;
+    };
+    EXPECT_EQ(value("1 - 2 - 3"), -4.0f);
+    EXPECT_EQ(value("2 ^ 3 ^ 2"), 512.0f);
+    EXPECT_EQ(value("-2 ^ 2"), -4.0f);
+    EXPECT_EQ(value("1 + 2 * 3"), 7.0f);
+    EXPECT_EQ(value("8 / 4 / 2"), 1.0f);
+    EXPECT_EQ(value("1 < 2 ? 3 : 4"), 3.0f);
+    EXPECT_EQ(value("0 ? 1 : 0 ? 2 : 3"), 3.0f);
+    EXPECT_EQ(value("(1 < 0) || (2 == 2)"), 1.0f);
+    EXPECT_EQ(value("2."), 2.0f);
+    EXPECT_EQ(value(".5 * 4"), 2.0f);
+
+    EXPECT_EQ(parse_formula(f, "-close ^ 2").id, (-power(f.close, 2)).id);
+    EXPECT_EQ(parse_formula(f, "close * -1").id, (f.close * -1).id);
+    EXPECT_EQ(parse_formula(f, "close - open - high").id, ((f.close - f.open) - f.high).id);
+    EXPECT_EQ(parse_formula(f, "close < open ? high : low").id, where(f.close < f.open, f.high, f.low).id);
+}
+
+TEST(FormulaParserTest, FunctionNamesAreCaseInsensitive) {
+    ExprGraph g;
+    AlphaFields f(g);
+    EXPECT_EQ(parse_formula(f, "Ts_ArgMax(close, 5)").id, ts_argmax(f.close, 5).id);
+    EXPECT_EQ(parse_formula(f, "TS_RANK(close, 5)").id, ts_rank(f.close, 5).id);
+    EXPECT_EQ(parse_formula(f, "SignedPower(close, 2)").id, signed_power(f.close, 2).id);
+    EXPECT_EQ(parse_formula(f, "Log(volume)").id, log(f.volume).id);
+}
+
+TEST(FormulaParserTest, MinMaxDispatchOnSecondArgument) {
+    ExprGraph g;
+    AlphaFields f(g);
+    EXPECT_EQ(parse_formula(f, "min(close, 5)").id, ts_min(f.close, 5).id);
+    EXPECT_EQ(parse_formula(f, "max(close, 2 + 3)").id, ts_max(f.close, 5).id);
+    EXPECT_EQ(parse_formula(f, "min(close, open)").id, min(f.close, f.open).id);
+    EXPECT_EQ(parse_formula(f, "max(open, close)").id, max(f.close, f.open).id);
+}
+
+TEST(FormulaParserTest, FieldsAdvAndFractionalWindows) {
+    ExprGraph g;
+    AlphaFields f(g);
+    EXPECT_EQ(parse_formula(f, "adv180").id, f.adv(180).id);
+    EXPECT_EQ(parse_formula(f, "correlation(vwap, adv20, 4.24304)").id, correlation(f.vwap, f.adv(20), 4).id);
+    EXPECT_EQ(parse_formula(f, "decay_linear(close, 16.4662)").id, decay_linear(f.close, 16).id);
+    EXPECT_EQ(parse_formula(f, "scale(close, 2)").id, scale(f.close, 2).id);
+
+    // 任意标识符都是输入字段，可在求值时提供
+    Expr custom = parse_formula(f, "rank(turnover)");
+    vector<NodeId> roots = {custom.id};
+    EXPECT_EQ(compile_plan(g, roots).fields, (vector<string>{"turnover"}));
+}
+
+// ========== 错误 ==========
+
+TEST(FormulaParserTest, SyntaxErrorsReportTheColumn) {
+    ExprGraph g;
+    AlphaFields f(g);
+    auto message = [&](const char* text) {
+        try {
+            parse_formula(f, text);
+        } catch (const std::invalid_argument& e) {
+            return string(e.what());
+        }
+        ADD_FAILURE() << "no error for " << text;
+        return string();
+    };
+    EXPECT_NE(message("rank(close").find("expected ')' at column 11"), string::npos);
+    EXPECT_NE(message("close $ open").find("unexpected character '$' at column 7"), string::npos);
+    EXPECT_NE(message("close open").find("unexpected 'open'"), string::npos);
+    EXPECT_NE(message("close +").find("unexpected end of formula"), string::npos);
+    EXPECT_NE(message("foo(close)").find("unknown function 'foo'"), string::npos);
+    EXPECT_NE(message("rank(close, 2)").find("rank expects 1 argument(s), got 2"), string::npos);
+    EXPECT_NE(message("delta(close, open)").find("delta expects a numeric parameter"), string::npos);
+    EXPECT_NE(message("delay(close, -1)").find("window must be non-negative"), string::npos);
+    EXPECT_NE(message("a < b ? c").find("expected ':'"), string::npos);
+    EXPECT_NE(message("adv99999999999999999999").find("adv window out of range: 'adv99999999999999999999' at column 1"), string::npos);
+}
+
+TEST(FormulaParserTest, IndClassIsTypedAsAGroup) {
+    ExprGraph g;
+    AlphaFields f(g);
+    EXPECT_THROW(parse_formula(f, "rank(IndClass.sector)"), std::invalid_argument);
+    EXPECT_THROW(parse_formula(f, "IndClass.industry + 1"), std::invalid_argument);
+    EXPECT_THROW(parse_formula(f, "IndNeutralize(close, open)"), std::invalid_argument);
+    // IndClass.name 读取同名分类字段
+    Expr e = parse_formula(f, "IndNeutralize(close, IndClass.subindustry)");
+    EXPECT_EQ(g.node(e.id).op, OpCode::IndNeutralize);
+    EXPECT_EQ(g.node(e.id).args[0], f.close.id);
+    EXPECT_EQ(g.node(e.id).args[1], f.subindustry.id);
+}
+
+// ========== 代价估计 ==========
+
+TEST(FormulaCostTest, CostFollowsTheKernelModel) {
+    FormulaBatch batch({"ts_rank(close, 10) + ts_rank(close, 40)", "rank(delta(close, 1))",
+                        "correlation(close, volume, 5) + correlation(close, volume, 60)"});
+    const ExprGraph& g = batch.graph();
+    auto costs = batch.costs(100, 250);
+    ASSERT_EQ(costs.size(), batch.plan().order.size());
+
+    auto cost_of = [&](OpCode op, int window) {
+        for (const NodeCost& c : costs)
+            if (g.node(c.id).op == op && g.node(c.id).window == window) return c;
+        ADD_FAILURE() << op_info(op).name << " " << window << " not in plan";
+        return NodeCost{};
+    };
+    EXPECT_DOUBLE_EQ(cost_of(OpCode::TsRank, 40).ops, 4.0 * cost_of(OpCode::TsRank, 10).ops);
+    // 滑动二阶矩每格 O(1)：代价与窗口长度无关
+    EXPECT_DOUBLE_EQ(cost_of(OpCode::Correlation, 60).ops, cost_of(OpCode::Correlation, 5).ops);
+    EXPECT_EQ(cost_of(OpCode::Field, 0).ops, 0.0);
+    EXPECT_EQ(cost_of(OpCode::Field, 0).bytes, 0u);
+    EXPECT_EQ(cost_of(OpCode::Delta, 1).bytes, 100u * 250u * sizeof(float));
+
+    string report = batch.explain(100, 250);
+    EXPECT_NE(report.find("ts_rank(#3, 40)"), string::npos);
+    EXPECT_NE(report.find("total"), string::npos);
+}
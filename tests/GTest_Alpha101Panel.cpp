@@ -0,0 +1,546 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdint>
+
+#include "Alpha101Panel.h"
+
+// ========== Panel 基础测试 ==========
+
+// 生成 value = s * 100 + t 的面板，便于核对索引
+static Panel<float> index_panel(size_t S, size_t T, PanelLayout layout) {
+    Panel<float> p(S, T, layout);
+    for (size_t s = 0; s < S; ++s)
+        for (size_t t = 0; t < T; ++t) p(s, t) = s * 100.0f + t;
+    return p;
+}
+
+// 逐元素比较两个面板（NaN 视为相等）
+static void expect_panel_near(const Panel<float>& a, const Panel<float>& b, float tol = 1e-5f) {
+    ASSERT_EQ(a.stocks(), b.stocks());
+    ASSERT_EQ(a.dates(), b.dates());
+    for (size_t s = 0; s < a.stocks(); ++s)
+        for (size_t t = 0; t < a.dates(); ++t) {
+            if (isnan(a(s, t)) || isnan(b(s, t))) {
+                EXPECT_EQ(isnan(a(s, t)), isnan(b(s, t))) << "s=" << s << " t=" << t;
+            } else {
+                EXPECT_NEAR(a(s, t), b(s, t), tol) << "s=" << s << " t=" << t;
+            }
+        }
+}
+
+TEST(PanelTest, DefaultInitIsNaN) {
+    Panel<float> p(3, 4);
+    EXPECT_EQ(p.stocks(), 3);
+    EXPECT_EQ(p.dates(), 4);
+    EXPECT_EQ(p.size(), 12);
+    for (size_t i = 0; i < p.size(); ++i) EXPECT_TRUE(isnan(p.data()[i]));
+}
+
+TEST(PanelTest, AlignedAllocation) {
+    Panel<float> p(7, 13);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(p.data()) % Panel<float>::kAlignment, 0u);
+}
+
+TEST(PanelTest, StockMajorRowsAreSeries) {
+    auto p = index_panel(3, 5, PanelLayout::StockMajor);
+    EXPECT_EQ(p.rows(), 3);
+    EXPECT_EQ(p.cols(), 5);
+    auto r = p.row(2);
+    ASSERT_EQ(r.size(), 5);
+    for (size_t t = 0; t < 5; ++t) EXPECT_FLOAT_EQ(r[t], 200.0f + t);
+    EXPECT_TRUE(p.series(1).contiguous());
+    EXPECT_FALSE(p.cross_section(1).contiguous());
+}
+
+TEST(PanelTest, TimeMajorRowsAreCrossSections) {
+    auto p = index_panel(3, 5, PanelLayout::TimeMajor);
+    EXPECT_EQ(p.rows(), 5);
+    EXPECT_EQ(p.cols(), 3);
+    auto r = p.row(4);
+    ASSERT_EQ(r.size(), 3);
+    for (size_t s = 0; s < 3; ++s) EXPECT_FLOAT_EQ(r[s], s * 100.0f + 4);
+    EXPECT_TRUE(p.cross_section(2).contiguous());
+    EXPECT_FALSE(p.series(2).contiguous());
+}
+
+TEST(PanelTest, StridedColumnView) {
+    auto p = index_panel(4, 6, PanelLayout::StockMajor);
+    auto c = p.col(3);  // 日期 3 的截面
+    ASSERT_EQ(c.size(), 4);
+    EXPECT_EQ(c.stride(), 6);
+    for (size_t s = 0; s < 4; ++s) EXPECT_FLOAT_EQ(c[s], s * 100.0f + 3);
+}
+
+TEST(PanelTest, SeriesAndCrossSectionAgreeAcrossLayouts) {
+    auto a = index_panel(4, 6, PanelLayout::StockMajor);
+    auto b = index_panel(4, 6, PanelLayout::TimeMajor);
+    for (size_t s = 0; s < 4; ++s)
+        for (size_t t = 0; t < 6; ++t) {
+            EXPECT_FLOAT_EQ(a.series(s)[t], b.series(s)[t]);
+            EXPECT_FLOAT_EQ(a.cross_section(t)[s], b.cross_section(t)[s]);
+        }
+}
+
+TEST(PanelTest, NestedRoundTrip) {
+    vector<vector<float>> mat = {{1, 2, 3}, {4, 5, 6}};
+    auto p = Panel<float>::from_nested(mat, PanelLayout::TimeMajor);
+    EXPECT_EQ(p.stocks(), 2);
+    EXPECT_EQ(p.dates(), 3);
+    EXPECT_FLOAT_EQ(p(1, 2), 6.0f);
+    EXPECT_EQ(p.to_nested(), mat);
+}
+
+TEST(PanelTest, CopyIsDeepMoveIsShallow) {
+    auto a = index_panel(2, 3, PanelLayout::StockMajor);
+    Panel<float> b = a;
+    b(0, 0) = -1.0f;
+    EXPECT_FLOAT_EQ(a(0, 0), 0.0f);
+    EXPECT_NE(a.data(), b.data());
+
+    const float* ptr = a.data();
+    Panel<float> c = std::move(a);
+    EXPECT_EQ(c.data(), ptr);
+    EXPECT_TRUE(a.empty());
+}
+
+TEST(PanelTest, ViewIsZeroCopy) {
+    vector<float> buf = {1, 2, 3, 4, 5, 6};
+    auto v = Panel<float>::view(buf.data(), 2, 3, PanelLayout::StockMajor);
+    EXPECT_EQ(v.data(), buf.data());
+    EXPECT_FALSE(v.owns_memory());
+    v(1, 0) = 40.0f;
+    EXPECT_FLOAT_EQ(buf[3], 40.0f);
+    EXPECT_THROW(v.reset(3, 3, PanelLayout::StockMajor), std::logic_error);
+}
+
+TEST(PanelTest, ResetReusesMemoryForSameSize) {
+    Panel<float> p(4, 6);
+    const float* ptr = p.data();
+    p.reset(6, 4, PanelLayout::TimeMajor);
+    EXPECT_EQ(p.data(), ptr);
+    EXPECT_EQ(p.stocks(), 6);
+    EXPECT_EQ(p.layout(), PanelLayout::TimeMajor);
+}
+
+// ========== 算子 Panel 重载测试 ==========
+// Panel 重载必须与逐股票调用 vector 版的结果一致，且与布局无关。
+// S = 37 覆盖 AVX-512（16）/AVX2（8）整组 lane 与标量尾部
+
+class PanelOpsTest : public ::testing::TestWithParam<PanelLayout> {
+   protected:
+    static constexpr size_t S = 37, T = 40;
+
+    static vector<vector<float>> random_mat(uint32_t seed) {
+        vector<vector<float>> mat(S, vector<float>(T));
+        uint32_t x = seed;
+        for (auto& row : mat)
+            for (auto& v : row) {
+                x = x * 1664525u + 1013904223u;
+                v = 1.0f + (x >> 8) % 1000 / 10.0f;
+            }
+        return mat;
+    }
+
+    // 对嵌套矩阵逐股票应用 vector 版算子，作为参考结果
+    template <typename Fn>
+    static Panel<float> reference(const vector<vector<float>>& mat, Fn&& fn) {
+        vector<vector<float>> out;
+        for (const auto& row : mat) out.push_back(fn(row));
+        return Panel<float>::from_nested(out);
+    }
+};
+
+TEST_P(PanelOpsTest, TimeSeriesOpsMatchVectorVersions) {
+    auto mat = random_mat(7);
+    auto p = Panel<float>::from_nested(mat, GetParam());
+
+    expect_panel_near(rolling_ts_sum(p, 5), reference(mat, [](auto& v) { return rolling_ts_sum(v, 5); }), 1e-3f);
+    expect_panel_near(rolling_sma(p, 5), reference(mat, [](auto& v) { return rolling_sma(v, 5); }), 1e-4f);
+    expect_panel_near(rolling_stddev(p, 10), reference(mat, [](auto& v) { return rolling_stddev(v, 10); }), 0.0f);
+    expect_panel_near(ts_rank(p, 6), reference(mat, [](auto& v) { return ts_rank(v, 6); }));
+    expect_panel_near(product(p, 3), reference(mat, [](auto& v) { return product(v, 3); }), 1e-1f);
+    expect_panel_near(ts_min(p, 7), reference(mat, [](auto& v) { return ts_min(v, 7); }));
+    expect_panel_near(ts_max(p, 7), reference(mat, [](auto& v) { return ts_max(v, 7); }));
+    expect_panel_near(delta(p, 3), reference(mat, [](auto& v) { return delta(v, 3); }));
+    expect_panel_near(delay(p, 3), reference(mat, [](auto& v) { return delay(v, 3); }));
+    expect_panel_near(ts_argmax(p, 5), reference(mat, [](auto& v) { return ts_argmax(v, 5); }));
+    expect_panel_near(ts_argmin(p, 5), reference(mat, [](auto& v) { return ts_argmin(v, 5); }));
+    expect_panel_near(decay_linear(p, 8), reference(mat, [](auto& v) { return decay_linear(v, 8); }), 1e-3f);
+}
+
+TEST_P(PanelOpsTest, BinaryOpsMatchVectorVersions) {
+    auto ma = random_mat(11), mb = random_mat(13);
+    auto pa = Panel<float>::from_nested(ma, GetParam());
+    auto pb = Panel<float>::from_nested(mb, GetParam());
+
+    vector<vector<float>> corr, cov;
+    for (size_t s = 0; s < S; ++s) {
+        corr.push_back(rolling_correlation(ma[s], mb[s], 10));
+        cov.push_back(rolling_covariance(ma[s], mb[s], 10));
+    }
+    expect_panel_near(rolling_correlation(pa, pb, 10), Panel<float>::from_nested(corr), 0.0f);
+    expect_panel_near(rolling_covariance(pa, pb, 10), Panel<float>::from_nested(cov), 0.0f);
+}
+
+TEST_P(PanelOpsTest, CrossSectionalOpsMatchVectorVersions) {
+    auto mat = random_mat(17);
+    auto p = Panel<float>::from_nested(mat, GetParam());
+    auto ranked = alpha_rank(p);
+    auto scaled = scale(p, 2.0f);
+
+    for (size_t t = 0; t < T; ++t) {
+        vector<float> xs(S);
+        for (size_t s = 0; s < S; ++s) xs[s] = mat[s][t];
+        auto r = alpha_rank(xs);
+        auto k = scale(xs, 2.0f);
+        for (size_t s = 0; s < S; ++s) {
+            EXPECT_FLOAT_EQ(ranked(s, t), r[s]) << "s=" << s << " t=" << t;
+            EXPECT_NEAR(scaled(s, t), k[s], 1e-6f) << "s=" << s << " t=" << t;
+        }
+    }
+}
+
+// 截取自更长序列、以截取起点为 origin 求值：重新锚定的日期与完整求值相同，截取点之后第一个锚点窗口起逐位一致
+TEST_P(PanelOpsTest, AnchoredOpsOnASliceMatchFullHistory) {
+    auto pa = Panel<float>::from_nested(random_mat(31), GetParam());
+    auto pb = Panel<float>::from_nested(random_mat(32), GetParam());
+    int w = 6;
+    size_t d0 = 7, first = (d0 + w - 1) / w * w + w - 1;  // 第一个锚点窗口 [12, 18) 的末尾
+    auto sa = slice_dates(pa, d0, T, GetParam()), sb = slice_dates(pb, d0, T, GetParam());
+    auto expect_tail_equal = [&](const Panel<float>& full, const Panel<float>& part) {
+        ASSERT_EQ(part.dates(), T - d0);
+        for (size_t s = 0; s < S; ++s)
+            for (size_t t = first; t < T; ++t) EXPECT_EQ(part(s, t - d0), full(s, t)) << "s=" << s << " t=" << t;
+    };
+    expect_tail_equal(rolling_ts_sum(pa, w), rolling_ts_sum(sa, w, d0));
+    expect_tail_equal(rolling_sma(pa, w), rolling_sma(sa, w, d0));
+    expect_tail_equal(rolling_stddev(pa, w), rolling_stddev(sa, w, d0));
+    expect_tail_equal(decay_linear(pa, w), decay_linear(sa, w, d0));
+    expect_tail_equal(rolling_correlation(pa, pb, w), rolling_correlation(sa, sb, w, d0));
+    expect_tail_equal(rolling_covariance(pa, pb, w), rolling_covariance(sa, sb, w, d0));
+}
+
+TEST_P(PanelOpsTest, OutputKeepsInputLayout) {
+    auto p = Panel<float>::from_nested(random_mat(3), GetParam());
+    EXPECT_EQ(delta(p, 1).layout(), GetParam());
+    EXPECT_EQ(alpha_rank(p).layout(), GetParam());
+}
+
+TEST_P(PanelOpsTest, GroupOpsMatchSpanVersionsPerDate) {
+    auto mat = random_mat(11);
+    auto p = Panel<float>::from_nested(mat, GetParam());
+    size_t S = p.stocks(), T = p.dates();
+    Panel<int32_t> codes(S, T, GetParam());
+    for (size_t s = 0; s < S; ++s)
+        for (size_t t = 0; t < T; ++t) codes(s, t) = (int32_t)((s + (t >= T / 2 ? 1 : 0)) % 3);
+    GroupPartition gp(codes);
+    EXPECT_EQ(gp.segments(), 2u);
+
+    auto demeaned = group_demean(p, gp), ranked = group_rank(p, gp), scaled = group_scale(p, gp, 3.0f);
+    EXPECT_EQ(demeaned.layout(), GetParam());
+    vector<float> x(S), y(S);
+    for (size_t t = 0; t < T; ++t) {
+        for (size_t s = 0; s < S; ++s) x[s] = p(s, t);
+        group_demean(x, gp.at(t), y);
+        for (size_t s = 0; s < S; ++s) EXPECT_EQ(demeaned(s, t), y[s]) << "s=" << s << " t=" << t;
+        group_rank(x, gp.at(t), y);
+        for (size_t s = 0; s < S; ++s) EXPECT_EQ(ranked(s, t), y[s]) << "s=" << s << " t=" << t;
+        group_scale(x, gp.at(t), 3.0f, y);
+        for (size_t s = 0; s < S; ++s) EXPECT_EQ(scaled(s, t), y[s]) << "s=" << s << " t=" << t;
+    }
+}
+
+TEST_P(PanelOpsTest, DerivedVwapAndReturns) {
+    auto high = Panel<float>::from_nested(random_mat(21), GetParam());
+    auto low = Panel<float>::from_nested(random_mat(22), GetParam());
+    auto close = Panel<float>::from_nested(random_mat(23), GetParam());
+    auto volume = Panel<float>::from_nested(random_mat(24), GetParam());
+    auto amount = Panel<float>::from_nested(random_mat(25), GetParam());
+    volume(3, 7) = 0.0f;
+
+    Panel<float> vwap, returns, vwap_amount, returns_only;
+    derive_vwap_returns(high, low, close, volume, nullptr, vwap, returns);
+    derive_vwap_returns(high, low, close, volume, &amount, vwap_amount, returns_only);
+    EXPECT_EQ(vwap.layout(), GetParam());
+    EXPECT_EQ(returns.layout(), GetParam());
+    for (size_t s = 0; s < S; ++s)
+        for (size_t t = 0; t < T; ++t) {
+            EXPECT_EQ(vwap(s, t), (high(s, t) + low(s, t) + close(s, t)) / 3.0f);
+            if (s == 3 && t == 7) EXPECT_TRUE(isnan(vwap_amount(s, t)));
+            else EXPECT_EQ(vwap_amount(s, t), amount(s, t) / volume(s, t));
+            if (t == 0) EXPECT_TRUE(isnan(returns(s, t)));
+            else EXPECT_EQ(returns(s, t), close(s, t) / close(s, t - 1) - 1.0f) << "s=" << s << " t=" << t;
+        }
+
+    derive_returns(close, returns_only);
+    expect_panel_near(returns_only, returns, 0.0f);
+
+    Panel<float> other_layout = Panel<float>::from_nested(random_mat(21), GetParam() == PanelLayout::TimeMajor
+                                                                               ? PanelLayout::StockMajor
+                                                                               : PanelLayout::TimeMajor);
+    EXPECT_THROW(derive_vwap_returns(other_layout, low, close, volume, nullptr, vwap, returns), std::invalid_argument);
+}
+
+INSTANTIATE_TEST_SUITE_P(Layouts, PanelOpsTest, ::testing::Values(PanelLayout::StockMajor, PanelLayout::TimeMajor),
+                         [](const auto& info) {
+                             return info.param == PanelLayout::StockMajor ? string("StockMajor") : string("TimeMajor");
+                         });
+
+// ========== SIMD 内核测试（TimeMajor） ==========
+
+// 含 NaN 的输入：TimeMajor（SIMD 内核）与 StockMajor（逐股票 span 算子）的 NaN 位置必须一致
+TEST(SimdKernelTest, NaNHandlingMatchesScalarPath) {
+    size_t S = 19, T = 30;
+    Panel<float> sm(S, T, PanelLayout::StockMajor);
+    for (size_t s = 0; s < S; ++s)
+        for (size_t t = 0; t < T; ++t) sm(s, t) = ((s * 7 + t * 13) % 17 == 0) ? NAN : 1.0f + (s * 31 + t * 17) % 23;
+    Panel<float> tm = Panel<float>::from_nested(sm.to_nested(), PanelLayout::TimeMajor);
+
+    expect_panel_near(ts_min(tm, 4), ts_min(sm, 4));
+    expect_panel_near(ts_max(tm, 4), ts_max(sm, 4));
+    expect_panel_near(ts_argmax(tm, 5), ts_argmax(sm, 5));
+    expect_panel_near(ts_argmin(tm, 5), ts_argmin(sm, 5));
+    expect_panel_near(ts_rank(tm, 6), ts_rank(sm, 6));
+    expect_panel_near(rolling_ts_sum(tm, 3), rolling_ts_sum(sm, 3), 0.0f);  // 同一 double 运算顺序，逐位一致
+    expect_panel_near(rolling_sma(tm, 7), rolling_sma(sm, 7), 0.0f);
+    expect_panel_near(decay_linear(tm, 4), decay_linear(sm, 4), 0.0f);
+    expect_panel_near(rolling_stddev(tm, 5), rolling_stddev(sm, 5), 0.0f);
+    expect_panel_near(rolling_correlation(tm, tm, 5), rolling_correlation(sm, sm, 5), 0.0f);
+}
+
+// 价格量级（~100）的随机游走：float 和式在此会丢失有效位，TimeMajor 与 StockMajor 必须逐位一致
+TEST(SimdKernelTest, StddevMatchesScalarPathOnPriceLevels) {
+    size_t S = 64, T = 400;
+    Panel<float> sm(S, T, PanelLayout::StockMajor);
+    uint32_t state = 12345;
+    for (size_t s = 0; s < S; ++s) {
+        float price = 100.0f + s;
+        for (size_t t = 0; t < T; ++t) {
+            state = state * 1664525u + 1013904223u;
+            price *= 1.0f + ((state >> 8) / 16777216.0f - 0.5f) * 0.04f;
+            sm(s, t) = (t % 97 == s % 97) ? NAN : price;
+        }
+    }
+    Panel<float> tm = Panel<float>::from_nested(sm.to_nested(), PanelLayout::TimeMajor);
+    for (int window : {2, 5, 10, 20}) expect_panel_near(rolling_stddev(tm, window), rolling_stddev(sm, window), 0.0f);
+}
+
+// 相关系数 / 协方差：价格量级输入、整段为常数的股票（零方差 → NaN）与含 NaN 的窗口，两种布局逐位一致
+TEST(SimdKernelTest, ComomentMatchesScalarPathWithFlatAndNaNWindows) {
+    size_t S = 37, T = 120;
+    Panel<float> sa(S, T, PanelLayout::StockMajor), sb(S, T, PanelLayout::StockMajor);
+    uint32_t state = 777;
+    for (size_t s = 0; s < S; ++s) {
+        float pa = 50.0f + s, pb = 120.0f - s;
+        for (size_t t = 0; t < T; ++t) {
+            state = state * 1664525u + 1013904223u;
+            pa *= 1.0f + ((state >> 8) / 16777216.0f - 0.5f) * 0.04f;
+            pb = pb * 0.9f + pa * 0.1f;
+            sa(s, t) = (t % 23 == s % 23) ? NAN : pa;
+            // 每 5 只股票一只 b 全程不变；另有一段 b 在若干窗口内保持常数
+            sb(s, t) = s % 5 == 0 ? 42.0f : (t >= 40 && t < 60 ? 7.5f : pb);
+        }
+    }
+    Panel<float> ta = Panel<float>::from_nested(sa.to_nested(), PanelLayout::TimeMajor);
+    Panel<float> tb = Panel<float>::from_nested(sb.to_nested(), PanelLayout::TimeMajor);
+    for (int window : {1, 2, 5, 10}) {
+        auto corr_tm = rolling_correlation(ta, tb, window), corr_sm = rolling_correlation(sa, sb, window);
+        expect_panel_near(corr_tm, corr_sm, 0.0f);
+        expect_panel_near(rolling_covariance(ta, tb, window), rolling_covariance(sa, sb, window), 0.0f);
+        for (size_t t = 0; t < T; ++t) EXPECT_TRUE(isnan(corr_tm(0, t))) << "t=" << t;
+    }
+}
+
+TEST(SimdKernelTest, TiesPickEarliestPosition) {
+    // 所有股票窗口内全部相等：argmax/argmin 均取最旧位置 1
+    Panel<float> tm(20, 8, PanelLayout::TimeMajor, 3.0f);
+    auto amax = ts_argmax(tm, 4);
+    auto amin = ts_argmin(tm, 4);
+    for (size_t s = 0; s < 20; ++s)
+        for (size_t t = 3; t < 8; ++t) {
+            EXPECT_FLOAT_EQ(amax(s, t), 1.0f);
+            EXPECT_FLOAT_EQ(amin(s, t), 1.0f);
+        }
+}
+
+TEST(SimdKernelTest, WindowLongerThanSeriesIsAllNaN) {
+    Panel<float> tm(17, 3, PanelLayout::TimeMajor, 1.0f);
+    auto out = rolling_stddev(tm, 5);
+    for (size_t i = 0; i < out.size(); ++i) EXPECT_TRUE(isnan(out.data()[i]));
+}
+
+TEST(SimdKernelTest, StddevNaNMatchesScalarKernel) {
+    Panel<float> tm(19, 12, PanelLayout::TimeMajor, 0.0f);
+    for (size_t s = 0; s < 19; ++s)
+        for (size_t t = 0; t < 12; ++t) tm(s, t) = (t == s % 4) ? NAN : float(s + t * t);
+    auto out = rolling_stddev(tm, 4);
+    for (size_t s = 0; s < 19; ++s) {
+        vector<float> row(12), expected(12);
+        for (size_t t = 0; t < 12; ++t) row[t] = tm(s, t);
+        rolling_stddev(row, 4, expected);
+        for (size_t t = 0; t < 12; ++t) {
+            if (isnan(expected[t])) {
+                EXPECT_TRUE(isnan(out(s, t))) << "s=" << s << " t=" << t;
+            } else {
+                EXPECT_FLOAT_EQ(out(s, t), expected[t]) << "s=" << s << " t=" << t;
+            }
+        }
+    }
+}
+
+// ========== 分块转置测试 ==========
+
+TEST(TransposeTest, MatchesElementwiseCopyForOddShapes) {
+    // 覆盖 8×8 寄存器块、块内尾部与跨 kTransposeTile 的边界
+    for (auto [rows, cols] : {pair<size_t, size_t>{1, 1}, {7, 9}, {8, 8}, {16, 250}, {33, 65}, {100, 3}}) {
+        vector<float> src(rows * cols);
+        for (size_t i = 0; i < src.size(); ++i) src[i] = (i % 11 == 0) ? NAN : float(i);
+        vector<float> dst(cols * rows, -1.0f);
+        transpose(src.data(), rows, cols, cols, dst.data(), rows);
+        for (size_t r = 0; r < rows; ++r)
+            for (size_t c = 0; c < cols; ++c) {
+                float expected = src[r * cols + c], got = dst[c * rows + r];
+                if (isnan(expected)) EXPECT_TRUE(isnan(got)) << rows << "x" << cols << " r=" << r << " c=" << c;
+                else EXPECT_EQ(got, expected) << rows << "x" << cols << " r=" << r << " c=" << c;
+            }
+    }
+}
+
+TEST(TransposeTest, StridedSubBlockLeavesNeighboursUntouched) {
+    // 把 [5 × 20] 的子块写入 [20 × 12] 矩阵的第 3..7 列，其余元素保持不变
+    size_t rows = 5, cols = 20, dst_stride = 12, c_off = 3;
+    vector<float> src(rows * cols);
+    for (size_t i = 0; i < src.size(); ++i) src[i] = float(i);
+    vector<float> dst(cols * dst_stride, -1.0f);
+    transpose(src.data(), rows, cols, cols, dst.data() + c_off, dst_stride);
+    for (size_t c = 0; c < cols; ++c)
+        for (size_t j = 0; j < dst_stride; ++j) {
+            float got = dst[c * dst_stride + j];
+            if (j >= c_off && j < c_off + rows) EXPECT_EQ(got, src[(j - c_off) * cols + c]);
+            else EXPECT_EQ(got, -1.0f);
+        }
+}
+
+// ========== 分组分类与分组截面算子测试 ==========
+
+TEST(GroupPartitionTest, SharesIndexAcrossUnchangedDates) {
+    // 股票 2 在 t = 4 从组 30 换到组 10；编码 -1 与 NaN 为未分类
+    Panel<float> codes(4, 8, PanelLayout::StockMajor);
+    for (size_t t = 0; t < 8; ++t) {
+        codes(0, t) = 10;
+        codes(1, t) = 30;
+        codes(2, t) = t < 4 ? 30 : 10;
+        codes(3, t) = t == 6 ? NAN : -1;
+    }
+    GroupPartition gp(codes);
+    EXPECT_EQ(gp.groups(), 2u);
+    EXPECT_EQ(gp.segments(), 2u);
+    EXPECT_EQ(&gp.at(0), &gp.at(3));
+    EXPECT_EQ(&gp.at(4), &gp.at(7));
+    EXPECT_EQ(gp.at(0).members.size(), 3u);
+    EXPECT_EQ(gp.at(7).group(0).size() + gp.at(7).group(1).size(), 3u);
+}
+
+TEST(GroupPartitionTest, ShapeMismatchThrows) {
+    GroupPartition gp(Panel<int32_t>(3, 5, PanelLayout::StockMajor, 0));
+    Panel<float> in(3, 6, PanelLayout::StockMajor, 1.0f);
+    EXPECT_THROW(group_demean(in, gp), std::invalid_argument);
+}
+
+// ========== span 重载测试 ==========
+
+TEST(SpanOverloadTest, WritesIntoCallerBuffer) {
+    vector<float> input = {1, 2, 3, 4, 5};
+    vector<float> out(5, -1.0f);
+    rolling_ts_sum(span<const float>(input), 3, span<float>(out));
+    EXPECT_TRUE(isnan(out[0]));
+    EXPECT_TRUE(isnan(out[1]));
+    EXPECT_FLOAT_EQ(out[2], 6);
+    EXPECT_FLOAT_EQ(out[4], 12);
+}
+
+TEST(SpanOverloadTest, TsMinMaxPropagateNaN) {
+    vector<float> input = {3, 1, NAN, 4, 5, 2};
+    vector<float> mn(6), mx(6);
+    ts_min(span<const float>(input), 3, span<float>(mn));
+    ts_max(span<const float>(input), 3, span<float>(mx));
+    EXPECT_TRUE(isnan(mn[2]));
+    EXPECT_TRUE(isnan(mn[4]));
+    EXPECT_FLOAT_EQ(mn[5], 2);
+    EXPECT_FLOAT_EQ(mx[5], 5);
+}
+
+// ========== PanelArena ==========
+
+TEST(PanelArenaTest, BumpAllocatesAlignedAndRewinds) {
+    PanelArena arena(ArenaPages::Normal, 1 << 20);  // 块长按 2 MB 取整
+    EXPECT_EQ(arena.capacity(), 0u);
+    char* a = static_cast<char*>(arena.allocate(10));
+    char* b = static_cast<char*>(arena.allocate(100));
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(a) % kArenaHugePage, 0u);  // 块起点按大页对齐
+    EXPECT_EQ(b, a + 64);                                             // 碰撞分配，64 字节对齐
+    EXPECT_EQ(arena.capacity(), kArenaHugePage);
+    EXPECT_EQ(arena.pages(), ArenaPages::Normal);
+
+    auto m = arena.mark();
+    char* c = static_cast<char*>(arena.allocate(3 << 20));  // 放不下：申请新块
+    EXPECT_EQ(arena.capacity(), kArenaHugePage + (size_t(4) << 20));
+    arena.rewind(m);
+    EXPECT_EQ(arena.allocate(64), b + 128);
+    arena.reset();
+    EXPECT_EQ(arena.allocate(64), a);
+    EXPECT_EQ(arena.allocate(3 << 20), c);  // 回卷后复用已有的块，不再申请
+    EXPECT_EQ(arena.capacity(), kArenaHugePage + (size_t(4) << 20));
+    EXPECT_GE(arena.high_water(), kArenaHugePage + (size_t(3) << 20));
+}
+
+TEST(PanelArenaTest, LivePanelsBlockRewindAndOutliveTheArena) {
+    Panel<float> kept;
+    {
+        PanelArena arena;
+        auto m = arena.mark();
+        {
+            auto p = Panel<float>::in_arena(arena, 100, 30, PanelLayout::TimeMajor);
+            EXPECT_FALSE(p.owns_memory());
+            EXPECT_EQ(arena.live(), 1u);
+            EXPECT_THROW(arena.rewind(m), std::logic_error);
+            {
+                ArenaFrame frame(&arena);  // 帧内无分配：正常回卷
+            }
+            p.reset(30, 100, PanelLayout::StockMajor);  // 元素个数不变：复用
+            EXPECT_THROW(p.reset(10, 10, PanelLayout::StockMajor), std::logic_error);
+        }
+        EXPECT_EQ(arena.live(), 0u);
+        arena.rewind(m);
+
+        kept = Panel<float>::in_arena(arena, 7, 9, PanelLayout::TimeMajor);
+        for (size_t i = 0; i < kept.size(); ++i) kept.data()[i] = (float)i;
+    }
+    // arena 已析构，面板仍持有内存块
+    EXPECT_EQ(kept(6, 8), 8.0f * 7 + 6);
+}
+
+TEST(PanelArenaTest, RewindIsBlockedByLivePanelsPastTheMarkOnly) {
+    PanelArena arena(ArenaPages::Normal);
+    auto p1 = Panel<float>::in_arena(arena, 16, 16, PanelLayout::TimeMajor);
+    auto m = arena.mark();
+    auto p2 = Panel<float>::in_arena(arena, 16, 16, PanelLayout::TimeMajor);
+    p1 = Panel<float>();  // mark 之前的面板析构：存活个数与 mark 时相同，但 p2 仍在回卷点之后
+    EXPECT_EQ(arena.live(), 1u);
+    EXPECT_FALSE(arena.try_rewind(m));
+    {
+        ArenaFrame frame(&arena);
+    }
+    auto p3 = Panel<float>::in_arena(arena, 16, 16, PanelLayout::TimeMajor);
+    EXPECT_NE(p3.data(), p2.data());
+    EXPECT_GT(p3.data(), p2.data());
+
+    p2 = Panel<float>();
+    EXPECT_FALSE(arena.try_rewind(m));  // p3 仍存活
+    p3 = Panel<float>();
+    EXPECT_TRUE(arena.try_rewind(m));
+    arena.reset();
+}
+
+// main-Funktion wird von GTest::gtest_main bereitgestellt, kein manuelles Schreiben nötig
@@ -0,0 +1,408 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <random>
+
+#if defined(__unix__)
+#include <csignal>
+#include <sys/resource.h>
+#endif
+
+#include "Alpha101Store.h"
+
+// ========== 测试辅助 ==========
+
+// 每个测试使用自己的临时文件，析构时删除
+struct TempFile {
+    string path;
+    explicit TempFile(const string& name)
+        : path((std::filesystem::temp_directory_path() / ("alpha101_" + name + "_" + to_string(::getpid()))).string()) {}
+    ~TempFile() { std::remove(path.c_str()); }
+};
+
+static Panel<float> value_panel(size_t S, size_t T, PanelLayout layout, float base) {
+    Panel<float> p(S, T, layout);
+    for (size_t s = 0; s < S; ++s)
+        for (size_t t = 0; t < T; ++t) p(s, t) = base + s * 1000.0f + t;
+    return p;
+}
+
+// ========== 列式面板文件 ==========
+
+class PanelFileTest : public ::testing::TestWithParam<PanelLayout> {};
+
+TEST_P(PanelFileTest, RoundTripsEveryColumnAsZeroCopyView) {
+    size_t S = 37, T = 53;
+    auto open = value_panel(S, T, PanelLayout::StockMajor, 0.5f);  // 写出时转换布局
+    auto close = value_panel(S, T, PanelLayout::TimeMajor, 0.25f);
+    close(3, 7) = NAN;
+    Panel<int32_t> industry(S, T, PanelLayout::StockMajor);
+    for (size_t s = 0; s < S; ++s)
+        for (size_t t = 0; t < T; ++t) industry(s, t) = (int32_t)(s % 4) - 1;
+
+    TempFile tmp("roundtrip");
+    write_panel_file(tmp.path, {{"open", open}, {"close", close}, {"industry", industry}}, GetParam());
+
+    PanelFile file(tmp.path);
+    EXPECT_EQ(file.stocks(), S);
+    EXPECT_EQ(file.dates(), T);
+    EXPECT_EQ(file.layout(), GetParam());
+    EXPECT_EQ(file.fields(), (vector<string>{"open", "close", "industry"}));
+
+    auto o = file.panel("open"), c = file.panel("close");
+    auto ind = file.panel<int32_t>("industry");
+    EXPECT_FALSE(o.owns_memory());  // 映射内存上的视图
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(o.data()) % kPanelFilePage, 0u);
+    EXPECT_EQ(o.layout(), GetParam());
+    for (size_t s = 0; s < S; ++s)
+        for (size_t t = 0; t < T; ++t) {
+            EXPECT_EQ(o(s, t), open(s, t));
+            if (s == 3 && t == 7) EXPECT_TRUE(isnan(c(s, t)));
+            else EXPECT_EQ(c(s, t), close(s, t));
+            EXPECT_EQ(ind(s, t), industry(s, t));
+        }
+}
+
+TEST_P(PanelFileTest, DateRangeMatchesSlice) {
+    size_t S = 11, T = 40;
+    auto close = value_panel(S, T, GetParam(), 1.0f);
+    TempFile tmp("range");
+    write_panel_file(tmp.path, {{"close", close}}, GetParam());
+    PanelFile file(tmp.path);
+
+    auto recent = file.panel("close", 25, 40);
+    ASSERT_EQ(recent.dates(), 15u);
+    // TimeMajor 文件的日期区间是连续内存，仍为视图；StockMajor 文件复制出新面板
+    EXPECT_EQ(recent.owns_memory(), GetParam() == PanelLayout::StockMajor);
+    for (size_t s = 0; s < S; ++s)
+        for (size_t t = 0; t < 15; ++t) EXPECT_EQ(recent(s, t), close(s, 25 + t));
+    EXPECT_THROW(file.panel("close", 30, 20), std::invalid_argument);
+}
+
+INSTANTIATE_TEST_SUITE_P(Layouts, PanelFileTest, ::testing::Values(PanelLayout::StockMajor, PanelLayout::TimeMajor),
+                         [](const auto& info) {
+                             return info.param == PanelLayout::StockMajor ? string("StockMajor") : string("TimeMajor");
+                         });
+
+TEST(PanelFileTest, ViewsOutliveTheFileObject) {
+    auto close = value_panel(4, 9, PanelLayout::TimeMajor, 2.0f);
+    TempFile tmp("keepalive");
+    write_panel_file(tmp.path, {{"close", close}});
+    Panel<float> view;
+    {
+        PanelFile file(tmp.path);
+        view = file.panel("close");
+    }
+    EXPECT_EQ(view(3, 8), close(3, 8));
+    view(0, 0) = -1.0f;  // 私有映射：写入不影响文件
+    EXPECT_EQ(PanelFile(tmp.path).panel("close")(0, 0), close(0, 0));
+}
+
+TEST(PanelFileTest, RejectsBadInputs) {
+    auto a = value_panel(4, 9, PanelLayout::TimeMajor, 0.0f);
+    auto b = value_panel(4, 8, PanelLayout::TimeMajor, 0.0f);
+    TempFile tmp("bad");
+    EXPECT_THROW(write_panel_file(tmp.path, {{"a", a}, {"b", b}}), std::invalid_argument);
+    EXPECT_THROW(write_panel_file(tmp.path, {{"a", a}, {"a", a}}), std::invalid_argument);
+    EXPECT_THROW(write_panel_file(tmp.path, {{string(48, 'x'), a}}), std::invalid_argument);
+
+    write_panel_file(tmp.path, {{"a", a}});
+    PanelFile file(tmp.path);
+    EXPECT_THROW(file.panel("missing"), std::invalid_argument);
+    EXPECT_THROW(file.panel<int32_t>("a"), std::invalid_argument);
+
+    // 截断的文件与错误的魔数
+    std::filesystem::resize_file(tmp.path, kPanelFilePage + 10);
+    EXPECT_THROW(PanelFile{tmp.path}, std::invalid_argument);
+    {
+        std::ofstream out(tmp.path, std::ios::binary | std::ios::trunc);
+        out << string(200, 'z');
+    }
+    EXPECT_THROW(PanelFile{tmp.path}, std::invalid_argument);
+    EXPECT_THROW(PanelFile{tmp.path + ".none"}, std::runtime_error);
+}
+
+// ========== 因子库 ==========
+
+TEST(FactorStoreTest, RunLengthCodingRoundTripsRunBoundaries) {
+    // 覆盖：恰好 3 / 130 / 131 长的游程、128 与 129 字节的字面段、空输入
+    vector<uint8_t> in;
+    in.insert(in.end(), 3, 7);
+    in.insert(in.end(), 130, 0);
+    in.insert(in.end(), 131, 255);
+    for (int i = 0; i < 129; ++i) in.push_back((uint8_t)(i * 37));
+    in.push_back(1);
+    in.push_back(1);
+    in.push_back(2);
+    for (size_t len : {(size_t)0, (size_t)1, (size_t)4, in.size()}) {
+        vector<uint8_t> packed, back(len);
+        rle_encode(in.data(), len, packed);
+        ASSERT_TRUE(rle_decode(packed.data(), packed.size(), back.data(), len));
+        EXPECT_TRUE(std::equal(back.begin(), back.end(), in.begin())) << "len=" << len;
+        EXPECT_FALSE(len > 0 && rle_decode(packed.data(), packed.size() - 1, back.data(), len));
+    }
+}
+
+class FactorStoreTest : public ::testing::TestWithParam<PanelLayout> {};
+
+TEST_P(FactorStoreTest, RangeReadsMatchTheWrittenPanels) {
+    size_t S = 23, T = 150;  // 块长 32：5 个块，最后一块 22 个日期
+    auto a1 = value_panel(S, T, GetParam(), -0.5f);
+    for (size_t s = 0; s < S; ++s)
+        for (size_t t = 0; t < 19; ++t) a1(s, t) = NAN;  // 预热期
+    Panel<int32_t> signal(S, T, GetParam());
+    for (size_t s = 0; s < S; ++s)
+        for (size_t t = 0; t < T; ++t) signal(s, t) = (s * 7 + t) % 17 ? 0 : (int32_t)(s % 2) * 2 - 1;  // 稀疏多空信号
+
+    TempFile tmp("factors");
+    write_factor_store(tmp.path, {{"alpha001", a1}, {"signal", signal}}, 32);
+    FactorStore store(tmp.path);
+    EXPECT_EQ(store.stocks(), S);
+    EXPECT_EQ(store.dates(), T);
+    EXPECT_EQ(store.block_dates(), 32u);
+    EXPECT_EQ(store.alphas(), (vector<string>{"alpha001", "signal"}));
+    EXPECT_LT(store.compression_ratio("signal"), 0.5);
+
+    auto same = [&](const Panel<float>& got, size_t d0) {
+        for (size_t s = 0; s < S; ++s)
+            for (size_t t = 0; t < got.dates(); ++t) {
+                float want = a1(s, d0 + t);
+                if (isnan(want)) EXPECT_TRUE(isnan(got(s, t)));
+                else EXPECT_EQ(got(s, t), want);
+            }
+    };
+    same(store.read("alpha001"), 0);
+    for (auto [d0, d1] : vector<pair<size_t, size_t>>{{0, 32}, {5, 6}, {31, 97}, {64, 150}, {149, 150}, {40, 40}}) {
+        auto part = store.read("alpha001", d0, d1, GetParam());
+        ASSERT_EQ(part.dates(), d1 - d0);
+        EXPECT_EQ(part.layout(), GetParam());
+        same(part, d0);
+    }
+    auto sig = store.read<int32_t>("signal", 100, 150);
+    for (size_t s = 0; s < S; ++s)
+        for (size_t t = 0; t < 50; ++t) EXPECT_EQ(sig(s, t), signal(s, 100 + t));
+}
+
+INSTANTIATE_TEST_SUITE_P(Layouts, FactorStoreTest, ::testing::Values(PanelLayout::StockMajor, PanelLayout::TimeMajor),
+                         [](const auto& info) {
+                             return info.param == PanelLayout::StockMajor ? string("StockMajor") : string("TimeMajor");
+                         });
+
+TEST(FactorStoreTest, RejectsBadInputsAndCorruptBlocks) {
+    auto a = value_panel(4, 9, PanelLayout::TimeMajor, 0.0f);
+    TempFile tmp("factors_bad");
+    EXPECT_THROW(write_factor_store(tmp.path, {{"a", a}}, 0), std::invalid_argument);
+    EXPECT_THROW(write_factor_store(tmp.path, {{"a", a}, {"a", a}}), std::invalid_argument);
+
+    write_factor_store(tmp.path, {{"a", a}}, 4);
+    FactorStore store(tmp.path);
+    EXPECT_THROW(store.read("missing"), std::invalid_argument);
+    EXPECT_THROW(store.read<int32_t>("a"), std::invalid_argument);
+    EXPECT_THROW(store.read("a", 5, 3), std::invalid_argument);
+
+    // 常数面板压缩为游程块；破坏其首个控制字节后解码必须报错而不是越界
+    Panel<float> flat(4, 200, PanelLayout::TimeMajor, 0.25f);
+    write_factor_store(tmp.path, {{"flat", flat}});
+    EXPECT_LT(FactorStore(tmp.path).compression_ratio("flat"), 0.05);
+    {
+        std::fstream f(tmp.path, std::ios::binary | std::ios::in | std::ios::out);
+        f.seekp(sizeof(FactorFileHeader));
+        f.put((char)0x7f);
+    }
+    EXPECT_THROW(FactorStore(tmp.path).read("flat"), std::invalid_argument);
+
+    std::filesystem::resize_file(tmp.path, 100);
+    EXPECT_THROW(FactorStore{tmp.path}, std::invalid_argument);
+    EXPECT_THROW(FactorStore{tmp.path + ".none"}, std::runtime_error);
+}
+
+// ========== 追加与增量扩展 ==========
+
+static vector<char> file_bytes(const string& path) {
+    std::ifstream in(path, std::ios::binary);
+    return vector<char>(std::istreambuf_iterator<char>(in), {});
+}
+
+TEST(FactorStoreAppendTest, AppendedStoreReadsLikeWritingAtOnce) {
+    size_t S = 13, T = 110;
+    auto a1 = value_panel(S, T, PanelLayout::StockMajor, 0.5f);
+    Panel<int32_t> sig(S, T, PanelLayout::TimeMajor, 0);
+    sig(4, 90) = 1;
+    TempFile whole("append_whole"), grown("append_grown");
+    write_factor_store(whole.path, {{"a1", a1}, {"sig", sig}}, 32);
+
+    // 70 个日期起步（最后一块不完整），再分三次追加：跨块边界、恰好补满到 96、以及 0 个日期
+    write_factor_store(grown.path,
+                       {{"a1", slice_dates(a1, 0, 70, PanelLayout::TimeMajor)}, {"sig", slice_dates(sig, 0, 70, PanelLayout::TimeMajor)}}, 32);
+    FactorStore store(grown.path);
+    for (auto [d0, d1] : vector<pair<size_t, size_t>>{{70, 96}, {96, 96}, {96, 110}}) {
+        auto part_a1 = slice_dates(a1, d0, d1, PanelLayout::StockMajor);
+        auto part_sig = slice_dates(sig, d0, d1, PanelLayout::TimeMajor);
+        vector<char> before = file_bytes(grown.path);
+        store.append({{"sig", part_sig}, {"a1", part_a1}});  // 顺序任意
+        EXPECT_EQ(store.dates(), d1);
+        // 只在文件尾追加：文件头之后的已有字节原样保留
+        vector<char> after = file_bytes(grown.path);
+        ASSERT_GE(after.size(), before.size());
+        EXPECT_TRUE(std::equal(before.begin() + sizeof(FactorFileHeader), before.end(),
+                               after.begin() + sizeof(FactorFileHeader)));
+    }
+    EXPECT_EQ(store.read("a1", 60, 110)(7, 40), a1(7, 100));
+    FactorStore ref(whole.path);
+    auto x = ref.read("a1"), y = store.read("a1");
+    auto xs = ref.read<int32_t>("sig"), ys = store.read<int32_t>("sig");
+    for (size_t s = 0; s < S; ++s)
+        for (size_t t = 0; t < T; ++t) {
+            ASSERT_EQ(bit_cast<uint32_t>(y(s, t)), bit_cast<uint32_t>(x(s, t))) << "s=" << s << " t=" << t;
+            ASSERT_EQ(ys(s, t), xs(s, t)) << "s=" << s << " t=" << t;
+        }
+}
+
+// 追加前打开的读者（另一个对象或进程的映射）在追加后仍读到追加前的完整内容
+TEST(FactorStoreAppendTest, ReadersOpenedBeforeAppendKeepTheirSnapshot) {
+    size_t S = 11, T0 = 45;
+    auto a = value_panel(S, 80, PanelLayout::TimeMajor, 0.5f);
+    TempFile tmp("append_reader");
+    write_factor_store(tmp.path, {{"a", slice_dates(a, 0, T0, PanelLayout::TimeMajor)}}, 32);
+    FactorStore reader(tmp.path), writer(tmp.path);
+    writer.append({{"a", slice_dates(a, T0, 80, PanelLayout::TimeMajor)}});
+    EXPECT_EQ(reader.dates(), T0);
+    auto old = reader.read("a");
+    for (size_t s = 0; s < S; ++s)
+        for (size_t t = 0; t < T0; ++t) ASSERT_EQ(old(s, t), a(s, t)) << "s=" << s << " t=" << t;
+    EXPECT_EQ(FactorStore(tmp.path).read("a", 70, 80)(3, 5), a(3, 75));
+}
+
+TEST(FactorStoreAppendTest, RejectsMismatchedColumns) {
+    auto a = value_panel(4, 9, PanelLayout::TimeMajor, 0.0f);
+    TempFile tmp("append_bad");
+    write_factor_store(tmp.path, {{"a", a}, {"b", a}});
+    FactorStore store(tmp.path);
+    auto wide = value_panel(5, 2, PanelLayout::TimeMajor, 0.0f);
+    Panel<int32_t> codes(4, 2, PanelLayout::TimeMajor, 0);
+    auto day = value_panel(4, 2, PanelLayout::TimeMajor, 0.0f);
+    EXPECT_THROW(store.append({{"a", day}}), std::invalid_argument);
+    EXPECT_THROW(store.append({{"a", day}, {"c", day}}), std::invalid_argument);
+    EXPECT_THROW(store.append({{"a", wide}, {"b", wide}}), std::invalid_argument);
+    EXPECT_THROW(store.append({{"a", day}, {"b", codes}}), std::invalid_argument);
+    EXPECT_EQ(FactorStore(tmp.path).dates(), 9u);
+}
+
+static void expect_same_store(const string& path, const Panel<float>& a) {
+    FactorStore store(path);
+    ASSERT_EQ(store.dates(), a.dates());
+    auto got = store.read("a");
+    for (size_t s = 0; s < a.stocks(); ++s)
+        for (size_t t = 0; t < a.dates(); ++t) ASSERT_EQ(got(s, t), a(s, t)) << "s=" << s << " t=" << t;
+}
+
+#if defined(__unix__)
+TEST(FactorStoreAppendTest, FailedAppendRestoresTheOldContents) {
+    auto a = value_panel(40, 100, PanelLayout::TimeMajor, 0.5f);
+    TempFile tmp("append_fail");
+    write_factor_store(tmp.path, {{"a", a}}, 32);
+    uintmax_t size = std::filesystem::file_size(tmp.path);
+    FactorStore store(tmp.path);
+
+    // 文件长度上限略高于现有文件：追加的块写到一半时写满（EFBIG，相当于磁盘已满）
+    rlimit saved{};
+    ASSERT_EQ(getrlimit(RLIMIT_FSIZE, &saved), 0);
+    rlimit limited = saved;
+    limited.rlim_cur = size + 256;
+    auto old_handler = std::signal(SIGXFSZ, SIG_IGN);
+    ASSERT_EQ(setrlimit(RLIMIT_FSIZE, &limited), 0);
+    auto more = value_panel(40, 200, PanelLayout::TimeMajor, 7.0f);
+    EXPECT_THROW(store.append({{"a", more}}), std::runtime_error);
+    setrlimit(RLIMIT_FSIZE, &saved);
+    std::signal(SIGXFSZ, old_handler);
+
+    EXPECT_EQ(std::filesystem::file_size(tmp.path), size);
+    EXPECT_EQ(store.dates(), 100u);
+    EXPECT_EQ(store.read("a", 90, 100)(3, 5), a(3, 95));
+    expect_same_store(tmp.path, a);
+
+    store.append({{"a", more}});  // 空间恢复后照常追加
+    EXPECT_EQ(store.dates(), 300u);
+    EXPECT_EQ(store.read("a", 250, 300)(3, 5), more(3, 155));
+}
+#endif
+
+TEST(FactorStoreAppendTest, InterruptedAppendLeavesTheOldStoreReadable) {
+    auto a = value_panel(40, 100, PanelLayout::TimeMajor, 0.5f);
+    TempFile tmp("append_crash");
+    write_factor_store(tmp.path, {{"a", a}}, 32);
+
+    // 模拟追加写到一半时崩溃：文件尾多出半个块与半份索引，文件头尚未改写
+    {
+        std::fstream f(tmp.path, std::ios::binary | std::ios::in | std::ios::out);
+        f.seekp(0, std::ios::end);
+        f << string(1000, 'x');
+    }
+    expect_same_store(tmp.path, a);
+
+    // 下次追加写在残留字节之后，照常生效
+    auto more = value_panel(40, 50, PanelLayout::TimeMajor, 7.0f);
+    FactorStore(tmp.path).append({{"a", more}});
+    FactorStore store(tmp.path);
+    EXPECT_EQ(store.dates(), 150u);
+    EXPECT_EQ(store.read("a", 90, 150)(3, 5), a(3, 95));
+    EXPECT_EQ(store.read("a", 140, 150)(3, 5), more(3, 45));
+}
+
+TEST(FactorStoreAppendTest, ExtendMatchesFullEvaluation) {
+    size_t S = 8, T = 140, T0 = 100;
+    std::mt19937 gen(7);
+    std::normal_distribution<float> ret(0.0f, 0.02f);
+    std::uniform_real_distribution<float> u(0.0f, 1.0f);
+    Panel<float> close(S, T, PanelLayout::TimeMajor), open(S, T, PanelLayout::TimeMajor), high(S, T, PanelLayout::TimeMajor),
+        low(S, T, PanelLayout::TimeMajor), volume(S, T, PanelLayout::TimeMajor), returns;
+    for (size_t s = 0; s < S; ++s) {
+        float p = 20.0f + s;
+        for (size_t t = 0; t < T; ++t) {
+            p *= 1.0f + ret(gen);
+            close(s, t) = p;
+            open(s, t) = p * (1.0f + 0.3f * ret(gen));
+            high(s, t) = std::max(p, open(s, t)) * (1.0f + 0.01f * u(gen));
+            low(s, t) = std::min(p, open(s, t)) * (1.0f - 0.01f * u(gen));
+            volume(s, t) = 1e5f * (1.0f + u(gen));
+        }
+    }
+    derive_returns(close, returns);
+    FieldMap fields = {{"close", &close}, {"open", &open},     {"high", &high},
+                       {"low", &low},     {"volume", &volume}, {"returns", &returns}};
+    AlphaBatch batch(vector<int>{1, 4, 12, 23, 101});
+    auto full = batch.evaluate(fields);
+
+    // 因子库先有前 T0 个日期，再用完整输入扩展
+    vector<Panel<float>> head;
+    for (const auto& p : full) head.push_back(slice_dates(p, 0, T0, PanelLayout::TimeMajor));
+    TempFile tmp("extend");
+    write_factor_store(tmp.path, alpha_columns(batch, head), 32);
+    EXPECT_EQ(extend_factor_store(tmp.path, fields, batch), T - T0);
+    EXPECT_EQ(extend_factor_store(tmp.path, fields, batch), 0u);
+
+    FactorStore store(tmp.path);
+    ASSERT_EQ(store.dates(), T);
+    EXPECT_EQ(store.alphas(), (vector<string>{"alpha001", "alpha004", "alpha012", "alpha023", "alpha101"}));
+    for (size_t i = 0; i < full.size(); ++i) {
+        auto got = store.read(alpha_column_name(batch.ids()[i]));
+        for (size_t s = 0; s < S; ++s)
+            for (size_t t = 0; t < T; ++t) {
+                float x = full[i](s, t), y = got(s, t);
+                ASSERT_EQ(isnan(x), isnan(y)) << store.alphas()[i] << " s=" << s << " t=" << t;
+                if (!isnan(x)) {
+                    EXPECT_EQ(y, x) << store.alphas()[i] << " s=" << s << " t=" << t;
+                }
+            }
+    }
+
+    auto short_close = slice_dates(close, 0, T - 1, PanelLayout::TimeMajor);
+    FieldMap shorter = fields;
+    shorter["close"] = &short_close;
+    EXPECT_THROW(extend_factor_store(tmp.path, shorter, batch), std::invalid_argument);
+}
+
+// main-Funktion wird von GTest::gtest_main bereitgestellt, kein manuelles Schreiben nötig
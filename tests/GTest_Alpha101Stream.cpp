@@ -0,0 +1,197 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <random>
+
+#include "Alpha101.h"
+#include "Alpha101Stream.h"
+
+// ========== 测试数据 ==========
+
+// 随机游走序列，每隔 gap 个点插入一个 NaN（gap = 0 时不插入）
+static vector<float> random_series(size_t n, unsigned seed, size_t gap = 0) {
+    std::mt19937 gen(seed);
+    std::normal_distribution<float> step(0.0f, 1.0f);
+    vector<float> x(n);
+    float v = 100.0f;
+    for (size_t i = 0; i < n; ++i) {
+        v += step(gen);
+        x[i] = (gap && i % gap == gap - 1) ? NAN : v;
+    }
+    return x;
+}
+
+template <typename Stream>
+static vector<float> run_stream(Stream stream, const vector<float>& x) {
+    vector<float> out(x.size());
+    for (size_t i = 0; i < x.size(); ++i) out[i] = stream.push(x[i]);
+    return out;
+}
+
+static void expect_identical(const vector<float>& a, const vector<float>& b, const char* what) {
+    ASSERT_EQ(a.size(), b.size());
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (isnan(a[i]) || isnan(b[i])) {
+            EXPECT_EQ(isnan(a[i]), isnan(b[i])) << what << " i=" << i;
+        } else {
+            EXPECT_EQ(a[i], b[i]) << what << " i=" << i;
+        }
+    }
+}
+
+// ========== 环形缓冲区 ==========
+
+TEST(RingBufferTest, KeepsTheMostRecentValuesOldestFirst) {
+    RingBuffer buf(3);
+    buf.push(1);
+    buf.push(2);
+    EXPECT_FALSE(buf.full());
+    buf.push(3);
+    buf.push(4);
+    EXPECT_TRUE(buf.full());
+    EXPECT_EQ(buf.front(), 2);
+    EXPECT_EQ(buf[1], 3);
+    EXPECT_EQ(buf.back(), 4);
+    buf.clear();
+    EXPECT_EQ(buf.size(), 0u);
+}
+
+// ========== 流式算子 vs 批量算子 ==========
+
+TEST(StreamOperatorTest, BitIdenticalToBatchOperators) {
+    for (size_t gap : {0u, 37u}) {
+        vector<float> x = random_series(400, 3, gap), y = random_series(400, 4, gap ? gap + 5 : 0);
+        for (int w : {1, 2, 5, 20}) {
+            vector<float> expected(x.size());
+            delay(span<const float>(x), w, span<float>(expected));
+            expect_identical(run_stream(DelayStream(w), x), expected, "delay");
+            delta(span<const float>(x), w, span<float>(expected));
+            expect_identical(run_stream(DeltaStream(w), x), expected, "delta");
+            rolling_stddev(span<const float>(x), w, span<float>(expected));
+            expect_identical(run_stream(StddevStream(w), x), expected, "stddev");
+            ts_min(span<const float>(x), w, span<float>(expected));
+            expect_identical(run_stream(TsMinStream(w), x), expected, "ts_min");
+            ts_max(span<const float>(x), w, span<float>(expected));
+            expect_identical(run_stream(TsMaxStream(w), x), expected, "ts_max");
+            ts_argmax(span<const float>(x), w, span<float>(expected));
+            expect_identical(run_stream(TsArgmaxStream(w), x), expected, "ts_argmax");
+            ts_argmin(span<const float>(x), w, span<float>(expected));
+            expect_identical(run_stream(TsArgminStream(w), x), expected, "ts_argmin");
+            ts_rank(span<const float>(x), w, span<float>(expected));
+            expect_identical(run_stream(TsRankStream(w), x), expected, "ts_rank");
+            decay_linear(span<const float>(x), w, span<float>(expected));
+            expect_identical(run_stream(DecayLinearStream(w), x), expected, "decay_linear");
+
+            vector<float> corr(x.size()), cov(x.size());
+            rolling_correlation(span<const float>(x), span<const float>(y), w, span<float>(expected));
+            CorrelationStream cs(w);
+            CovarianceStream vs(w);
+            for (size_t i = 0; i < x.size(); ++i) {
+                corr[i] = cs.push(x[i], y[i]);
+                cov[i] = vs.push(x[i], y[i]);
+            }
+            expect_identical(corr, expected, "correlation");
+            rolling_covariance(span<const float>(x), span<const float>(y), w, span<float>(expected));
+            expect_identical(cov, expected, "covariance");
+        }
+    }
+}
+
+TEST(StreamOperatorTest, SlidingSumsBitIdenticalToBatchOperators) {
+    vector<float> x = random_series(1000, 5, 53);
+    for (int w : {1, 3, 10, 60}) {
+        vector<float> sum(x.size()), mean(x.size());
+        rolling_ts_sum(span<const float>(x), w, span<float>(sum));
+        rolling_sma(span<const float>(x), w, span<float>(mean));
+        expect_identical(run_stream(TsSumStream(w), x), sum, "ts_sum");
+        expect_identical(run_stream(TsMeanStream(w), x), mean, "ts_mean");
+    }
+}
+
+// ts_rank 的有序窗口：大量并列值、±0 与 NaN 都按批量版本计数
+TEST(StreamOperatorTest, TsRankHandlesTiesAndNaN) {
+    vector<float> x(300);
+    for (size_t i = 0; i < x.size(); ++i) x[i] = i % 17 == 5 ? NAN : (float)((i * 7) % 5) - 2.0f;
+    x[40] = -0.0f;
+    for (int w : {1, 4, 9, 30}) {
+        vector<float> expected(x.size());
+        ts_rank(span<const float>(x), w, span<float>(expected));
+        expect_identical(run_stream(TsRankStream(w), x), expected, "ts_rank");
+    }
+}
+
+// product 以 double 累乘、乘入新值除去旧值：与 float 连乘差在舍入量级，0 / inf / NaN / 符号与批量版本相同
+TEST(StreamOperatorTest, ProductMatchesBatchWithinRounding) {
+    std::mt19937 gen(11);
+    std::uniform_real_distribution<float> u(0.5f, 1.5f);
+    vector<float> x(500);
+    for (size_t i = 0; i < x.size(); ++i) x[i] = (i % 3 == 0 ? -1.0f : 1.0f) * u(gen);
+    x[50] = 0.0f;
+    x[120] = -0.0f;
+    x[200] = INFINITY;
+    x[230] = NAN;
+    x[300] = -INFINITY;
+    x[303] = 0.0f;  // 与 -inf 同窗时为 NaN
+    for (int w : {1, 2, 5, 20}) {
+        vector<float> expected(x.size());
+        product(span<const float>(x), w, span<float>(expected));
+        vector<float> got = run_stream(ProductStream(w), x);
+        for (size_t i = 0; i < x.size(); ++i) {
+            float e = expected[i], g = got[i];
+            ASSERT_EQ(isnan(e), isnan(g)) << "w=" << w << " i=" << i;
+            if (isnan(e)) continue;
+            if (e == 0.0f || isinf(e)) {
+                EXPECT_EQ(bit_cast<uint32_t>(g), bit_cast<uint32_t>(e)) << "w=" << w << " i=" << i;
+            } else {
+                EXPECT_NEAR(g, e, 1e-5f * std::abs(e)) << "w=" << w << " i=" << i;
+            }
+        }
+    }
+}
+
+TEST(StreamOperatorTest, ResetRestartsWarmUp) {
+    StddevStream sd(3);
+    TsArgmaxStream am(2);
+    for (float v : {1.0f, 2.0f, 4.0f}) {
+        sd.push(v);
+        am.push(v);
+    }
+    sd.reset();
+    am.reset();
+    EXPECT_TRUE(isnan(sd.push(1.0f)));
+    EXPECT_TRUE(isnan(am.push(5.0f)));
+    EXPECT_EQ(am.push(3.0f), 1.0f);
+}
+
+// ========== Alpha001Stream ==========
+
+TEST(Alpha001StreamTest, MatchesBatchAlpha001BarByBar) {
+    const size_t S = 37, T = 160;
+    vector<vector<float>> close(S), returns(S, vector<float>(T));
+    for (size_t s = 0; s < S; ++s) {
+        close[s] = random_series(T, 100 + s);
+        returns[s][0] = NAN;
+        for (size_t t = 1; t < T; ++t) returns[s][t] = close[s][t] / close[s][t - 1] - 1.0f;
+    }
+    close[5][70] = NAN;  // 单点缺失只影响包含它的窗口
+    returns[9][90] = NAN;
+    auto expected = alpha001(close, returns);
+
+    Alpha001Stream stream(S);
+    vector<float> c(S), r(S), out(S);
+    for (size_t t = 0; t < T; ++t) {
+        for (size_t s = 0; s < S; ++s) {
+            c[s] = close[s][t];
+            r[s] = returns[s][t];
+        }
+        stream.push(c, r, out);
+        for (size_t s = 0; s < S; ++s) {
+            if (isnan(expected[s][t])) {
+                EXPECT_TRUE(isnan(out[s])) << "s=" << s << " t=" << t;
+            } else {
+                EXPECT_EQ(out[s], expected[s][t]) << "s=" << s << " t=" << t;
+            }
+        }
+    }
+    EXPECT_EQ(stream.bars(), T);
+}
@@ -0,0 +1,113 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+#include "Alpha101ThreadPool.h"
+
+// ========== 线程池 ==========
+
+TEST(ThreadPoolTest, RunInvokesEveryParticipantOnce) {
+    ThreadPool pool(4);
+    ASSERT_EQ(pool.size(), 4u);
+    vector<int> hits(pool.size(), 0);
+    for (int rep = 0; rep < 100; ++rep) pool.run([&](size_t w) { ++hits[w]; });
+    for (int h : hits) EXPECT_EQ(h, 100);
+}
+
+TEST(ThreadPoolTest, ParallelForCoversRangeWithContiguousBlocks) {
+    ThreadPool pool(3);
+    for (size_t n : {0u, 1u, 2u, 3u, 10u, 1001u}) {
+        vector<int> hits(n, 0);
+        vector<size_t> owner(n);
+        pool.parallel_for(n, [&](size_t begin, size_t end, size_t w) {
+            for (size_t i = begin; i < end; ++i) {
+                ++hits[i];
+                owner[i] = w;
+            }
+        });
+        for (size_t i = 0; i < n; ++i) EXPECT_EQ(hits[i], 1) << "n=" << n << " i=" << i;
+        for (size_t i = 1; i < n; ++i) EXPECT_LE(owner[i - 1], owner[i]) << "n=" << n << " i=" << i;
+    }
+}
+
+TEST(ThreadPoolTest, SingleThreadRunsInline) {
+    ThreadPool pool(1);
+    EXPECT_EQ(pool.size(), 1u);
+    thread::id caller = this_thread::get_id(), seen;
+    pool.run([&](size_t) { seen = this_thread::get_id(); });
+    EXPECT_EQ(seen, caller);
+}
+
+TEST(ThreadPoolTest, RethrowsWorkerExceptionAndStaysUsable) {
+    ThreadPool pool(4);
+    EXPECT_THROW(pool.run([](size_t w) {
+        if (w == 2) throw invalid_argument("worker 2 failed");
+    }),
+                 invalid_argument);
+    atomic<size_t> count{0};
+    pool.run([&](size_t) { ++count; });
+    EXPECT_EQ(count.load(), 4u);
+}
+
+// ========== NUMA 拓扑与线程绑定 ==========
+
+TEST(NumaTest, ParsesCpuLists) {
+    EXPECT_EQ(parse_cpu_list("0-3,8,10-11\n"), (vector<int>{0, 1, 2, 3, 8, 10, 11}));
+    EXPECT_EQ(parse_cpu_list("5, 2-3,3"), (vector<int>{2, 3, 5}));
+    EXPECT_TRUE(parse_cpu_list("").empty());
+    EXPECT_THROW(parse_cpu_list("4-2"), invalid_argument);
+    EXPECT_THROW(parse_cpu_list("a-b"), invalid_argument);
+}
+
+TEST(NumaTest, ReadsNodesFromSysfsAndFallsBackToOneNode) {
+    auto root = filesystem::temp_directory_path() / "alpha101_numa_test";
+    filesystem::remove_all(root);
+    auto write = [&](const string& node, const string& cpulist) {
+        filesystem::create_directories(root / node);
+        ofstream(root / node / "cpulist") << cpulist << "\n";
+    };
+    write("node1", "4-7");
+    write("node0", "0-3");
+    write("node2", "");  // 纯内存节点
+    ofstream(root / "possible") << "0-2\n";
+    auto nodes = numa_nodes(root.string());
+    ASSERT_EQ(nodes.size(), 2u);
+    EXPECT_EQ(nodes[0].id, 0);
+    EXPECT_EQ(nodes[1].cpus, (vector<int>{4, 5, 6, 7}));
+
+    auto affinity = numa_affinity(nodes, 2);
+    ASSERT_EQ(affinity.size(), 4u);
+    EXPECT_EQ(affinity[1], nodes[0].cpus);
+    EXPECT_EQ(affinity[2], nodes[1].cpus);
+    EXPECT_EQ(numa_affinity(nodes).size(), 8u);
+    filesystem::remove_all(root);
+
+    auto fallback = numa_nodes(root.string());
+    ASSERT_EQ(fallback.size(), 1u);
+    EXPECT_FALSE(fallback[0].cpus.empty());
+}
+
+#ifdef ALPHA101_HAVE_AFFINITY
+TEST(NumaTest, PinnedPoolRunsOnItsCpusAndRestoresTheCaller) {
+    cpu_set_t before;
+    ASSERT_EQ(pthread_getaffinity_np(pthread_self(), sizeof(before), &before), 0);
+    int cpu = -1;
+    for (int c = 0; c < CPU_SETSIZE && cpu < 0; ++c)
+        if (CPU_ISSET(c, &before)) cpu = c;
+    ASSERT_GE(cpu, 0);
+
+    ThreadPool pool(vector<vector<int>>(3, vector<int>{cpu}));
+    ASSERT_EQ(pool.size(), 3u);
+    vector<int> seen(pool.size(), -1);
+    pool.run([&](size_t w) { seen[w] = sched_getcpu(); });
+    for (int c : seen) EXPECT_EQ(c, cpu);
+
+    cpu_set_t after;
+    ASSERT_EQ(pthread_getaffinity_np(pthread_self(), sizeof(after), &after), 0);
+    EXPECT_TRUE(CPU_EQUAL(&before, &after));
+    EXPECT_FALSE(pin_this_thread({}));
+}
+#endif
@@ -3,6 +3,7 @@
 #include <cmath>
 
 #include "Alpha101Utils.h"
+#include "HeapAllocationCounter.h"
 
 // Hilfsfunktion: Zwei Vektoren auf Gleichheit prüfen (NaN berücksichtigt)
 bool vectors_equal(const vector<float>& a, const vector<float>& b, float tolerance = 1e-5) {
@@ -810,6 +811,64 @@ TEST(RollingSmaTest, WindowTwo) {
     EXPECT_FLOAT_EQ(result[4], 45);
 }
 
+TEST(RollingTsSumTest, NaNOnlyAffectsWindowsContainingIt) {
+    vector<float> input = {1, 2, NAN, 4, 5, 6, 7};
+    vector<float> sum = rolling_ts_sum(input, 2), mean = rolling_sma(input, 2);
+
+    EXPECT_FLOAT_EQ(sum[1], 3);
+    EXPECT_TRUE(isnan(sum[2]));
+    EXPECT_TRUE(isnan(sum[3]));
+    EXPECT_FLOAT_EQ(sum[4], 9);
+    EXPECT_FLOAT_EQ(sum[6], 13);
+    EXPECT_TRUE(isnan(mean[3]));
+    EXPECT_FLOAT_EQ(mean[4], 4.5);
+}
+
+TEST(RollingTsSumTest, SlidingSumDoesNotDrift) {
+    // 成交量量级的长序列：逐窗口 double 重算作为参照
+    vector<float> input(20000);
+    for (size_t i = 0; i < input.size(); ++i) input[i] = 1e7f + 3e6f * std::sin(0.1f * i);
+    int w = 20;
+    vector<float> result = rolling_ts_sum(input, w);
+    for (size_t i = w - 1; i < input.size(); i += 97) {
+        double expected = 0;
+        for (size_t j = i + 1 - w; j <= i; ++j) expected += input[j];
+        EXPECT_NEAR(result[i], expected, expected * 1e-7) << "i=" << i;
+    }
+}
+
+// ========== Prefix Sum Tests ==========
+
+TEST(PrefixSumTest, EveryWindowMatchesSlidingVersion) {
+    vector<float> input(600);
+    for (size_t i = 0; i < input.size(); ++i) input[i] = (i % 71 == 70) ? NAN : 50.0f + 20.0f * std::cos(0.3f * i);
+    PrefixSum prefix(input);
+    ASSERT_EQ(prefix.size(), input.size());
+
+    for (int w : {1, 5, 20, 60, 180, 250}) {
+        vector<float> sum(input.size()), mean(input.size()), ref_sum(input.size()), ref_mean(input.size());
+        prefix.rolling_sum(w, span<float>(sum));
+        prefix.rolling_mean(w, span<float>(mean));
+        rolling_ts_sum(span<const float>(input), w, span<float>(ref_sum));
+        rolling_sma(span<const float>(input), w, span<float>(ref_mean));
+        for (size_t i = 0; i < input.size(); ++i) {
+            ASSERT_EQ(isnan(sum[i]), isnan(ref_sum[i])) << "w=" << w << " i=" << i;
+            ASSERT_EQ(isnan(mean[i]), isnan(ref_mean[i])) << "w=" << w << " i=" << i;
+            if (isnan(sum[i])) continue;
+            EXPECT_NEAR(sum[i], ref_sum[i], std::abs(ref_sum[i]) * 1e-6f) << "w=" << w << " i=" << i;
+            EXPECT_NEAR(mean[i], ref_mean[i], std::abs(ref_mean[i]) * 1e-6f) << "w=" << w << " i=" << i;
+        }
+    }
+}
+
+TEST(PrefixSumTest, WindowLongerThanSeriesIsAllNaN) {
+    vector<float> input = {1, 2, 3};
+    PrefixSum prefix(input);
+    vector<float> out(3);
+    prefix.rolling_sum(5, span<float>(out));
+    for (float v : out) EXPECT_TRUE(isnan(v));
+}
+
 // ========== Rolling Stddev Tests ==========
 
 TEST(RollingStddevTest, BasicTest) {
@@ -824,6 +883,17 @@ TEST(RollingStddevTest, BasicTest) {
     EXPECT_NEAR(result[4], 1.0, 1e-5);
 }
 
+TEST(RollingStddevTest, NaNOnlyPoisonsWindowsContainingIt) {
+    vector<float> input = {NAN, 1, 2, 3, 4, 5};
+    vector<float> result = rolling_stddev(input, 3);
+
+    ASSERT_EQ(result.size(), 6);
+    EXPECT_TRUE(isnan(result[2]));
+    EXPECT_NEAR(result[3], 1.0, 1e-5);
+    EXPECT_NEAR(result[4], 1.0, 1e-5);
+    EXPECT_NEAR(result[5], 1.0, 1e-5);
+}
+
 // ========== Rolling Correlation Tests ==========
 
 TEST(RollingCorrelationTest, PositiveCorrelation) {
@@ -911,6 +981,91 @@ TEST(RollingCovarianceTest, NegativeCovariance) {
     EXPECT_NEAR(result[4], -2.0, 1e-5);
 }
 
+// ========== Sliding Co-Moment (rolling_correlation / rolling_covariance) Tests ==========
+
+// 两遍参考实现（double）：逐窗口先求均值再求离差积
+static void two_pass_reference(const vector<float>& a, const vector<float>& b, int w, vector<double>& corr,
+                               vector<double>& cov) {
+    size_t n = a.size();
+    corr.assign(n, NAN);
+    cov.assign(n, NAN);
+    for (size_t i = w - 1; i < n; ++i) {
+        double ma = 0, mb = 0;
+        for (size_t j = i + 1 - w; j <= i; ++j) {
+            ma += a[j];
+            mb += b[j];
+        }
+        ma /= w;
+        mb /= w;
+        double spd = 0, ssa = 0, ssb = 0;
+        for (size_t j = i + 1 - w; j <= i; ++j) {
+            spd += (a[j] - ma) * (b[j] - mb);
+            ssa += (a[j] - ma) * (a[j] - ma);
+            ssb += (b[j] - mb) * (b[j] - mb);
+        }
+        corr[i] = spd / sqrt(ssa * ssb);
+        cov[i] = spd / (w - 1);
+    }
+}
+
+TEST(SlidingComomentTest, LongSeriesWithLargeMeanStaysAccurate) {
+    // 价格量级 ~1e4、小幅波动、20000 步：检验平移 + 重锚定后无累积漂移
+    size_t n = 20000;
+    vector<float> a(n), b(n);
+    uint32_t x = 2024;
+    for (size_t i = 0; i < n; ++i) {
+        x = x * 1664525u + 1013904223u;
+        a[i] = 10000.0f + (x >> 16) % 1000 / 100.0f;
+        b[i] = 0.5f * a[i] + (x >> 8) % 100 / 50.0f;
+    }
+    for (int w : {5, 20, 250}) {
+        vector<double> corr_ref, cov_ref;
+        two_pass_reference(a, b, w, corr_ref, cov_ref);
+        auto corr = rolling_correlation(a, b, w);
+        auto cov = rolling_covariance(a, b, w);
+        for (size_t i = w - 1; i < n; ++i) {
+            ASSERT_NEAR(corr[i], corr_ref[i], 1e-4) << "w=" << w << " i=" << i;
+            ASSERT_NEAR(cov[i], cov_ref[i], 1e-3 * fabs(cov_ref[i]) + 1e-4) << "w=" << w << " i=" << i;
+        }
+    }
+}
+
+TEST(SlidingComomentTest, NaNInWindowGivesNaN) {
+    vector<float> a = {1, 2, 3, NAN, 5, 6, 7, 8};
+    vector<float> b = {2, 1, 4, 3, 6, 5, 8, 7};
+    auto corr = rolling_correlation(a, b, 3);
+    auto cov = rolling_covariance(b, a, 3);
+    for (size_t i = 3; i <= 5; ++i) {
+        EXPECT_TRUE(isnan(corr[i])) << i;
+        EXPECT_TRUE(isnan(cov[i])) << i;
+    }
+    EXPECT_FALSE(isnan(corr[6]));
+    EXPECT_FALSE(isnan(cov[7]));
+}
+
+TEST(SlidingComomentTest, ConstantWindowCorrelationIsNaN) {
+    // 与两遍算法的 0/0 一致：任一侧窗口方差为零时相关系数为 NaN，协方差为 0
+    vector<float> a = {1, 4, 2, 7, 7, 7, 7, 3};
+    vector<float> b = {3, 1, 4, 1, 5, 9, 2, 6};
+    auto corr = rolling_correlation(a, b, 3);
+    auto cov = rolling_covariance(a, b, 3);
+    EXPECT_TRUE(isnan(corr[5]));
+    EXPECT_TRUE(isnan(corr[6]));
+    EXPECT_NEAR(cov[5], 0.0f, 1e-6f);
+    EXPECT_FALSE(isnan(corr[7]));
+}
+
+TEST(SlidingComomentTest, SpanOverloadWritesCallerBuffer) {
+    vector<float> x = {1, 2, 3, 4, 5};
+    vector<float> y = {2, 4, 6, 8, 10};
+    vector<float> out(5, 0.0f);
+    rolling_correlation(span<const float>(x), span<const float>(y), 3, span<float>(out));
+    EXPECT_TRUE(isnan(out[1]));
+    EXPECT_NEAR(out[4], 1.0f, 1e-6f);
+    rolling_covariance(span<const float>(x), span<const float>(y), 3, span<float>(out));
+    EXPECT_NEAR(out[4], 2.0f, 1e-6f);
+}
+
 // ========== Rolling Rank Tests ==========
 
 TEST(RollingRankTest, BasicTest) {
@@ -1365,6 +1520,76 @@ TEST(RankTest, LargerDataset) {
     EXPECT_FLOAT_EQ(result[9], 0.25);  // 10
 }
 
+// ========== Radix Rank Tests ==========
+
+// O(n²) 参考实现：平均名次 = 严格小于个数 + (相等个数 + 1) / 2，再除以有效个数
+static vector<float> brute_alpha_rank(const vector<float>& a) {
+    size_t m = 0;
+    for (float v : a) m += !isnan(v);
+    vector<float> r(a.size(), NAN);
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (isnan(a[i])) continue;
+        size_t less = 0, equal = 0;
+        for (float v : a) {
+            less += v < a[i];
+            equal += v == a[i];
+        }
+        r[i] = (2 * less + 1 + equal) / 2.0f / (float)m;
+    }
+    return r;
+}
+
+TEST(RadixRankTest, MatchesReferenceWithTiesNaNsAndSpecials) {
+    // 负数、±0、±inf、大量并列与 NaN 混合，规模跨过自动切换阈值
+    size_t n = 3 * kAlphaRankRadixThreshold;
+    vector<float> input(n);
+    uint32_t x = 99;
+    for (size_t i = 0; i < n; ++i) {
+        x = x * 1664525u + 1013904223u;
+        input[i] = ((int)((x >> 16) % 201) - 100) * 0.25f;
+    }
+    input[3] = NAN;
+    input[10] = -0.0f;
+    input[11] = 0.0f;
+    input[20] = INFINITY;
+    input[21] = -INFINITY;
+    input[n - 1] = NAN;
+
+    vector<float> expected = brute_alpha_rank(input);
+    vector<float> radix(n);
+    vector<size_t> buf;
+    alpha_rank_radix(span<const float>(input), span<float>(radix), buf);
+    vector<float> automatic = alpha_rank(input);
+
+    for (size_t i = 0; i < n; ++i) {
+        if (isnan(expected[i])) {
+            EXPECT_TRUE(isnan(radix[i])) << i;
+            EXPECT_TRUE(isnan(automatic[i])) << i;
+        } else {
+            EXPECT_EQ(expected[i], radix[i]) << i;
+            EXPECT_EQ(expected[i], automatic[i]) << i;
+        }
+    }
+    EXPECT_EQ(radix[10], radix[11]);  // -0.0 与 +0.0 并列
+}
+
+TEST(RadixRankTest, SmallAndDegenerateInputs) {
+    vector<size_t> buf;
+    for (vector<float> input : {vector<float>{}, vector<float>{NAN, NAN}, vector<float>{7.0f},
+                                vector<float>{2, 2, 2, 2}, vector<float>{3, -1, NAN, 2}}) {
+        vector<float> expected = brute_alpha_rank(input);
+        vector<float> out(input.size());
+        alpha_rank_radix(span<const float>(input), span<float>(out), buf);
+        for (size_t i = 0; i < input.size(); ++i) {
+            if (isnan(expected[i])) {
+                EXPECT_TRUE(isnan(out[i]));
+            } else {
+                EXPECT_EQ(expected[i], out[i]);
+            }
+        }
+    }
+}
+
 // ========== TS Rank Ultra Tests ==========
 
 TEST(TsRankUltraTest, BasicTest) {
@@ -1419,6 +1644,57 @@ TEST(TsRankUltraTest, WithDuplicates) {
     }
 }
 
+// ========== TS Rank Fenwick Tests ==========
+
+static void expect_same_ranks(const vector<float>& expected, const vector<float>& actual) {
+    ASSERT_EQ(expected.size(), actual.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+        if (isnan(expected[i])) {
+            EXPECT_TRUE(isnan(actual[i])) << "i=" << i;
+        } else {
+            EXPECT_FLOAT_EQ(expected[i], actual[i]) << "i=" << i;
+        }
+    }
+}
+
+TEST(TsRankFenwickTest, MatchesRollingRankWithTies) {
+    vector<float> input = {1, 3, 2, 3, 3, 2, 1, 4};
+    expect_same_ranks(ts_rank(input, 4), ts_rank_fenwick(input, 4));
+    expect_same_ranks(ts_rank(input, 1), ts_rank_fenwick(input, 1));
+    expect_same_ranks(ts_rank(input, 8), ts_rank_fenwick(input, 8));
+}
+
+TEST(TsRankFenwickTest, LargeDatasetVaryingWindow) {
+    // 取值只有 37 种，并列大量出现
+    vector<float> input;
+    uint32_t x = 7;
+    for (int i = 0; i < 5000; ++i) {
+        x = x * 1664525u + 1013904223u;
+        input.push_back((float)((x >> 16) % 37));
+    }
+    for (int w : {2, 10, 50, 250}) expect_same_ranks(ts_rank(input, w), ts_rank_fenwick(input, w));
+}
+
+TEST(TsRankFenwickTest, NaNMatchesCountingVersion) {
+    vector<float> input = {1, NAN, 3, 2, NAN, 5, 4, 4, 1};
+    vector<float> expected(input.size());
+    ts_rank(span<const float>(input), 3, span<float>(expected));
+    expect_same_ranks(expected, ts_rank_fenwick(input, 3));
+}
+
+TEST(TsRankFenwickTest, ReusedBuffers) {
+    vector<uint32_t> codes;
+    vector<float> domain;
+    FenwickCounter tree;
+    vector<float> a = {5, 4, 3, 2, 1, 2, 3};
+    vector<float> b = {10, 10, 20, 30, 20, 10};
+    vector<float> out_a(a.size()), out_b(b.size());
+    ts_rank_fenwick(span<const float>(a), 3, span<float>(out_a), codes, domain, tree);
+    ts_rank_fenwick(span<const float>(b), 3, span<float>(out_b), codes, domain, tree);
+    expect_same_ranks(ts_rank(a, 3), out_a);
+    expect_same_ranks(ts_rank(b, 3), out_b);
+}
+
 // ========== Scale (Skalierung) Tests ==========
 
 TEST(ScaleTest, BasicExample) {
@@ -1716,6 +1992,86 @@ TEST(TsArgminTest, DefaultWindow) {
     EXPECT_FLOAT_EQ(result[9], 6.0f);
 }
 
+// ========== Monotonic-Deque ts_min / ts_max / ts_argmax / ts_argmin Tests ==========
+
+// 暴力参考实现：逐窗口扫描，窗口内含 NaN 输出 NaN，并列取最早位置
+static vector<float> brute_window(const vector<float>& a, int window, bool is_max, bool want_arg) {
+    vector<float> out(a.size(), NAN);
+    for (size_t i = window - 1; i < a.size(); ++i) {
+        size_t start = i + 1 - window, best = start;
+        bool has_nan = false;
+        for (size_t j = start; j <= i; ++j) {
+            if (isnan(a[j])) has_nan = true;
+            else if (isnan(a[best]) || (is_max ? a[j] > a[best] : a[j] < a[best])) best = j;
+        }
+        if (!has_nan) out[i] = want_arg ? (float)(best - start + 1) : a[best];
+    }
+    return out;
+}
+
+// 含大量并列值与零散 NaN 的序列
+static vector<float> ties_and_nans(size_t n, uint32_t seed) {
+    vector<float> a(n);
+    for (size_t i = 0; i < n; ++i) {
+        seed = seed * 1664525u + 1013904223u;
+        a[i] = (seed >> 24) % 29 == 0 ? NAN : (float)((seed >> 16) % 7);
+    }
+    return a;
+}
+
+TEST(MonotonicDequeTest, MatchesBruteForceWithTiesAndNaN) {
+    auto a = ties_and_nans(500, 12345);
+    for (int w : {1, 2, 3, 5, 8, 20, 64, 250}) {
+        EXPECT_TRUE(vectors_equal(ts_min(a, w), brute_window(a, w, false, false))) << "ts_min w=" << w;
+        EXPECT_TRUE(vectors_equal(ts_max(a, w), brute_window(a, w, true, false))) << "ts_max w=" << w;
+        EXPECT_TRUE(vectors_equal(ts_argmax(a, w), brute_window(a, w, true, true))) << "ts_argmax w=" << w;
+        EXPECT_TRUE(vectors_equal(ts_argmin(a, w), brute_window(a, w, false, true))) << "ts_argmin w=" << w;
+    }
+}
+
+TEST(MonotonicDequeTest, CallerBuffersReusedAcrossWindows) {
+    auto a = ties_and_nans(300, 777);
+    vector<float> out(a.size());
+    vector<size_t> idx_buf;
+    for (int w : {40, 3, 17, 1, 100}) {
+        ts_argmax(span<const float>(a), w, span<float>(out), idx_buf);
+        EXPECT_TRUE(vectors_equal(out, brute_window(a, w, true, true))) << "w=" << w;
+        ts_min(span<const float>(a), w, span<float>(out), idx_buf);
+        EXPECT_TRUE(vectors_equal(out, brute_window(a, w, false, false))) << "w=" << w;
+    }
+}
+
+TEST(MonotonicDequeTest, NoAllocationOnceBufferIsSized) {
+    auto a = ties_and_nans(200, 99);
+    vector<float> out(a.size());
+    vector<size_t> idx_buf;
+    ts_max(span<const float>(a), 20, span<float>(out), idx_buf);
+    const size_t* storage = idx_buf.data();
+    for (int rep = 0; rep < 3; ++rep) ts_argmin(span<const float>(a), 20, span<float>(out), idx_buf);
+    EXPECT_EQ(idx_buf.data(), storage);
+}
+
+TEST(MonotonicDequeTest, WindowLongerThanSeries) {
+    vector<float> a = {3, 1, 2};
+    vector<float> r = ts_max(a, 5);
+    ASSERT_EQ(r.size(), 3);
+    for (float v : r) EXPECT_TRUE(isnan(v));
+}
+
+TEST(MonotonicDequeTest, NaNLeavesWindowThenRecovers) {
+    // NaN 位于下标 2，window=3：下标 2..4 的窗口包含 NaN，下标 5 起恢复
+    vector<float> a = {5, 4, NAN, 1, 2, 3, 9};
+    vector<float> r = ts_min(a, 3);
+    EXPECT_TRUE(isnan(r[2]));
+    EXPECT_TRUE(isnan(r[3]));
+    EXPECT_TRUE(isnan(r[4]));
+    EXPECT_FLOAT_EQ(r[5], 1);
+    EXPECT_FLOAT_EQ(r[6], 2);
+    vector<float> am = ts_argmax(a, 3);
+    EXPECT_FLOAT_EQ(am[5], 3);
+    EXPECT_FLOAT_EQ(am[6], 3);
+}
+
 // ========== Decay Linear Tests ==========
 
 TEST(DecayLinearTest, BasicTest) {
@@ -1806,9 +2162,220 @@ TEST(DecayLinearTest, RecentValuesWeightedHigher) {
     EXPECT_GT(result[2], result2[2]);
 }
 
+TEST(DecayLinearTest, NaNOnlyAffectsWindowsContainingIt) {
+    vector<float> input = {1.0f, 2.0f, NAN, 4.0f, 5.0f, 6.0f, 7.0f};
+    vector<float> result = decay_linear(input, 2);
+
+    EXPECT_NEAR(result[1], 5.0f / 3.0f, 1e-5f);
+    EXPECT_TRUE(isnan(result[2]));
+    EXPECT_TRUE(isnan(result[3]));
+    EXPECT_NEAR(result[4], 14.0f / 3.0f, 1e-5f);
+    EXPECT_NEAR(result[6], 20.0f / 3.0f, 1e-5f);
+}
+
+TEST(DecayLinearTest, RecursiveUpdateMatchesDotProduct) {
+    // 价格量级的长序列，与逐窗口 double 点积比较，检验递推漂移有界
+    vector<float> input(5000);
+    for (size_t i = 0; i < input.size(); ++i) input[i] = 100.0f + 30.0f * std::sin(0.05f * i) + (i % 7) * 0.3f;
+    for (int period : {1, 3, 8, 20, 61}) {
+        vector<float> result = decay_linear(input, period);
+        double divisor = period * (period + 1) / 2.0;
+        for (size_t i = period - 1; i < input.size(); i += 13) {
+            double expected = 0.0;
+            for (int k = 0; k < period; ++k) expected += (k + 1) * (double)input[i + 1 - period + k];
+            expected /= divisor;
+            EXPECT_NEAR(result[i], expected, std::abs(expected) * 1e-6) << "period=" << period << " i=" << i;
+        }
+    }
+}
+
 TEST(DecayLinearTest, ResultSize) {
     vector<float> input = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f};
     EXPECT_EQ(decay_linear(input, 3).size(), input.size());
 }
 
+// ========== Workspace-Overloads: stationär ohne Heap-Allokation ==========
+
+// 依次调用全部 Workspace 重载；每轮输入不同，规模不变
+static void run_all_ops(span<const float> a, span<const float> b, span<float> out, Workspace& ws) {
+    rolling_ts_sum(a, 20, out, ws);
+    rolling_sma(a, 20, out, ws);
+    rolling_stddev(a, 20, out, ws);
+    rolling_correlation(a, b, 20, out, ws);
+    rolling_covariance(a, b, 20, out, ws);
+    ts_rank(a, 10, out, ws);
+    ts_rank_fenwick(a, 10, out, ws);
+    product(a, 5, out, ws);
+    ts_min(a, 30, out, ws);
+    ts_max(a, 30, out, ws);
+    ts_argmax(a, 30, out, ws);
+    ts_argmin(a, 30, out, ws);
+    delta(a, 3, out, ws);
+    delay(a, 3, out, ws);
+    decay_linear(a, 10, out, ws);
+    alpha_rank(a, out, ws);
+    scale(a, 1.0f, out, ws);
+}
+
+TEST(WorkspaceTest, SteadyStateMakesNoHeapAllocations) {
+    // n = 1000 使 alpha_rank 走基数排序路径（键缓冲区 2n）
+    for (size_t n : {100u, 1000u}) {
+        vector<vector<float>> inputs(4, vector<float>(n));
+        for (size_t r = 0; r < inputs.size(); ++r)
+            for (size_t i = 0; i < n; ++i) inputs[r][i] = (i * (7 + r) % 97 == 13) ? NAN : std::sin(0.1f * i * (r + 1)) * 50.0f;
+        vector<float> out(n);
+        Workspace ws;
+        run_all_ops(inputs[0], inputs[1], out, ws);  // 首轮：缓冲区增长到所需规模
+
+        size_t before = g_heap_allocations.load();
+        for (int rep = 0; rep < 3; ++rep)
+            for (size_t r = 0; r < inputs.size(); ++r) run_all_ops(inputs[r], inputs[(r + 1) % inputs.size()], out, ws);
+        EXPECT_EQ(g_heap_allocations.load() - before, 0u) << "n=" << n;
+
+        // 对照：不带 Workspace 的重载每次调用都分配队列存储，计数器必须能观察到
+        before = g_heap_allocations.load();
+        ts_argmax(span<const float>(inputs[0]), 30, span<float>(out));
+        EXPECT_GT(g_heap_allocations.load() - before, 0u);
+    }
+}
+
+TEST(WorkspaceTest, ReserveAvoidsFirstCallAllocations) {
+    size_t n = 600;
+    vector<float> a(n), b(n), out(n);
+    for (size_t i = 0; i < n; ++i) {
+        a[i] = std::cos(0.3f * i) * 10.0f;
+        b[i] = std::sin(0.2f * i);
+    }
+    Workspace ws;
+    ws.reserve(n, 30);
+    size_t before = g_heap_allocations.load();
+    run_all_ops(a, b, out, ws);
+    EXPECT_EQ(g_heap_allocations.load() - before, 0u);
+}
+
+TEST(WorkspaceTest, MatchesOverloadsWithoutWorkspace) {
+    vector<float> a(300);
+    for (size_t i = 0; i < a.size(); ++i) a[i] = (i % 41 == 40) ? NAN : std::sin(0.17f * i) * 3.0f;
+    vector<float> expected(a.size()), actual(a.size());
+    Workspace ws;
+
+    ts_argmax(span<const float>(a), 12, span<float>(expected));
+    ts_argmax(span<const float>(a), 12, span<float>(actual), ws);
+    EXPECT_TRUE(vectors_equal(actual, expected, 0.0f));
+    ts_rank_fenwick(span<const float>(a), 12, span<float>(expected));
+    ts_rank_fenwick(span<const float>(a), 12, span<float>(actual), ws);
+    EXPECT_TRUE(vectors_equal(actual, expected, 0.0f));
+    vector<size_t> idx_buf;
+    alpha_rank(span<const float>(a), span<float>(expected), idx_buf);
+    alpha_rank(span<const float>(a), span<float>(actual), ws);
+    EXPECT_TRUE(vectors_equal(actual, expected, 0.0f));
+
+    // 重新锚定的算子把 origin 原样转交给 span 版本。尖峰移出窗口后 double 和式丢掉的小值
+    // 直到下一次锚定才恢复，锚点位置不同则输出不同
+    for (size_t i = 0; i < a.size(); ++i) a[i] = i % 29 == 0 ? 1e20f : 1.0f + 0.01f * (i % 13);
+    span<const float> x(a), y(a.data() + 1, a.size() - 1);
+    rolling_stddev(x, 12, span<float>(expected), 5);
+    rolling_stddev(x, 12, span<float>(actual), ws, 5);
+    EXPECT_TRUE(vectors_equal(actual, expected, 0.0f));
+    rolling_ts_sum(x, 12, span<float>(expected), 7);
+    rolling_ts_sum(x, 12, span<float>(actual), ws, 7);
+    EXPECT_TRUE(vectors_equal(actual, expected, 0.0f));
+    decay_linear(x, 12, span<float>(expected), 3);
+    decay_linear(x, 12, span<float>(actual), ws, 3);
+    EXPECT_TRUE(vectors_equal(actual, expected, 0.0f));
+    expected.resize(y.size());
+    actual.resize(y.size());
+    rolling_correlation(x.first(y.size()), y, 12, span<float>(expected), 9);
+    rolling_correlation(x.first(y.size()), y, 12, span<float>(actual), ws, 9);
+    EXPECT_TRUE(vectors_equal(actual, expected, 0.0f));
+    rolling_covariance(x.first(y.size()), y, 12, span<float>(expected), 9);
+    rolling_covariance(x.first(y.size()), y, 12, span<float>(actual), ws, 9);
+    EXPECT_TRUE(vectors_equal(actual, expected, 0.0f));
+}
+
+// ========== 分组截面算子测试 ==========
+
+TEST(GroupIndexTest, MembersAreContiguousPerGroup) {
+    vector<uint32_t> codes = {2, 0, GroupIndex::kNoGroup, 2, 1, 0};
+    GroupIndex gi;
+    gi.build(codes, 3);
+    ASSERT_EQ(gi.groups(), 3u);
+    EXPECT_EQ(vector<uint32_t>(gi.group(0).begin(), gi.group(0).end()), (vector<uint32_t>{1, 5}));
+    EXPECT_EQ(vector<uint32_t>(gi.group(1).begin(), gi.group(1).end()), (vector<uint32_t>{4}));
+    EXPECT_EQ(vector<uint32_t>(gi.group(2).begin(), gi.group(2).end()), (vector<uint32_t>{0, 3}));
+    EXPECT_EQ(gi.members.size(), 5u);  // 未分类的股票不在任何组中
+}
+
+TEST(GroupOpsTest, DemeanSubtractsGroupMeanIgnoringNaN) {
+    vector<uint32_t> codes = {0, 1, 0, 1, 0, GroupIndex::kNoGroup};
+    GroupIndex gi;
+    gi.build(codes, 2);
+    vector<float> a = {1.0f, 10.0f, 3.0f, NAN, 5.0f, 7.0f}, out(6);
+    group_demean(a, gi, out);
+    EXPECT_FLOAT_EQ(out[0], -2.0f);
+    EXPECT_FLOAT_EQ(out[2], 0.0f);
+    EXPECT_FLOAT_EQ(out[4], 2.0f);
+    EXPECT_FLOAT_EQ(out[1], 0.0f);  // 组 1 只有一个有效值
+    EXPECT_TRUE(isnan(out[3]));
+    EXPECT_TRUE(isnan(out[5]));  // 未分类
+}
+
+TEST(GroupOpsTest, RankAndScaleMatchPlainOpsOnEachGroup) {
+    // 每组单独抽出后调用 alpha_rank / scale，结果必须与分组算子逐位相同；
+    // n=1500 超过 kAlphaRankRadixThreshold，走整截面基数排序 + 按组分桶的路径
+    for (size_t n : {size_t(97), size_t(1500)}) {
+        SCOPED_TRACE(n);
+        size_t G = 6;
+        vector<uint32_t> codes(n);
+        vector<float> a(n);
+        for (size_t i = 0; i < n; ++i) {
+            codes[i] = (uint32_t)(i * 37 % G);
+            a[i] = (i % 13 == 0) ? float(i % 5) : std::sin(0.7f * i) * 4.0f;  // 含并列
+        }
+        a[20] = NAN;
+        codes[31] = GroupIndex::kNoGroup;
+        GroupIndex gi;
+        gi.build(codes, G);
+        vector<float> ranked(n), scaled(n);
+        group_rank(a, gi, ranked);
+        group_scale(a, gi, 2.0f, scaled);
+        EXPECT_TRUE(isnan(ranked[31]));
+        for (size_t g = 0; g < G; ++g) {
+            vector<float> x, r, sc;
+            for (uint32_t i : gi.group(g)) x.push_back(a[i]);
+            r.resize(x.size());
+            sc.resize(x.size());
+            vector<size_t> idx_buf;
+            alpha_rank(span<const float>(x), span<float>(r), idx_buf);
+            scale(span<const float>(x), 2.0f, span<float>(sc));
+            size_t j = 0;
+            for (uint32_t i : gi.group(g)) {
+                if (isnan(r[j])) EXPECT_TRUE(isnan(ranked[i]));
+                else EXPECT_EQ(ranked[i], r[j]) << "g=" << g << " i=" << i;
+                if (isnan(sc[j])) EXPECT_TRUE(isnan(scaled[i]));
+                else EXPECT_EQ(scaled[i], sc[j]) << "g=" << g << " i=" << i;
+                ++j;
+            }
+        }
+    }
+}
+
+TEST(GroupOpsTest, RankWithWorkspaceDoesNotAllocate) {
+    size_t n = 1000;
+    vector<uint32_t> codes(n);
+    vector<float> a(n), out(n);
+    for (size_t i = 0; i < n; ++i) {
+        codes[i] = (uint32_t)(i % 11);
+        a[i] = std::cos(0.3f * i);
+    }
+    GroupIndex gi;
+    gi.build(codes, 11);
+    Workspace ws;
+    ws.reserve(n);
+    group_rank(a, gi, out, ws);  // 首次调用让 idx 容纳基数排序的分桶计数
+    size_t before = g_heap_allocations.load();
+    for (int rep = 0; rep < 3; ++rep) group_rank(a, gi, out, ws);
+    EXPECT_EQ(g_heap_allocations.load() - before, 0u);
+}
+
 // main-Funktion wird von GTest::gtest_main bereitgestellt, kein manuelles Schreiben nötig
\ No newline at end of file
@@ -0,0 +1,35 @@
+#ifndef ALPHA101_TESTS_HEAPALLOCATIONCOUNTER_H
+#define ALPHA101_TESTS_HEAPALLOCATIONCOUNTER_H
+
+// ========== 堆分配计数：替换全局 operator new，用于验证稳态零分配 ==========
+// 替换全局 operator new / delete，每个测试可执行文件只能有一个翻译单元包含本文件。
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+static std::atomic<size_t> g_heap_allocations{0};
+
+static void* counted_alloc(size_t n, size_t align = alignof(std::max_align_t)) {
+    ++g_heap_allocations;
+    n = n ? n : 1;
+    void* p = align <= alignof(std::max_align_t) ? std::malloc(n) : std::aligned_alloc(align, (n + align - 1) / align * align);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+void* operator new(size_t n) { return counted_alloc(n); }
+void* operator new[](size_t n) { return counted_alloc(n); }
+void* operator new(size_t n, std::align_val_t al) { return counted_alloc(n, (size_t)al); }
+void* operator new[](size_t n, std::align_val_t al) { return counted_alloc(n, (size_t)al); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+void operator delete[](void* p, size_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, size_t, std::align_val_t) noexcept { std::free(p); }
+
+#endif  // ALPHA101_TESTS_HEAPALLOCATIONCOUNTER_H